@@ -0,0 +1,154 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_ADMISSION_CONTROLLER_H
+#define ACA_ADMISSION_CONTROLLER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace aca_admission_controller
+{
+/*
+  Credit based admission control for goal state ingestion.
+
+  Every goal state takes credits for its number of resources and its serialized size
+  before it gets programmed, and gives them back once it is done. When the budget
+  (ADMISSION_MAX_IN_FLIGHT_RESOURCES / ADMISSION_MAX_IN_FLIGHT_BYTES by default,
+  set_limits() from the -n/-w command line options) is used up:
+    - try_admit() fails, used by unary gRPC calls to return RESOURCE_EXHAUSTED
+    - admit() blocks, used by the pulsar consumer to stop receiving
+    - admit_async() parks the continuation, used by the gRPC stream so no more
+      reads are posted and gRPC flow control pushes back on the sender
+  A goal state is always admitted when nothing else is in flight, so a single
+  goal state larger than the budget can still go through.
+*/
+class ACA_Admission_Controller {
+  public:
+  static ACA_Admission_Controller &get_instance();
+
+  // change the budget, 0 means unlimited
+  void set_limits(unsigned long max_resources, unsigned long max_bytes);
+
+  // take the credits if they are available, never blocks
+  bool try_admit(unsigned long resources, unsigned long bytes);
+
+  // take the credits, wait until they are available
+  void admit(unsigned long resources, unsigned long bytes);
+
+  // run on_admitted once the credits are taken, either right away on the calling
+  // thread or later on the thread releasing the credits
+  void admit_async(unsigned long resources, unsigned long bytes,
+                   std::function<void()> on_admitted);
+
+  // give back credits taken by try_admit/admit/admit_async
+  void release(unsigned long resources, unsigned long bytes);
+
+  // number of goal states waiting for credits
+  unsigned long get_queue_depth();
+
+  // highest number of goal states that were waiting for credits at the same time
+  unsigned long get_max_queue_depth();
+
+  // number of goal states that had to wait for credits
+  unsigned long get_deferred_count();
+
+  unsigned long get_in_flight_resources();
+
+  unsigned long get_in_flight_bytes();
+
+  // number of goal states turned away by try_admit
+  unsigned long get_rejected_count();
+
+  // compiler will flag the error when below is called.
+  ACA_Admission_Controller(ACA_Admission_Controller const &) = delete;
+  void operator=(ACA_Admission_Controller const &) = delete;
+
+  private:
+  ACA_Admission_Controller();
+  ~ACA_Admission_Controller(){};
+
+  struct pending_admission {
+    unsigned long resources;
+    unsigned long bytes;
+    std::function<void()> on_admitted;
+  };
+
+  // must be called with _credits_mutex held
+  bool has_credits(unsigned long resources, unsigned long bytes);
+  void take_credits(unsigned long resources, unsigned long bytes);
+  void count_deferred();
+
+  std::mutex _credits_mutex;
+  std::condition_variable _credits_cv;
+  // admit_async callers waiting for credits, served in FIFO order
+  std::deque<pending_admission> _pending_admissions;
+  unsigned long _blocked_admissions;
+  unsigned long _max_resources;
+  unsigned long _max_bytes;
+  unsigned long _in_flight_resources;
+  unsigned long _in_flight_bytes;
+  unsigned long _in_flight_goal_states;
+  std::atomic_ulong _rejected_count;
+  std::atomic_ulong _max_queue_depth;
+  std::atomic_ulong _deferred_count;
+};
+
+/*
+  Owns credits taken from the admission controller and gives them back when it goes
+  out of scope, so an exception thrown while programming a goal state does not leak
+  them and stall admission. release() gives them back earlier, a guard created with
+  admitted == false owns nothing.
+*/
+class ACA_Admission_Guard {
+  public:
+  ACA_Admission_Guard(unsigned long resources, unsigned long bytes, bool admitted = true)
+          : _admitted(admitted), _resources(resources), _bytes(bytes){};
+  ~ACA_Admission_Guard()
+  {
+    release();
+  };
+
+  void release()
+  {
+    if (_admitted) {
+      _admitted = false;
+      ACA_Admission_Controller::get_instance().release(_resources, _bytes);
+    }
+  };
+
+  // compiler will flag the error when below is called.
+  ACA_Admission_Guard(ACA_Admission_Guard const &) = delete;
+  void operator=(ACA_Admission_Guard const &) = delete;
+
+  private:
+  bool _admitted;
+  unsigned long _resources;
+  unsigned long _bytes;
+};
+
+// number of resources in a GoalState or GoalStateV2 that need to be programmed,
+// subnet/vpc/gateway states only carry info for them
+template <class GoalStateType>
+static inline unsigned long aca_get_goal_state_resource_count(const GoalStateType &goal_state)
+{
+  return goal_state.port_states_size() + goal_state.neighbor_states_size() +
+         goal_state.router_states_size() + goal_state.dhcp_states_size();
+}
+
+} // namespace aca_admission_controller
+#endif // #ifndef ACA_ADMISSION_CONTROLLER_H
@@ -17,24 +17,14 @@
 
 #include <string>
 #include <unordered_map>
-#include "hashmap/HashMap.h"
+#include "aca_arp_table.h"
+#include "aca_snapshot.h"
 #include <mutex>
 
 using namespace std;
 
 namespace aca_arp_responder
 {
-#define ARP_ENTRY_DATA_SET(pData, pConfig)                                     \
-  do {                                                                         \
-    (pData)->ipv4_address = (pConfig)->ipv4_address;                           \
-    (pData)->vlan_id = (pConfig)->vlan_id;                                     \
-  } while (0)
-
-#define ARP_TABLE_DATA_SET(pData, pConfig)                                     \
-  do {                                                                         \
-    (pData)->mac_address = (pConfig)->mac_address;                             \
-  } while (0)
-
 struct arp_config {
   string mac_address;
   string ipv4_address;
@@ -43,32 +33,6 @@ struct arp_config {
   string port_host_name;
 };
 
-struct arp_entry_data {
-  string ipv4_address;
-  string ipv6_address;
-  uint16_t vlan_id;
-  bool operator==(const arp_entry_data &p) const
-  {
-    return ipv4_address == p.ipv4_address && vlan_id == p.vlan_id;
-  }
-
-  bool operator!=(const arp_entry_data &p) const
-  {
-    return ipv4_address != p.ipv4_address || vlan_id != p.vlan_id;
-  }
-};
-
-struct arp_hash {
-  size_t operator()(const arp_entry_data &p) const
-  {
-    return hash<string>()(p.ipv4_address) ^ (hash<uint16_t>()(p.vlan_id) << 1);
-  }
-};
-
-struct arp_table_data {
-  string mac_address;
-};
-
 struct arp_message {
   uint16_t hrd;
   uint16_t pro;
@@ -100,7 +64,8 @@ class ACA_ARP_Responder {
   public:
   static ACA_ARP_Responder &get_instance();
 
-  bool does_arp_entry_exist(arp_entry_data stData);
+  // ipv4_address is in network byte order, as in an ARP message
+  bool does_arp_entry_exist(uint16_t vlan_id, uint32_t ipv4_address);
 
   /* Managemet Plane Ops*/
   int add_arp_entry(arp_config *arp_config_in);
@@ -114,11 +79,24 @@ class ACA_ARP_Responder {
   string _get_source_ip(arp_message *arpmsg);
   int _parse_arp_request(uint32_t in_port, vlan_message *vlanmsg, arp_message *arpmsg);
 
+  // drop the ARP entries of a vlan id before it is handed to another VPC,
+  // returns how many there were
+  size_t delete_vlan_arp_entries(uint16_t vlan_id);
+
+  // drop every ARP entry, e.g. what a failed restore left behind
+  void clear_all_data();
+
+  // write the ARP DB, called while no goal state is being programmed
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // rebuild the ARP DB at startup, -EINVAL if the snapshot data is damaged
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
+
   private:
   ACA_ARP_Responder();
   ~ACA_ARP_Responder();
 
-  CTSL::HashMap<arp_entry_data, arp_table_data *, arp_hash> _arp_db;
+  ACA_Arp_Table _arp_db;
 
   /*************** Initialization and De-initialization ***********************/
   void _init_arp_db();
@@ -128,14 +106,15 @@ class ACA_ARP_Responder {
 
   /*************** Management plane operations ***********************/
   void _validate_mac_address(const char *mac_string);
-  void _validate_ipv4_address(const char *ip_address);
-  void _validate_ipv6_address(const char *ip_address);
-  int _validate_arp_entry(arp_config *arp_cfg_in);
+  // parse the key and MAC bytes of an arp_config, -ENOENT if it has no IPv4 address
+  // to answer for, -EINVAL if an address is malformed
+  int _get_arp_entry(arp_config *arp_cfg_in, uint64_t &key,
+                     uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]);
 
   /**************** Data plane operations *********************/
   int _validate_arp_message(arp_message *arpmsg);
 
-  arp_message *_pack_arp_reply(arp_message *arpreq, string mac_address);
+  arp_message *_pack_arp_reply(arp_message *arpreq, const uint8_t *mac_address);
 
   string _serialize_arp_message(vlan_message *vlanmsg, arp_message *arpmsg);
 };
@@ -0,0 +1,152 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_ARP_TABLE_H
+#define ACA_ARP_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// slots of an empty ARP table, the table doubles when half of its slots are used
+#define ARP_TABLE_INITIAL_SLOTS 1024
+
+#define ARP_MAC_ADDRESS_LENGTH 6
+
+namespace aca_arp_responder
+{
+struct arp_table_slot {
+  std::atomic<uint64_t> key;
+  std::atomic<uint64_t> mac_address;
+};
+
+struct arp_table_slots {
+  explicit arp_table_slots(size_t slot_count);
+
+  size_t mask;
+  std::unique_ptr<arp_table_slot[]> slots;
+};
+
+/*
+  Read-mostly ARP table for the packet path.
+
+  An entry is keyed by (vlan id << 32 | IPv4 address in network byte order) and holds
+  the 6 MAC bytes packed in a 64 bit word, so a lookup is a few integer compares in an
+  open addressed array, with no string and no lock.
+
+  Readers never block: find() and contains() only do atomic loads. Writers are
+  serialized by a mutex and change the slots in place, an erased key leaves a
+  tombstone. When half of the slots are used the writer copies the live entries into
+  a bigger array and publishes it, then waits for the readers still walking the old
+  array (two reader counters flipped by an epoch, RCU style) before freeing it.
+*/
+class ACA_Arp_Table {
+  public:
+  ACA_Arp_Table();
+  ~ACA_Arp_Table();
+
+  static uint64_t make_key(uint16_t vlan_id, uint32_t ipv4_address)
+  {
+    return (uint64_t)vlan_id << 32 | ipv4_address;
+  }
+
+  static uint16_t get_vlan_id(uint64_t key)
+  {
+    return (uint16_t)(key >> 32);
+  }
+
+  static uint32_t get_ipv4_address(uint64_t key)
+  {
+    return (uint32_t)key;
+  }
+
+  // copy the MAC of key into mac_address, false if key is not in the table
+  bool find(uint64_t key, uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]) const;
+
+  bool contains(uint64_t key) const;
+
+  // false if key is already in the table, its MAC is left unchanged
+  bool insert(uint64_t key, const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]);
+
+  void insert_or_update(uint64_t key, const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]);
+
+  // false if key is not in the table
+  bool erase(uint64_t key);
+
+  void clear();
+
+  size_t size() const;
+
+  /*
+   * call function(key, mac_address) for every entry, writers wait until it returns.
+   * function must not modify the table.
+   */
+  template <typename Function> void for_each(Function function)
+  {
+    std::lock_guard<std::mutex> writer_lock(_writer_mutex);
+    arp_table_slots *current_slots = _slots.load(std::memory_order_relaxed);
+    uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+
+    for (size_t i = 0; i <= current_slots->mask; i++) {
+      uint64_t key = current_slots->slots[i].key.load(std::memory_order_relaxed);
+      if (key != EMPTY_KEY && key != ERASED_KEY) {
+        unpack_mac_address(
+                current_slots->slots[i].mac_address.load(std::memory_order_relaxed),
+                mac_address);
+        function(key, (const uint8_t *)mac_address);
+      }
+    }
+  }
+
+  // compiler will flag the error when below is called.
+  ACA_Arp_Table(ACA_Arp_Table const &) = delete;
+  void operator=(ACA_Arp_Table const &) = delete;
+
+  private:
+  // a vlan id has 12 bits, so no real key comes near these two
+  static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+  static constexpr uint64_t ERASED_KEY = UINT64_MAX - 1;
+
+  static uint64_t pack_mac_address(const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]);
+  static void unpack_mac_address(uint64_t packed_mac_address,
+                                 uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]);
+
+  static size_t _hash(uint64_t key);
+
+  // lock free read side: packed MAC of key, false if key is not in the table
+  bool _lookup(uint64_t key, uint64_t &packed_mac_address) const;
+
+  // writer side: slot holding key, or the empty slot ending its probe sequence
+  static arp_table_slot *_find_slot(arp_table_slots *current_slots, uint64_t key);
+
+  // move the live entries into an array with room for at least one more entry
+  void _resize();
+
+  // publish new_slots and free the current array once no reader uses it
+  void _replace_slots(arp_table_slots *new_slots);
+
+  std::atomic<arp_table_slots *> _slots;
+
+  // readers count themselves in _reader_counts[_reader_epoch & 1]
+  mutable std::atomic<uint64_t> _reader_epoch;
+  mutable std::atomic<uint64_t> _reader_counts[2];
+
+  std::mutex _writer_mutex;
+  std::atomic<size_t> _entry_count;
+  // live entries plus tombstones, only used by writers
+  size_t _used_slot_count;
+};
+} // namespace aca_arp_responder
+#endif // #ifndef ACA_ARP_TABLE_H
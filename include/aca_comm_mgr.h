@@ -16,6 +16,7 @@
 #define ACA_COMM_MGR_H
 
 #include "goalstateprovisioner.grpc.pb.h"
+#include <shared_mutex>
 
 using std::string;
 
@@ -34,6 +35,22 @@ class Aca_Comm_Manager {
   int update_goal_state(alcor::schema::GoalStateV2 &goal_state_message,
                         alcor::schema::GoalStateOperationReply &gsOperationReply);
 
+  // reprogram the goal states recorded in the journal after the marker of the
+  // restored snapshot, called at startup before the controller connects.
+  // Returns the number of goal states replayed
+  long restore_from_journal();
+
+  // write the in-memory dataplane tables to file_path and drop the journal records
+  // covered by the snapshot it replaces, that one is kept as the fallback.
+  // Goal state processing is paused while the tables are copied
+  int take_snapshot(const string &file_path);
+
+  // rebuild the in-memory dataplane tables from file_path, or from the previous
+  // snapshot if it is damaged, called at startup before restore_from_journal.
+  // The tables are left empty if neither can be restored.
+  // Returns -ENOENT if there is no snapshot yet
+  int restore_from_snapshot(const string &file_path);
+
   // compiler will flag error when below is called
   Aca_Comm_Manager(Aca_Comm_Manager const &) = delete;
   void operator=(Aca_Comm_Manager const &) = delete;
@@ -44,9 +61,20 @@ class Aca_Comm_Manager {
   Aca_Comm_Manager(){};
   ~Aca_Comm_Manager(){};
 
-  void print_goal_state(alcor::schema::GoalState parsed_struct);
+  void print_goal_state(const alcor::schema::GoalState &parsed_struct);
+
+  void print_goal_state(const alcor::schema::GoalStateV2 &parsed_struct);
+
+  // restore one snapshot file, the tables are cleared if it fails partway
+  int restore_snapshot_file(const string &file_path);
+
+  // held shared by every goal state update, exclusive while a snapshot is taken
+  std::shared_timed_mutex _snapshot_gate;
 
-  void print_goal_state(alcor::schema::GoalStateV2 parsed_struct);
+  // the snapshot last taken or restored and where its marker is in the journal,
+  // only used at startup and then by the snapshot thread
+  uint64_t _snapshot_id = 0;
+  size_t _snapshot_marker_position = 0;
 };
 } // namespace aca_comm_manager
 #endif
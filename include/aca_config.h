@@ -36,4 +36,71 @@
 #define REQUEST_UUID_ON_DEMAND_PAYLOAD_MAP_SIZE_CHECK_FREQUENCY_IN_MICROSECONDS \
   1000 // 10 microsecond, which is 1 millisecond
 
+// deadline of an on-demand HostRequest to NCM, including its hedged duplicate
+#define ON_DEMAND_GRPC_DEADLINE_IN_MICROSECONDS 2000000 // 2 seconds
+
+// hedge delay used before enough reply latencies are collected to estimate p95
+#define ON_DEMAND_HEDGE_DEFAULT_DELAY_IN_MICROSECONDS 50000 // 50 milliseconds
+
+// lower bound of the hedge delay, so a fast NCM does not get every request twice
+#define ON_DEMAND_HEDGE_MIN_DELAY_IN_MICROSECONDS 5000 // 5 milliseconds
+
+// number of recent reply latencies kept to estimate the p95 hedge delay
+#define ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE 256
+
+// minimum number of latency samples before the p95 estimate is used
+#define ON_DEMAND_HEDGE_MIN_LATENCY_SAMPLES 20
+
+// goal states with at most this many resources go to the high priority lane,
+// on-demand pushes (one neighbor state) always do
+#define GRPC_PRIORITY_LANES_HIGH_PRIORITY_MAX_RESOURCES 16
+
+// number of gRPC server workers that only serve the high priority lane
+#define GRPC_PRIORITY_LANES_RESERVED_HIGH_PRIORITY_WORKERS 2
+
+// a shared worker takes a bulk goal state after this many high priority ones in a row
+#define GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY 8
+
+// or when the oldest bulk goal state has waited this long
+#define GRPC_PRIORITY_LANES_BULK_MAX_WAIT_IN_MICROSECONDS 500000 // 500 milliseconds
+
+// admission control budget for goal states being programmed, 0 means unlimited
+#define ADMISSION_MAX_IN_FLIGHT_RESOURCES 20000
+#define ADMISSION_MAX_IN_FLIGHT_BYTES 268435456 // 256 MB
+
+// goal state workitems mostly wait on ovs-vsctl/ovs-ofctl,
+// so the work stealing pool runs a few workers per core
+#define WORK_STEALING_POOL_THREADS_PER_CORE 2
+
+// number of serial executor shards, operations on a VPC are
+// serialized on the shard picked by its tunnel id
+#define VPC_SERIAL_EXECUTOR_SHARDS 16
+
+// initial size of the preallocated journal of accepted goal states (-j option),
+// it doubles when full and is compacted back by every snapshot
+#define JOURNAL_CAPACITY_IN_BYTES 268435456 // 256 MB
+
+// how often the in-memory tables are snapshotted so that the journal stays short,
+// a snapshot is also taken as soon as the journal is half full
+#define SNAPSHOT_INTERVAL_IN_SECONDS 300
+
+// number of pulsar consumers sharing the goal state subscription, Key_Shared
+// keeps the messages with the same ordering key (VPC or host) on one consumer
+#define PULSAR_CONSUMER_WORKERS 4
+
+// a consumer takes up to this many messages already in its receiver queue at once
+#define PULSAR_CONSUMER_BATCH_MAX_MESSAGES 32
+
+// acknowledgements are sent to the broker in groups at most this often
+#define PULSAR_CONSUMER_ACK_GROUPING_TIME_IN_MILLISECONDS 100
+
+// goal state replies published on the message bus (-r option) are sent, one message
+// per reply, in batches of up to this many bytes or once the oldest reply has waited
+// the linger time
+#define REPLY_PUBLISHER_MAX_BATCH_BYTES 65536 // 64 KB
+#define REPLY_PUBLISHER_LINGER_IN_MICROSECONDS 10000 // 10 milliseconds
+
+// replies are dropped when this much is waiting for a slow message bus
+#define REPLY_PUBLISHER_MAX_PENDING_BYTES 16777216 // 16 MB
+
 #endif // #ifndef ACA_CONFIG_H
\ No newline at end of file
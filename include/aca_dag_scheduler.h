@@ -0,0 +1,80 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_DAG_SCHEDULER_H
+#define ACA_DAG_SCHEDULER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aca_dag_scheduler
+{
+/*
+  Runs a set of tasks that depend on each other. A task is started on the work
+  stealing pool as soon as all the tasks it depends on are done, so independent
+  chains (e.g. two VPCs) do not wait for each other.
+
+  Dependencies must point from an earlier node to a later one, which keeps the graph
+  acyclic by construction. A task without a function is a join node, it only waits
+  for its dependencies and is useful to avoid adding N x M edges.
+  One ACA_Dag_Scheduler instance is built and run once per goal state.
+*/
+class ACA_Dag_Scheduler {
+  public:
+  typedef size_t node_id;
+
+  // add a task, returns its node id
+  node_id add_node(std::function<int()> task);
+
+  // add a join node which does nothing by itself
+  node_id add_join_node();
+
+  /*
+   * make "after" wait for "before".
+   * Return:
+   *    EXIT_SUCCESS, or -EINVAL if a node is unknown or before is not added earlier than after
+   */
+  int add_dependency(node_id before, node_id after);
+
+  /*
+   * run all nodes and wait for them.
+   * Return:
+   *    EXIT_SUCCESS if all tasks succeeded, otherwise the rc of a failed task,
+   *    an error is preferred over EINPROGRESS
+   * Tasks still run when a task they depend on failed, like the staged update did.
+   */
+  int run();
+
+  size_t node_count();
+
+  private:
+  struct dag_node {
+    std::function<int()> task;
+    std::vector<node_id> successors;
+    size_t dependency_count = 0;
+    std::atomic_size_t remaining_dependencies;
+  };
+
+  void run_nodes(const std::vector<node_id> &ready_nodes);
+  void record_rc(int rc);
+
+  std::vector<std::unique_ptr<dag_node> > _nodes;
+  std::mutex _rc_mutex;
+  int _overall_rc;
+};
+} // namespace aca_dag_scheduler
+#endif // #ifndef ACA_DAG_SCHEDULER_H
@@ -26,14 +26,15 @@ class ACA_Dataplane_Mizar : public aca_net_programming_if::ACA_Core_Net_Programm
   public:
   int initialize();
 
-  int update_vpc_state_workitem(const alcor::schema::VpcState current_VpcState,
+  int update_vpc_state_workitem(const alcor::schema::VpcState &current_VpcState,
                                 alcor::schema::GoalStateOperationReply &gsOperationReply);
 
-  int update_subnet_state_workitem(const alcor::schema::SubnetState current_SubnetState,
+  int update_subnet_state_workitem(const alcor::schema::SubnetState &current_SubnetState,
                                    alcor::schema::GoalStateOperationReply &gsOperationReply);
 
-  int update_port_state_workitem(const alcor::schema::PortState current_PortState,
+  int update_port_state_workitem(const alcor::schema::PortState &current_PortState,
                                  alcor::schema::GoalState &parsed_struct,
+                                 const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                  alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   private:
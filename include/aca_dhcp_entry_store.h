@@ -0,0 +1,99 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_DHCP_ENTRY_STORE_H
+#define ACA_DHCP_ENTRY_STORE_H
+
+#include "aca_config.h"
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// independently locked shards of the DHCP entries, a power of 2
+#define DHCP_ENTRY_STORE_SHARDS 16
+
+namespace aca_dhcp_server
+{
+// addresses are IPv4 in network byte order, 0 when not configured
+struct dhcp_entry_data {
+  uint32_t ipv4_address;
+  uint32_t subnet_mask;
+  uint32_t gateway_address;
+  uint32_t dns_address_count;
+  uint32_t dns_addresses[DHCP_MSG_OPTS_DNS_LENGTH];
+};
+
+/*
+  DHCP entries keyed by the 48 bit MAC of the port.
+
+  A MAC is hashed to one of DHCP_ENTRY_STORE_SHARDS shards, each with its own
+  shared_timed_mutex, so DHCP requests from many VMs are answered in parallel and
+  only wait for a goal state writing the same shard. Lookups copy the entry out,
+  nothing points into the store once the lock is released.
+*/
+class ACA_Dhcp_Entry_Store {
+  public:
+  ACA_Dhcp_Entry_Store();
+
+  // "aa:bb:cc:dd:ee:ff" or "AA-BB-CC-DD-EE-FF" to the 48 bit MAC, false if malformed
+  static bool parse_mac_address(const std::string &mac_string, uint64_t &mac_address);
+
+  static std::string mac_address_to_string(uint64_t mac_address);
+
+  bool find(uint64_t mac_address, dhcp_entry_data &entry) const;
+
+  // false if mac_address is already in the store
+  bool insert(uint64_t mac_address, const dhcp_entry_data &entry);
+
+  // false if mac_address is not in the store
+  bool update(uint64_t mac_address, const dhcp_entry_data &entry);
+
+  // false if mac_address is not in the store
+  bool erase(uint64_t mac_address);
+
+  void clear();
+
+  size_t size() const;
+
+  // call function(mac_address, entry) for every entry, function must not modify the store
+  template <typename Function> void for_each(Function function) const
+  {
+    for (const dhcp_entry_shard &shard : _shards) {
+      std::shared_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+      for (const auto &[mac_address, entry] : shard.entries) {
+        function(mac_address, entry);
+      }
+    }
+  }
+
+  // compiler will flag the error when below is called.
+  ACA_Dhcp_Entry_Store(ACA_Dhcp_Entry_Store const &) = delete;
+  void operator=(ACA_Dhcp_Entry_Store const &) = delete;
+
+  private:
+  struct dhcp_entry_shard {
+    mutable std::shared_timed_mutex mutex;
+    std::unordered_map<uint64_t, dhcp_entry_data> entries;
+  };
+
+  dhcp_entry_shard &_get_shard(uint64_t mac_address);
+  const dhcp_entry_shard &_get_shard(uint64_t mac_address) const;
+
+  dhcp_entry_shard _shards[DHCP_ENTRY_STORE_SHARDS];
+  std::atomic<size_t> _entry_count;
+};
+} // namespace aca_dhcp_server
+#endif // #ifndef ACA_DHCP_ENTRY_STORE_H
@@ -16,8 +16,8 @@
 #define ACA_DHCP_SERVER_H
 
 #include "aca_dhcp_programming_if.h"
-#include <unordered_map>
-#include <mutex>
+#include "aca_dhcp_entry_store.h"
+#include "aca_snapshot.h"
 #include <cstdint>
 #include <cstdlib>
 #include <string>
@@ -27,29 +27,6 @@ using namespace aca_dhcp_programming_if;
 // dhcp server implementation class
 namespace aca_dhcp_server
 {
-struct dhcp_entry_data {
-  string ipv4_address;
-  string ipv6_address;
-  string port_host_name;
-  string subnet_mask;
-  string gateway_address;
-  string dns_addresses[DHCP_MSG_OPTS_DNS_LENGTH];
-};
-
-#define DHCP_ENTRY_DATA_SET(pData, pCfg)                                       \
-  do {                                                                         \
-    (pData)->ipv4_address = (pCfg)->ipv4_address;                              \
-    (pData)->port_host_name = (pCfg)->port_host_name;                          \
-    (pData)->subnet_mask = (pCfg)->subnet_mask;                                \
-    (pData)->gateway_address = (pCfg)->gateway_address;                        \
-    for (int i = 0; i < DHCP_MSG_OPTS_DNS_LENGTH; i++) {                       \
-      if ((pCfg)->dns_addresses[i].size() <= 0) {                                \
-        break;                                                                 \
-      }                                                                        \
-      (pData)->dns_addresses[i] = (pCfg)->dns_addresses[i];                        \
-    }                                                                          \
-  } while (0)
-
 //BOOTP Message Type
 #define BOOTP_MSG_BOOTREQUEST (0x1)
 #define BOOTP_MSG_BOOTREPLY (0x2)
@@ -253,6 +230,15 @@ class ACA_Dhcp_Server : public aca_dhcp_programming_if::ACA_Dhcp_Programming_Int
   void dhcps_recv(uint32_t in_port, void *message);
   void dhcps_xmit(uint32_t in_port, void *message);
 
+  // drop every DHCP entry, e.g. what a failed restore left behind
+  void clear_all_data();
+
+  // write the DHCP DB, called while no goal state is being programmed
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // rebuild the DHCP DB at startup, -EINVAL if the snapshot data is damaged
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
+
   private:
   /*************** Initialization and De-initialization ***********************/
   void _init_dhcp_db();
@@ -261,12 +247,12 @@ class ACA_Dhcp_Server : public aca_dhcp_programming_if::ACA_Dhcp_Programming_Int
   void _deinit_dhcp_ofp();
 
   /*************** Management plane operations ***********************/
-  dhcp_entry_data *_search_dhcp_entry(string mac_address);
+  // MAC and packed entry of a validated dhcp_cfg_in
+  int _get_dhcp_entry(dhcp_config *dhcp_cfg_in, uint64_t &mac_address, dhcp_entry_data &stData);
   void _validate_mac_address(const char *mac_string);
   void _validate_ipv4_address(const char *ip_address);
   void _validate_ipv6_address(const char *ip_address);
   int _validate_dhcp_entry(dhcp_config *dhcp_cfg_in);
-  void _standardize_mac_address(string &mac_string);
 
   /**************** Data plane operations *********************/
   int _validate_dhcp_message(dhcp_message *dhcpmsg);
@@ -275,23 +261,23 @@ class ACA_Dhcp_Server : public aca_dhcp_programming_if::ACA_Dhcp_Programming_Int
   uint8_t _get_message_type(dhcp_message *dhcpmsg);
   uint32_t _get_server_id(dhcp_message *dhcpmsg);
   uint32_t _get_requested_ip(dhcp_message *dhcpmsg);
-  string _get_client_id(dhcp_message *dhcpmsg);
+  bool _get_client_mac_address(dhcp_message *dhcpmsg, uint64_t &mac_address);
 
   void _parse_dhcp_none(uint32_t in_port, dhcp_message *dhcpmsg);
   void _parse_dhcp_discover(uint32_t in_port, dhcp_message *dhcpmsg);
   void _parse_dhcp_request(uint32_t in_port, dhcp_message *dhcpmsg);
 
-  dhcp_message *_pack_dhcp_offer(dhcp_message *dhcpdiscover, dhcp_entry_data *pData);
-  dhcp_message *_pack_dhcp_ack(dhcp_message *dhcpreq, dhcp_entry_data *pData);
+  dhcp_message *_pack_dhcp_offer(dhcp_message *dhcpdiscover, const dhcp_entry_data *pData);
+  dhcp_message *_pack_dhcp_ack(dhcp_message *dhcpreq, const dhcp_entry_data *pData);
   dhcp_message *_pack_dhcp_nak(dhcp_message *dhcpreq);
   void _pack_dhcp_message(dhcp_message *rpl, dhcp_message *req);
   void _pack_dhcp_header(dhcp_message *dhcpmsg);
   void _pack_dhcp_opt_msgtype(uint8_t *option, uint8_t msg_type);
   void _pack_dhcp_opt_ip_lease_time(uint8_t *option, uint32_t lease);
   void _pack_dhcp_opt_server_id(uint8_t *option, uint32_t server_id);
-  void _pack_dhcp_opt_subnet_mask(uint8_t *option, string subnet_mask);
-  void _pack_dhcp_opt_router(uint8_t *option, string router_address);
-  int _pack_dhcp_opt_dns(uint8_t *option, string dns_addresses[]);
+  void _pack_dhcp_opt_subnet_mask(uint8_t *option, uint32_t subnet_mask);
+  void _pack_dhcp_opt_router(uint8_t *option, uint32_t router_address);
+  int _pack_dhcp_opt_dns(uint8_t *option, const dhcp_entry_data *pData);
 
   unsigned short check_sum(unsigned char *a, int len);
   string _serialize_dhcp_message(dhcp_message *dhcpmsg);
@@ -302,8 +288,7 @@ class ACA_Dhcp_Server : public aca_dhcp_programming_if::ACA_Dhcp_Programming_Int
   int _get_db_size() const;
 #define DHCP_DB_SIZE _get_db_size()
 
-  std::unordered_map<std::string, dhcp_entry_data> *_dhcp_db;
-  std::mutex _dhcp_db_mutex;
+  ACA_Dhcp_Entry_Store _dhcp_db;
 
   void (aca_dhcp_server::ACA_Dhcp_Server ::*_parse_dhcp_msg_ops[DHCP_MSG_MAX])(
           uint32_t in_port, dhcp_message *dhcpmsg);
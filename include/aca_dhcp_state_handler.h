@@ -17,6 +17,7 @@
 
 #include "aca_dhcp_programming_if.h"
 #include "goalstateprovisioner.grpc.pb.h"
+#include "aca_goal_state_index.h"
 
 namespace aca_dhcp_state_handler
 {
@@ -25,16 +26,18 @@ class Aca_Dhcp_State_Handler {
   static Aca_Dhcp_State_Handler &get_instance();
 
   // process ONE DHCP state
-  int update_dhcp_state_workitem(const alcor::schema::DHCPState current_DHCPState,
+  int update_dhcp_state_workitem(const alcor::schema::DHCPState &current_DHCPState,
                                  alcor::schema::GoalState &parsed_struct,
+                                 const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                  alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N DHCP states
   int update_dhcp_states(alcor::schema::GoalState &parsed_struct,
+                         const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                          alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE DHCP state
-  int update_dhcp_state_workitem_v2(const alcor::schema::DHCPState current_DHCPState,
+  int update_dhcp_state_workitem_v2(const alcor::schema::DHCPState &current_DHCPState,
                                     alcor::schema::GoalStateV2 &parsed_struct,
                                     alcor::schema::GoalStateOperationReply &gsOperationReply);
 
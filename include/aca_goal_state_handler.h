@@ -17,6 +17,7 @@
 
 #include "aca_net_programming_if.h"
 #include "goalstateprovisioner.grpc.pb.h"
+#include <vector>
 
 namespace aca_goal_state_handler
 {
@@ -25,7 +26,7 @@ class Aca_Goal_State_Handler {
   static Aca_Goal_State_Handler &get_instance();
 
   // process ONE VPC state
-  int update_vpc_state_workitem(const alcor::schema::VpcState current_VpcState,
+  int update_vpc_state_workitem(const alcor::schema::VpcState &current_VpcState,
                                 alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N VPC states
@@ -33,7 +34,7 @@ class Aca_Goal_State_Handler {
                         alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE subnet state
-  int update_subnet_state_workitem(const alcor::schema::SubnetState current_SubnetState,
+  int update_subnet_state_workitem(const alcor::schema::SubnetState &current_SubnetState,
                                    alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N subnet states
@@ -41,16 +42,18 @@ class Aca_Goal_State_Handler {
                            alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE port state
-  int update_port_state_workitem(const alcor::schema::PortState current_PortState,
+  int update_port_state_workitem(const alcor::schema::PortState &current_PortState,
                                  alcor::schema::GoalState &parsed_struct,
+                                 const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                  alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N port states
   int update_port_states(alcor::schema::GoalState &parsed_struct,
+                         const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                          alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE port state for GoalStateV2
-  int update_port_state_workitem_v2(const alcor::schema::PortState current_PortState,
+  int update_port_state_workitem_v2(const alcor::schema::PortState &current_PortState,
                                     alcor::schema::GoalStateV2 &parsed_struct,
                                     alcor::schema::GoalStateOperationReply &gsOperationReply);
 
@@ -59,16 +62,19 @@ class Aca_Goal_State_Handler {
                          alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE neighbor state
-  int update_neighbor_state_workitem(const alcor::schema::NeighborState current_NeighborState,
-                                     alcor::schema::GoalState &parsed_struct,
-                                     alcor::schema::GoalStateOperationReply &gsOperationReply);
+  int update_neighbor_state_workitem(
+          const alcor::schema::NeighborState &current_NeighborState,
+          alcor::schema::GoalState &parsed_struct,
+          const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
+          alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N neighbor states
   int update_neighbor_states(alcor::schema::GoalState &parsed_struct,
+                             const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                              alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE neighbor state for GoalStateV2
-  int update_neighbor_state_workitem_v2(const alcor::schema::NeighborState current_NeighborState,
+  int update_neighbor_state_workitem_v2(const alcor::schema::NeighborState &current_NeighborState,
                                         alcor::schema::GoalStateV2 &parsed_struct,
                                         alcor::schema::GoalStateOperationReply &gsOperationReply);
 
@@ -77,16 +83,19 @@ class Aca_Goal_State_Handler {
                              alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE router state
-  int update_router_state_workitem(const alcor::schema::RouterState current_RouterState,
-                                   alcor::schema::GoalState &parsed_struct,
-                                   alcor::schema::GoalStateOperationReply &gsOperationReply);
+  int update_router_state_workitem(
+          const alcor::schema::RouterState &current_RouterState,
+          alcor::schema::GoalState &parsed_struct,
+          const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
+          alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process 0 to N router states
   int update_router_states(alcor::schema::GoalState &parsed_struct,
+                           const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                            alcor::schema::GoalStateOperationReply &gsOperationReply);
 
   // process ONE router state for GoalStateV2
-  int update_router_state_workitem_v2(const alcor::schema::RouterState current_RouterState,
+  int update_router_state_workitem_v2(const alcor::schema::RouterState &current_RouterState,
                                       alcor::schema::GoalStateV2 &parsed_struct,
                                       alcor::schema::GoalStateOperationReply &gsOperationReply);
 
@@ -100,6 +109,48 @@ class Aca_Goal_State_Handler {
           int operation_rc, ulong culminative_dataplane_programming_time,
           ulong culminative_network_configuration_time, ulong state_elapse_time);
 
+  // mark the port and neighbor updates of a queued goal state as pending,
+  // so older updates of the same resources still waiting can be coalesced
+  void add_pending_updates(const alcor::schema::GoalState &parsed_struct);
+
+  void add_pending_updates(const alcor::schema::GoalStateV2 &parsed_struct);
+
+  // called once the goal state added by add_pending_updates is done
+  void remove_pending_updates(const alcor::schema::GoalState &parsed_struct);
+
+  void remove_pending_updates(const alcor::schema::GoalStateV2 &parsed_struct);
+
+  // true if a newer pending update supersedes this one, or a CREATE and DELETE cancelled
+  // out, the skipped operation is reported as SUCCESS with zero programming time
+  bool skip_superseded_update(alcor::schema::GoalStateOperationReply &gsOperationReply,
+                              const std::string &id, alcor::schema::ResourceType resource_type,
+                              alcor::schema::OperationType operation_type,
+                              uint32_t revision_number);
+
+  // true if the resource is already programmed at revision_number, the skipped operation
+  // is reported as SUCCESS with zero programming and elapse time, the mark of a cache hit
+  bool skip_applied_revision(alcor::schema::GoalStateOperationReply &gsOperationReply,
+                             const std::string &id, alcor::schema::ResourceType resource_type,
+                             alcor::schema::OperationType operation_type, uint32_t revision_number);
+
+  // read by the workitem before it programs the resource, handed to record_applied_revision
+  uint64_t get_revision_generation();
+
+  // remember the revision once the workitem programmed it successfully and the dataplane
+  // was not reset since revision_generation, a delete or a failed operation forgets the resource.
+  // tunnel_ids are the VPCs whose vlan teardown forgets it too
+  void record_applied_revision(const std::string &id, alcor::schema::ResourceType resource_type,
+                               alcor::schema::OperationType operation_type,
+                               uint32_t revision_number, int operation_rc,
+                               uint64_t revision_generation,
+                               const std::vector<uint32_t> &tunnel_ids = {});
+
+  // move the operation statuses collected by each workitem into gsOperationReply,
+  // called by the dispatching thread after all workitems are done
+  void merge_goal_state_operation_replies(
+          alcor::schema::GoalStateOperationReply &gsOperationReply,
+          std::vector<alcor::schema::GoalStateOperationReply> &workitem_replies);
+
   // compiler will flag error when below is called
   Aca_Goal_State_Handler(Aca_Goal_State_Handler const &) = delete;
   void operator=(Aca_Goal_State_Handler const &) = delete;
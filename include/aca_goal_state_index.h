@@ -0,0 +1,64 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_GOAL_STATE_INDEX_H
+#define ACA_GOAL_STATE_INDEX_H
+
+#include "goalstateprovisioner.grpc.pb.h"
+#include <string>
+#include <unordered_map>
+
+namespace aca_goal_state_index
+{
+// a fixed ip of a neighbor, both point into the goal state message
+struct neighbor_fixed_ip_entry {
+  const alcor::schema::NeighborConfiguration *neighbor_configuration;
+  const alcor::schema::NeighborConfiguration_FixedIp *fixed_ip;
+};
+
+/*
+  Read-only lookup tables over one GoalState (V1) message, so that workitems do not
+  scan subnet_states, vpc_states, gateway_states and neighbor_states again for every
+  port, neighbor and routing rule. All pointers point into the message, the index
+  must not outlive it.
+
+  Aca_Comm_Manager::update_goal_state builds the index once per message and passes
+  it down to the workitems.
+*/
+class ACA_Goal_State_Index {
+  public:
+  explicit ACA_Goal_State_Index(const alcor::schema::GoalState &goal_state);
+
+  // compiler will flag the error when below is called.
+  ACA_Goal_State_Index(ACA_Goal_State_Index const &) = delete;
+  void operator=(ACA_Goal_State_Index const &) = delete;
+
+  // subnet state by subnet id, an INFO state wins over other operation types
+  const alcor::schema::SubnetState *find_subnet(const std::string &subnet_id) const;
+
+  // zeta gateway of an INFO vpc state, nullptr if the VPC has none
+  const alcor::schema::GatewayConfiguration *find_zeta_gateway(const std::string &vpc_id) const;
+
+  // first neighbor fixed ip with this ip address, e.g. a routing rule's next hop
+  bool find_neighbor_fixed_ip(const std::string &ip_address,
+                              neighbor_fixed_ip_entry &found_entry) const;
+
+  private:
+  std::unordered_map<std::string, const alcor::schema::SubnetState *> _subnets;
+  std::unordered_map<std::string, const alcor::schema::GatewayConfiguration *> _vpc_zeta_gateways;
+  std::unordered_map<std::string, neighbor_fixed_ip_entry> _neighbor_fixed_ips;
+};
+
+} // namespace aca_goal_state_index
+#endif // #ifndef ACA_GOAL_STATE_INDEX_H
@@ -18,6 +18,8 @@
 #include <grpc/support/log.h>
 #include "goalstateprovisioner.grpc.pb.h"
 #include "ctpl/ctpl_stl.h"
+#include "aca_priority_lanes.h"
+#include "aca_admission_controller.h"
 
 using namespace alcor::schema;
 using grpc::Server;
@@ -62,6 +64,9 @@ class GoalStateProvisionerAsyncServer {
     CallStatus status_;
     CallType type_;
     grpc::ServerContext ctx_;
+    //  credits taken from the admission controller for the goal state being processed
+    unsigned long admittedResources_ = 0;
+    unsigned long admittedBytes_ = 0;
   };
 
   //  struct for PushNetworkResourceStates, which is a unary gRPC call
@@ -117,6 +122,16 @@ class GoalStateProvisionerAsyncServer {
   void ProcessPushNetworkResourceStatesAsyncCall(AsyncGoalStateProvionerCallBase *baseCall,
                                                  bool ok);
   void ProcessPushGoalStatesStreamAsyncCall(AsyncGoalStateProvionerCallBase *baseCall, bool ok);
+  /*
+    Program the received goal state and send the reply back,
+    these run in the priority lanes instead of the completion queue threads.
+  */
+  void HandleGoalState(PushNetworkResourceStatesAsyncCall *unaryCall);
+  void HandleGoalStateV2(PushGoalStatesStreamAsyncCall *streamingCall);
+  // hand the credits taken for the call to a guard, they go back even if programming throws
+  aca_admission_controller::ACA_Admission_Guard
+  TakeAdmission(AsyncGoalStateProvionerCallBase *baseCall);
+  void ReleaseAdmission(aca_admission_controller::ACA_Admission_Guard &admission_guard);
 
   private:
   bool keepReadingFromCq_ = true;
@@ -124,4 +139,5 @@ class GoalStateProvisionerAsyncServer {
   std::unique_ptr<ServerCompletionQueue> cq_;
   GoalStateProvisioner::AsyncService service_;
   ctpl::thread_pool thread_pool_;
+  aca_priority_lanes::ACA_Priority_Lanes priority_lanes_;
 };
@@ -13,9 +13,16 @@
 //     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/alarm.h>
 #include <grpc/support/log.h>
+#include "aca_config.h"
 #include "goalstateprovisioner.grpc.pb.h"
 
 using namespace alcor::schema;
@@ -27,20 +34,85 @@ using grpc::ServerReaderWriter;
 using grpc::ServerWriter;
 using grpc::Status;
 
+struct AsyncClientCall;
+struct HedgedHostRequest;
+
 class GoalStateProvisionerClientImpl final : public GoalStateProvisioner::Service {
   public:
   std::unique_ptr<GoalStateProvisioner::Stub> stub_;
   std::shared_ptr<grpc_impl::Channel> chan_;
+  // second channel used to hedge slow on-demand requests, only set
+  // when a hedge NCM endpoint is configured (-e)
+  std::unique_ptr<GoalStateProvisioner::Stub> hedge_stub_;
+  std::shared_ptr<grpc_impl::Channel> hedge_chan_;
   void RequestGoalStates(HostRequest *request, grpc::CompletionQueue *cq);
+  /*
+   * process one event coming out of the completion queue used by RequestGoalStates.
+   * Input:
+   *    void *tag: tag returned by cq->Next
+   *    bool ok: ok flag returned by cq->Next
+   * Return:
+   *    the finished call when it carries the first reply for its request,
+   *    the caller owns it and must delete it after processing;
+   *    nullptr when there is nothing to process (hedge timer, duplicate or failed reply)
+   */
+  AsyncClientCall *HandleAsyncEvent(void *tag, bool ok);
+  /*
+   * record the latency of an on-demand reply and recompute the hedge delay
+   * as the p95 of the latest ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE latencies,
+   * the delay stays at its default until ON_DEMAND_HEDGE_MIN_LATENCY_SAMPLES are recorded.
+   * Input:
+   *    long latency_us: time from sending the request to its first reply
+   */
+  void RecordReplyLatency(long latency_us);
+  // current delay before a slow on-demand request is hedged
+  long GetHedgeDelay();
   explicit GoalStateProvisionerClientImpl(){};
   void ConnectToNCM();
   void RunClient();
   bool a = chan_ == nullptr;
+
+  private:
+  void SendAsyncCall(std::shared_ptr<HedgedHostRequest> request, bool is_hedge);
+  void SendHedgeIfNeeded(std::shared_ptr<HedgedHostRequest> request);
+
+  // ring buffer of the latest on-demand reply latencies, used to estimate p95
+  std::mutex _latency_mutex;
+  std::vector<long> _latency_samples;
+  size_t _next_latency_sample = 0;
+  std::atomic_long _hedge_delay_us{ON_DEMAND_HEDGE_DEFAULT_DELAY_IN_MICROSECONDS};
 };
 
-struct AsyncClientCall {
+// state shared by the original on-demand request and its hedged duplicate
+struct HedgedHostRequest {
+  alcor::schema::HostRequest request;
+  grpc::CompletionQueue *cq;
+  std::chrono::system_clock::time_point deadline;
+  // set by the first reply, later replies for the same request are dropped
+  std::atomic_bool answered{false};
+  // set once a duplicate request has been sent
+  std::atomic_bool hedged{false};
+};
+
+enum AsyncClientTagType { ASYNC_CLIENT_CALL, ASYNC_CLIENT_HEDGE_ALARM };
+
+// common header of every tag put into the client completion queue
+struct AsyncClientTag {
+  AsyncClientTagType type_;
+};
+
+struct AsyncClientCall : AsyncClientTag {
   alcor::schema::HostRequestReply reply;
   grpc::ClientContext context;
   grpc::Status status;
   std::unique_ptr<grpc::ClientAsyncResponseReader<alcor::schema::HostRequestReply> > response_reader;
-};
\ No newline at end of file
+  std::shared_ptr<HedgedHostRequest> request_;
+  bool is_hedge;
+  std::chrono::_V2::steady_clock::time_point sent_time;
+};
+
+// fires after the hedge delay to send a duplicate request if no reply arrived yet
+struct AsyncClientHedgeAlarm : AsyncClientTag {
+  grpc::Alarm alarm;
+  std::shared_ptr<HedgedHostRequest> request_;
+};
@@ -0,0 +1,136 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_HOST_IP_SET_H
+#define ACA_HOST_IP_SET_H
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// slots of an empty host IP set, the set doubles when half of its slots are used
+#define HOST_IP_SET_INITIAL_SLOTS 16
+
+// receive buffer for one batch of netlink address notifications
+#define HOST_IP_MONITOR_BUFFER_SIZE 8192
+
+struct nlmsghdr;
+
+namespace aca_ovs_l2_programmer
+{
+// 16 address bytes in network byte order, an IPv4 address is kept IPv4-mapped (::ffff:a.b.c.d)
+struct host_ip_address {
+  uint64_t high;
+  uint64_t low;
+
+  bool operator==(const host_ip_address &other) const
+  {
+    return high == other.high && low == other.low;
+  }
+};
+
+/*
+  Addresses configured on the interfaces of this host.
+
+  The addresses are kept binary in an open addressed array, so checking whether a
+  neighbor's host IP is local is a hash and a couple of compares instead of a walk
+  over strings. Lookups share a reader/writer lock with the rare changes.
+
+  load_local_addresses() fills the set from getifaddrs(). start_monitor() then keeps
+  it current from the kernel's RTM_NEWADDR / RTM_DELADDR notifications. A new address
+  is added as is. A deleted one triggers a reload, because the same address can still
+  be configured on another interface.
+*/
+class ACA_Host_Ip_Set {
+  public:
+  ACA_Host_Ip_Set();
+  ~ACA_Host_Ip_Set();
+
+  // false if ip_address is neither a valid IPv4 nor IPv6 address
+  static bool parse_ip_address(const std::string &ip_address, host_ip_address &address);
+
+  // ipv4_address in network byte order
+  static host_ip_address from_ipv4(uint32_t ipv4_address);
+
+  static host_ip_address from_ipv6(const uint8_t ipv6_address[16]);
+
+  static std::string to_string(const host_ip_address &address);
+
+  bool contains(const std::string &ip_address) const;
+
+  bool contains(const host_ip_address &address) const;
+
+  // false if address is already in the set
+  bool insert(const host_ip_address &address);
+
+  // false if address is not in the set
+  bool erase(const host_ip_address &address);
+
+  void clear();
+
+  size_t size() const;
+
+  // replace the content of the set with the current addresses of this host
+  int load_local_addresses();
+
+  /*
+   * apply a buffer of netlink messages received on an RTMGRP_IPV4_IFADDR /
+   * RTMGRP_IPV6_IFADDR socket, returns the number of address messages applied
+   */
+  int apply_netlink_messages(const void *buffer, size_t length);
+
+  // subscribe to address changes, then (re)load the set and start the monitor thread
+  int start_monitor();
+
+  void stop_monitor();
+
+  // compiler will flag the error when below is called.
+  ACA_Host_Ip_Set(ACA_Host_Ip_Set const &) = delete;
+  void operator=(ACA_Host_Ip_Set const &) = delete;
+
+  private:
+  struct host_ip_slot {
+    host_ip_address address;
+    bool used;
+  };
+
+  static size_t _hash(const host_ip_address &address);
+
+  // slot holding address, or the empty slot ending its probe sequence
+  size_t _find_slot(const host_ip_address &address) const;
+
+  // insert into _slots with _set_mutex held, _slots must have room
+  bool _insert_locked(const host_ip_address &address);
+
+  void _grow_locked();
+
+  // address carried by an RTM_NEWADDR / RTM_DELADDR message, false if there is none
+  static bool _get_message_address(const struct nlmsghdr *message, host_ip_address &address);
+
+  void _monitor_loop();
+
+  std::vector<host_ip_slot> _slots;
+  size_t _entry_count;
+  mutable std::shared_timed_mutex _set_mutex;
+
+  int _netlink_socket;
+  // written by stop_monitor() to wake the monitor thread up
+  int _stop_event;
+  std::thread _monitor_thread;
+};
+} // namespace aca_ovs_l2_programmer
+#endif // #ifndef ACA_HOST_IP_SET_H
@@ -0,0 +1,120 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_ID_TABLE_H
+#define ACA_ID_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define ID_TABLE_STRIPES 16
+
+// handles are resolved back to ids through chunks of this many entries
+#define ID_TABLE_CHUNK_SIZE 4096
+#define ID_TABLE_MAX_CHUNKS 16384
+
+namespace aca_id_table
+{
+// compact stand-in for a port, subnet, router, neighbor or VPC id
+typedef uint32_t id_handle;
+
+/*
+  Interns resource ids (36 char UUID strings) into 32 bit handles, so the agent
+  tables holding many of them key and compare integers instead of strings.
+
+  Handles are reference counted: every intern() or retain() takes a reference
+  and every release() drops one. While an id has references it keeps the same
+  handle; once the last one is dropped the id is forgotten and its handle is
+  handed out again. A table holds exactly one reference per entry keyed by a
+  handle and releases it when the entry is erased or replaced. Only intern ids of
+  resources the agent programs, not per request ids.
+
+  intern(), retain(), release() and find() take a reader/writer lock on one of
+  ID_TABLE_STRIPES stripes, picked by the hash of the id. get_id() only reads an
+  array and takes no lock.
+*/
+class ACA_Id_Table {
+  public:
+  static ACA_Id_Table &get_instance();
+
+  // never returned for an interned id
+  static constexpr id_handle NO_HANDLE = 0;
+
+  // handle of id with one more reference, a new one is assigned if id has none.
+  // NO_HANDLE if all the ID_TABLE_CHUNK_SIZE * ID_TABLE_MAX_CHUNKS handles are in use
+  id_handle intern(const std::string &id);
+
+  // one more reference to a handle the caller already holds a reference to
+  void retain(id_handle handle);
+
+  // drop a reference taken by intern() or retain(), the id is forgotten with its
+  // last reference
+  void release(id_handle handle);
+
+  // handle of id without taking a reference, NO_HANDLE if id is not interned
+  id_handle find(const std::string &id) const;
+
+  // id of a handle, empty string for NO_HANDLE or a released handle.
+  // Only valid while a reference to the handle is held
+  const std::string &get_id(id_handle handle) const;
+
+  // number of ids currently interned
+  size_t size() const;
+
+  // compiler will flag the error when below is called.
+  ACA_Id_Table(ACA_Id_Table const &) = delete;
+  void operator=(ACA_Id_Table const &) = delete;
+
+  private:
+  ACA_Id_Table();
+  ~ACA_Id_Table();
+
+  struct id_entry {
+    id_handle handle = NO_HANDLE;
+    // taken under the reader lock, dropped to 0 only under the writer lock
+    std::atomic<uint64_t> reference_count{ 0 };
+  };
+
+  struct id_stripe {
+    mutable std::shared_timed_mutex stripe_mutex;
+    // keys of an unordered_map never move, get_id() points at them
+    std::unordered_map<std::string, id_entry> handles;
+  };
+
+  size_t _get_stripe_index(const std::string &id) const;
+
+  // a released handle, or a never used one
+  id_handle _allocate_handle();
+
+  // make get_id(handle) return *id, nullptr makes it return an empty string
+  void _store_id(id_handle handle, const std::string *id);
+
+  id_stripe _stripes[ID_TABLE_STRIPES];
+
+  std::atomic<std::atomic<const std::string *> *> _chunks[ID_TABLE_MAX_CHUNKS];
+
+  std::atomic<id_handle> _next_handle;
+
+  std::mutex _free_handles_mutex;
+  std::vector<id_handle> _free_handles;
+
+  std::atomic<size_t> _id_count;
+};
+} // namespace aca_id_table
+#endif // #ifndef ACA_ID_TABLE_H
@@ -0,0 +1,145 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_JOURNAL_H
+#define ACA_JOURNAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace aca_journal
+{
+/*
+  Append-only write-ahead journal of goal states, used to rebuild the in-memory tables
+  after a restart without waiting for a full resync from the controller.
+
+  The journal file is preallocated and memory-mapped. Each record is a small header
+  (magic, payload length, crc32 of the payload) followed by the payload. append()
+  copies the record into the mapping and returns, a flusher thread msyncs everything
+  copied so far in one go (group commit). A journal that fills up between two
+  snapshots is doubled in size instead of refusing the record.
+
+  replay() walks the records from the start and stops at the first one that is torn
+  or fails its checksum, later appends go right after the last good record.
+*/
+class ACA_Journal {
+  public:
+  static ACA_Journal &get_instance();
+
+  /*
+   * map the journal file, create it if needed, and start the flusher thread.
+   * Input:
+   *    const std::string &file_path: journal file
+   *    size_t capacity: initial size of the preallocated file, in bytes
+   * Return:
+   *    EXIT_SUCCESS, -EINVAL if already open, or -errno of the failed system call
+   */
+  int open(const std::string &file_path, size_t capacity);
+
+  void close();
+
+  bool is_open();
+
+  /*
+   * append one record, the flusher thread writes it to disk shortly after.
+   * Return:
+   *    EXIT_SUCCESS, -EINVAL if the journal is not open,
+   *    or -errno of a failed attempt to grow a full journal
+   */
+  int append(const void *payload, size_t payload_length);
+
+  /*
+   * wait until every record appended so far is on disk.
+   * Return:
+   *    EXIT_SUCCESS, -EINVAL if the journal is not open, or -errno of a failed msync
+   */
+  int flush();
+
+  /*
+   * call on_record for every good record in order, appends made by on_record are
+   * dropped since they would journal the same goal state again.
+   * Return:
+   *    number of records replayed, or -EINVAL if the journal is not open
+   */
+  long replay(const std::function<void(const char *payload, size_t payload_length)> &on_record);
+
+  // drop all the records
+  int reset();
+
+  /*
+   * drop the records before offset, e.g. once they are covered by a snapshot.
+   * The records after it are written to a new file that replaces the journal,
+   * nothing changes unless EXIT_SUCCESS is returned.
+   * Return:
+   *    EXIT_SUCCESS, -EINVAL if the journal is not open or offset is past its end,
+   *    or -errno of the failed system call
+   */
+  int discard_before(size_t offset);
+
+  // bytes used by the records
+  size_t size();
+
+  size_t capacity();
+
+  // compiler will flag the error when below is called.
+  ACA_Journal(ACA_Journal const &) = delete;
+  void operator=(ACA_Journal const &) = delete;
+
+  private:
+  ACA_Journal(){};
+  ~ACA_Journal();
+
+  struct record_header {
+    uint32_t magic;
+    uint32_t payload_length;
+    uint32_t payload_crc;
+  };
+
+  // must be called with _journal_mutex held
+  size_t find_tail();
+
+  // make room for at least min_capacity bytes, called with _journal_mutex held by lock
+  int grow(std::unique_lock<std::mutex> &lock, size_t min_capacity);
+
+  // body of the flusher thread, runs from open() to close()
+  void flush_records();
+
+  std::mutex _journal_mutex;
+  // signaled when records are appended or the journal is closing
+  std::condition_variable _appended_cv;
+  std::condition_variable _flushed_cv;
+  std::thread _flusher_thread;
+  bool _closing = false;
+  // errno of the last failed msync, 0 once a flush succeeds again
+  int _flush_errno = 0;
+  int _fd = -1;
+  std::string _file_path;
+  char *_mapping = nullptr;
+  size_t _capacity = 0;
+  // end of the last record copied into the mapping
+  size_t _tail = 0;
+  // end of the last record known to be on disk
+  size_t _flushed = 0;
+  bool _flushing = false;
+  bool _replaying = false;
+};
+
+uint32_t aca_crc32(const void *data, size_t length);
+
+} // namespace aca_journal
+#endif // #ifndef ACA_JOURNAL_H
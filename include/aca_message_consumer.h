@@ -17,6 +17,7 @@
 
 #include "cppkafka/consumer.h"
 #include "cppkafka/configuration.h"
+#include "aca_reply_publisher.h"
 
 using cppkafka::Configuration;
 using cppkafka::Consumer;
@@ -36,6 +37,8 @@ class MessageConsumer {
 
   Consumer *ptr_consumer; //A pointer to the Kafka consumer
 
+  aca_reply_publisher::ACA_Reply_Publisher *reply_publisher = nullptr; //Replies are dropped when not set
+
   public:
   MessageConsumer(string brokers, string group_id);
 
@@ -49,6 +52,9 @@ class MessageConsumer {
 
   void setGroupId(string group_id);
 
+  // send the reply of every consumed goal state back to the controller
+  void setReplyPublisher(aca_reply_publisher::ACA_Reply_Publisher *reply_publisher);
+
   bool consumeDispatched(string topic);
 
   private:
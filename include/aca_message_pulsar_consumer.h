@@ -20,6 +20,7 @@
 #include "pulsar/ConsumerConfiguration.h"
 #include "pulsar/Message.h"
 #include "pulsar/Result.h"
+#include "aca_reply_publisher.h"
 
 
 using namespace pulsar;
@@ -39,6 +40,8 @@ class ACA_Message_Pulsar_Consumer {
 
     Client *ptr_client; //A pointer to the pulsar client
 
+    aca_reply_publisher::ACA_Reply_Publisher *reply_publisher = nullptr; //Replies are dropped when not set
+
   public:
     ACA_Message_Pulsar_Consumer(string brokers, string subscription_name);
 
@@ -52,9 +55,18 @@ class ACA_Message_Pulsar_Consumer {
 
     void setSubscriptionName(string subscription_name);
 
+    // send the reply of every consumed goal state back to the controller
+    void setReplyPublisher(aca_reply_publisher::ACA_Reply_Publisher *reply_publisher);
+
+    // consume goal states with PULSAR_CONSUMER_WORKERS consumers on a Key_Shared
+    // subscription, blocks until one of them fails to receive, then stops the
+    // others and returns the rc of the first one that stopped
     bool consumeDispatched(string topic);
 
   private:
+    // receive, program and acknowledge batches of goal states on one consumer
+    int consumeBatches(Consumer &consumer, string topic);
+
     void setBrokers(string brokers);
 
     void setLastTopicName(string topic);
@@ -21,6 +21,7 @@
 #include "pulsar/Message.h"
 #include "pulsar/MessageBuilder.h"
 #include "pulsar/Result.h"
+#include <vector>
 
 using namespace std;
 using namespace pulsar;
@@ -35,8 +36,14 @@ class ACA_Message_Pulsar_Producer {
 
   ClientConfiguration client_config; //Configuration of the pulsar client
 
+  ProducerConfiguration producer_config; //Configuration of the pulsar producer, LZ4 compressed
+
   Client *ptr_client; //A pointer to the pulsar client
 
+  Producer producer; //Created by the first publish and reused after that
+
+  bool producer_created = false;
+
   public:
   ACA_Message_Pulsar_Producer(string brokers, string topic);
 
@@ -48,9 +55,16 @@ class ACA_Message_Pulsar_Producer {
 
   void setTopicName(string topic);
 
-  bool publish(string message);
+  // send message and wait for the broker, returns EXIT_SUCCESS or EXIT_FAILURE
+  int publish(string message);
+
+  // send every entry of messages as its own message, batched by the producer into
+  // as few broker requests as possible, returns EXIT_SUCCESS or EXIT_FAILURE
+  int publishBatch(const vector<string> &messages);
 
   private:
+  int createProducerIfNeeded();
+
   void setBrokers(string brokers);
 };
 
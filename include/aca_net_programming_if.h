@@ -16,6 +16,7 @@
 #define ACA_NET_PROGRAMMING_IF_H
 
 #include "goalstateprovisioner.grpc.pb.h"
+#include "aca_goal_state_index.h"
 
 // Core Network Programming Interface class
 namespace aca_net_programming_if
@@ -26,40 +27,43 @@ class ACA_Core_Net_Programming_Interface {
   virtual int initialize() = 0;
 
   virtual int
-  update_vpc_state_workitem(const alcor::schema::VpcState current_VpcState,
+  update_vpc_state_workitem(const alcor::schema::VpcState &current_VpcState,
                             alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_subnet_state_workitem(const alcor::schema::SubnetState current_SubnetState,
+  update_subnet_state_workitem(const alcor::schema::SubnetState &current_SubnetState,
                                alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_port_state_workitem(const alcor::schema::PortState current_PortState,
+  update_port_state_workitem(const alcor::schema::PortState &current_PortState,
                              alcor::schema::GoalState &parsed_struct,
+                             const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                              alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_port_state_workitem(const alcor::schema::PortState current_PortState,
+  update_port_state_workitem(const alcor::schema::PortState &current_PortState,
                              alcor::schema::GoalStateV2 &parsed_struct,
                              alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_neighbor_state_workitem(const alcor::schema::NeighborState current_NeighborState,
+  update_neighbor_state_workitem(const alcor::schema::NeighborState &current_NeighborState,
                                  alcor::schema::GoalState &parsed_struct,
+                                 const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                  alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_neighbor_state_workitem(const alcor::schema::NeighborState current_NeighborState,
+  update_neighbor_state_workitem(const alcor::schema::NeighborState &current_NeighborState,
                                  alcor::schema::GoalStateV2 &parsed_struct,
                                  alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_router_state_workitem(const alcor::schema::RouterState current_RouterState,
+  update_router_state_workitem(const alcor::schema::RouterState &current_RouterState,
                                alcor::schema::GoalState &parsed_struct,
+                               const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 
   virtual int
-  update_router_state_workitem(const alcor::schema::RouterState current_RouterState,
+  update_router_state_workitem(const alcor::schema::RouterState &current_RouterState,
                                alcor::schema::GoalStateV2 &parsed_struct,
                                alcor::schema::GoalStateOperationReply &gsOperationReply) = 0;
 };
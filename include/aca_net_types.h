@@ -0,0 +1,163 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_NET_TYPES_H
+#define ACA_NET_TYPES_H
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <arpa/inet.h>
+
+#define MAC_ADDRESS_LENGTH 6
+
+namespace aca_net_types
+{
+/*
+  Address value types parsed once when a goal state is read and then handed
+  to the programmers and kept in their tables, instead of the text forms being
+  validated and converted again at every step. Both are plain bytes, cheap to
+  copy and usable as hash keys.
+*/
+
+// IPv4 address in network byte order, 0.0.0.0 also stands for unset
+struct ipv4_addr {
+  uint32_t value;
+
+  // false if text is not a dotted quad IPv4 address
+  static bool parse(const std::string &text, ipv4_addr &address)
+  {
+    return inet_pton(AF_INET, text.c_str(), &address.value) == 1;
+  }
+
+  std::string to_string() const
+  {
+    char text[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &value, text, sizeof(text));
+    return std::string(text);
+  }
+
+  bool is_unset() const
+  {
+    return value == 0;
+  }
+
+  bool operator==(const ipv4_addr &other) const
+  {
+    return value == other.value;
+  }
+
+  bool operator!=(const ipv4_addr &other) const
+  {
+    return value != other.value;
+  }
+};
+
+struct mac_addr {
+  uint8_t bytes[MAC_ADDRESS_LENGTH];
+
+  // false if text is not 6 hex bytes separated by ':' or '-', as aca_validate_mac_address
+  static bool parse(const std::string &text, mac_addr &address)
+  {
+    const char *cursor = text.c_str();
+    char separator = 0;
+
+    for (int i = 0; i < MAC_ADDRESS_LENGTH; i++) {
+      if (i > 0) {
+        if (separator == 0 && (*cursor == ':' || *cursor == '-')) {
+          separator = *cursor;
+        }
+        if (*cursor != separator) {
+          return false;
+        }
+        cursor++;
+      }
+
+      int byte_value = 0;
+      int digit_count = 0;
+      for (; digit_count < 2 && isxdigit((unsigned char)*cursor); digit_count++, cursor++) {
+        byte_value = byte_value << 4 | hex_digit_value(*cursor);
+      }
+      if (digit_count == 0) {
+        return false;
+      }
+      address.bytes[i] = (uint8_t)byte_value;
+    }
+    return *cursor == '\0';
+  }
+
+  // lower case, ':' separated, as ovs-ofctl prints it
+  std::string to_string() const
+  {
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string text(MAC_ADDRESS_LENGTH * 3 - 1, ':');
+
+    for (int i = 0; i < MAC_ADDRESS_LENGTH; i++) {
+      text[i * 3] = hex_digits[bytes[i] >> 4];
+      text[i * 3 + 1] = hex_digits[bytes[i] & 0x0f];
+    }
+    return text;
+  }
+
+  // the 6 bytes in the low 48 bits, first byte highest
+  uint64_t to_u64() const
+  {
+    uint64_t packed = 0;
+    for (int i = 0; i < MAC_ADDRESS_LENGTH; i++) {
+      packed = packed << 8 | bytes[i];
+    }
+    return packed;
+  }
+
+  bool operator==(const mac_addr &other) const
+  {
+    return memcmp(bytes, other.bytes, MAC_ADDRESS_LENGTH) == 0;
+  }
+
+  bool operator!=(const mac_addr &other) const
+  {
+    return !(*this == other);
+  }
+
+  private:
+  static int hex_digit_value(char digit)
+  {
+    return (digit <= '9') ? digit - '0' : (digit | 0x20) - 'a' + 10;
+  }
+};
+
+static_assert(std::is_trivially_copyable<ipv4_addr>::value, "ipv4_addr is copied as bytes");
+static_assert(std::is_trivially_copyable<mac_addr>::value, "mac_addr is copied as bytes");
+} // namespace aca_net_types
+
+namespace std
+{
+template <> struct hash<aca_net_types::ipv4_addr> {
+  size_t operator()(const aca_net_types::ipv4_addr &address) const
+  {
+    return hash<uint32_t>{}(address.value);
+  }
+};
+
+template <> struct hash<aca_net_types::mac_addr> {
+  size_t operator()(const aca_net_types::mac_addr &address) const
+  {
+    return hash<uint64_t>{}(address.to_u64());
+  }
+};
+} // namespace std
+#endif // #ifndef ACA_NET_TYPES_H
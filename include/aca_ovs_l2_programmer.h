@@ -16,6 +16,9 @@
 #define ACA_OVS_L2_PROGRAMMER_H
 
 #include "goalstateprovisioner.grpc.pb.h"
+#include "aca_host_ip_set.h"
+#include "aca_net_types.h"
+#include <atomic>
 #include <string>
 
 #define PRIORITY_HIGH 50
@@ -29,14 +32,19 @@ class ACA_OVS_L2_Programmer {
   public:
   static ACA_OVS_L2_Programmer &get_instance();
 
-  std::vector<std::string> host_ips_vector;
-
+  // load the addresses of this host and keep following their changes
   void get_local_host_ips();
 
   bool is_ip_on_the_same_host(const std::string hosting_port_ip);
 
+  bool is_ip_on_the_same_host(const aca_net_types::ipv4_addr hosting_port_ip);
+
   int setup_ovs_bridges_if_need();
 
+  // true once setup_ovs_bridges_if_need had to create br-int and br-tun,
+  // a snapshot taken before then describes flows that are gone
+  bool is_bridges_created();
+
   int create_port(const std::string vpc_id, const std::string port_name,
                   const std::string virtual_ip, const std::string virtual_mac,
                   uint tunnel_id, ulong &culminative_time);
@@ -64,6 +72,10 @@ class ACA_OVS_L2_Programmer {
   private:
   ACA_OVS_L2_Programmer(){};
   ~ACA_OVS_L2_Programmer(){};
+
+  ACA_Host_Ip_Set _host_ips;
+
+  std::atomic<bool> _bridges_created{ false };
 };
 } // namespace aca_ovs_l2_programmer
 #endif // #ifndef ACA_OVS_L2_PROGRAMMER_H
\ No newline at end of file
@@ -16,17 +16,25 @@
 #define ACA_OVS_L3_PROGRAMMER_H
 
 #include "goalstateprovisioner.grpc.pb.h"
+#include "aca_goal_state_index.h"
+#include "aca_snapshot.h"
+#include "aca_id_table.h"
+#include "aca_net_types.h"
 #include <unordered_map>
+#include <shared_mutex>
 #include <string>
 
 using namespace std;
 using namespace alcor::schema;
+using aca_id_table::id_handle;
+using aca_net_types::ipv4_addr;
+using aca_net_types::mac_addr;
 
 // port id is stored as the key to ports table
 struct neighbor_port_table_entry {
-  string virtual_ip;
-  string virtual_mac;
-  string host_ip;
+  ipv4_addr virtual_ip;
+  mac_addr virtual_mac;
+  ipv4_addr host_ip;
 };
 
 // routing rule id is stored as the key to routing_rules table
@@ -38,9 +46,11 @@ struct routing_rule_entry {
   uint priority;
 };
 
+// ids are interned by aca_id_table, the tables below are keyed by their handles
+
 // subnet id is stored as the key to subnet_routing_table
 struct subnet_routing_table_entry {
-  string vpc_id;
+  id_handle vpc_id = aca_id_table::ACA_Id_Table::NO_HANDLE;
   alcor::schema::NetworkType network_type;
   string cidr;
   uint tunnel_id;
@@ -48,10 +58,10 @@ struct subnet_routing_table_entry {
   string gateway_mac;
   // list of neighbor ports within the subnet
   // hashtable <key: neighbor ID, value: neighbor_port_table_entry>
-  unordered_map<string, neighbor_port_table_entry> neighbor_ports;
+  unordered_map<id_handle, neighbor_port_table_entry> neighbor_ports;
   // list of routing rules for this subnet
   // hashtable <key: routing rule ID, value: routing_rule_entry>
-  unordered_map<string, routing_rule_entry> routing_rules;
+  unordered_map<id_handle, routing_rule_entry> routing_rules;
 };
 
 // OVS L3 programmer implementation class
@@ -63,25 +73,32 @@ class ACA_OVS_L3_Programmer {
 
   void clear_all_data();
 
-  int create_or_update_router(RouterConfiguration &current_RouterConfiguration,
+  int create_or_update_router(const RouterConfiguration &current_RouterConfiguration,
                               GoalState &parsed_struct,
+                              const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                               ulong &culminative_time_dataplane_programming_time);
 
-  int create_or_update_router(RouterConfiguration &current_RouterConfiguration,
+  int create_or_update_router(const RouterConfiguration &current_RouterConfiguration,
                               GoalStateV2 &parsed_struct,
                               ulong &culminative_time_dataplane_programming_time);
 
-  int delete_router(RouterConfiguration &current_RouterConfiguration,
+  int delete_router(const RouterConfiguration &current_RouterConfiguration,
                     ulong &culminative_time_dataplane_programming_time);
 
   int create_or_update_l3_neighbor(const string neighbor_id, const string vpc_id,
-                                   const string subnet_id, const string virtual_ip,
-                                   const string virtual_mac,
-                                   const string remote_host_ip, uint tunnel_id,
+                                   const string subnet_id, const ipv4_addr virtual_ip,
+                                   const mac_addr virtual_mac,
+                                   const ipv4_addr remote_host_ip, uint tunnel_id,
                                    ulong &culminative_time_dataplane_programming_time);
 
   int delete_l3_neighbor(const string neighbor_id, const string subnet_id,
-                         const string virtual_ip, ulong &culminative_time);
+                         const ipv4_addr virtual_ip, ulong &culminative_time);
+
+  // write the routers table, called while no goal state is being programmed
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // rebuild the routers table at startup, -EINVAL if the snapshot data is damaged
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
 
   // compiler will flag the error when below is called.
   ACA_OVS_L3_Programmer(ACA_OVS_L3_Programmer const &) = delete;
@@ -94,11 +111,36 @@ class ACA_OVS_L3_Programmer {
   string _host_dvr_mac;
 
   // hashtable <key: router IDs, value: hashtable <key: subnet IDs, value: subnet_routing_table_entry> >
-  unordered_map<string, unordered_map<string, subnet_routing_table_entry> > _routers_table;
-
-  // mutex for reading and writing to routers_table
-  // consider using a read / write lock to improve performance
-  mutex _routers_table_mutex;
+  unordered_map<id_handle, unordered_map<id_handle, subnet_routing_table_entry> > _routers_table;
+
+  // hashtable <key: subnet ID, value: ID of the router connected to the subnet GW>
+  // a subnet GW is connected to one router, kept in step with _routers_table
+  unordered_map<id_handle, id_handle> _subnet_router_index;
+
+  // shared for reading routers_table and subnet_router_index, exclusive for changing them
+  std::shared_timed_mutex _routers_table_mutex;
+
+  // below are called with _routers_table_mutex held, exclusive for the (un)index ones
+  void _index_router_subnets(id_handle router_handle);
+  void _unindex_router_subnets(id_handle router_handle);
+  // subnet tables of the router connected to the subnet, nullptr if there is none
+  unordered_map<id_handle, subnet_routing_table_entry> *
+  _find_router_subnets(id_handle subnet_handle, id_handle &router_handle);
+  // every entry of a router's subnet tables holds one reference to each handle it is
+  // keyed by or names (subnet, vpc, neighbor, routing rule): take the ones of entries
+  // only in new_subnets and release the ones of entries only in old_subnets, all of
+  // old_subnets for nullptr
+  void _move_table_references(
+          const unordered_map<id_handle, subnet_routing_table_entry> &old_subnets,
+          const unordered_map<id_handle, subnet_routing_table_entry> *new_subnets);
+  // drop from new_subnets, copied from the router's tables, the neighbors deleted since
+  void _drop_deleted_neighbors(id_handle router_handle,
+                               unordered_map<id_handle, subnet_routing_table_entry> &new_subnets);
+  // add or replace the router's subnet tables, the router entry holds a reference too
+  void _store_router_subnets(id_handle router_handle,
+                             unordered_map<id_handle, subnet_routing_table_entry> &new_subnets);
+  // false if the router is not in the table
+  bool _erase_router(id_handle router_handle);
 };
 } // namespace aca_ovs_l3_programmer
 #endif // #ifndef ACA_OVS_L3_PROGRAMMER_H
\ No newline at end of file
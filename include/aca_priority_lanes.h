@@ -0,0 +1,88 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_PRIORITY_LANES_H
+#define ACA_PRIORITY_LANES_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aca_priority_lanes
+{
+/*
+  Two-lane task scheduler.
+
+  Small goal states (e.g. pushed by NCM because of an on-demand request) go to the
+  high priority lane, bulk goal states go to the bulk lane. Some workers are reserved
+  for the high priority lane and never pick up bulk work, so a first packet does not
+  wait behind a bulk resync. The other workers prefer high priority tasks, but take a
+  bulk task after GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY high priority tasks
+  in a row, or when the oldest bulk task has waited longer than
+  GRPC_PRIORITY_LANES_BULK_MAX_WAIT_IN_MICROSECONDS, so bulk work cannot starve.
+*/
+class ACA_Priority_Lanes {
+  public:
+  enum Lane { HIGH_PRIORITY_LANE, BULK_LANE };
+
+  ACA_Priority_Lanes();
+  ~ACA_Priority_Lanes();
+
+  /*
+   * start the workers.
+   * Input:
+   *    int worker_count: total number of workers, at least 1
+   *    int reserved_high_priority_workers: workers only serving the high priority lane,
+   *                                        capped to worker_count - 1
+   */
+  void start(int worker_count, int reserved_high_priority_workers);
+
+  // finish the queued tasks and join all workers
+  void stop();
+
+  void push(Lane lane, std::function<void()> task);
+
+  // number of tasks waiting in the lane
+  size_t queue_depth(Lane lane);
+
+  // compiler will flag the error when below is called.
+  ACA_Priority_Lanes(ACA_Priority_Lanes const &) = delete;
+  void operator=(ACA_Priority_Lanes const &) = delete;
+
+  private:
+  struct lane_task {
+    std::function<void()> task;
+    std::chrono::_V2::steady_clock::time_point enqueue_time;
+  };
+
+  void worker_loop(bool high_priority_only);
+  // must be called with _lanes_mutex held
+  bool pick_task(bool high_priority_only, lane_task &picked_task);
+
+  std::mutex _lanes_mutex;
+  // reserved workers wait on _high_priority_cv, shared workers on _shared_cv
+  std::condition_variable _high_priority_cv;
+  std::condition_variable _shared_cv;
+  std::deque<lane_task> _high_priority_queue;
+  std::deque<lane_task> _bulk_queue;
+  std::vector<std::thread> _workers;
+  uint _consecutive_high_priority_tasks;
+  bool _stopping;
+};
+} // namespace aca_priority_lanes
+#endif // #ifndef ACA_PRIORITY_LANES_H
@@ -0,0 +1,92 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_REPLY_PUBLISHER_H
+#define ACA_REPLY_PUBLISHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aca_reply_publisher
+{
+/*
+  Sends goal state replies back to the controller over the message bus without
+  holding up the consumer that programmed the goal state.
+
+  publish() only queues the serialized GoalStateOperationReply. A background thread
+  hands the queued replies to send_batch once REPLY_PUBLISHER_MAX_BATCH_BYTES are
+  waiting or the oldest one has waited REPLY_PUBLISHER_LINGER_IN_MICROSECONDS.
+  Every reply of a batch is sent as its own message, concatenated replies would be
+  parsed as one merged GoalStateOperationReply. Packing the messages into broker
+  requests and compressing them is left to the producer (batching and LZ4 on pulsar).
+
+  When the bus is slower than the replies come in and REPLY_PUBLISHER_MAX_PENDING_BYTES
+  are queued, new replies are dropped instead of blocking the consumer.
+*/
+class ACA_Reply_Publisher {
+  public:
+  // send_batch is called on the background thread with the serialized replies to
+  // send, one message each, returns EXIT_SUCCESS on success
+  ACA_Reply_Publisher(std::function<int(const std::vector<std::string> &)> send_batch,
+                      size_t max_batch_bytes, size_t max_pending_bytes,
+                      std::chrono::microseconds linger);
+  ~ACA_Reply_Publisher();
+
+  /*
+   * queue a serialized GoalStateOperationReply, never blocks.
+   * Return:
+   *    EXIT_SUCCESS, -ENOBUFS if too many replies are waiting,
+   *    -ESHUTDOWN after close()
+   */
+  int publish(std::string serialized_reply);
+
+  // send the replies still queued and stop the background thread
+  void close();
+
+  unsigned long get_published_batch_count();
+
+  unsigned long get_dropped_count();
+
+  // compiler will flag the error when below is called.
+  ACA_Reply_Publisher(ACA_Reply_Publisher const &) = delete;
+  void operator=(ACA_Reply_Publisher const &) = delete;
+
+  private:
+  void run();
+
+  std::function<int(const std::vector<std::string> &)> _send_batch;
+  size_t _max_batch_bytes;
+  size_t _max_pending_bytes;
+  std::chrono::microseconds _linger;
+
+  std::mutex _queue_mutex;
+  std::condition_variable _queue_cv;
+  std::deque<std::string> _pending_replies;
+  size_t _pending_bytes;
+  // when the oldest pending reply was queued
+  std::chrono::steady_clock::time_point _oldest_pending_time;
+  bool _closing;
+  unsigned long _published_batch_count;
+  unsigned long _dropped_count;
+
+  std::thread _publisher_thread;
+};
+} // namespace aca_reply_publisher
+#endif // #ifndef ACA_REPLY_PUBLISHER_H
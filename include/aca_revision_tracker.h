@@ -0,0 +1,126 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_REVISION_TRACKER_H
+#define ACA_REVISION_TRACKER_H
+
+#include "aca_snapshot.h"
+#include "aca_id_table.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aca_revision_tracker
+{
+/*
+  Remembers the last revision_number successfully applied for each resource, so a
+  controller retry or a full resync carrying an unchanged resource is answered
+  without going to ovs-vsctl/ovs-ofctl again.
+
+  Resources are keyed by (resource type, interned resource id) packed in 64 bits, the
+  table is striped by the key so workitems of one goal state rarely contend on the
+  same lock. Every entry holds a reference to its id handle until it is forgotten.
+  A revision of 0 means the sender did not set one and is never treated as applied.
+
+  Whatever resets the dataplane (clear_all_data, re-creating br-int/br-tun) must call
+  clear(), a recorded revision is only as good as the flows and ports behind it. For
+  the same reason a neighbor or router is recorded with the VPCs (tunnel ids) whose
+  vlan its flows match, and forget_tunnel() drops it when one of those vlans is torn
+  down.
+  clear() also starts a new generation, a workitem that started programming before
+  the reset cannot record its revision afterwards.
+*/
+class ACA_Revision_Tracker {
+  public:
+  static ACA_Revision_Tracker &get_instance();
+
+  // true if revision_number or a newer revision is already applied for the resource,
+  // also counts the call as a cache hit
+  bool is_applied(int resource_type, const std::string &resource_id, uint32_t revision_number);
+
+  // generation to pass to record_applied, read before programming the resource
+  uint64_t get_generation();
+
+  /*
+   * remember revision_number as applied, an older revision never replaces a newer one.
+   * Nothing is recorded if clear() was called since generation was read.
+   * tunnel_ids are the VPCs whose vlan the flows of the resource match.
+   */
+  void record_applied(int resource_type, const std::string &resource_id,
+                      uint32_t revision_number, uint64_t generation,
+                      const std::vector<uint32_t> &tunnel_ids = {});
+
+  // drop the resource, the next revision for it is always applied
+  void forget(int resource_type, const std::string &resource_id);
+
+  // drop every resource recorded with tunnel_id, its vlan and the flows matching
+  // it are gone. Returns how many were dropped
+  size_t forget_tunnel(uint32_t tunnel_id);
+
+  // 0 if nothing is recorded for the resource
+  uint32_t get_applied_revision(int resource_type, const std::string &resource_id);
+
+  size_t size();
+
+  unsigned long cache_hit_count();
+
+  // forget every resource and start a new generation
+  void clear();
+
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // EXIT_SUCCESS, or -EINVAL if the snapshot data is damaged
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
+
+  // compiler will flag the error when below is called.
+  ACA_Revision_Tracker(ACA_Revision_Tracker const &) = delete;
+  void operator=(ACA_Revision_Tracker const &) = delete;
+
+  private:
+  ACA_Revision_Tracker(){};
+  ~ACA_Revision_Tracker(){};
+
+  struct applied_revision {
+    uint32_t revision_number = 0;
+    std::vector<uint32_t> tunnel_ids;
+  };
+
+  struct revision_stripe {
+    std::mutex stripe_mutex;
+    std::unordered_map<uint64_t, applied_revision> applied_revisions;
+  };
+
+  revision_stripe &get_stripe(uint64_t key);
+
+  static uint64_t make_key(int resource_type, aca_id_table::id_handle resource_handle);
+
+  // key of a resource never interned, nothing is recorded for it
+  static const uint64_t NO_KEY = 0;
+
+  // NO_KEY if the resource id was never interned
+  static uint64_t find_key(int resource_type, const std::string &resource_id);
+
+  static const int STRIPE_COUNT = 64;
+
+  revision_stripe _stripes[STRIPE_COUNT];
+
+  std::atomic<unsigned long> _cache_hits{ 0 };
+
+  std::atomic<uint64_t> _generation{ 0 };
+};
+} // namespace aca_revision_tracker
+#endif // #ifndef ACA_REVISION_TRACKER_H
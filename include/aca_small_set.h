@@ -0,0 +1,125 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_SMALL_SET_H
+#define ACA_SMALL_SET_H
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+  Set for a handful of values, e.g. the ports of a VPC on this host.
+
+  The first INLINE_CAPACITY values are stored in the object itself, more go to a
+  vector that is only allocated once the inline slots are full. Lookups are a
+  linear scan, which beats hashing at these sizes, and size() doubles as the
+  reference count of the owner. Not thread safe, the owner serializes access.
+*/
+template <class T, size_t INLINE_CAPACITY> class ACA_Small_Set {
+  public:
+  // returns false if value is already in the set
+  bool insert(const T &value)
+  {
+    if (contains(value)) {
+      return false;
+    }
+
+    if (_size < INLINE_CAPACITY) {
+      _inline_values[_size] = value;
+    } else {
+      _overflow_values.push_back(value);
+    }
+    _size++;
+    return true;
+  }
+
+  // returns false if value is not in the set
+  bool erase(const T &value)
+  {
+    for (size_t i = 0; i < _size; i++) {
+      if (at(i) == value) {
+        // the last value takes the place of the erased one
+        size_t last = _size - 1;
+        if (i != last) {
+          at(i) = std::move(at(last));
+        }
+        if (last < INLINE_CAPACITY) {
+          _inline_values[last] = T();
+        } else {
+          _overflow_values.pop_back();
+        }
+        _size--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool contains(const T &value) const
+  {
+    for (size_t i = 0; i < _size; i++) {
+      if (at(i) == value) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < _size && i < INLINE_CAPACITY; i++) {
+      _inline_values[i] = T();
+    }
+    _overflow_values.clear();
+    _overflow_values.shrink_to_fit();
+    _size = 0;
+  }
+
+  template <class Function> void for_each(Function function) const
+  {
+    for (size_t i = 0; i < _size; i++) {
+      function(at(i));
+    }
+  }
+
+  private:
+  T &at(size_t index)
+  {
+    return index < INLINE_CAPACITY ? _inline_values[index] :
+                                     _overflow_values[index - INLINE_CAPACITY];
+  }
+
+  const T &at(size_t index) const
+  {
+    return index < INLINE_CAPACITY ? _inline_values[index] :
+                                     _overflow_values[index - INLINE_CAPACITY];
+  }
+
+  std::array<T, INLINE_CAPACITY> _inline_values;
+  std::vector<T> _overflow_values;
+  size_t _size = 0;
+};
+#endif // #ifndef ACA_SMALL_SET_H
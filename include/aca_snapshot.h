@@ -0,0 +1,116 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_SNAPSHOT_H
+#define ACA_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+namespace aca_snapshot
+{
+/*
+  Compact binary snapshot of the in-memory dataplane tables.
+
+  Every table writes its entries into one ACA_Snapshot_Writer, in a fixed order,
+  and reads them back from an ACA_Snapshot_Reader in the same order at startup.
+  Numbers are stored in host byte order and strings as a 32 bit length followed by
+  the bytes, the file is only read back by the agent on the same host.
+
+  The snapshot file is a header (magic, format version, data length, crc32) followed
+  by the data. It is written to a temporary file, read back, then renamed, so a crash
+  while writing leaves the previous snapshot in place, and loaded with mmap. The
+  snapshot it replaces is kept at get_previous_path() in case the new one is damaged
+  later on.
+*/
+class ACA_Snapshot_Writer {
+  public:
+  void put_u8(uint8_t value);
+  void put_u16(uint16_t value);
+  void put_u32(uint32_t value);
+  void put_u64(uint64_t value);
+  void put_string(const std::string &value);
+  // raw bytes without a length, e.g. entries collected by another writer
+  void put_bytes(const std::string &value);
+
+  const std::string &get_data() const;
+
+  private:
+  std::string _data;
+};
+
+// every get_* returns false once the data is exhausted, and keeps returning false
+class ACA_Snapshot_Reader {
+  public:
+  ACA_Snapshot_Reader(const char *data, size_t length);
+
+  bool get_u8(uint8_t &value);
+  bool get_u16(uint16_t &value);
+  bool get_u32(uint32_t &value);
+  bool get_u64(uint64_t &value);
+  bool get_string(std::string &value);
+
+  // false once a get_* ran out of data
+  bool is_good() const;
+
+  bool is_at_end() const;
+
+  private:
+  bool get_bytes(void *value, size_t length);
+
+  const char *_data;
+  size_t _length;
+  size_t _offset;
+  bool _good;
+};
+
+class ACA_Snapshot_File {
+  public:
+  ACA_Snapshot_File(){};
+  ~ACA_Snapshot_File();
+
+  /*
+   * write data as the new snapshot file_path, the current one is moved to
+   * get_previous_path(file_path) once the new one reads back correctly.
+   * Return:
+   *    EXIT_SUCCESS, -EIO if the new snapshot does not read back,
+   *    or -errno of the failed system call
+   */
+  static int write(const std::string &file_path, const std::string &data);
+
+  // where write() keeps the snapshot it replaced
+  static std::string get_previous_path(const std::string &file_path);
+
+  /*
+   * map the snapshot file_path and check its header and checksum.
+   * Return:
+   *    EXIT_SUCCESS, -ENOENT if there is no snapshot, -EINVAL if it is damaged,
+   *    or -errno of the failed system call
+   */
+  int load(const std::string &file_path);
+
+  // data of the loaded snapshot, valid until this object is destroyed
+  ACA_Snapshot_Reader get_reader() const;
+
+  size_t size() const;
+
+  ACA_Snapshot_File(ACA_Snapshot_File const &) = delete;
+  void operator=(ACA_Snapshot_File const &) = delete;
+
+  private:
+  char *_mapping = nullptr;
+  size_t _mapping_length = 0;
+};
+} // namespace aca_snapshot
+#endif // #ifndef ACA_SNAPSHOT_H
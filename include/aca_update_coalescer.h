@@ -0,0 +1,118 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_UPDATE_COALESCER_H
+#define ACA_UPDATE_COALESCER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace aca_update_coalescer
+{
+/*
+  Coalesces superseded resource updates waiting in the ingest queue.
+
+  Every goal state adds its resources as pending when it is queued and removes them
+  once it is programmed. A workitem about to program a resource asks decide() first:
+    - a CREATE with a newer CREATE or DELETE of the resource pending, or programmed
+      while this one waited: skip it, only the final state gets programmed
+    - a DELETE with a newer DELETE pending: skip it, the newer one removes the same
+    - a DELETE with a newer CREATE pending is applied, the CREATE does not remove
+      what the old revision programmed. Unless that CREATE already started or a newer
+      revision is applied: the priority lanes let a small CREATE overtake an older
+      bulk DELETE, which would then remove the re-created resource
+    - a CREATE superseded by a DELETE of a resource never programmed before cancels
+      out with that DELETE, both are skipped
+  Only CREATE and DELETE are full replacements of the resource, callers must not add
+  or ask about an UPDATE (a port UPDATE may turn into a CREATE, a DELETE or nothing),
+  so an UPDATE is always applied and never supersedes anything.
+  Resources are keyed by (resource type, resource id) and ordered by revision_number,
+  a revision of 0 is never coalesced. Resources nobody added as pending are applied.
+*/
+class ACA_Update_Coalescer {
+  public:
+  enum Operation { CREATE_OPERATION, DELETE_OPERATION };
+
+  enum Decision { APPLY, SKIP_SUPERSEDED, SKIP_CANCELLED };
+
+  static ACA_Update_Coalescer &get_instance();
+
+  // called when the goal state carrying the update is queued
+  void add_pending(int resource_type, const std::string &resource_id,
+                   uint32_t revision_number, Operation operation);
+
+  // called once the goal state carrying the update is done
+  void remove_pending(int resource_type, const std::string &resource_id, uint32_t revision_number);
+
+  /*
+   * decide whether the update should be programmed.
+   * Input:
+   *    uint32_t applied_revision: revision the resource is currently programmed at on
+   *                               this host, 0 if it is not programmed
+   */
+  Decision decide(int resource_type, const std::string &resource_id,
+                  uint32_t revision_number, Operation operation, uint32_t applied_revision);
+
+  // number of resources with pending updates
+  size_t size();
+
+  // number of updates skipped by decide()
+  unsigned long coalesced_count();
+
+  // forget every pending resource when the dataplane is reset, the updates still
+  // queued are then applied as they come
+  void clear();
+
+  // compiler will flag the error when below is called.
+  ACA_Update_Coalescer(ACA_Update_Coalescer const &) = delete;
+  void operator=(ACA_Update_Coalescer const &) = delete;
+
+  private:
+  ACA_Update_Coalescer(){};
+  ~ACA_Update_Coalescer(){};
+
+  struct pending_resource {
+    // revision -> number of queued goal states carrying it
+    std::map<uint32_t, int> pending_revisions;
+    // newest revision added while the resource has pending revisions, the entry is
+    // erased with its last pending revision
+    uint32_t newest_revision = 0;
+    Operation newest_operation = CREATE_OPERATION;
+    // a CREATE was skipped in favor of the newest DELETE
+    bool create_cancelled = false;
+    // newest CREATE decide() let through, an older DELETE must not run after it
+    uint32_t started_create_revision = 0;
+  };
+
+  struct coalescer_stripe {
+    std::mutex stripe_mutex;
+    std::unordered_map<std::string, pending_resource> pending_resources;
+  };
+
+  coalescer_stripe &get_stripe(const std::string &key);
+
+  static std::string make_key(int resource_type, const std::string &resource_id);
+
+  static const int STRIPE_COUNT = 64;
+
+  coalescer_stripe _stripes[STRIPE_COUNT];
+
+  std::atomic<unsigned long> _coalesced_updates{ 0 };
+};
+} // namespace aca_update_coalescer
+#endif // #ifndef ACA_UPDATE_COALESCER_H
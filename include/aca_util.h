@@ -17,6 +17,7 @@
 
 #include "aca_net_config.h"
 #include "aca_log.h"
+#include "aca_net_types.h"
 #include "goalstateprovisioner.grpc.pb.h"
 #include <string>
 #include <arpa/inet.h>
@@ -125,20 +126,14 @@ static inline bool aca_validate_fixed_ips_size(const int fixed_ips_size)
 
 static inline bool aca_validate_mac_address(const char *mac_string)
 {
-  unsigned char mac[6];
+  aca_net_types::mac_addr mac;
 
   if (mac_string == nullptr) {
     ACA_LOG_ERROR("%s", "Input mac_string is null\n");
     return false;
   }
 
-  if (sscanf(mac_string, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &mac[0], &mac[1],
-             &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
-    return true;
-  }
-
-  if (sscanf(mac_string, "%hhx-%hhx-%hhx-%hhx-%hhx-%hhx", &mac[0], &mac[1],
-             &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
+  if (aca_net_types::mac_addr::parse(mac_string, mac)) {
     return true;
   }
 
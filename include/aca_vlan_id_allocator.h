@@ -0,0 +1,72 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_VLAN_ID_ALLOCATOR_H
+#define ACA_VLAN_ID_ALLOCATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <sys/types.h>
+
+// internal vlan ids are 12 bits, 0 and 4095 are reserved
+#define VLAN_ID_COUNT 4096
+
+namespace aca_vlan_manager
+{
+/*
+  Allocator of the internal vlan ids used by the VPCs on this host.
+
+  One bit per vlan id, kept in atomic 64 bit words, so allocate/release never
+  take a lock. allocate() is next-fit: it picks the first free id at or after the
+  one handed out last, wrapping around, so an id freed by a VPC teardown is only
+  reused once the others are taken. That leaves time for the flows of the old
+  VPC to be gone before the id shows up again on a new one.
+*/
+class ACA_Vlan_Id_Allocator {
+  public:
+  ACA_Vlan_Id_Allocator();
+
+  // returns a free vlan id, or 0 if all of them are in use
+  uint allocate();
+
+  // take a given vlan id, e.g. restored from a snapshot. Returns false if it is
+  // already taken or reserved
+  bool reserve(uint vlan_id);
+
+  // give back a vlan id returned by allocate or reserve
+  void release(uint vlan_id);
+
+  void clear();
+
+  // number of vlan ids in use
+  uint get_allocated_count();
+
+  // where allocate() starts looking, saved in snapshots so that a restarted agent
+  // hands out the same ids
+  uint get_next_vlan_id();
+  void set_next_vlan_id(uint vlan_id);
+
+  // compiler will flag the error when below is called.
+  ACA_Vlan_Id_Allocator(ACA_Vlan_Id_Allocator const &) = delete;
+  void operator=(ACA_Vlan_Id_Allocator const &) = delete;
+
+  private:
+  static const uint BITS_PER_WORD = 64;
+  static const uint WORD_COUNT = VLAN_ID_COUNT / BITS_PER_WORD;
+
+  std::atomic<uint64_t> _allocated_bits[WORD_COUNT];
+  std::atomic_uint _next_vlan_id;
+};
+} // namespace aca_vlan_manager
+#endif // #ifndef ACA_VLAN_ID_ALLOCATOR_H
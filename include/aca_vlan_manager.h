@@ -17,26 +17,32 @@
 
 #include "goalstateprovisioner.grpc.pb.h"
 #include "hashmap/HashMap.h"
+#include "aca_snapshot.h"
+#include "aca_vlan_id_allocator.h"
+#include "aca_small_set.h"
 #include <string>
 #include <list>
 #include <unordered_map>
+#include <memory>
 #include <mutex>
 #include <atomic>
 
 using namespace std;
 
-// TODO: implement a better available internal vlan ids
-static atomic_uint current_available_vlan_id(1);
+// number of ovs_ports of a VPC stored without a separate allocation
+#define VPC_OVS_PORTS_INLINE_CAPACITY 4
 
 // Vlan Manager class
 namespace aca_vlan_manager
 {
 struct vpc_table_entry {
+  // set when the entry is created and never changed, so it can be read
+  // without going through the VPC's shard
   uint vlan_id;
 
-  // list of ovs_ports names on this host in the same VPC to share the same internal vlan_id
-  // CTSL::HashMap <key: ovs_port name, value: int* (not used)>
-  CTSL::HashMap<string, int *> ovs_ports;
+  // list of ovs_ports names on this host in the same VPC to share the same internal vlan_id,
+  // a VPC rarely has more than a few ports on one host. The entry is gone with its last port
+  ACA_Small_Set<string, VPC_OVS_PORTS_INLINE_CAPACITY> ovs_ports;
 
   string zeta_gateway_id;
 };
@@ -67,8 +73,16 @@ class ACA_Vlan_Manager {
 
   bool is_exist_zeta_gateway(const string auxGateway_id);
 
+  // lock free, used on the on-demand packet path. Returns 0 if vlan_id is not in use
   uint get_tunnelId_by_vlanId(uint vlan_id);
 
+  // write the VPC table, called while no goal state is being programmed
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // rebuild the VPC table at startup, -EINVAL if the snapshot data is damaged
+  // or gives the same vlan id to two VPCs
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
+
   // compiler will flag error when below is called
   ACA_Vlan_Manager(ACA_Vlan_Manager const &) = delete;
   void operator=(ACA_Vlan_Manager const &) = delete;
@@ -78,10 +92,23 @@ class ACA_Vlan_Manager {
   ~ACA_Vlan_Manager(){};
 
   // CTSL::HashMap <key: tunnel ID, value: vpc_table_entry>
-  CTSL::HashMap<uint, vpc_table_entry *> _vpcs_table;
-  // mutex for reading and writing to _vpcs_table
-  mutex _vpcs_table_mutex;
-  void create_entry(uint tunnel_id);
+  // an entry is only created, changed or erased on the ACA_Vpc_Serial_Executor
+  // shard owning its tunnel ID, the openflow commands are issued by the caller
+  // once the shard operation returns, so a slow ovs-ofctl call does not hold up
+  // the other VPCs on the same shard
+  CTSL::HashMap<uint, std::shared_ptr<vpc_table_entry> > _vpcs_table;
+
+  // internal vlan ids of the VPCs, given back when a VPC's last port is deleted
+  ACA_Vlan_Id_Allocator _vlan_id_allocator;
+
+  // reverse index of _vpcs_table, tunnel ID by internal vlan ID, 0 if not in use
+  std::atomic_uint _tunnel_ids_by_vlan_id[VLAN_ID_COUNT] = {};
+
+  std::shared_ptr<vpc_table_entry> create_entry(uint tunnel_id);
+  void set_tunnel_id_by_vlan_id(uint vlan_id, uint tunnel_id);
+  // table 4 rule stamping the VPC's incoming vxlan traffic with its internal vlan
+  void add_incoming_vxlan_rule(uint tunnel_id, uint internal_vlan_id, ulong &culminative_time,
+                               int &overall_rc);
 };
 } // namespace aca_vlan_manager
 #endif // #ifndef ACA_VLAN_MANAGER_H
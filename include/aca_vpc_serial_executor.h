@@ -0,0 +1,73 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_VPC_SERIAL_EXECUTOR_H
+#define ACA_VPC_SERIAL_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aca_vpc_serial_executor
+{
+/*
+  Serializes the operations on a VPC without locks. Every tunnel id maps to one
+  shard, each shard is a single thread running its queue in FIFO order, so two
+  operations on the same VPC never overlap while different VPCs run in parallel.
+
+  execute() blocks the caller until its operation is done, calling it again from
+  inside an operation on the same shard runs the nested operation inline.
+*/
+class ACA_Vpc_Serial_Executor {
+  public:
+  static ACA_Vpc_Serial_Executor &get_instance();
+
+  /*
+   * run operation on the shard owning tunnel_id and wait for it.
+   * Return:
+   *    the rc of operation, exceptions thrown by operation are rethrown to the caller
+   */
+  int execute(uint tunnel_id, const std::function<int()> &operation);
+
+  // true if the calling thread is the shard thread owning tunnel_id
+  bool is_on_shard(uint tunnel_id);
+
+  int shard_count();
+
+  // compiler will flag the error when below is called.
+  ACA_Vpc_Serial_Executor(ACA_Vpc_Serial_Executor const &) = delete;
+  void operator=(ACA_Vpc_Serial_Executor const &) = delete;
+
+  private:
+  ACA_Vpc_Serial_Executor();
+  ~ACA_Vpc_Serial_Executor();
+
+  struct executor_shard {
+    std::mutex shard_mutex;
+    std::condition_variable shard_cv;
+    std::deque<std::function<void()> > operations;
+    std::thread shard_thread;
+    bool stopping = false;
+  };
+
+  void shard_loop(int shard_index);
+
+  std::vector<std::unique_ptr<executor_shard> > _shards;
+};
+} // namespace aca_vpc_serial_executor
+#endif // #ifndef ACA_VPC_SERIAL_EXECUTOR_H
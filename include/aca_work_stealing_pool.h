@@ -0,0 +1,121 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef ACA_WORK_STEALING_POOL_H
+#define ACA_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aca_work_stealing_pool
+{
+// one-shot countdown, std::latch is c++20
+class aca_latch {
+  public:
+  explicit aca_latch(size_t count) : _count(count)
+  {
+  }
+
+  void count_down()
+  {
+    std::lock_guard<std::mutex> latch_lock(_latch_mutex);
+    if (_count > 0 && --_count == 0) {
+      _latch_cv.notify_all();
+    }
+  }
+
+  bool try_wait()
+  {
+    std::lock_guard<std::mutex> latch_lock(_latch_mutex);
+    return _count == 0;
+  }
+
+  void wait()
+  {
+    std::unique_lock<std::mutex> latch_lock(_latch_mutex);
+    _latch_cv.wait(latch_lock, [this] { return _count == 0; });
+  }
+
+  private:
+  size_t _count;
+  std::mutex _latch_mutex;
+  std::condition_variable _latch_cv;
+};
+
+/*
+  Process-wide work-stealing thread pool used to fan out goal state workitems.
+
+  Each worker owns a deque, it runs its own tasks from the back and steals from the
+  front of the other deques when it runs dry. Tasks submitted from outside of the pool
+  are spread over the deques round-robin. The thread calling parallel_for also runs
+  the tasks of its own call while it waits, so nested parallel_for calls from a worker
+  cannot deadlock, and a call with a single task runs it right on the caller.
+*/
+class ACA_Work_Stealing_Pool {
+  public:
+  static ACA_Work_Stealing_Pool &get_instance();
+
+  /*
+   * run fn(i) for every i in [0, count) on the pool and wait for all of them.
+   * Input:
+   *    size_t count: number of items
+   *    size_t chunk_size: items per task, 0 to pick one based on the pool size
+   *    fn: called once per item, from any thread
+   * The first exception thrown by fn is rethrown after all items are done.
+   */
+  void parallel_for(size_t count, size_t chunk_size, const std::function<void(size_t)> &fn);
+
+  int size();
+
+  // compiler will flag the error when below is called.
+  ACA_Work_Stealing_Pool(ACA_Work_Stealing_Pool const &) = delete;
+  void operator=(ACA_Work_Stealing_Pool const &) = delete;
+
+  private:
+  ACA_Work_Stealing_Pool();
+  ~ACA_Work_Stealing_Pool();
+
+  struct pool_task {
+    std::function<void()> run;
+    // parallel_for call the task belongs to
+    const void *batch;
+  };
+
+  struct worker_queue {
+    std::mutex queue_mutex;
+    std::deque<pool_task> tasks;
+  };
+
+  void submit(std::function<void()> task, const void *batch);
+  // run one queued task, own deque first, then steal; false if there was nothing to run
+  // batch: only run a task of this parallel_for call, nullptr for any task
+  bool try_run_one(const void *batch = nullptr);
+  void worker_loop(int worker_index);
+
+  std::vector<std::unique_ptr<worker_queue> > _queues;
+  std::vector<std::thread> _workers;
+  std::atomic_size_t _pending_tasks;
+  std::atomic_size_t _next_queue;
+  std::mutex _sleep_mutex;
+  std::condition_variable _sleep_cv;
+  bool _stopping;
+};
+} // namespace aca_work_stealing_pool
+#endif // #ifndef ACA_WORK_STEALING_POOL_H
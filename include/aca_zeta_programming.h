@@ -20,6 +20,7 @@
 #include <atomic>
 #include "goalstateprovisioner.grpc.pb.h"
 #include "hashmap/HashMap.h"
+#include "aca_snapshot.h"
 
 using namespace std;
 
@@ -81,10 +82,10 @@ class ACA_Zeta_Programming {
 
   void clear_all_data();
 
-  int create_zeta_config(const alcor::schema::GatewayConfiguration current_AuxGateway,
+  int create_zeta_config(const alcor::schema::GatewayConfiguration &current_AuxGateway,
                          uint tunnel_id);
 
-  int delete_zeta_config(const alcor::schema::GatewayConfiguration current_AuxGateway,
+  int delete_zeta_config(const alcor::schema::GatewayConfiguration &current_AuxGateway,
                          uint tunnel_id);
 
   bool group_rule_exists(uint group_id);
@@ -95,6 +96,12 @@ class ACA_Zeta_Programming {
 
   bool group_rule_info_correct(uint group_id, string gws_ip, string gws_mac);
 
+  // write the zeta config table, called while no goal state is being programmed
+  void snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer);
+
+  // rebuild the zeta config table at startup, -EINVAL if the snapshot data is damaged
+  int restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader);
+
   private:
   int _create_group_punt_rule(uint tunnel_id, uint group_id);
   int _delete_group_punt_rule(uint tunnel_id);
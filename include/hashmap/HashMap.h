@@ -24,33 +24,44 @@
 #ifndef HASH_MAP_H_
 #define HASH_MAP_H_
 
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <vector>
 #include "HashNode.h"
 
-constexpr size_t HASH_SIZE_DEFAULT = 1031; // A prime number as hash size gives a better distribution of values in buckets
+constexpr size_t HASH_STRIPES_DEFAULT = 16; // Number of independently locked and resized stripes
+constexpr size_t HASH_STRIPE_INITIAL_BUCKETS = 4; // Buckets of a stripe before its first resize
+constexpr size_t HASH_MAX_LOAD_FACTOR = 1; // A stripe doubles its buckets above this many entries per bucket
 namespace CTSL //Concurrent Thread Safe Library
 {
 //The class represting the hash map.
 //It is expected for user defined types, the hash function will be provided.
 //By default, the std::hash function will be used
-//If the hash size is not provided, then a defult size of 1031 will be used
-//The hash table itself consists of an array of hash buckets.
-//Each hash bucket is implemented as singly linked list with the head as a dummy node created
-//during the creation of the bucket. All the hash buckets are created during the construction of the map.
-//Locks are taken per bucket, hence multiple threads can write simultaneously in different buckets in the hash map
+//The hash map is split into a fixed number of stripes (16 by default, rounded up to a power of 2),
+//a key always goes to the stripe picked by its hash. Each stripe has its own lock and its own
+//array of buckets, and each bucket is implemented as singly linked list.
+//Locks are taken per stripe, hence multiple threads can write simultaneously in different stripes,
+//and many threads can read the same stripe simultaneously.
+//A stripe doubles its bucket array when it gets too full, only that stripe is locked while its
+//entries are moved, so the map grows a stripe at a time and chains stay short at any size.
+//Values are owned by the map: erase() and clear() delete them when V is a raw pointer, other
+//value types (e.g. std::shared_ptr) are simply destroyed with their node.
 template <typename K, typename V, typename F = std::hash<K> > class HashMap {
   public:
-  HashMap(size_t hashSize_ = HASH_SIZE_DEFAULT) : hashSize(hashSize_)
+  HashMap(size_t stripeCount_ = HASH_STRIPES_DEFAULT) : stripeCount(roundUpToPowerOf2(stripeCount_))
   {
-    hashTable = new HashBucket<K, V>[hashSize]; //create the hash table as an array of hash buckets
+    stripes = new HashStripe[stripeCount]; //create the stripes, each with a few empty buckets
   }
 
   ~HashMap()
   {
-    delete[] hashTable;
+    clear();
+    delete[] stripes;
   }
   //Copy and Move of the HashMap are not supported at this moment
   HashMap(const HashMap &) = delete;
@@ -63,57 +74,204 @@ template <typename K, typename V, typename F = std::hash<K> > class HashMap {
   //If key is not found, function returns false.
   bool find(const K &key, V &value) const
   {
-    size_t hashValue = hashFn(key) % hashSize;
-    return hashTable[hashValue].find(key, value);
+    size_t hashValue = hash(key);
+    HashStripe &stripe = getStripe(hashValue);
+    // A shared mutex is used to enable mutiple concurrent reads
+    std::shared_lock<std::shared_timed_mutex> lock(stripe.mutex_);
+
+    for (HashNode<K, V> *node = stripe.buckets[getBucketIndex(stripe, hashValue)];
+         node != nullptr; node = node->next) {
+      if (node->getKey() == key) {
+        value = node->getValue();
+        return true;
+      }
+    }
+    return false;
   }
 
   //Function to insert into the hash map.
   //If key already exists, update the value, else insert a new node in the bucket with the <key, value> pair.
   void insert(const K &key, const V &value)
   {
-    size_t hashValue = hashFn(key) % hashSize;
-    hashTable[hashValue].insert(key, value);
+    size_t hashValue = hash(key);
+    HashStripe &stripe = getStripe(hashValue);
+    //Exclusive lock to enable single write in the stripe
+    std::unique_lock<std::shared_timed_mutex> lock(stripe.mutex_);
+    HashNode<K, V> *&bucket = stripe.buckets[getBucketIndex(stripe, hashValue)];
+
+    for (HashNode<K, V> *node = bucket; node != nullptr; node = node->next) {
+      if (node->getKey() == key) {
+        node->setValue(value); //Key found in bucket, update the value
+        return;
+      }
+    }
+
+    //New entry, create a node and add to the front of the bucket
+    HashNode<K, V> *node = new HashNode<K, V>(key, value);
+    node->next = bucket;
+    bucket = node;
+    stripe.count++;
+    entryCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (stripe.count > stripe.buckets.size() * HASH_MAX_LOAD_FACTOR) {
+      rehash(stripe);
+    }
   }
 
-  //Function to remove an entry from the bucket, if found
+  //Function to remove an entry from the hash map, if found
   void erase(const K &key)
   {
-    size_t hashValue = hashFn(key) % hashSize;
-    hashTable[hashValue].erase(key);
+    size_t hashValue = hash(key);
+    HashStripe &stripe = getStripe(hashValue);
+    //Exclusive lock to enable single write in the stripe
+    std::unique_lock<std::shared_timed_mutex> lock(stripe.mutex_);
+    HashNode<K, V> **link = &stripe.buckets[getBucketIndex(stripe, hashValue)];
+
+    while (*link != nullptr && (*link)->getKey() != key) {
+      link = &(*link)->next;
+    }
+
+    if (nullptr == *link) //Key not found, nothing to be done
+    {
+      return;
+    }
+
+    //Remove the node from the bucket and free up the memory
+    HashNode<K, V> *node = *link;
+    *link = node->next;
+    freeValue(node->getValue());
+    delete node;
+    stripe.count--;
+    entryCount.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  //Number of entries, kept up to date by insert/erase instead of counting them
+  size_t size() const
+  {
+    return entryCount.load(std::memory_order_relaxed);
   }
 
   //Function to see if the whole hashtable is empty.
   bool empty() const
   {
-    for (size_t i = 0; i < hashSize; i++) {
-      auto hash_node = (hashTable[i]).head;
-      if (hash_node == nullptr) {
-        // no entry for this hashtable bucket, go look at the next bucket
-        continue;
-      } else {
-        // found an entry in this hashtable bucket,
-        // return false since the hashtable is not emply
-        return false;
-      }
-    }
-
-    // went through the whole table and didn't find any hashtable bucket
-    // return true since the hashtable is emply
-    return true;
+    return size() == 0;
   }
 
   //Function to clean up the hasp map, i.e., remove all entries from it
   void clear()
   {
-    for (size_t i = 0; i < hashSize; i++) {
-      (hashTable[i]).clear();
+    for (size_t i = 0; i < stripeCount; i++) {
+      HashStripe &stripe = stripes[i];
+      std::unique_lock<std::shared_timed_mutex> lock(stripe.mutex_);
+
+      for (HashNode<K, V> *&bucket : stripe.buckets) {
+        HashNode<K, V> *node = bucket;
+        while (node != nullptr) {
+          HashNode<K, V> *next = node->next;
+          //Free up the memory
+          freeValue(node->getValue());
+          delete node;
+          node = next;
+        }
+      }
+      stripe.buckets.assign(HASH_STRIPE_INITIAL_BUCKETS, nullptr);
+      stripe.buckets.shrink_to_fit();
+      entryCount.fetch_sub(stripe.count, std::memory_order_relaxed);
+      stripe.count = 0;
     }
   }
 
-  HashBucket<K, V> *hashTable;
-  const size_t hashSize;
+  //Function to visit every entry, function(key, value) is called with the entry's stripe
+  //locked for reading: it can read the map but must not insert, erase or clear.
+  //Entries inserted or erased in other stripes during the walk may or may not be visited
+  template <typename Function> void for_each(Function function) const
+  {
+    for (size_t i = 0; i < stripeCount; i++) {
+      HashStripe &stripe = stripes[i];
+      std::shared_lock<std::shared_timed_mutex> lock(stripe.mutex_);
+
+      for (HashNode<K, V> *bucket : stripe.buckets) {
+        for (HashNode<K, V> *node = bucket; node != nullptr; node = node->next) {
+          function(node->getKey(), node->getValue());
+        }
+      }
+    }
+  }
 
   private:
+  struct HashStripe {
+    HashStripe() : buckets(HASH_STRIPE_INITIAL_BUCKETS, nullptr), count(0)
+    {
+    }
+
+    mutable std::shared_timed_mutex mutex_; //The mutex for this stripe
+    std::vector<HashNode<K, V> *> buckets; //Heads of the bucket lists, a power of 2 of them
+    size_t count; //Number of entries in this stripe
+  };
+
+  static size_t roundUpToPowerOf2(size_t value)
+  {
+    size_t power = 1;
+    while (power < value) {
+      power <<= 1;
+    }
+    return power;
+  }
+
+  static void freeValue(const V &value)
+  {
+    if constexpr (std::is_pointer<V>::value) {
+      delete value;
+    } else {
+      (void)value;
+    }
+  }
+
+  //Mix the user hash, std::hash of an integer is the integer itself and both the stripe
+  //and the bucket are picked from its bits
+  size_t hash(const K &key) const
+  {
+    uint64_t hashValue = hashFn(key);
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xff51afd7ed558ccdULL;
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xc4ceb9fe1a85ec53ULL;
+    hashValue ^= hashValue >> 33;
+    return hashValue;
+  }
+
+  HashStripe &getStripe(size_t hashValue) const
+  {
+    return stripes[hashValue & (stripeCount - 1)];
+  }
+
+  size_t getBucketIndex(const HashStripe &stripe, size_t hashValue) const
+  {
+    return (hashValue / stripeCount) & (stripe.buckets.size() - 1);
+  }
+
+  //Double the buckets of a stripe, called with the stripe locked for writing
+  void rehash(HashStripe &stripe)
+  {
+    std::vector<HashNode<K, V> *> oldBuckets(stripe.buckets.size() * 2, nullptr);
+    oldBuckets.swap(stripe.buckets);
+
+    for (HashNode<K, V> *bucket : oldBuckets) {
+      HashNode<K, V> *node = bucket;
+      while (node != nullptr) {
+        HashNode<K, V> *next = node->next;
+        HashNode<K, V> *&newBucket =
+                stripe.buckets[getBucketIndex(stripe, hash(node->getKey()))];
+        node->next = newBucket;
+        newBucket = node;
+        node = next;
+      }
+    }
+  }
+
+  const size_t stripeCount;
+  HashStripe *stripes;
+  std::atomic<size_t> entryCount{ 0 };
   F hashFn;
 };
 } // namespace CTSL
@@ -14,20 +14,33 @@
 
 #include "aca_log.h"
 #include "aca_util.h"
+#include "aca_config.h"
 #include "aca_ovs_control.h"
 #include "aca_message_pulsar_consumer.h"
+#include "aca_message_pulsar_producer.h"
+#include "aca_reply_publisher.h"
 #include "aca_grpc.h"
 #include "aca_grpc_client.h"
 #include "aca_ovs_l2_programmer.h"
 #include "aca_ovs_control.h"
+#include "aca_admission_controller.h"
+#include "aca_comm_mgr.h"
+#include "aca_journal.h"
 #include "goalstateprovisioner.grpc.pb.h"
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <unistd.h> /* for getopt */
 #include <grpcpp/grpcpp.h>
 #include <cmath>
 
 using aca_message_pulsar::ACA_Message_Pulsar_Consumer;
+using aca_message_pulsar::ACA_Message_Pulsar_Producer;
+using aca_reply_publisher::ACA_Reply_Publisher;
 using aca_ovs_control::ACA_OVS_Control;
+using aca_admission_controller::ACA_Admission_Controller;
+using aca_comm_manager::Aca_Comm_Manager;
+using aca_journal::ACA_Journal;
 using std::string;
 
 // Defines
@@ -47,17 +60,35 @@ std::thread *g_grpc_server_thread = NULL;
 std::thread *g_grpc_client_thread = NULL;
 std::thread *ovs_monitor_brtun_thread = NULL;
 std::thread *ovs_monitor_brint_thread = NULL;
+std::thread *g_snapshot_thread = NULL;
 GoalStateProvisionerAsyncServer *g_grpc_server = NULL;
 GoalStateProvisionerClientImpl *g_grpc_client = NULL;
+ACA_Message_Pulsar_Producer *g_reply_producer = NULL;
+ACA_Reply_Publisher *g_reply_publisher = NULL;
 string g_broker_list = EMPTY_STRING;
 string g_pulsar_topic = EMPTY_STRING;
 string g_pulsar_subsription_name = EMPTY_STRING;
+// optional pulsar topic to send goal state replies to
+string g_pulsar_reply_topic = EMPTY_STRING;
 string g_grpc_server_port = EMPTY_STRING;
 string g_ofctl_command = EMPTY_STRING;
 string g_ofctl_target = EMPTY_STRING;
 string g_ofctl_options = EMPTY_STRING;
 string g_ncm_address = EMPTY_STRING;
 string g_ncm_port = EMPTY_STRING;
+// optional second NCM endpoint (ip:port) to hedge slow on-demand requests
+string g_ncm_hedge_address = EMPTY_STRING;
+// optional journal of applied goal states, replayed at startup
+string g_journal_path = EMPTY_STRING;
+// snapshot of the in-memory tables next to the journal, keeps the journal short
+string g_snapshot_path = EMPTY_STRING;
+// set by aca_cleanup to wake the snapshot thread up and have it exit
+static std::mutex g_snapshot_mutex;
+static std::condition_variable g_snapshot_cv;
+static bool g_snapshot_stopping = false;
+// admission control budget for goal states in flight, 0 means unlimited
+unsigned long g_admission_max_resources = ADMISSION_MAX_IN_FLIGHT_RESOURCES;
+unsigned long g_admission_max_bytes = ADMISSION_MAX_IN_FLIGHT_BYTES;
 
 // total time for execute_system_command in microseconds
 std::atomic_ulong g_total_execute_system_time(0);
@@ -103,6 +134,12 @@ static void aca_cleanup()
   ACA_LOG_DEBUG("g_total_update_GS_time = %lu microseconds or %lu milliseconds\n",
                 g_total_update_GS_time.load(), us_to_ms(g_total_update_GS_time.load()));
 
+  ACA_LOG_INFO("admission queue depth = %lu, max queue depth = %lu, goal states deferred = %lu, goal states rejected = %lu\n",
+               ACA_Admission_Controller::get_instance().get_queue_depth(),
+               ACA_Admission_Controller::get_instance().get_max_queue_depth(),
+               ACA_Admission_Controller::get_instance().get_deferred_count(),
+               ACA_Admission_Controller::get_instance().get_rejected_count());
+
   ACA_LOG_INFO("%s", "Program exiting, cleaning up...\n");
 
   // Optional: Delete all global objects allocated by libprotobuf.
@@ -121,6 +158,42 @@ static void aca_cleanup()
     ACA_LOG_ERROR("%s", "Unable to call delete, grpc server pointer is null.\n");
   }
 
+  // the snapshot thread compacts the journal, stop it before the journal is closed
+  if (g_snapshot_thread != NULL) {
+    {
+      std::lock_guard<std::mutex> snapshot_lock(g_snapshot_mutex);
+      g_snapshot_stopping = true;
+    }
+    g_snapshot_cv.notify_all();
+    if (g_snapshot_thread->joinable()) {
+      g_snapshot_thread->join();
+    }
+    delete g_snapshot_thread;
+    g_snapshot_thread = NULL;
+    ACA_LOG_INFO("%s", "Cleaned up snapshot thread.\n");
+  }
+
+  // no more goal states after the server is down, flush and unmap the journal
+  ACA_Journal::get_instance().close();
+
+  // send the replies still queued, the pulsar consumer may still hold the publisher
+  // so it is only closed here
+  if (g_reply_publisher != NULL) {
+    g_reply_publisher->close();
+    ACA_LOG_INFO("Closed reply publisher, %lu batches published, %lu replies dropped\n",
+                 g_reply_publisher->get_published_batch_count(),
+                 g_reply_publisher->get_dropped_count());
+    delete g_reply_publisher;
+    g_reply_publisher = NULL;
+  }
+
+  // only used by the reply publisher, which is gone now
+  if (g_reply_producer != NULL) {
+    delete g_reply_producer;
+    g_reply_producer = NULL;
+    ACA_LOG_INFO("%s", "Cleaned up reply producer.\n");
+  }
+
   if (g_grpc_server_thread != NULL) {
     delete g_grpc_server_thread;
     g_grpc_server_thread = NULL;
@@ -148,6 +221,34 @@ static void aca_cleanup()
   ACA_LOG_CLOSE();
 }
 
+// snapshot the in-memory tables every SNAPSHOT_INTERVAL_IN_SECONDS, or sooner
+// when the journal is half full, the journal only keeps what came after
+static void aca_snapshot_periodically()
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  auto last_snapshot_time = chrono::steady_clock::now();
+
+  while (journal.is_open()) {
+    {
+      std::unique_lock<std::mutex> snapshot_lock(g_snapshot_mutex);
+      if (g_snapshot_cv.wait_for(snapshot_lock, chrono::seconds(1),
+                                 [] { return g_snapshot_stopping; })) {
+        break;
+      }
+    }
+
+    auto seconds_since_snapshot =
+            chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - last_snapshot_time)
+                    .count();
+
+    if ((seconds_since_snapshot >= SNAPSHOT_INTERVAL_IN_SECONDS && journal.size() > 0) ||
+        journal.size() > journal.capacity() / 2) {
+      Aca_Comm_Manager::get_instance().take_snapshot(g_snapshot_path);
+      last_snapshot_time = chrono::steady_clock::now();
+    }
+  }
+}
+
 // function to handle ctrl-c and kill process
 static void aca_signal_handler(int sig_num)
 {
@@ -171,7 +272,7 @@ int main(int argc, char *argv[])
   signal(SIGINT, aca_signal_handler);
   signal(SIGTERM, aca_signal_handler);
 
-  while ((option = getopt(argc, argv, "a:p:b:h:g:s:c:t:o:md")) != -1) {
+  while ((option = getopt(argc, argv, "a:p:e:b:h:g:r:s:c:t:o:j:n:w:md")) != -1) {
     switch (option) {
     case 'a':
       g_ncm_address = optarg;
@@ -179,6 +280,9 @@ int main(int argc, char *argv[])
     case 'p':
       g_ncm_port = optarg;
       break;
+    case 'e':
+      g_ncm_hedge_address = optarg;
+      break;
     case 'b':
       g_broker_list = optarg;
       break;
@@ -188,6 +292,9 @@ int main(int argc, char *argv[])
     case 'g':
       g_pulsar_subsription_name = optarg;
       break;
+    case 'r':
+      g_pulsar_reply_topic = optarg;
+      break;
     case 's':
       g_grpc_server_port = optarg;
       break;
@@ -200,6 +307,15 @@ int main(int argc, char *argv[])
     case 'o':
       g_ofctl_options = optarg;
       break;
+    case 'j':
+      g_journal_path = optarg;
+      break;
+    case 'n':
+      g_admission_max_resources = strtoul(optarg, NULL, 10);
+      break;
+    case 'w':
+      g_admission_max_bytes = strtoul(optarg, NULL, 10);
+      break;
     case 'm':
       g_demo_mode = true;
       break;
@@ -211,11 +327,16 @@ int main(int argc, char *argv[])
               "Usage: %s\n"
               "\t\t[-a NCM IP Address]\n"
               "\t\t[-p NCM Port]\n"
+              "\t\t[-e NCM IP Address:Port to hedge on-demand requests]\n"
               "\t\t[-b pulsar broker list]\n"
               "\t\t[-h pulsar host topic to listen]\n"
               "\t\t[-g pulsar subscription name]\n"
+              "\t\t[-r pulsar topic to send goal state replies to]\n"
               "\t\t[-s gRPC server port\n"
               "\t\t[-c ofctl command]\n"
+              "\t\t[-j journal file to restore from and record to]\n"
+              "\t\t[-n max goal state resources in flight, 0 for unlimited]\n"
+              "\t\t[-w max goal state bytes in flight, 0 for unlimited]\n"
               "\t\t[-m enable demo mode]\n"
               "\t\t[-d enable debug mode]\n",
               argv[0]);
@@ -243,6 +364,45 @@ int main(int argc, char *argv[])
     g_ofctl_target = OFCTL_TARGET;
   }
 
+  ACA_Admission_Controller::get_instance().set_limits(g_admission_max_resources,
+                                                      g_admission_max_bytes);
+  ACA_LOG_INFO("Admission control budget: %lu resources, %lu bytes in flight\n",
+               g_admission_max_resources, g_admission_max_bytes);
+
+  aca_ovs_l2_programmer::ACA_OVS_L2_Programmer::get_instance().get_local_host_ips();
+
+  rc = aca_ovs_l2_programmer::ACA_OVS_L2_Programmer::get_instance().setup_ovs_bridges_if_need();
+  if (rc == EXIT_FAILURE) {
+    ACA_LOG_ERROR("%s \n", "ACA is not able to create the bridges, please check your environment");
+    aca_cleanup();
+    return rc;
+  }
+
+  // rebuild the in-memory tables from the journal before the controller can push
+  // anything, it then only needs to send what changed while the agent was down
+  if (g_journal_path != EMPTY_STRING) {
+    g_snapshot_path = g_journal_path + ".snapshot";
+    if (aca_ovs_l2_programmer::ACA_OVS_L2_Programmer::get_instance().is_bridges_created()) {
+      // the snapshot describes flows and ports on the bridges that were just replaced,
+      // restoring it would have the controller's resync skipped as already applied
+      ACA_LOG_INFO("Bridges were re-created, not restoring snapshot %s\n",
+                   g_snapshot_path.c_str());
+    } else {
+      Aca_Comm_Manager::get_instance().restore_from_snapshot(g_snapshot_path);
+    }
+
+    rc = ACA_Journal::get_instance().open(g_journal_path, JOURNAL_CAPACITY_IN_BYTES);
+    if (rc == EXIT_SUCCESS) {
+      Aca_Comm_Manager::get_instance().restore_from_journal();
+
+      // joined by aca_cleanup
+      g_snapshot_thread = new std::thread(aca_snapshot_periodically);
+    } else {
+      ACA_LOG_ERROR("Not able to open journal %s, rc: %d, continuing without it\n",
+                    g_journal_path.c_str(), rc);
+    }
+  }
+
   g_grpc_server = new GoalStateProvisionerAsyncServer();
   g_grpc_server_thread = new std::thread(std::bind(
           &GoalStateProvisionerAsyncServer::RunServer, g_grpc_server, thread_pools_size));
@@ -255,14 +415,6 @@ int main(int argc, char *argv[])
           std::bind(&GoalStateProvisionerClientImpl::RunClient, g_grpc_client));
   g_grpc_client_thread->detach();
 
-  aca_ovs_l2_programmer::ACA_OVS_L2_Programmer::get_instance().get_local_host_ips();
-
-  rc = aca_ovs_l2_programmer::ACA_OVS_L2_Programmer::get_instance().setup_ovs_bridges_if_need();
-  if (rc == EXIT_FAILURE) {
-    ACA_LOG_ERROR("%s \n", "ACA is not able to create the bridges, please check your environment");
-    aca_cleanup();
-    return rc;
-  }
   // monitor br-int for dhcp request message
   ovs_monitor_brint_thread =
           new thread(bind(&ACA_OVS_Control::monitor,
@@ -273,6 +425,17 @@ int main(int argc, char *argv[])
   ACA_OVS_Control::get_instance().monitor("br-tun", "resume");
 
   ACA_Message_Pulsar_Consumer network_config_consumer(g_broker_list, g_pulsar_subsription_name);
+
+  if (g_pulsar_reply_topic != EMPTY_STRING) {
+    g_reply_producer = new ACA_Message_Pulsar_Producer(g_broker_list, g_pulsar_reply_topic);
+    g_reply_publisher = new ACA_Reply_Publisher(
+            [](const vector<string> &replies) {
+              return g_reply_producer->publishBatch(replies);
+            },
+            REPLY_PUBLISHER_MAX_BATCH_BYTES, REPLY_PUBLISHER_MAX_PENDING_BYTES,
+            chrono::microseconds(REPLY_PUBLISHER_LINGER_IN_MICROSECONDS));
+    network_config_consumer.setReplyPublisher(g_reply_publisher);
+  }
   rc = network_config_consumer.consumeDispatched(g_pulsar_topic);
   aca_cleanup();
   return rc;
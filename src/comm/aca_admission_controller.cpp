@@ -0,0 +1,199 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_admission_controller.h"
+#include <algorithm>
+#include <vector>
+
+namespace aca_admission_controller
+{
+ACA_Admission_Controller &ACA_Admission_Controller::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Admission_Controller instance;
+  return instance;
+}
+
+ACA_Admission_Controller::ACA_Admission_Controller()
+{
+  _blocked_admissions = 0;
+  _max_resources = ADMISSION_MAX_IN_FLIGHT_RESOURCES;
+  _max_bytes = ADMISSION_MAX_IN_FLIGHT_BYTES;
+  _in_flight_resources = 0;
+  _in_flight_bytes = 0;
+  _in_flight_goal_states = 0;
+  _rejected_count = 0;
+  _max_queue_depth = 0;
+  _deferred_count = 0;
+}
+
+void ACA_Admission_Controller::set_limits(unsigned long max_resources, unsigned long max_bytes)
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+  _max_resources = max_resources;
+  _max_bytes = max_bytes;
+}
+
+bool ACA_Admission_Controller::has_credits(unsigned long resources, unsigned long bytes)
+{
+  if (_in_flight_goal_states == 0) {
+    return true;
+  }
+  if (_max_resources != 0 && _in_flight_resources + resources > _max_resources) {
+    return false;
+  }
+  if (_max_bytes != 0 && _in_flight_bytes + bytes > _max_bytes) {
+    return false;
+  }
+  return true;
+}
+
+void ACA_Admission_Controller::take_credits(unsigned long resources, unsigned long bytes)
+{
+  _in_flight_resources += resources;
+  _in_flight_bytes += bytes;
+  _in_flight_goal_states++;
+}
+
+void ACA_Admission_Controller::count_deferred()
+{
+  unsigned long queue_depth = _pending_admissions.size() + _blocked_admissions;
+
+  _deferred_count++;
+  if (queue_depth > _max_queue_depth.load()) {
+    _max_queue_depth = queue_depth;
+  }
+}
+
+bool ACA_Admission_Controller::try_admit(unsigned long resources, unsigned long bytes)
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+
+  // do not jump ahead of the ones already waiting
+  if (_pending_admissions.empty() && _blocked_admissions == 0 &&
+      has_credits(resources, bytes)) {
+    take_credits(resources, bytes);
+    return true;
+  }
+
+  _rejected_count++;
+  ACA_LOG_DEBUG("[METRICS] Admission rejected: resources: %lu, bytes: %lu, in flight resources: %lu, in flight bytes: %lu\n",
+                resources, bytes, _in_flight_resources, _in_flight_bytes);
+  return false;
+}
+
+void ACA_Admission_Controller::admit(unsigned long resources, unsigned long bytes)
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+
+  _blocked_admissions++;
+  if (!_pending_admissions.empty() || !has_credits(resources, bytes)) {
+    count_deferred();
+  }
+  _credits_cv.wait(credits_lock, [&] {
+    return _pending_admissions.empty() && has_credits(resources, bytes);
+  });
+  _blocked_admissions--;
+
+  take_credits(resources, bytes);
+}
+
+void ACA_Admission_Controller::admit_async(unsigned long resources, unsigned long bytes,
+                                           std::function<void()> on_admitted)
+{
+  {
+    std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+
+    if (!_pending_admissions.empty() || _blocked_admissions != 0 ||
+        !has_credits(resources, bytes)) {
+      ACA_LOG_DEBUG("[METRICS] Admission deferred: resources: %lu, bytes: %lu, queue depth: %lu\n",
+                    resources, bytes, _pending_admissions.size() + _blocked_admissions + 1);
+      _pending_admissions.push_back({ resources, bytes, std::move(on_admitted) });
+      count_deferred();
+      return;
+    }
+    take_credits(resources, bytes);
+  }
+
+  on_admitted();
+}
+
+void ACA_Admission_Controller::release(unsigned long resources, unsigned long bytes)
+{
+  std::vector<std::function<void()> > admitted_callbacks;
+
+  {
+    std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+
+    _in_flight_resources -= std::min(resources, _in_flight_resources);
+    _in_flight_bytes -= std::min(bytes, _in_flight_bytes);
+    if (_in_flight_goal_states > 0) {
+      _in_flight_goal_states--;
+    }
+
+    // serve the parked ones first, in order
+    while (!_pending_admissions.empty() &&
+           has_credits(_pending_admissions.front().resources,
+                       _pending_admissions.front().bytes)) {
+      pending_admission &next_admission = _pending_admissions.front();
+      take_credits(next_admission.resources, next_admission.bytes);
+      admitted_callbacks.push_back(std::move(next_admission.on_admitted));
+      _pending_admissions.pop_front();
+    }
+  }
+  _credits_cv.notify_all();
+
+  // run outside of the lock, the callbacks may call back into the controller
+  for (auto &on_admitted : admitted_callbacks) {
+    on_admitted();
+  }
+}
+
+unsigned long ACA_Admission_Controller::get_queue_depth()
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+  return _pending_admissions.size() + _blocked_admissions;
+}
+
+unsigned long ACA_Admission_Controller::get_max_queue_depth()
+{
+  return _max_queue_depth.load();
+}
+
+unsigned long ACA_Admission_Controller::get_deferred_count()
+{
+  return _deferred_count.load();
+}
+
+unsigned long ACA_Admission_Controller::get_in_flight_resources()
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+  return _in_flight_resources;
+}
+
+unsigned long ACA_Admission_Controller::get_in_flight_bytes()
+{
+  std::unique_lock<std::mutex> credits_lock(_credits_mutex);
+  return _in_flight_bytes;
+}
+
+unsigned long ACA_Admission_Controller::get_rejected_count()
+{
+  return _rejected_count.load();
+}
+
+} // namespace aca_admission_controller
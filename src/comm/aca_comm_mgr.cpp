@@ -17,12 +17,29 @@
 #include "aca_comm_mgr.h"
 #include "aca_goal_state_handler.h"
 #include "aca_dhcp_state_handler.h"
+#include "aca_dag_scheduler.h"
+#include "aca_goal_state_index.h"
+#include "aca_journal.h"
+#include "aca_snapshot.h"
+#include "aca_vlan_manager.h"
+#include "aca_ovs_l3_programmer.h"
+#include "aca_arp_responder.h"
+#include "aca_dhcp_server.h"
+#include "aca_zeta_programming.h"
+#include "aca_revision_tracker.h"
 #include "goalstateprovisioner.grpc.pb.h"
+#include <unordered_map>
 
 using namespace std;
 using namespace alcor::schema;
 using namespace aca_goal_state_handler;
 using namespace aca_dhcp_state_handler;
+using aca_dag_scheduler::ACA_Dag_Scheduler;
+using aca_goal_state_index::ACA_Goal_State_Index;
+using aca_journal::ACA_Journal;
+using aca_snapshot::ACA_Snapshot_File;
+using aca_snapshot::ACA_Snapshot_Reader;
+using aca_snapshot::ACA_Snapshot_Writer;
 
 extern string g_rpc_server;
 extern string g_rpc_protocol;
@@ -30,6 +47,184 @@ extern std::atomic_ulong g_total_update_GS_time;
 
 namespace aca_comm_manager
 {
+// first byte of a journal record, tells which goal state format follows
+static const char JOURNAL_GOAL_STATE_V1 = 1;
+static const char JOURNAL_GOAL_STATE_V2 = 2;
+// marks where a snapshot was taken, followed by the 64 bit snapshot id
+static const char JOURNAL_SNAPSHOT_MARKER = 3;
+
+// record an accepted goal state before it is programmed so a restarted agent can
+// replay it, the journal flusher writes it out in the background,
+// works for both GoalState and GoalStateV2
+template <class GoalStateType>
+static void aca_journal_goal_state(char goal_state_format, const GoalStateType &goal_state_message)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+
+  if (!journal.is_open()) {
+    return;
+  }
+
+  string journal_record(1, goal_state_format);
+  goal_state_message.AppendToString(&journal_record);
+
+  int rc = journal.append(journal_record.data(), journal_record.size());
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to journal goal state, rc: %d\n", rc);
+  }
+}
+
+// record that the goal states before this point are covered by snapshot_id
+static void aca_journal_snapshot_marker(uint64_t snapshot_id)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  char journal_record[1 + sizeof(snapshot_id)];
+
+  if (!journal.is_open()) {
+    return;
+  }
+
+  journal_record[0] = JOURNAL_SNAPSHOT_MARKER;
+  memcpy(journal_record + 1, &snapshot_id, sizeof(snapshot_id));
+
+  int rc = journal.append(journal_record, sizeof(journal_record));
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to journal the marker of snapshot %lu, rc: %d\n", snapshot_id, rc);
+  }
+}
+
+static bool aca_is_snapshot_marker(const char *journal_record, size_t record_length,
+                                   uint64_t *snapshot_id)
+{
+  if (record_length != 1 + sizeof(*snapshot_id) || journal_record[0] != JOURNAL_SNAPSHOT_MARKER) {
+    return false;
+  }
+  memcpy(snapshot_id, journal_record + 1, sizeof(*snapshot_id));
+  return true;
+}
+
+// drop whatever a partly restored snapshot left in the tables
+static void aca_clear_restored_tables()
+{
+  aca_vlan_manager::ACA_Vlan_Manager::get_instance().clear_all_data();
+  aca_ovs_l3_programmer::ACA_OVS_L3_Programmer::get_instance().clear_all_data();
+  aca_arp_responder::ACA_ARP_Responder::get_instance().clear_all_data();
+  aca_dhcp_server::ACA_Dhcp_Server::get_instance().clear_all_data();
+  aca_zeta_programming::ACA_Zeta_Programming::get_instance().clear_all_data();
+  aca_revision_tracker::ACA_Revision_Tracker::get_instance().clear();
+}
+
+/*
+  Turn a GoalStateV2 into a dependency graph so that unrelated resources do not wait
+  for each other:
+    ports of a VPC -> neighbors of that VPC
+    routers of a subnet -> L3 neighbors on that subnet
+    port -> DHCP entry with the same mac
+  Routers and ports have no dependencies. Each node writes to its own workitem reply.
+*/
+static void aca_build_goal_state_dag(GoalStateV2 &goal_state_message,
+                                     ACA_Dag_Scheduler &dag_scheduler,
+                                     std::vector<GoalStateOperationReply> &workitem_replies)
+{
+  Aca_Goal_State_Handler &goal_state_handler = Aca_Goal_State_Handler::get_instance();
+  Aca_Dhcp_State_Handler &dhcp_state_handler = Aca_Dhcp_State_Handler::get_instance();
+  std::unordered_map<string, std::vector<ACA_Dag_Scheduler::node_id> > subnet_router_nodes;
+  std::unordered_map<string, std::vector<ACA_Dag_Scheduler::node_id> > vpc_port_nodes;
+  std::unordered_map<string, ACA_Dag_Scheduler::node_id> mac_port_nodes;
+  std::unordered_map<string, ACA_Dag_Scheduler::node_id> subnet_routers_done;
+  std::unordered_map<string, ACA_Dag_Scheduler::node_id> vpc_ports_done;
+  size_t workitem_index = 0;
+
+  workitem_replies.resize(
+          goal_state_message.router_states_size() + goal_state_message.port_states_size() +
+          goal_state_message.neighbor_states_size() + goal_state_message.dhcp_states_size());
+
+  // named references below, c++17 lambdas cannot capture structured bindings
+  for (auto &router_state_entry : goal_state_message.router_states()) {
+    const RouterState &current_RouterState = router_state_entry.second;
+    GoalStateOperationReply &workitem_reply = workitem_replies[workitem_index++];
+    auto router_node = dag_scheduler.add_node([&] {
+      return goal_state_handler.update_router_state_workitem_v2(
+              current_RouterState, goal_state_message, workitem_reply);
+    });
+
+    auto &current_RouterConfiguration = current_RouterState.configuration();
+    for (int i = 0; i < current_RouterConfiguration.subnet_routing_tables_size(); i++) {
+      subnet_router_nodes[current_RouterConfiguration.subnet_routing_tables(i).subnet_id()]
+              .push_back(router_node);
+    }
+  }
+
+  for (auto &port_state_entry : goal_state_message.port_states()) {
+    const PortState &current_PortState = port_state_entry.second;
+    GoalStateOperationReply &workitem_reply = workitem_replies[workitem_index++];
+    auto port_node = dag_scheduler.add_node([&] {
+      return goal_state_handler.update_port_state_workitem_v2(
+              current_PortState, goal_state_message, workitem_reply);
+    });
+
+    auto &current_PortConfiguration = current_PortState.configuration();
+    vpc_port_nodes[current_PortConfiguration.vpc_id()].push_back(port_node);
+    mac_port_nodes[current_PortConfiguration.mac_address()] = port_node;
+  }
+
+  // join nodes keep the edge count linear when many neighbors share a VPC or subnet
+  for (auto &[subnet_id, router_nodes] : subnet_router_nodes) {
+    auto join_node = dag_scheduler.add_join_node();
+    for (auto router_node : router_nodes) {
+      dag_scheduler.add_dependency(router_node, join_node);
+    }
+    subnet_routers_done[subnet_id] = join_node;
+  }
+  for (auto &[vpc_id, port_nodes] : vpc_port_nodes) {
+    auto join_node = dag_scheduler.add_join_node();
+    for (auto port_node : port_nodes) {
+      dag_scheduler.add_dependency(port_node, join_node);
+    }
+    vpc_ports_done[vpc_id] = join_node;
+  }
+
+  for (auto &neighbor_state_entry : goal_state_message.neighbor_states()) {
+    const NeighborState &current_NeighborState = neighbor_state_entry.second;
+    GoalStateOperationReply &workitem_reply = workitem_replies[workitem_index++];
+    auto neighbor_node = dag_scheduler.add_node([&] {
+      return goal_state_handler.update_neighbor_state_workitem_v2(
+              current_NeighborState, goal_state_message, workitem_reply);
+    });
+
+    auto &current_NeighborConfiguration = current_NeighborState.configuration();
+    auto ports_done = vpc_ports_done.find(current_NeighborConfiguration.vpc_id());
+    if (ports_done != vpc_ports_done.end()) {
+      dag_scheduler.add_dependency(ports_done->second, neighbor_node);
+    }
+
+    for (int i = 0; i < current_NeighborConfiguration.fixed_ips_size(); i++) {
+      auto &current_fixed_ip = current_NeighborConfiguration.fixed_ips(i);
+      if (current_fixed_ip.neighbor_type() != NeighborType::L3) {
+        continue;
+      }
+      auto routers_done = subnet_routers_done.find(current_fixed_ip.subnet_id());
+      if (routers_done != subnet_routers_done.end()) {
+        dag_scheduler.add_dependency(routers_done->second, neighbor_node);
+      }
+    }
+  }
+
+  for (auto &dhcp_state_entry : goal_state_message.dhcp_states()) {
+    const DHCPState &current_DhcpState = dhcp_state_entry.second;
+    GoalStateOperationReply &workitem_reply = workitem_replies[workitem_index++];
+    auto dhcp_node = dag_scheduler.add_node([&] {
+      return dhcp_state_handler.update_dhcp_state_workitem_v2(
+              current_DhcpState, goal_state_message, workitem_reply);
+    });
+
+    auto port_node = mac_port_nodes.find(current_DhcpState.configuration().mac_address());
+    if (port_node != mac_port_nodes.end()) {
+      dag_scheduler.add_dependency(port_node->second, dhcp_node);
+    }
+  }
+}
+
 Aca_Comm_Manager &Aca_Comm_Manager::get_instance()
 {
   // It is instantiated on first use.
@@ -75,6 +270,11 @@ int Aca_Comm_Manager::update_goal_state(GoalState &goal_state_message,
 {
   int exec_command_rc;
   int rc = EXIT_SUCCESS;
+  std::shared_lock<std::shared_timed_mutex> snapshot_gate_lock(_snapshot_gate);
+
+  // under the gate so a snapshot either covers this goal state or keeps its record
+  aca_journal_goal_state(JOURNAL_GOAL_STATE_V1, goal_state_message);
+
   auto start = chrono::steady_clock::now();
 
   ACA_LOG_DEBUG("Starting to update goal state with format_version: %u\n",
@@ -85,9 +285,12 @@ int Aca_Comm_Manager::update_goal_state(GoalState &goal_state_message,
 
   this->print_goal_state(goal_state_message);
 
+  // lookup tables shared by all the workitems of this message
+  ACA_Goal_State_Index goal_state_index(goal_state_message);
+
   if (goal_state_message.router_states_size() > 0) {
     exec_command_rc = Aca_Goal_State_Handler::get_instance().update_router_states(
-            goal_state_message, gsOperationReply);
+            goal_state_message, goal_state_index, gsOperationReply);
     if (exec_command_rc == EXIT_SUCCESS) {
       ACA_LOG_INFO("Successfully updated router states, rc: %d\n", exec_command_rc);
     } else {
@@ -101,7 +304,7 @@ int Aca_Comm_Manager::update_goal_state(GoalState &goal_state_message,
 
   if (goal_state_message.port_states_size() > 0) {
     exec_command_rc = Aca_Goal_State_Handler::get_instance().update_port_states(
-            goal_state_message, gsOperationReply);
+            goal_state_message, goal_state_index, gsOperationReply);
     if (exec_command_rc == EXIT_SUCCESS) {
       ACA_LOG_INFO("Successfully updated port states, rc: %d\n", exec_command_rc);
     } else if (exec_command_rc == EINPROGRESS) {
@@ -119,7 +322,7 @@ int Aca_Comm_Manager::update_goal_state(GoalState &goal_state_message,
 
   if (goal_state_message.neighbor_states_size() > 0) {
     exec_command_rc = Aca_Goal_State_Handler::get_instance().update_neighbor_states(
-            goal_state_message, gsOperationReply);
+            goal_state_message, goal_state_index, gsOperationReply);
     if (exec_command_rc == EXIT_SUCCESS) {
       ACA_LOG_INFO("Successfully updated neighbor states, rc: %d\n", exec_command_rc);
     } else {
@@ -132,7 +335,7 @@ int Aca_Comm_Manager::update_goal_state(GoalState &goal_state_message,
           cast_to_microseconds(neighbor_update_finished_time - port_update_finished_time)
                   .count();
   exec_command_rc = Aca_Dhcp_State_Handler::get_instance().update_dhcp_states(
-          goal_state_message, gsOperationReply);
+          goal_state_message, goal_state_index, gsOperationReply);
   if (exec_command_rc != EXIT_SUCCESS) {
     ACA_LOG_ERROR("Failed to update dhcp state. Failed with error code %d\n", exec_command_rc);
     rc = exec_command_rc;
@@ -167,6 +370,11 @@ int Aca_Comm_Manager::update_goal_state(GoalStateV2 &goal_state_message,
 {
   int exec_command_rc;
   int rc = EXIT_SUCCESS;
+  std::shared_lock<std::shared_timed_mutex> snapshot_gate_lock(_snapshot_gate);
+
+  // under the gate so a snapshot either covers this goal state or keeps its record
+  aca_journal_goal_state(JOURNAL_GOAL_STATE_V2, goal_state_message);
+
   auto start = chrono::steady_clock::now();
   auto t0 = std::chrono::high_resolution_clock::now();
   ACA_LOG_DEBUG("Starting to update goal state with format_version: %u\n",
@@ -184,77 +392,36 @@ int Aca_Comm_Manager::update_goal_state(GoalStateV2 &goal_state_message,
   auto gs_printout_operation_time =
           cast_to_microseconds(gs_printout_finished_time - start).count();
 
-  if (goal_state_message.router_states_size() > 0) {
-    exec_command_rc = Aca_Goal_State_Handler::get_instance().update_router_states(
-            goal_state_message, gsOperationReply);
-    if (exec_command_rc == EXIT_SUCCESS) {
-      ACA_LOG_INFO("Successfully updated router states, rc: %d\n", exec_command_rc);
-    } else {
-      ACA_LOG_ERROR("Failed to update router states. rc: %d\n", exec_command_rc);
-      rc = exec_command_rc;
-    }
-  }
-  auto router_update_finished_time = chrono::steady_clock::now();
-  auto router_operation_time =
-          cast_to_microseconds(router_update_finished_time - gs_printout_finished_time)
-                  .count();
+  ACA_Dag_Scheduler dag_scheduler;
+  std::vector<GoalStateOperationReply> workitem_replies;
 
-  if (goal_state_message.port_states_size() > 0) {
-    exec_command_rc = Aca_Goal_State_Handler::get_instance().update_port_states(
-            goal_state_message, gsOperationReply);
-    if (exec_command_rc == EXIT_SUCCESS) {
-      ACA_LOG_INFO("Successfully updated port states, rc: %d\n", exec_command_rc);
-    } else if (exec_command_rc == EINPROGRESS) {
-      ACA_LOG_INFO("Update port states returned pending, rc: %d\n", exec_command_rc);
-      rc = exec_command_rc;
-    } else {
-      ACA_LOG_ERROR("Failed to update port states. rc: %d\n", exec_command_rc);
-      rc = exec_command_rc;
-    }
-  }
-  auto port_update_finished_time = chrono::steady_clock::now();
-  auto port_operation_time =
-          cast_to_microseconds(port_update_finished_time - router_update_finished_time)
-                  .count();
-  if (goal_state_message.neighbor_states_size() > 0) {
-    exec_command_rc = Aca_Goal_State_Handler::get_instance().update_neighbor_states(
-            goal_state_message, gsOperationReply);
-    if (exec_command_rc == EXIT_SUCCESS) {
-      ACA_LOG_INFO("Successfully updated neighbor states, rc: %d\n", exec_command_rc);
-    } else {
-      ACA_LOG_ERROR("Failed to update neighbor states. rc: %d\n", exec_command_rc);
-      rc = exec_command_rc;
-    }
-  }
-  auto neighbor_update_finished_time = chrono::steady_clock::now();
-  auto neighbor_operation_time =
-          cast_to_microseconds(neighbor_update_finished_time - port_update_finished_time)
-                  .count();
-  exec_command_rc = Aca_Dhcp_State_Handler::get_instance().update_dhcp_states(
-          goal_state_message, gsOperationReply);
-  if (exec_command_rc != EXIT_SUCCESS) {
-    ACA_LOG_ERROR("Failed to update dhcp state. Failed with error code %d\n", exec_command_rc);
+  aca_build_goal_state_dag(goal_state_message, dag_scheduler, workitem_replies);
+
+  exec_command_rc = dag_scheduler.run();
+  if (exec_command_rc == EXIT_SUCCESS) {
+    ACA_LOG_INFO("Successfully updated goal state, rc: %d\n", exec_command_rc);
+  } else if (exec_command_rc == EINPROGRESS) {
+    ACA_LOG_INFO("Update goal state returned pending, rc: %d\n", exec_command_rc);
+    rc = exec_command_rc;
+  } else {
+    ACA_LOG_ERROR("Failed to update goal state. rc: %d\n", exec_command_rc);
     rc = exec_command_rc;
   }
 
+  Aca_Goal_State_Handler::get_instance().merge_goal_state_operation_replies(
+          gsOperationReply, workitem_replies);
+
   auto end = chrono::steady_clock::now();
 
-  auto dhcp_operation_time =
-          cast_to_microseconds(end - neighbor_update_finished_time).count();
+  auto dag_operation_time = cast_to_microseconds(end - gs_printout_finished_time).count();
   auto message_total_operation_time = cast_to_microseconds(end - start).count();
 
   ACA_LOG_DEBUG("[METRICS] Elapsed time for message total operation took: %ld microseconds or %ld milliseconds\n\
 [METRICS] Elapsed time for gs printout operation took: %ld microseconds or %ld milliseconds\n\
-[METRICS] Elapsed time for router operation took: %ld microseconds or %ld milliseconds\n\
-[METRICS] Elapsed time for port operation took: %ld microseconds or %ld milliseconds\n\
-[METRICS] Elapsed time for neighbor operation took: %ld microseconds or %ld milliseconds\n\
-[METRICS] Elapsed time for dhcp operation took: %ld microseconds or %ld milliseconds\n",
+[METRICS] Elapsed time for dependency graph of %zu nodes took: %ld microseconds or %ld milliseconds\n",
                 message_total_operation_time, us_to_ms(message_total_operation_time),
                 gs_printout_operation_time, us_to_ms(gs_printout_operation_time),
-                router_operation_time, us_to_ms(router_operation_time),
-                port_operation_time, us_to_ms(port_operation_time),
-                neighbor_operation_time, us_to_ms(neighbor_operation_time),
-                dhcp_operation_time, us_to_ms(dhcp_operation_time));
+                dag_scheduler.node_count(), dag_operation_time, us_to_ms(dag_operation_time));
 
   gsOperationReply.set_message_total_operation_time(
           message_total_operation_time + gsOperationReply.message_total_operation_time());
@@ -264,7 +431,200 @@ int Aca_Comm_Manager::update_goal_state(GoalStateV2 &goal_state_message,
   return rc;
 }
 
-void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
+long Aca_Comm_Manager::restore_from_journal()
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  long restored_count = 0;
+  long restore_failures = 0;
+  long record_index = 0;
+  long snapshot_marker_index = -1;
+  uint64_t snapshot_id;
+  auto start = chrono::steady_clock::now();
+
+  // the restored snapshot covers every record up to its marker
+  if (_snapshot_id != 0) {
+    journal.replay([&](const char *journal_record, size_t record_length) {
+      if (aca_is_snapshot_marker(journal_record, record_length, &snapshot_id) &&
+          snapshot_id == _snapshot_id) {
+        snapshot_marker_index = record_index;
+      }
+      record_index++;
+    });
+    if (snapshot_marker_index < 0) {
+      ACA_LOG_WARN("Marker of snapshot %lu is not in the journal, replaying all of it\n",
+                   _snapshot_id);
+    }
+  }
+
+  record_index = 0;
+  journal.replay([&](const char *journal_record, size_t record_length) {
+    GoalStateOperationReply gsOperationReply;
+    int rc = -EINVAL;
+
+    if (record_index++ <= snapshot_marker_index ||
+        aca_is_snapshot_marker(journal_record, record_length, &snapshot_id)) {
+      return;
+    }
+    restored_count++;
+
+    if (record_length > 0 && journal_record[0] == JOURNAL_GOAL_STATE_V1) {
+      GoalState goal_state_message;
+      if (goal_state_message.ParseFromArray(journal_record + 1, record_length - 1)) {
+        rc = update_goal_state(goal_state_message, gsOperationReply);
+      }
+    } else if (record_length > 0 && journal_record[0] == JOURNAL_GOAL_STATE_V2) {
+      GoalStateV2 goal_state_message;
+      if (goal_state_message.ParseFromArray(journal_record + 1, record_length - 1)) {
+        rc = update_goal_state(goal_state_message, gsOperationReply);
+      }
+    }
+
+    if (rc != EXIT_SUCCESS && rc != EINPROGRESS) {
+      restore_failures++;
+    }
+  });
+
+  auto restore_time = cast_to_microseconds(chrono::steady_clock::now() - start).count();
+
+  ACA_LOG_INFO("[METRICS] Restored %ld goal states from the journal, %ld of them failed, took: %ld microseconds or %ld milliseconds\n",
+               restored_count, restore_failures, restore_time, us_to_ms(restore_time));
+
+  return restored_count;
+}
+
+int Aca_Comm_Manager::take_snapshot(const string &file_path)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  ACA_Snapshot_Writer snapshot_writer;
+  size_t marker_position;
+  auto start = chrono::steady_clock::now();
+
+  // unique across restarts, the journal can still hold the markers of an earlier run
+  uint64_t snapshot_id = std::max<uint64_t>(
+          _snapshot_id + 1, chrono::duration_cast<chrono::nanoseconds>(
+                                    chrono::system_clock::now().time_since_epoch())
+                                    .count());
+
+  // the tables and the journal marker must describe the same set of goal states
+  _snapshot_gate.lock();
+  snapshot_writer.put_u64(snapshot_id);
+  aca_vlan_manager::ACA_Vlan_Manager::get_instance().snapshot(snapshot_writer);
+  aca_ovs_l3_programmer::ACA_OVS_L3_Programmer::get_instance().snapshot(snapshot_writer);
+  aca_arp_responder::ACA_ARP_Responder::get_instance().snapshot(snapshot_writer);
+  aca_dhcp_server::ACA_Dhcp_Server::get_instance().snapshot(snapshot_writer);
+  aca_zeta_programming::ACA_Zeta_Programming::get_instance().snapshot(snapshot_writer);
+  aca_revision_tracker::ACA_Revision_Tracker::get_instance().snapshot(snapshot_writer);
+  marker_position = journal.size();
+  aca_journal_snapshot_marker(snapshot_id);
+  _snapshot_gate.unlock();
+
+  auto capture_finished_time = chrono::steady_clock::now();
+
+  // a marker without a snapshot is skipped by restore_from_journal
+  int rc = ACA_Snapshot_File::write(file_path, snapshot_writer.get_data());
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to write snapshot %s, rc: %d\n", file_path.c_str(), rc);
+    return rc;
+  }
+
+  // the snapshot just replaced is now the fallback, keep the journal from its marker on
+  if (journal.is_open()) {
+    rc = journal.discard_before(_snapshot_marker_position);
+    if (rc == EXIT_SUCCESS) {
+      marker_position -= _snapshot_marker_position;
+    } else {
+      ACA_LOG_ERROR("Failed to discard journal records covered by the snapshot, rc: %d\n", rc);
+    }
+  }
+  _snapshot_id = snapshot_id;
+  _snapshot_marker_position = marker_position;
+
+  auto end = chrono::steady_clock::now();
+  auto capture_time = cast_to_microseconds(capture_finished_time - start).count();
+  auto snapshot_time = cast_to_microseconds(end - start).count();
+
+  ACA_LOG_INFO("[METRICS] Snapshot of %lu bytes took: %ld microseconds or %ld milliseconds, goal states were paused for: %ld microseconds\n",
+               snapshot_writer.get_data().size(), snapshot_time, us_to_ms(snapshot_time),
+               capture_time);
+
+  return rc;
+}
+
+int Aca_Comm_Manager::restore_snapshot_file(const string &file_path)
+{
+  ACA_Snapshot_File snapshot_file;
+  uint64_t snapshot_id = 0;
+  auto start = chrono::steady_clock::now();
+
+  int rc = snapshot_file.load(file_path);
+  if (rc == -ENOENT) {
+    ACA_LOG_INFO("No snapshot found at %s\n", file_path.c_str());
+    return rc;
+  } else if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to load snapshot %s, rc: %d\n", file_path.c_str(), rc);
+    return rc;
+  }
+
+  // same order as take_snapshot
+  ACA_Snapshot_Reader snapshot_reader = snapshot_file.get_reader();
+  rc = snapshot_reader.get_u64(snapshot_id) ? EXIT_SUCCESS : -EINVAL;
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_vlan_manager::ACA_Vlan_Manager::get_instance().restore(snapshot_reader);
+  }
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_ovs_l3_programmer::ACA_OVS_L3_Programmer::get_instance().restore(snapshot_reader);
+  }
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_arp_responder::ACA_ARP_Responder::get_instance().restore(snapshot_reader);
+  }
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_dhcp_server::ACA_Dhcp_Server::get_instance().restore(snapshot_reader);
+  }
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_zeta_programming::ACA_Zeta_Programming::get_instance().restore(snapshot_reader);
+  }
+  if (rc == EXIT_SUCCESS) {
+    rc = aca_revision_tracker::ACA_Revision_Tracker::get_instance().restore(snapshot_reader);
+  }
+
+  auto restore_time = cast_to_microseconds(chrono::steady_clock::now() - start).count();
+
+  if (rc == EXIT_SUCCESS) {
+    _snapshot_id = snapshot_id;
+    // where its marker sits is not tracked across restarts, the next snapshot
+    // then keeps the whole journal
+    _snapshot_marker_position = 0;
+    ACA_LOG_INFO("[METRICS] Restored %lu bytes snapshot, took: %ld microseconds or %ld milliseconds\n",
+                 snapshot_file.size(), restore_time, us_to_ms(restore_time));
+  } else {
+    ACA_LOG_ERROR("Snapshot %s is damaged, rc: %d\n", file_path.c_str(), rc);
+    aca_clear_restored_tables();
+  }
+
+  return rc;
+}
+
+int Aca_Comm_Manager::restore_from_snapshot(const string &file_path)
+{
+  int rc = restore_snapshot_file(file_path);
+  if (rc == EXIT_SUCCESS) {
+    return rc;
+  }
+
+  // the journal still holds every record since the marker of the previous snapshot
+  string previous_file_path = ACA_Snapshot_File::get_previous_path(file_path);
+  int previous_rc = restore_snapshot_file(previous_file_path);
+  if (previous_rc == EXIT_SUCCESS) {
+    ACA_LOG_WARN("Restored previous snapshot %s instead of %s\n", previous_file_path.c_str(),
+                 file_path.c_str());
+    return previous_rc;
+  }
+
+  _snapshot_id = 0;
+  return (rc == -ENOENT) ? previous_rc : rc;
+}
+
+void Aca_Comm_Manager::print_goal_state(const GoalState &parsed_struct)
 {
   if (g_debug_mode == false) {
     return;
@@ -274,7 +634,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.vpc_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.vpc_states(i).operation_type()));
 
-    VpcConfiguration current_VpcConfiguration =
+    const VpcConfiguration &current_VpcConfiguration =
             parsed_struct.vpc_states(i).configuration();
 
     fprintf(stdout, "current_VpcConfiguration.revision_number(): %d\n",
@@ -316,7 +676,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.subnet_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.subnet_states(i).operation_type()));
 
-    SubnetConfiguration current_SubnetConfiguration =
+    const SubnetConfiguration &current_SubnetConfiguration =
             parsed_struct.subnet_states(i).configuration();
 
     fprintf(stdout, "current_SubnetConfiguration.revision_number(): %d\n",
@@ -376,7 +736,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.port_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.port_states(i).operation_type()));
 
-    PortConfiguration current_PortConfiguration =
+    const PortConfiguration &current_PortConfiguration =
             parsed_struct.port_states(i).configuration();
 
     fprintf(stdout, "current_PortConfiguration.revision_number(): %d\n",
@@ -442,7 +802,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.neighbor_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.neighbor_states(i).operation_type()));
 
-    NeighborConfiguration current_NeighborConfiguration =
+    const NeighborConfiguration &current_NeighborConfiguration =
             parsed_struct.neighbor_states(i).configuration();
 
     fprintf(stdout, "current_NeighborConfiguration.revision_number(): %d\n",
@@ -493,7 +853,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.security_group_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.security_group_states(i).operation_type()));
 
-    SecurityGroupConfiguration current_SecurityGroupConfiguration =
+    const SecurityGroupConfiguration &current_SecurityGroupConfiguration =
             parsed_struct.security_group_states(i).configuration();
 
     fprintf(stdout, "current_SecurityGroupConfiguration.revision_number(): %d\n",
@@ -547,7 +907,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.dhcp_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.dhcp_states(i).operation_type()));
 
-    DHCPConfiguration current_DHCPConfiguration =
+    const DHCPConfiguration &current_DHCPConfiguration =
             parsed_struct.dhcp_states(i).configuration();
 
     fprintf(stdout, "current_DHCPConfiguration.revision_number(): %d\n",
@@ -578,7 +938,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.router_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.router_states(i).operation_type()));
 
-    RouterConfiguration current_RouterConfiguration =
+    const RouterConfiguration &current_RouterConfiguration =
             parsed_struct.router_states(i).configuration();
 
     fprintf(stdout, "current_RouterConfiguration.revision_number(): %d\n",
@@ -603,7 +963,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
       for (int k = 0;
            k < current_RouterConfiguration.subnet_routing_tables(j).routing_rules_size();
            k++) {
-        auto current_routing_rule =
+        auto &current_routing_rule =
                 current_RouterConfiguration.subnet_routing_tables(j).routing_rules(k);
 
         fprintf(stdout, "current_routing_rule(%d).operation_type(): %s\n", k,
@@ -636,7 +996,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
     fprintf(stdout, "parsed_struct.gateway_states(%d).operation_type(): %s\n", i,
             aca_get_operation_string(parsed_struct.gateway_states(i).operation_type()));
 
-    GatewayConfiguration current_GatewayConfiguration =
+    const GatewayConfiguration &current_GatewayConfiguration =
             parsed_struct.gateway_states(i).configuration();
 
     fprintf(stdout, "current_GatewayConfiguration.gateway_type(): %d\n",
@@ -662,7 +1022,7 @@ void Aca_Comm_Manager::print_goal_state(GoalState parsed_struct)
   }
 }
 
-void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
+void Aca_Comm_Manager::print_goal_state(const GoalStateV2 &parsed_struct)
 {
   if (g_debug_mode == false) {
     return;
@@ -673,7 +1033,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_VpcState.operation_type(): %s\n",
             aca_get_operation_string(current_VpcState.operation_type()));
 
-    VpcConfiguration current_VpcConfiguration = current_VpcState.configuration();
+    const VpcConfiguration &current_VpcConfiguration = current_VpcState.configuration();
 
     fprintf(stdout, "current_VpcConfiguration.revision_number(): %d\n",
             current_VpcConfiguration.revision_number());
@@ -716,7 +1076,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_SubnetState.operation_type(): %s\n",
             aca_get_operation_string(current_SubnetState.operation_type()));
 
-    SubnetConfiguration current_SubnetConfiguration = current_SubnetState.configuration();
+    const SubnetConfiguration &current_SubnetConfiguration = current_SubnetState.configuration();
 
     fprintf(stdout, "current_SubnetConfiguration.revision_number(): %d\n",
             current_SubnetConfiguration.revision_number());
@@ -778,7 +1138,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_PortState.operation_type(): %s\n",
             aca_get_operation_string(current_PortState.operation_type()));
 
-    PortConfiguration current_PortConfiguration = current_PortState.configuration();
+    const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
 
     fprintf(stdout, "current_PortConfiguration.revision_number(): %d\n",
             current_PortConfiguration.revision_number());
@@ -846,7 +1206,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_NeighborState.operation_type(): %s\n",
             aca_get_operation_string(current_NeighborState.operation_type()));
 
-    NeighborConfiguration current_NeighborConfiguration =
+    const NeighborConfiguration &current_NeighborConfiguration =
             current_NeighborState.configuration();
 
     fprintf(stdout, "current_NeighborConfiguration.revision_number(): %d\n",
@@ -901,7 +1261,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_security_group_State.operation_type(): %s\n",
             aca_get_operation_string(current_security_group_State.operation_type()));
 
-    SecurityGroupConfiguration current_SecurityGroupConfiguration =
+    const SecurityGroupConfiguration &current_SecurityGroupConfiguration =
             current_security_group_State.configuration();
 
     fprintf(stdout, "current_SecurityGroupConfiguration.revision_number(): %d\n",
@@ -958,7 +1318,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_dhcp_State.operation_type(): %s\n",
             aca_get_operation_string(current_dhcp_State.operation_type()));
 
-    DHCPConfiguration current_DHCPConfiguration = current_dhcp_State.configuration();
+    const DHCPConfiguration &current_DHCPConfiguration = current_dhcp_State.configuration();
 
     fprintf(stdout, "current_DHCPConfiguration.revision_number(): %d\n",
             current_DHCPConfiguration.revision_number());
@@ -991,7 +1351,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_router_State.operation_type(): %s\n",
             aca_get_operation_string(current_router_State.operation_type()));
 
-    RouterConfiguration current_RouterConfiguration =
+    const RouterConfiguration &current_RouterConfiguration =
             current_router_State.configuration();
 
     fprintf(stdout, "current_RouterConfiguration.revision_number(): %d\n",
@@ -1016,7 +1376,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
       for (int k = 0;
            k < current_RouterConfiguration.subnet_routing_tables(j).routing_rules_size();
            k++) {
-        auto current_routing_rule =
+        auto &current_routing_rule =
                 current_RouterConfiguration.subnet_routing_tables(j).routing_rules(k);
 
         fprintf(stdout, "current_routing_rule(%d).operation_type(): %s\n", k,
@@ -1052,7 +1412,7 @@ void Aca_Comm_Manager::print_goal_state(GoalStateV2 parsed_struct)
     fprintf(stdout, "current_gateway_State.operation_type(): %s\n",
             aca_get_operation_string(current_gateway_State.operation_type()));
 
-    GatewayConfiguration current_GatewayConfiguration =
+    const GatewayConfiguration &current_GatewayConfiguration =
             current_gateway_State.configuration();
 
     fprintf(stdout, "current_GatewayConfiguration.gateway_type(): %d\n",
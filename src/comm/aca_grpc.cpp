@@ -30,6 +30,9 @@
 #include "aca_comm_mgr.h"
 #include "aca_log.h"
 #include "aca_grpc.h"
+#include "aca_config.h"
+#include "aca_admission_controller.h"
+#include "aca_goal_state_handler.h"
 
 extern string g_grpc_server_port;
 extern string g_ncm_address;
@@ -37,12 +40,39 @@ extern string g_ncm_port;
 
 using namespace alcor::schema;
 using aca_comm_manager::Aca_Comm_Manager;
+using aca_priority_lanes::ACA_Priority_Lanes;
+using aca_admission_controller::ACA_Admission_Controller;
+using aca_admission_controller::ACA_Admission_Guard;
+using aca_admission_controller::aca_get_goal_state_resource_count;
+using aca_goal_state_handler::Aca_Goal_State_Handler;
+
+// on-demand pushes and small goal states should not wait behind bulk pushes,
+// works for both GoalState and GoalStateV2
+template <class GoalStateType>
+static ACA_Priority_Lanes::Lane aca_get_goal_state_lane(const GoalStateType &goal_state)
+{
+  // if there's only one neighbor state, it means that it is pushed
+  // because of the on-demand request
+  if (goal_state.neighbor_states_size() == 1) {
+    return ACA_Priority_Lanes::HIGH_PRIORITY_LANE;
+  }
+
+  if (aca_get_goal_state_resource_count(goal_state) <= GRPC_PRIORITY_LANES_HIGH_PRIORITY_MAX_RESOURCES) {
+    return ACA_Priority_Lanes::HIGH_PRIORITY_LANE;
+  }
+
+  return ACA_Priority_Lanes::BULK_LANE;
+}
 
 Status GoalStateProvisionerAsyncServer::ShutDownServer()
 {
   ACA_LOG_INFO("%s", "Shutdown server");
   server_->Shutdown();
+  // the queued goal states still Finish/Write their calls on cq_, drain the
+  // lanes while cq_ is open and the cq workers are still reading it
+  priority_lanes_.stop();
   cq_->Shutdown();
+  // the cq workers leave once cq_ is shut down and drained
   thread_pool_.stop();
   keepReadingFromCq_ = false;
   return Status::OK;
@@ -93,25 +123,30 @@ void GoalStateProvisionerAsyncServer::ProcessPushNetworkResourceStatesAsyncCall(
               cq_.get(), /*CQ for finished call*/
               newPushNetworkResourceStatesAsyncCallInstance /*The unique tag for the call*/
       );
-      //  process goalstate in the thread pool
+      //  process goalstate in one of the priority lanes
       ACA_LOG_DEBUG("%s\n", "Processing a PushNetworkResourceStates call...");
-      ACA_LOG_DEBUG("%s\n", "V1: Received a GSV1, need to process it");
-
-      int rc = Aca_Comm_Manager::get_instance().update_goal_state(
-              unaryCall->goalState_, unaryCall->gsOperationReply_);
-      if (rc == EXIT_SUCCESS) {
-        ACA_LOG_INFO("V1: Control Fast Path synchronized - Successfully updated host with latest goal state %d.\n",
-                     rc);
-      } else if (rc == EINPROGRESS) {
-        ACA_LOG_INFO("V1: Control Fast Path synchronized - Update host with latest goal state returned pending, rc=%d.\n",
-                     rc);
-      } else {
-        ACA_LOG_ERROR("V1: Control Fast Path synchronized - Failed to update host with latest goal state, rc=%d.\n",
-                      rc);
+      ACA_Priority_Lanes::Lane lane = aca_get_goal_state_lane(unaryCall->goalState_);
+      // small goal states are not worth holding back, admission control is for bulk ones
+      if (lane == ACA_Priority_Lanes::BULK_LANE) {
+        unsigned long resources = aca_get_goal_state_resource_count(unaryCall->goalState_);
+        unsigned long bytes = unaryCall->goalState_.ByteSizeLong();
+        if (!ACA_Admission_Controller::get_instance().try_admit(resources, bytes)) {
+          ACA_LOG_ERROR("V1: Rejecting goal state with %lu resources and %lu bytes, agent is over its budget\n",
+                        resources, bytes);
+          unaryCall->status_ = AsyncGoalStateProvionerCallBase::CallStatus::SENT;
+          unaryCall->responder_.FinishWithError(
+                  Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                         "too many goal state resources in flight, please retry later"),
+                  unaryCall);
+          break;
+        }
+        unaryCall->admittedResources_ = resources;
+        unaryCall->admittedBytes_ = bytes;
       }
-      unaryCall->status_ = AsyncGoalStateProvionerCallBase::CallStatus::SENT;
-      unaryCall->responder_.Finish(unaryCall->gsOperationReply_, Status::OK, baseCall);
-      ACA_LOG_DEBUG("%s\n", "V1: responder_->Finish called");
+      // older updates of the same resources still queued can now be coalesced
+      Aca_Goal_State_Handler::get_instance().add_pending_updates(unaryCall->goalState_);
+      priority_lanes_.push(lane, std::bind(&GoalStateProvisionerAsyncServer::HandleGoalState,
+                                           this, unaryCall));
 
     } break;
     case AsyncGoalStateProvionerCallBase::CallStatus::SENT: {
@@ -171,50 +206,28 @@ void GoalStateProvisionerAsyncServer::ProcessPushGoalStatesStreamAsyncCall(
           streamingCall->stream_.Read(&streamingCall->goalStateV2_, baseCall);
           streamingCall->hasReadFromStream = true;
         } else {
-          //  process goalstateV2 in the thread pool
+          //  process goalstateV2 in one of the priority lanes
           //  It has read from the stream, now to GoalStateV2 should not be empty
           //  and we need to process it.
           ACA_LOG_DEBUG("%s\n", "This call has already read from the stream, now we process the gsv2...");
-
-          if (streamingCall->goalStateV2_.neighbor_states_size() == 1) {
-            // if there's only one neighbor state, it means that it is pushed
-            // because of the on-demand request
-            auto received_gs_time_high_res = std::chrono::high_resolution_clock::now();
-            auto neighbor_id =
-                    streamingCall->goalStateV2_.neighbor_states().begin()->first.c_str();
-            ACA_LOG_INFO("Neighbor ID: %s received at: %ld milliseconds\n", neighbor_id,
-                         std::chrono::duration_cast<std::chrono::milliseconds>(
-                                 received_gs_time_high_res.time_since_epoch())
-                                 .count());
-          }
-          std::chrono::_V2::steady_clock::time_point start =
-                  std::chrono::steady_clock::now();
-          int rc = Aca_Comm_Manager::get_instance().update_goal_state(
-                  streamingCall->goalStateV2_, streamingCall->gsOperationReply_);
-          if (rc == EXIT_SUCCESS) {
-            ACA_LOG_INFO("Control Fast Path streaming - Successfully updated host with latest goal state %d.\n",
-                         rc);
-          } else if (rc == EINPROGRESS) {
-            ACA_LOG_INFO("Control Fast Path streaming - Update host with latest goal state returned pending, rc=%d.\n",
-                         rc);
+          ACA_Priority_Lanes::Lane lane = aca_get_goal_state_lane(streamingCall->goalStateV2_);
+          auto process_goal_state = [this, lane, streamingCall] {
+            Aca_Goal_State_Handler::get_instance().add_pending_updates(streamingCall->goalStateV2_);
+            priority_lanes_.push(lane, std::bind(&GoalStateProvisionerAsyncServer::HandleGoalStateV2,
+                                                 this, streamingCall));
+          };
+          if (lane == ACA_Priority_Lanes::BULK_LANE) {
+            // when over budget, this call is parked and does not post its next read
+            // until credits are released, gRPC flow control then holds back the sender
+            streamingCall->admittedResources_ =
+                    aca_get_goal_state_resource_count(streamingCall->goalStateV2_);
+            streamingCall->admittedBytes_ = streamingCall->goalStateV2_.ByteSizeLong();
+            ACA_Admission_Controller::get_instance().admit_async(
+                    streamingCall->admittedResources_, streamingCall->admittedBytes_,
+                    process_goal_state);
           } else {
-            ACA_LOG_ERROR("Control Fast Path streaming - Failed to update host with latest goal state, rc=%d.\n",
-                          rc);
+            process_goal_state();
           }
-          std::chrono::_V2::steady_clock::time_point end =
-                  std::chrono::steady_clock::now();
-          auto message_total_operation_time =
-                  std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-                          .count();
-
-          ACA_LOG_DEBUG("[METRICS] Received goalstate at: [%ld], update finished at: [%ld]\nElapsed time for update goalstate operation took: %ld microseconds or %ld milliseconds\n",
-                        start, end, message_total_operation_time,
-                        (message_total_operation_time / 1000));
-
-          streamingCall->status_ = AsyncGoalStateProvionerCallBase::CallStatus::SENT;
-          streamingCall->hasReadFromStream = false;
-          streamingCall->stream_.Write(streamingCall->gsOperationReply_, baseCall);
-          streamingCall->gsOperationReply_.Clear();
         }
       }
       break;
@@ -227,6 +240,100 @@ void GoalStateProvisionerAsyncServer::ProcessPushGoalStatesStreamAsyncCall(
   }
 }
 
+ACA_Admission_Guard
+GoalStateProvisionerAsyncServer::TakeAdmission(AsyncGoalStateProvionerCallBase *baseCall)
+{
+  // only bulk goal states take credits, a streaming call is reused for the next one
+  bool admitted = (baseCall->admittedResources_ != 0 || baseCall->admittedBytes_ != 0);
+  unsigned long resources = baseCall->admittedResources_;
+  unsigned long bytes = baseCall->admittedBytes_;
+
+  baseCall->admittedResources_ = 0;
+  baseCall->admittedBytes_ = 0;
+  return ACA_Admission_Guard(resources, bytes, admitted);
+}
+
+void GoalStateProvisionerAsyncServer::ReleaseAdmission(ACA_Admission_Guard &admission_guard)
+{
+  admission_guard.release();
+  ACA_LOG_DEBUG("[METRICS] Admission queue depth: %lu, max queue depth: %lu, deferred: %lu, in flight resources: %lu, in flight bytes: %lu\n",
+                ACA_Admission_Controller::get_instance().get_queue_depth(),
+                ACA_Admission_Controller::get_instance().get_max_queue_depth(),
+                ACA_Admission_Controller::get_instance().get_deferred_count(),
+                ACA_Admission_Controller::get_instance().get_in_flight_resources(),
+                ACA_Admission_Controller::get_instance().get_in_flight_bytes());
+}
+
+void GoalStateProvisionerAsyncServer::HandleGoalState(PushNetworkResourceStatesAsyncCall *unaryCall)
+{
+  ACA_LOG_DEBUG("%s\n", "V1: Received a GSV1, need to process it");
+  ACA_Admission_Guard admission_guard = TakeAdmission(unaryCall);
+
+  int rc = Aca_Comm_Manager::get_instance().update_goal_state(
+          unaryCall->goalState_, unaryCall->gsOperationReply_);
+  Aca_Goal_State_Handler::get_instance().remove_pending_updates(unaryCall->goalState_);
+  if (rc == EXIT_SUCCESS) {
+    ACA_LOG_INFO("V1: Control Fast Path synchronized - Successfully updated host with latest goal state %d.\n",
+                 rc);
+  } else if (rc == EINPROGRESS) {
+    ACA_LOG_INFO("V1: Control Fast Path synchronized - Update host with latest goal state returned pending, rc=%d.\n",
+                 rc);
+  } else {
+    ACA_LOG_ERROR("V1: Control Fast Path synchronized - Failed to update host with latest goal state, rc=%d.\n",
+                  rc);
+  }
+  ReleaseAdmission(admission_guard);
+  unaryCall->status_ = AsyncGoalStateProvionerCallBase::CallStatus::SENT;
+  unaryCall->responder_.Finish(unaryCall->gsOperationReply_, Status::OK, unaryCall);
+  ACA_LOG_DEBUG("%s\n", "V1: responder_->Finish called");
+}
+
+void GoalStateProvisionerAsyncServer::HandleGoalStateV2(PushGoalStatesStreamAsyncCall *streamingCall)
+{
+  if (streamingCall->goalStateV2_.neighbor_states_size() == 1) {
+    // if there's only one neighbor state, it means that it is pushed
+    // because of the on-demand request
+    auto received_gs_time_high_res = std::chrono::high_resolution_clock::now();
+    auto neighbor_id =
+            streamingCall->goalStateV2_.neighbor_states().begin()->first.c_str();
+    ACA_LOG_INFO("Neighbor ID: %s received at: %ld milliseconds\n", neighbor_id,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                         received_gs_time_high_res.time_since_epoch())
+                         .count());
+  }
+  ACA_Admission_Guard admission_guard = TakeAdmission(streamingCall);
+  std::chrono::_V2::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+  int rc = Aca_Comm_Manager::get_instance().update_goal_state(
+          streamingCall->goalStateV2_, streamingCall->gsOperationReply_);
+  Aca_Goal_State_Handler::get_instance().remove_pending_updates(streamingCall->goalStateV2_);
+  if (rc == EXIT_SUCCESS) {
+    ACA_LOG_INFO("Control Fast Path streaming - Successfully updated host with latest goal state %d.\n",
+                 rc);
+  } else if (rc == EINPROGRESS) {
+    ACA_LOG_INFO("Control Fast Path streaming - Update host with latest goal state returned pending, rc=%d.\n",
+                 rc);
+  } else {
+    ACA_LOG_ERROR("Control Fast Path streaming - Failed to update host with latest goal state, rc=%d.\n",
+                  rc);
+  }
+  ReleaseAdmission(admission_guard);
+  std::chrono::_V2::steady_clock::time_point end =
+          std::chrono::steady_clock::now();
+  auto message_total_operation_time =
+          std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+                  .count();
+
+  ACA_LOG_DEBUG("[METRICS] Received goalstate at: [%ld], update finished at: [%ld]\nElapsed time for update goalstate operation took: %ld microseconds or %ld milliseconds\n",
+                start, end, message_total_operation_time,
+                (message_total_operation_time / 1000));
+
+  streamingCall->status_ = AsyncGoalStateProvionerCallBase::CallStatus::SENT;
+  streamingCall->hasReadFromStream = false;
+  streamingCall->stream_.Write(streamingCall->gsOperationReply_, streamingCall);
+  streamingCall->gsOperationReply_.Clear();
+}
+
 void GoalStateProvisionerAsyncServer::AsyncWorkder()
 {
   while (keepReadingFromCq_) {
@@ -281,6 +388,8 @@ void GoalStateProvisionerAsyncServer::RunServer(int thread_pool_size)
   };
   ACA_LOG_DEBUG("Async GRPC SERVER: finised resizing thread pool to %ld threads\n",
                 thread_pool_size);
+  priority_lanes_.start(thread_pool_size, GRPC_PRIORITY_LANES_RESERVED_HIGH_PRIORITY_WORKERS);
+
   //  Create the server
   ServerBuilder builder;
   string GRPC_SERVER_ADDRESS = "0.0.0.0:" + g_grpc_server_port;
@@ -22,6 +22,7 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
 #include <grpcpp/server_context.h>
@@ -34,16 +35,44 @@
 // extern string g_grpc_server_port;
 extern string g_ncm_address;
 extern string g_ncm_port;
+extern string g_ncm_hedge_address;
 
 using namespace alcor::schema;
 using aca_comm_manager::Aca_Comm_Manager;
 
+static std::shared_ptr<grpc_impl::Channel> aca_create_ncm_channel(string target,
+                                                                  bool use_local_subchannel_pool)
+{
+  grpc::ChannelArguments args;
+  // Channel does a keep alive ping every 10 seconds;
+  args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, 10000);
+  // If the channel does receive the keep alive ping result in 20 seconds, it closes the connection
+  args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, 20000);
+
+  // Allow keep alive ping even if there are no calls in flight
+  args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+
+  // Do not share the connection with other channels to the same target,
+  // so a hedged request does not queue behind a stalled connection
+  if (use_local_subchannel_pool) {
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+  }
+
+  return grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), args);
+}
+
 void GoalStateProvisionerClientImpl::RequestGoalStates(HostRequest *request,
                                                        grpc::CompletionQueue *cq)
 {
   std::chrono::_V2::steady_clock::time_point start = std::chrono::steady_clock::now();
-  grpc::ClientContext ctx;
-  alcor::schema::HostRequestReply reply;
+
+  auto hedged_request = std::make_shared<HedgedHostRequest>();
+  hedged_request->request = *request;
+  hedged_request->cq = cq;
+  // the deadline covers both the original request and its hedged duplicate
+  hedged_request->deadline =
+          std::chrono::system_clock::now() +
+          std::chrono::microseconds(ON_DEMAND_GRPC_DEADLINE_IN_MICROSECONDS);
 
   // check current grpc channel state, try to connect if needed
   grpc_connectivity_state current_state = chan_->GetState(true);
@@ -53,13 +82,27 @@ void GoalStateProvisionerClientImpl::RequestGoalStates(HostRequest *request,
                  "Channel state is not READY/CONNECTING/IDLE. Try to reconnnect.",
                  current_state);
     this->ConnectToNCM();
-    reply.mutable_operation_statuses()->Add();
-    reply.mutable_operation_statuses()->at(0).set_operation_status(OperationStatus::FAILURE);
+    if (hedge_stub_ == nullptr) {
+      return;
+    }
+    // no point to wait for the hedge delay, send to the hedge endpoint right away
+    hedged_request->hedged = true;
+    SendAsyncCall(hedged_request, true);
     return;
   }
-  AsyncClientCall *call = new AsyncClientCall;
-  call->response_reader = stub_->AsyncRequestGoalStates(&call->context, *request, cq);
-  call->response_reader->Finish(&call->reply, &call->status, (void *)call);
+
+  SendAsyncCall(hedged_request, false);
+
+  if (hedge_stub_ != nullptr) {
+    AsyncClientHedgeAlarm *hedge_alarm = new AsyncClientHedgeAlarm;
+    hedge_alarm->type_ = ASYNC_CLIENT_HEDGE_ALARM;
+    hedge_alarm->request_ = hedged_request;
+    hedge_alarm->alarm.Set(cq,
+                           std::chrono::system_clock::now() +
+                                   std::chrono::microseconds(_hedge_delay_us.load()),
+                           (void *)static_cast<AsyncClientTag *>(hedge_alarm));
+  }
+
   ACA_LOG_INFO("Sent hostOperationRequest on thread: %ld\n", std::this_thread::get_id());
   std::chrono::_V2::steady_clock::time_point end = std::chrono::steady_clock::now();
   auto send_host_operation_request_time =
@@ -70,22 +113,130 @@ void GoalStateProvisionerClientImpl::RequestGoalStates(HostRequest *request,
   return;
 }
 
+void GoalStateProvisionerClientImpl::SendAsyncCall(std::shared_ptr<HedgedHostRequest> request,
+                                                   bool is_hedge)
+{
+  GoalStateProvisioner::Stub *stub = is_hedge ? hedge_stub_.get() : stub_.get();
+
+  AsyncClientCall *call = new AsyncClientCall;
+  call->type_ = ASYNC_CLIENT_CALL;
+  call->request_ = request;
+  call->is_hedge = is_hedge;
+  call->sent_time = std::chrono::steady_clock::now();
+  call->context.set_deadline(request->deadline);
+  call->response_reader =
+          stub->AsyncRequestGoalStates(&call->context, request->request, request->cq);
+  call->response_reader->Finish(&call->reply, &call->status,
+                                (void *)static_cast<AsyncClientTag *>(call));
+}
+
+void GoalStateProvisionerClientImpl::SendHedgeIfNeeded(std::shared_ptr<HedgedHostRequest> request)
+{
+  if (hedge_stub_ == nullptr || request->answered.load() || request->hedged.exchange(true)) {
+    return;
+  }
+
+  if (std::chrono::system_clock::now() >= request->deadline) {
+    return;
+  }
+
+  ACA_LOG_INFO("%s\n", "No hostOperationReply yet, sending a hedged hostOperationRequest");
+  SendAsyncCall(request, true);
+}
+
+AsyncClientCall *GoalStateProvisionerClientImpl::HandleAsyncEvent(void *tag, bool ok)
+{
+  AsyncClientTag *client_tag = static_cast<AsyncClientTag *>(tag);
+
+  if (client_tag->type_ == ASYNC_CLIENT_HEDGE_ALARM) {
+    AsyncClientHedgeAlarm *hedge_alarm = static_cast<AsyncClientHedgeAlarm *>(client_tag);
+    // ok is false when the alarm was cancelled
+    if (ok) {
+      SendHedgeIfNeeded(hedge_alarm->request_);
+    }
+    delete hedge_alarm;
+    return nullptr;
+  }
+
+  AsyncClientCall *call = static_cast<AsyncClientCall *>(client_tag);
+
+  if (!ok || !call->status.ok()) {
+    ACA_LOG_INFO("%s hostOperationRequest failed, error code: [%d], message: [%s]\n",
+                 call->is_hedge ? "Hedged" : "Original", call->status.error_code(),
+                 call->status.error_message().c_str());
+    // the original request failed fast (e.g. NCM unavailable), hedge it now
+    // instead of waiting for the hedge delay
+    if (!call->is_hedge && call->status.error_code() != grpc::StatusCode::DEADLINE_EXCEEDED) {
+      SendHedgeIfNeeded(call->request_);
+    }
+    delete call;
+    return nullptr;
+  }
+
+  // first reply wins, the slower one is dropped
+  if (call->request_->answered.exchange(true)) {
+    ACA_LOG_DEBUG("%s\n", "Dropping duplicate hostOperationReply, request already answered");
+    delete call;
+    return nullptr;
+  }
+
+  RecordReplyLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - call->sent_time)
+                             .count());
+
+  if (call->is_hedge) {
+    ACA_LOG_INFO("%s\n", "Hedged hostOperationRequest was answered first");
+  }
+
+  return call;
+}
+
+void GoalStateProvisionerClientImpl::RecordReplyLatency(long latency_us)
+{
+  std::vector<long> samples;
+
+  /* Critical section begins */
+  _latency_mutex.lock();
+  if (_latency_samples.size() < ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE) {
+    _latency_samples.push_back(latency_us);
+  } else {
+    _latency_samples[_next_latency_sample % ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE] = latency_us;
+  }
+  _next_latency_sample++;
+  if (_latency_samples.size() >= ON_DEMAND_HEDGE_MIN_LATENCY_SAMPLES) {
+    samples = _latency_samples;
+  }
+  _latency_mutex.unlock();
+  /* Critical section ends */
+
+  if (samples.empty()) {
+    return;
+  }
+
+  auto p95 = samples.begin() + (samples.size() * 95) / 100;
+  std::nth_element(samples.begin(), p95, samples.end());
+  _hedge_delay_us = std::max(*p95, (long)ON_DEMAND_HEDGE_MIN_DELAY_IN_MICROSECONDS);
+}
+
+long GoalStateProvisionerClientImpl::GetHedgeDelay()
+{
+  return _hedge_delay_us.load();
+}
+
 void GoalStateProvisionerClientImpl::ConnectToNCM()
 {
   ACA_LOG_INFO("%s\n", "Trying to init a new sub to connect to the NCM");
-  grpc::ChannelArguments args;
-  // Channel does a keep alive ping every 10 seconds;
-  args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, 10000);
-  // If the channel does receive the keep alive ping result in 20 seconds, it closes the connection
-  args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, 20000);
-
-  // Allow keep alive ping even if there are no calls in flight
-  args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
 
-  chan_ = grpc::CreateCustomChannel(g_ncm_address + ":" + g_ncm_port,
-                                    grpc::InsecureChannelCredentials(), args);
+  chan_ = aca_create_ncm_channel(g_ncm_address + ":" + g_ncm_port, false);
   stub_ = GoalStateProvisioner::NewStub(chan_);
 
+  // the hedge channel reconnects by itself, it only needs to be created once
+  if (!g_ncm_hedge_address.empty() && hedge_chan_ == nullptr) {
+    ACA_LOG_INFO("Hedging on-demand requests to: %s\n", g_ncm_hedge_address.c_str());
+    hedge_chan_ = aca_create_ncm_channel(g_ncm_hedge_address, true);
+    hedge_stub_ = GoalStateProvisioner::NewStub(hedge_chan_);
+  }
+
   ACA_LOG_INFO("%s\n", "After initing a new sub to connect to the NCM");
 }
 
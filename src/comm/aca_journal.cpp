@@ -0,0 +1,505 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_journal.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aca_journal
+{
+// "ACJ1" in little endian, marks the start of a record
+static const uint32_t JOURNAL_RECORD_MAGIC = 0x314a4341;
+
+// records are kept 4 bytes aligned so their headers can be read in place
+static size_t aca_get_record_size(size_t payload_length)
+{
+  return (sizeof(uint32_t) * 3 + payload_length + 3) & ~(size_t)3;
+}
+
+// makes a rename in the directory durable
+static int aca_sync_parent_directory(const std::string &file_path)
+{
+  size_t separator = file_path.rfind('/');
+  std::string directory = (separator == std::string::npos) ?
+                                  "." :
+                                  file_path.substr(0, std::max<size_t>(separator, 1));
+
+  int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (directory_fd < 0) {
+    return -errno;
+  }
+
+  int rc = (fsync(directory_fd) == 0) ? EXIT_SUCCESS : -errno;
+  ::close(directory_fd);
+  return rc;
+}
+
+uint32_t aca_crc32(const void *data, size_t length)
+{
+  static const std::array<uint32_t, 256> crc_table = [] {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (0xedb88320 ^ (crc >> 1)) : (crc >> 1);
+      }
+      table[i] = crc;
+    }
+    return table;
+  }();
+
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  uint32_t crc = 0xffffffff;
+
+  for (size_t i = 0; i < length; i++) {
+    crc = crc_table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  }
+
+  return crc ^ 0xffffffff;
+}
+
+ACA_Journal &ACA_Journal::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Journal instance;
+  return instance;
+}
+
+ACA_Journal::~ACA_Journal()
+{
+  close();
+}
+
+int ACA_Journal::open(const std::string &file_path, size_t capacity)
+{
+  struct stat file_stat;
+  int rc;
+
+  std::lock_guard<std::mutex> lock(_journal_mutex);
+
+  if (_mapping != nullptr || capacity < aca_get_record_size(0)) {
+    ACA_LOG_ERROR("Journal already open or capacity %zu too small\n", capacity);
+    return -EINVAL;
+  }
+
+  _fd = ::open(file_path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (_fd < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to open journal %s, rc: %d\n", file_path.c_str(), rc);
+    return rc;
+  }
+
+  if (fstat(_fd, &file_stat) != 0) {
+    rc = -errno;
+    goto ERROR;
+  }
+
+  // never shrink an existing journal, its records would be lost
+  if ((size_t)file_stat.st_size > capacity) {
+    capacity = file_stat.st_size;
+  } else if ((size_t)file_stat.st_size < capacity && ftruncate(_fd, capacity) != 0) {
+    rc = -errno;
+    goto ERROR;
+  }
+
+  _mapping = static_cast<char *>(
+          mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0));
+  if (_mapping == MAP_FAILED) {
+    _mapping = nullptr;
+    rc = -errno;
+    goto ERROR;
+  }
+
+  _file_path = file_path;
+  _capacity = capacity;
+  _tail = find_tail();
+  _flushed = _tail;
+  _flush_errno = 0;
+  _flusher_thread = std::thread(&ACA_Journal::flush_records, this);
+
+  ACA_LOG_INFO("Journal %s opened, %zu of %zu bytes used\n", file_path.c_str(), _tail, _capacity);
+
+  return EXIT_SUCCESS;
+
+ERROR:
+  ACA_LOG_ERROR("Failed to map journal %s, rc: %d\n", file_path.c_str(), rc);
+  ::close(_fd);
+  _fd = -1;
+  return rc;
+}
+
+void ACA_Journal::close()
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  // the flusher writes out what is left before it exits
+  std::thread flusher_thread = std::move(_flusher_thread);
+  if (flusher_thread.joinable()) {
+    _closing = true;
+    _appended_cv.notify_all();
+    lock.unlock();
+    flusher_thread.join();
+    lock.lock();
+    _closing = false;
+  }
+
+  _flushed_cv.wait(lock, [this] { return !_flushing; });
+
+  if (_mapping != nullptr) {
+    msync(_mapping, _tail, MS_SYNC);
+    munmap(_mapping, _capacity);
+    _mapping = nullptr;
+  }
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+  _file_path.clear();
+  _capacity = 0;
+  _tail = 0;
+  _flushed = 0;
+}
+
+bool ACA_Journal::is_open()
+{
+  std::lock_guard<std::mutex> lock(_journal_mutex);
+  return _mapping != nullptr;
+}
+
+size_t ACA_Journal::find_tail()
+{
+  size_t offset = 0;
+  record_header header;
+
+  while (_capacity - offset >= sizeof(header)) {
+    memcpy(&header, _mapping + offset, sizeof(header));
+    if (header.magic != JOURNAL_RECORD_MAGIC) {
+      break;
+    }
+
+    if (header.payload_length > _capacity - offset - sizeof(header) ||
+        aca_crc32(_mapping + offset + sizeof(header), header.payload_length) !=
+                header.payload_crc) {
+      // torn by a crash in the middle of an append, clear it so the bytes left
+      // behind a shorter record appended here later are not taken for a record
+      size_t torn_length = std::min(_capacity - offset,
+                                    sizeof(header) + (size_t)header.payload_length);
+      ACA_LOG_WARN("Journal record at offset %zu is torn, dropping %zu bytes\n",
+                   offset, torn_length);
+      memset(_mapping + offset, 0, torn_length);
+      break;
+    }
+
+    offset += std::min(_capacity - offset, aca_get_record_size(header.payload_length));
+  }
+
+  return offset;
+}
+
+int ACA_Journal::grow(std::unique_lock<std::mutex> &lock, size_t min_capacity)
+{
+  // the flusher must not msync the old mapping while it moves
+  _flushed_cv.wait(lock, [this] { return !_flushing; });
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+  if (_capacity >= min_capacity) {
+    // another appender grew it while this one waited
+    return EXIT_SUCCESS;
+  }
+
+  size_t new_capacity = std::max(_capacity * 2, min_capacity);
+  if (ftruncate(_fd, new_capacity) != 0) {
+    int rc = -errno;
+    ACA_LOG_ERROR("Failed to grow the journal to %zu bytes, rc: %d\n", new_capacity, rc);
+    return rc;
+  }
+
+  void *new_mapping = mremap(_mapping, _capacity, new_capacity, MREMAP_MAYMOVE);
+  if (new_mapping == MAP_FAILED) {
+    int rc = -errno;
+    ACA_LOG_ERROR("Failed to remap the journal to %zu bytes, rc: %d\n", new_capacity, rc);
+    return rc;
+  }
+
+  // the next snapshot compacts it again
+  ACA_LOG_WARN("Journal is full, grown from %zu to %zu bytes\n", _capacity, new_capacity);
+  _mapping = static_cast<char *>(new_mapping);
+  _capacity = new_capacity;
+
+  return EXIT_SUCCESS;
+}
+
+int ACA_Journal::append(const void *payload, size_t payload_length)
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+
+  if (_replaying) {
+    return EXIT_SUCCESS;
+  }
+
+  size_t record_size = aca_get_record_size(payload_length);
+  while (record_size > _capacity - _tail) {
+    int rc = grow(lock, _tail + record_size);
+    if (rc != EXIT_SUCCESS) {
+      return rc;
+    }
+  }
+
+  record_header header;
+  header.magic = JOURNAL_RECORD_MAGIC;
+  header.payload_length = payload_length;
+  header.payload_crc = aca_crc32(payload, payload_length);
+
+  memcpy(_mapping + _tail + sizeof(header), payload, payload_length);
+  memcpy(_mapping + _tail, &header, sizeof(header));
+  _tail += record_size;
+
+  _appended_cv.notify_one();
+
+  return EXIT_SUCCESS;
+}
+
+int ACA_Journal::flush()
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+
+  size_t flush_end = _tail;
+  _appended_cv.notify_one();
+
+  // discard_before() shortens the journal, never wait past the current tail
+  _flushed_cv.wait(lock, [this, flush_end] {
+    return _mapping == nullptr || _flush_errno != 0 || _flushed >= std::min(flush_end, _tail);
+  });
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+  return (_flush_errno != 0) ? -_flush_errno : EXIT_SUCCESS;
+}
+
+void ACA_Journal::flush_records()
+{
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  // group commit: every flush covers all the records copied while the previous one ran
+  while (true) {
+    _appended_cv.wait(lock, [this] { return _closing || _flushed < _tail; });
+    if (_flushed >= _tail) {
+      break;
+    }
+
+    _flushing = true;
+    char *mapping = _mapping;
+    size_t flush_from = _flushed - (_flushed % page_size);
+    size_t flush_to = _tail;
+    lock.unlock();
+
+    int rc = msync(mapping + flush_from, flush_to - flush_from, MS_SYNC);
+    int msync_errno = errno;
+
+    lock.lock();
+    _flushing = false;
+    if (rc == 0) {
+      _flushed = std::max(_flushed, flush_to);
+      _flush_errno = 0;
+    } else {
+      ACA_LOG_ERROR("Failed to flush the journal, errno: %d\n", msync_errno);
+      _flush_errno = msync_errno;
+    }
+    _flushed_cv.notify_all();
+
+    if (rc != 0) {
+      if (_closing) {
+        break;
+      }
+      // retry later instead of spinning on a failing disk
+      _appended_cv.wait_for(lock, std::chrono::seconds(1), [this] { return _closing; });
+    }
+  }
+}
+
+long ACA_Journal::replay(
+        const std::function<void(const char *payload, size_t payload_length)> &on_record)
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+
+  size_t replay_end = _tail;
+  _replaying = true;
+  lock.unlock();
+
+  long record_count = 0;
+  size_t offset = 0;
+  record_header header;
+
+  // records up to the tail were checked when the journal was opened or appended
+  while (offset < replay_end) {
+    memcpy(&header, _mapping + offset, sizeof(header));
+    on_record(_mapping + offset + sizeof(header), header.payload_length);
+    offset += aca_get_record_size(header.payload_length);
+    record_count++;
+  }
+
+  lock.lock();
+  _replaying = false;
+
+  return record_count;
+}
+
+int ACA_Journal::reset()
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  if (_mapping == nullptr) {
+    return -EINVAL;
+  }
+
+  _flushed_cv.wait(lock, [this] { return !_flushing; });
+
+  // truncating and growing back zeroes the file without writing it out
+  if (ftruncate(_fd, 0) != 0 || ftruncate(_fd, _capacity) != 0) {
+    int rc = -errno;
+    ACA_LOG_ERROR("Failed to reset the journal, rc: %d\n", rc);
+    return rc;
+  }
+
+  _tail = 0;
+  _flushed = 0;
+
+  return EXIT_SUCCESS;
+}
+
+int ACA_Journal::discard_before(size_t offset)
+{
+  std::unique_lock<std::mutex> lock(_journal_mutex);
+
+  if (_mapping == nullptr || offset > _tail) {
+    return -EINVAL;
+  }
+
+  _flushed_cv.wait(lock, [this] { return !_flushing; });
+
+  // moving the records down in place is not crash safe: the file would hold a mix of
+  // old and moved records that still pass their checksums. Write the records kept to
+  // a new file instead and rename it over the journal, a crash leaves either one whole
+  std::string compact_path = _file_path + ".compact";
+  size_t compact_length = _tail - offset;
+  char *compact_mapping = nullptr;
+  size_t written = 0;
+  int rc = EXIT_SUCCESS;
+
+  int compact_fd = ::open(compact_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (compact_fd < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to create %s, rc: %d\n", compact_path.c_str(), rc);
+    return rc;
+  }
+
+  if (ftruncate(compact_fd, _capacity) != 0) {
+    rc = -errno;
+    goto ERROR;
+  }
+
+  while (written < compact_length) {
+    ssize_t write_length = pwrite(compact_fd, _mapping + offset + written,
+                                  compact_length - written, written);
+    if (write_length < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      rc = -errno;
+      goto ERROR;
+    }
+    written += write_length;
+  }
+
+  if (fsync(compact_fd) != 0) {
+    rc = -errno;
+    goto ERROR;
+  }
+
+  compact_mapping = static_cast<char *>(
+          mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, compact_fd, 0));
+  if (compact_mapping == MAP_FAILED) {
+    compact_mapping = nullptr;
+    rc = -errno;
+    goto ERROR;
+  }
+
+  if (rename(compact_path.c_str(), _file_path.c_str()) != 0) {
+    rc = -errno;
+    goto ERROR;
+  }
+
+  // either journal is good to restore from, a failure here only delays the compaction
+  rc = aca_sync_parent_directory(_file_path);
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_WARN("Failed to sync the directory of journal %s, rc: %d\n",
+                 _file_path.c_str(), rc);
+  }
+
+  munmap(_mapping, _capacity);
+  ::close(_fd);
+  _mapping = compact_mapping;
+  _fd = compact_fd;
+  _tail = compact_length;
+  _flushed = _tail;
+
+  return EXIT_SUCCESS;
+
+ERROR:
+  ACA_LOG_ERROR("Failed to compact journal %s, rc: %d\n", _file_path.c_str(), rc);
+  if (compact_mapping != nullptr) {
+    munmap(compact_mapping, _capacity);
+  }
+  ::close(compact_fd);
+  unlink(compact_path.c_str());
+  return rc;
+}
+
+size_t ACA_Journal::size()
+{
+  std::lock_guard<std::mutex> lock(_journal_mutex);
+  return _tail;
+}
+
+size_t ACA_Journal::capacity()
+{
+  std::lock_guard<std::mutex> lock(_journal_mutex);
+  return _capacity;
+}
+} // namespace aca_journal
@@ -75,6 +75,11 @@ void MessageConsumer::setGroupId(string group_id)
   this->group_id = group_id;
 }
 
+void MessageConsumer::setReplyPublisher(aca_reply_publisher::ACA_Reply_Publisher *reply_publisher)
+{
+  this->reply_publisher = reply_publisher;
+}
+
 bool MessageConsumer::consumeDispatched(string topic)
 {
   alcor::schema::GoalState deserialized_GoalState;
@@ -105,10 +110,14 @@ bool MessageConsumer::consumeDispatched(string topic)
             rc = Aca_Comm_Manager::get_instance().deserialize(
                     message.get_payload().get_data(), message.get_payload().get_size(), deserialized_GoalState);
             if (rc == EXIT_SUCCESS) {
+              gsOperationalReply.Clear();
               rc = Aca_Comm_Manager::get_instance().update_goal_state(
                       deserialized_GoalState, gsOperationalReply);
 
-              // TODO: send gsOperationalReply back to controller through Kafka
+              // queued only, the reply publisher batches and sends it in the background
+              if (this->reply_publisher != nullptr) {
+                this->reply_publisher->publish(gsOperationalReply.SerializeAsString());
+              }
 
               if (rc != EXIT_SUCCESS) {
                 ACA_LOG_ERROR("Failed to update host with latest goal state, rc=%d.\n", rc);
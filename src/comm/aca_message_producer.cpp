@@ -28,7 +28,9 @@ MessageProducer::MessageProducer(string brokers, string topic, int partition)
   setPartitionValue(partition);
 
   // Construct the configuration
-  this->config = { { "metadata.broker.list", this->brokers_list } };
+  this->config = { { "metadata.broker.list", this->brokers_list },
+                   // goal state replies compress well, most of their size is repeated ids
+                   { "compression.codec", "lz4" } };
 
   // Create the producer
   this->ptr_producer = new Producer(this->config);
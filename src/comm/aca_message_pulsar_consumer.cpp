@@ -16,16 +16,25 @@
 #include "goalstate.pb.h"
 #include "aca_comm_mgr.h"
 #include "aca_log.h"
-
+#include "aca_admission_controller.h"
+#include "aca_goal_state_handler.h"
+#include "aca_config.h"
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
 
 using aca_comm_manager::Aca_Comm_Manager;
+using aca_admission_controller::ACA_Admission_Controller;
+using aca_admission_controller::ACA_Admission_Guard;
+using aca_admission_controller::aca_get_goal_state_resource_count;
+using aca_goal_state_handler::Aca_Goal_State_Handler;
 using pulsar::Client;
 using pulsar::ConsumerConfiguration;
 using pulsar::Consumer;
 using pulsar::Message;
 using pulsar::Result;
 
-
 namespace aca_message_pulsar
 {
 ACA_Message_Pulsar_Consumer::ACA_Message_Pulsar_Consumer(string brokers, string subscription_name)
@@ -65,49 +74,146 @@ void ACA_Message_Pulsar_Consumer::setSubscriptionName(string subscription_name)
   this->subscription_name = subscription_name;
 }
 
+void ACA_Message_Pulsar_Consumer::setReplyPublisher(
+        aca_reply_publisher::ACA_Reply_Publisher *reply_publisher)
+{
+  this->reply_publisher = reply_publisher;
+}
+
 bool ACA_Message_Pulsar_Consumer::consumeDispatched(string topic)
 {
-  alcor::schema::GoalState deserialized_GoalState;
-  alcor::schema::GoalStateOperationReply gsOperationalReply;
-  int rc;
-  int overall_rc = EXIT_SUCCESS;
+  std::vector<Consumer> consumers(PULSAR_CONSUMER_WORKERS);
+  std::vector<std::thread> consumer_threads;
+  std::mutex stopped_mutex;
+  std::condition_variable stopped_cv;
+  bool stopped = false;
   Result result;
-  Message message;
-  Consumer consumer;
-  result = this->ptr_client->subscribe(topic,this->subscription_name,this->consumer_config,consumer);
+  int overall_rc = EXIT_SUCCESS;
+
+  // each ordering key sticks to one consumer, so goal states of a VPC are still
+  // programmed in order while different VPCs are programmed in parallel
+  this->consumer_config.setConsumerType(ConsumerKeyShared);
+  this->consumer_config.setAckGroupingTimeMs(PULSAR_CONSUMER_ACK_GROUPING_TIME_IN_MILLISECONDS);
+
+  for (size_t i = 0; i < consumers.size(); i++) {
+    result = this->ptr_client->subscribe(topic, this->subscription_name,
+                                         this->consumer_config, consumers[i]);
+    if (result != Result::ResultOk) {
+      ACA_LOG_ERROR("Failed to subscribe topic: %s\n", topic.c_str());
+      // the consumers already subscribed would otherwise keep their share of the keys
+      for (size_t j = 0; j < i; j++) {
+        consumers[j].close();
+      }
+      return EXIT_FAILURE;
+    }
+  }
+
+  ACA_LOG_DEBUG("%d consumers consuming messages from topic: %s\n",
+                PULSAR_CONSUMER_WORKERS, topic.c_str());
+
+  for (size_t i = 0; i < consumers.size(); i++) {
+    consumer_threads.emplace_back([&, i] {
+      int consumer_rc = consumeBatches(consumers[i], topic);
+
+      std::lock_guard<std::mutex> stopped_lock(stopped_mutex);
+      if (!stopped) {
+        ACA_LOG_ERROR("Consumer %zu stopped, rc: %d, stopping the others\n", i, consumer_rc);
+        stopped = true;
+        overall_rc = consumer_rc;
+      }
+      stopped_cv.notify_all();
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> stopped_lock(stopped_mutex);
+    stopped_cv.wait(stopped_lock, [&stopped] { return stopped; });
+  }
 
-  if (result != Result::ResultOk){
-    ACA_LOG_ERROR("Failed to subscribe topic: %s\n", topic.c_str());
-    return EXIT_FAILURE;
+  // a closed consumer fails its receive, which ends the remaining workers
+  for (auto &consumer : consumers) {
+    consumer.close();
   }
+  for (auto &consumer_thread : consumer_threads) {
+    consumer_thread.join();
+  }
+
+  return overall_rc;
+}
+
+int ACA_Message_Pulsar_Consumer::consumeBatches(Consumer &consumer, string topic)
+{
+  alcor::schema::GoalStateOperationReply gsOperationalReply;
+  std::vector<Message> messages;
+  std::vector<alcor::schema::GoalState> goal_states(PULSAR_CONSUMER_BATCH_MAX_MESSAGES);
+  std::vector<bool> deserialized(PULSAR_CONSUMER_BATCH_MAX_MESSAGES);
+  Aca_Goal_State_Handler &goal_state_handler = Aca_Goal_State_Handler::get_instance();
+  Result result;
+  Message message;
+  int rc;
+  int overall_rc = EXIT_SUCCESS;
 
-  ACA_LOG_DEBUG("Consumer consuming messages from topic: %s\n", topic.c_str());
+  messages.reserve(PULSAR_CONSUMER_BATCH_MAX_MESSAGES);
 
-  //Receive message
-  while(true){
+  while (true) {
+    // block for the first message, then take whatever else is already queued
+    messages.clear();
     result = consumer.receive(message);
 
     if (result != Result::ResultOk) {
-      ACA_LOG_ERROR("Failed to receive message from topic: %s\n",topic.c_str());
+      ACA_LOG_ERROR("Failed to receive message from topic: %s\n", topic.c_str());
       return EXIT_FAILURE;
     }
+    messages.push_back(message);
+
+    while (messages.size() < PULSAR_CONSUMER_BATCH_MAX_MESSAGES &&
+           consumer.receive(message, 0) == Result::ResultOk) {
+      messages.push_back(message);
+    }
+
+    ACA_LOG_DEBUG("Received a batch of %lu messages from topic: %s\n", messages.size(),
+                  topic.c_str());
 
-    else{
+    for (size_t i = 0; i < messages.size(); i++) {
       // Print the ordering key (if any)
-      if (message.hasOrderingKey()) {
-        ACA_LOG_DEBUG("%s  -> ", message.getOrderingKey().c_str());
+      if (messages[i].hasOrderingKey()) {
+        ACA_LOG_DEBUG("%s  -> ", messages[i].getOrderingKey().c_str());
       }
       // Print the payload
-      ACA_LOG_DEBUG("\n<=====incoming message: %s\n",
-                    message.getDataAsString().c_str());
+      ACA_LOG_DEBUG("\n<=====incoming message: %s\n", messages[i].getDataAsString().c_str());
 
+      // a reused GoalState would merge the repeated fields of consecutive messages
+      goal_states[i].Clear();
       rc = Aca_Comm_Manager::get_instance().deserialize(
-              (unsigned char *)message.getData(), message.getLength(), deserialized_GoalState);
-      if (rc == EXIT_SUCCESS) {
-        rc = Aca_Comm_Manager::get_instance().update_goal_state(
-                    deserialized_GoalState, gsOperationalReply);
+              (unsigned char *)messages[i].getData(), messages[i].getLength(), goal_states[i]);
+      deserialized[i] = (rc == EXIT_SUCCESS);
+      if (deserialized[i]) {
+        // later messages of the batch supersede the same resources in earlier ones
+        goal_state_handler.add_pending_updates(goal_states[i]);
+      } else {
+        ACA_LOG_ERROR("Deserialization failed with error code %d.\n", rc);
+        overall_rc = rc;
+      }
+    }
 
-      // TODO: send gsOperationalReply back to controller 
+    for (size_t i = 0; i < messages.size(); i++) {
+      if (deserialized[i]) {
+        // wait for credits, pulsar stops delivering once the receiver queue is full
+        unsigned long resources = aca_get_goal_state_resource_count(goal_states[i]);
+        unsigned long bytes = messages[i].getLength();
+        ACA_Admission_Controller::get_instance().admit(resources, bytes);
+        // the credits go back even if programming the goal state throws
+        ACA_Admission_Guard admission_guard(resources, bytes);
+        gsOperationalReply.Clear();
+        rc = Aca_Comm_Manager::get_instance().update_goal_state(goal_states[i],
+                                                                gsOperationalReply);
+        goal_state_handler.remove_pending_updates(goal_states[i]);
+        admission_guard.release();
+
+        // queued only, the reply publisher batches and sends it in the background
+        if (this->reply_publisher != nullptr) {
+          this->reply_publisher->publish(gsOperationalReply.SerializeAsString());
+        }
 
         if (rc != EXIT_SUCCESS) {
           ACA_LOG_ERROR("Failed to update host with latest goal state, rc=%d.\n", rc);
@@ -115,13 +221,14 @@ bool ACA_Message_Pulsar_Consumer::consumeDispatched(string topic)
         } else {
           ACA_LOG_INFO("Successfully updated host with latest goal state %d.\n", rc);
         }
-      } else {
-        ACA_LOG_ERROR("Deserialization failed with error code %d.\n", rc);
-        overall_rc = rc;
       }
 
-      // Now acknowledge message
-      consumer.acknowledge(message);
+      // Now acknowledge message, the acknowledgements are grouped by the consumer
+      consumer.acknowledgeAsync(messages[i], [topic](Result ack_result) {
+        if (ack_result != Result::ResultOk) {
+          ACA_LOG_ERROR("Failed to acknowledge message from topic: %s\n", topic.c_str());
+        }
+      });
     }
   }
   return overall_rc;
@@ -28,12 +28,20 @@ ACA_Message_Pulsar_Producer::ACA_Message_Pulsar_Producer(string brokers, string
   setBrokers(brokers);
   setTopicName(topic);
 
+  // goal state replies compress well, most of their size is repeated ids
+  this->producer_config.setCompressionType(CompressionLZ4);
+  // messages sent together go to the broker in one request but stay separate messages
+  this->producer_config.setBatchingEnabled(true);
+
   // Create client
   this->ptr_client= new Client(brokers,this->client_config);
 }
 
 ACA_Message_Pulsar_Producer::~ACA_Message_Pulsar_Producer()
 {
+  if (this->producer_created) {
+    this->producer.close();
+  }
   delete this->ptr_client;
 }
 
@@ -53,15 +61,28 @@ void ACA_Message_Pulsar_Producer::setTopicName(string topic)
 }
 
 
-bool ACA_Message_Pulsar_Producer::publish(string message)
+int ACA_Message_Pulsar_Producer::createProducerIfNeeded()
 {
   Result result;
 
-  // Create a producer
-  Producer producer;
-  result = this->ptr_client->createProducer(this->topic_name,producer);
-  if(result != ResultOk){
-    ACA_LOG_ERROR("Failed to create producer, result=%d.\n", result);
+  // Create the producer once, creating one per message costs a round trip to the broker
+  if (!this->producer_created) {
+    result = this->ptr_client->createProducer(this->topic_name, this->producer_config,
+                                              this->producer);
+    if(result != ResultOk){
+      ACA_LOG_ERROR("Failed to create producer, result=%d.\n", result);
+      return EXIT_FAILURE;
+    }
+    this->producer_created = true;
+  }
+  return EXIT_SUCCESS;
+}
+
+int ACA_Message_Pulsar_Producer::publish(string message)
+{
+  Result result;
+
+  if (createProducerIfNeeded() != EXIT_SUCCESS) {
     return EXIT_FAILURE;
   }
 
@@ -69,11 +90,11 @@ bool ACA_Message_Pulsar_Producer::publish(string message)
   Message msg = MessageBuilder().setContent(message).build();
   result = producer.send(msg);
   if(result != ResultOk){
-    ACA_LOG_ERROR("Failed to send message %s.\n", message.c_str());
+    ACA_LOG_ERROR("Failed to send message of %lu bytes, result=%d.\n", message.size(), result);
     return EXIT_FAILURE;
   }
 
-  ACA_LOG_INFO("Successfully send message %s\n", message.c_str());
+  ACA_LOG_INFO("Successfully send message of %lu bytes\n", message.size());
 
   // Flush all produced messages
   producer.flush();
@@ -81,6 +102,34 @@ bool ACA_Message_Pulsar_Producer::publish(string message)
 
 }
 
+int ACA_Message_Pulsar_Producer::publishBatch(const vector<string> &messages)
+{
+  Result result;
+
+  if (createProducerIfNeeded() != EXIT_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+
+  for (const string &message : messages) {
+    Message msg = MessageBuilder().setContent(message).build();
+    producer.sendAsync(msg, [](Result send_result, const MessageId &) {
+      if (send_result != ResultOk) {
+        ACA_LOG_ERROR("Failed to send message, result=%d.\n", send_result);
+      }
+    });
+  }
+
+  // send what the producer batched and wait for the broker to persist it
+  result = producer.flush();
+  if(result != ResultOk){
+    ACA_LOG_ERROR("Failed to send %lu messages, result=%d.\n", messages.size(), result);
+    return EXIT_FAILURE;
+  }
+
+  ACA_LOG_INFO("Successfully send %lu messages\n", messages.size());
+  return EXIT_SUCCESS;
+}
+
 void ACA_Message_Pulsar_Producer::setBrokers(string brokers)
 {
   //TODO: validate string as IP address
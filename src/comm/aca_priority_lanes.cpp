@@ -0,0 +1,163 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_priority_lanes.h"
+
+using namespace std;
+
+namespace aca_priority_lanes
+{
+ACA_Priority_Lanes::ACA_Priority_Lanes()
+{
+  _consecutive_high_priority_tasks = 0;
+  _stopping = false;
+}
+
+ACA_Priority_Lanes::~ACA_Priority_Lanes()
+{
+  stop();
+}
+
+void ACA_Priority_Lanes::start(int worker_count, int reserved_high_priority_workers)
+{
+  if (worker_count < 1) {
+    worker_count = 1;
+  }
+  // keep at least one worker for the bulk lane
+  if (reserved_high_priority_workers > worker_count - 1) {
+    reserved_high_priority_workers = worker_count - 1;
+  }
+  if (reserved_high_priority_workers < 0) {
+    reserved_high_priority_workers = 0;
+  }
+
+  ACA_LOG_INFO("Starting priority lanes with %d workers, %d reserved for the high priority lane\n",
+               worker_count, reserved_high_priority_workers);
+
+  for (int i = 0; i < worker_count; i++) {
+    bool high_priority_only = (i < reserved_high_priority_workers);
+    _workers.emplace_back(&ACA_Priority_Lanes::worker_loop, this, high_priority_only);
+  }
+}
+
+void ACA_Priority_Lanes::stop()
+{
+  _lanes_mutex.lock();
+  _stopping = true;
+  _lanes_mutex.unlock();
+
+  _high_priority_cv.notify_all();
+  _shared_cv.notify_all();
+
+  for (auto &worker : _workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  _workers.clear();
+}
+
+void ACA_Priority_Lanes::push(Lane lane, std::function<void()> task)
+{
+  lane_task new_task;
+  new_task.task = std::move(task);
+  new_task.enqueue_time = chrono::steady_clock::now();
+
+  _lanes_mutex.lock();
+  if (lane == HIGH_PRIORITY_LANE) {
+    _high_priority_queue.push_back(std::move(new_task));
+  } else {
+    _bulk_queue.push_back(std::move(new_task));
+  }
+  _lanes_mutex.unlock();
+
+  if (lane == HIGH_PRIORITY_LANE) {
+    // either a reserved or a shared worker can take it, whoever is idle first
+    _high_priority_cv.notify_one();
+    _shared_cv.notify_one();
+  } else {
+    _shared_cv.notify_one();
+  }
+}
+
+size_t ACA_Priority_Lanes::queue_depth(Lane lane)
+{
+  std::lock_guard<std::mutex> lanes_lock(_lanes_mutex);
+  return (lane == HIGH_PRIORITY_LANE) ? _high_priority_queue.size() : _bulk_queue.size();
+}
+
+bool ACA_Priority_Lanes::pick_task(bool high_priority_only, lane_task &picked_task)
+{
+  bool take_bulk = false;
+
+  if (_high_priority_queue.empty()) {
+    if (high_priority_only || _bulk_queue.empty()) {
+      return false;
+    }
+    take_bulk = true;
+  } else if (!high_priority_only && !_bulk_queue.empty()) {
+    // starvation protection for the bulk lane
+    auto bulk_wait_time =
+            chrono::duration_cast<chrono::microseconds>(
+                    chrono::steady_clock::now() - _bulk_queue.front().enqueue_time)
+                    .count();
+    if (_consecutive_high_priority_tasks >= GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY ||
+        bulk_wait_time >= GRPC_PRIORITY_LANES_BULK_MAX_WAIT_IN_MICROSECONDS) {
+      take_bulk = true;
+    }
+  }
+
+  if (take_bulk) {
+    picked_task = std::move(_bulk_queue.front());
+    _bulk_queue.pop_front();
+    _consecutive_high_priority_tasks = 0;
+  } else {
+    picked_task = std::move(_high_priority_queue.front());
+    _high_priority_queue.pop_front();
+    if (!_bulk_queue.empty()) {
+      _consecutive_high_priority_tasks++;
+    }
+  }
+  return true;
+}
+
+void ACA_Priority_Lanes::worker_loop(bool high_priority_only)
+{
+  std::condition_variable &lane_cv = high_priority_only ? _high_priority_cv : _shared_cv;
+
+  while (true) {
+    lane_task current_task;
+    {
+      std::unique_lock<std::mutex> lanes_lock(_lanes_mutex);
+      lane_cv.wait(lanes_lock, [&] {
+        return _stopping || !_high_priority_queue.empty() ||
+               (!high_priority_only && !_bulk_queue.empty());
+      });
+      if (!pick_task(high_priority_only, current_task)) {
+        // only left when stopping and there is nothing more to do
+        return;
+      }
+    }
+
+    try {
+      current_task.task();
+    } catch (const std::exception &e) {
+      ACA_LOG_ERROR("Priority lane task threw an exception: %s\n", e.what());
+    }
+  }
+}
+
+} // namespace aca_priority_lanes
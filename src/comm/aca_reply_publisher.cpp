@@ -0,0 +1,135 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_reply_publisher.h"
+#include "aca_log.h"
+#include <cerrno>
+#include <cstdlib>
+
+namespace aca_reply_publisher
+{
+ACA_Reply_Publisher::ACA_Reply_Publisher(
+        std::function<int(const std::vector<std::string> &)> send_batch, size_t max_batch_bytes,
+        size_t max_pending_bytes, std::chrono::microseconds linger)
+        : _send_batch(send_batch), _max_batch_bytes(max_batch_bytes),
+          _max_pending_bytes(max_pending_bytes), _linger(linger), _pending_bytes(0),
+          _closing(false), _published_batch_count(0), _dropped_count(0)
+{
+  _publisher_thread = std::thread(&ACA_Reply_Publisher::run, this);
+}
+
+ACA_Reply_Publisher::~ACA_Reply_Publisher()
+{
+  close();
+}
+
+int ACA_Reply_Publisher::publish(std::string serialized_reply)
+{
+  std::lock_guard<std::mutex> lock(_queue_mutex);
+
+  if (_closing) {
+    return -ESHUTDOWN;
+  }
+
+  if (_pending_bytes + serialized_reply.size() > _max_pending_bytes &&
+      !_pending_replies.empty()) {
+    _dropped_count++;
+    ACA_LOG_ERROR("Dropped a goal state reply, %lu bytes of replies are waiting\n",
+                  _pending_bytes);
+    return -ENOBUFS;
+  }
+
+  if (_pending_replies.empty()) {
+    _oldest_pending_time = std::chrono::steady_clock::now();
+  }
+  _pending_bytes += serialized_reply.size();
+  _pending_replies.push_back(std::move(serialized_reply));
+
+  // the background thread only needs waking up for the first reply or a full batch
+  if (_pending_replies.size() == 1 || _pending_bytes >= _max_batch_bytes) {
+    _queue_cv.notify_one();
+  }
+
+  return EXIT_SUCCESS;
+}
+
+void ACA_Reply_Publisher::close()
+{
+  {
+    std::lock_guard<std::mutex> lock(_queue_mutex);
+    _closing = true;
+  }
+  _queue_cv.notify_one();
+
+  if (_publisher_thread.joinable()) {
+    _publisher_thread.join();
+  }
+}
+
+unsigned long ACA_Reply_Publisher::get_published_batch_count()
+{
+  std::lock_guard<std::mutex> lock(_queue_mutex);
+  return _published_batch_count;
+}
+
+unsigned long ACA_Reply_Publisher::get_dropped_count()
+{
+  std::lock_guard<std::mutex> lock(_queue_mutex);
+  return _dropped_count;
+}
+
+void ACA_Reply_Publisher::run()
+{
+  std::unique_lock<std::mutex> lock(_queue_mutex);
+
+  while (true) {
+    _queue_cv.wait(lock, [this] { return _closing || !_pending_replies.empty(); });
+
+    if (_pending_replies.empty()) {
+      // closing and nothing left to send
+      return;
+    }
+
+    // linger for more replies unless a batch is already full
+    _queue_cv.wait_until(lock, _oldest_pending_time + _linger, [this] {
+      return _closing || _pending_bytes >= _max_batch_bytes;
+    });
+
+    // a single reply larger than a batch still goes out on its own
+    std::vector<std::string> batch;
+    size_t batch_bytes = 0;
+    while (!_pending_replies.empty() &&
+           (batch.empty() || batch_bytes + _pending_replies.front().size() <= _max_batch_bytes)) {
+      batch_bytes += _pending_replies.front().size();
+      _pending_bytes -= _pending_replies.front().size();
+      batch.push_back(std::move(_pending_replies.front()));
+      _pending_replies.pop_front();
+    }
+    // replies left behind start their own linger time
+    _oldest_pending_time = std::chrono::steady_clock::now();
+
+    lock.unlock();
+    int rc = _send_batch(batch);
+    if (rc != EXIT_SUCCESS) {
+      ACA_LOG_ERROR("Failed to publish %lu goal state replies of %lu bytes, rc: %d\n",
+                    batch.size(), batch_bytes, rc);
+    }
+    lock.lock();
+
+    if (rc == EXIT_SUCCESS) {
+      _published_batch_count++;
+    }
+  }
+}
+} // namespace aca_reply_publisher
@@ -0,0 +1,288 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_snapshot.h"
+#include "aca_journal.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using aca_journal::aca_crc32;
+
+namespace aca_snapshot
+{
+// "ACS1" in little endian
+static const uint32_t SNAPSHOT_MAGIC = 0x31534341;
+// bump when the layout written by any table changes
+static const uint32_t SNAPSHOT_FORMAT_VERSION = 5;
+
+struct snapshot_header {
+  uint32_t magic;
+  uint32_t format_version;
+  uint64_t data_length;
+  uint32_t data_crc;
+  uint32_t reserved;
+};
+
+void ACA_Snapshot_Writer::put_u8(uint8_t value)
+{
+  _data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void ACA_Snapshot_Writer::put_u16(uint16_t value)
+{
+  _data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void ACA_Snapshot_Writer::put_u32(uint32_t value)
+{
+  _data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void ACA_Snapshot_Writer::put_u64(uint64_t value)
+{
+  _data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void ACA_Snapshot_Writer::put_string(const std::string &value)
+{
+  put_u32(value.size());
+  _data.append(value);
+}
+
+void ACA_Snapshot_Writer::put_bytes(const std::string &value)
+{
+  _data.append(value);
+}
+
+const std::string &ACA_Snapshot_Writer::get_data() const
+{
+  return _data;
+}
+
+ACA_Snapshot_Reader::ACA_Snapshot_Reader(const char *data, size_t length)
+        : _data(data), _length(length), _offset(0), _good(true)
+{
+}
+
+bool ACA_Snapshot_Reader::get_bytes(void *value, size_t length)
+{
+  if (!_good || _length - _offset < length) {
+    _good = false;
+    return false;
+  }
+
+  memcpy(value, _data + _offset, length);
+  _offset += length;
+  return true;
+}
+
+bool ACA_Snapshot_Reader::get_u8(uint8_t &value)
+{
+  return get_bytes(&value, sizeof(value));
+}
+
+bool ACA_Snapshot_Reader::get_u16(uint16_t &value)
+{
+  return get_bytes(&value, sizeof(value));
+}
+
+bool ACA_Snapshot_Reader::get_u32(uint32_t &value)
+{
+  return get_bytes(&value, sizeof(value));
+}
+
+bool ACA_Snapshot_Reader::get_u64(uint64_t &value)
+{
+  return get_bytes(&value, sizeof(value));
+}
+
+bool ACA_Snapshot_Reader::get_string(std::string &value)
+{
+  uint32_t length;
+
+  if (!get_u32(length) || _length - _offset < length) {
+    _good = false;
+    return false;
+  }
+
+  value.assign(_data + _offset, length);
+  _offset += length;
+  return true;
+}
+
+bool ACA_Snapshot_Reader::is_good() const
+{
+  return _good;
+}
+
+bool ACA_Snapshot_Reader::is_at_end() const
+{
+  return _offset == _length;
+}
+
+ACA_Snapshot_File::~ACA_Snapshot_File()
+{
+  if (_mapping != nullptr) {
+    munmap(_mapping, _mapping_length);
+  }
+}
+
+int ACA_Snapshot_File::write(const std::string &file_path, const std::string &data)
+{
+  std::string temp_file_path = file_path + ".tmp";
+  snapshot_header header;
+  int rc = EXIT_SUCCESS;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = SNAPSHOT_MAGIC;
+  header.format_version = SNAPSHOT_FORMAT_VERSION;
+  header.data_length = data.size();
+  header.data_crc = aca_crc32(data.data(), data.size());
+
+  int fd = open(temp_file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to create snapshot %s, rc: %d\n", temp_file_path.c_str(), rc);
+    return rc;
+  }
+
+  const char *chunks[] = { reinterpret_cast<const char *>(&header), data.data() };
+  size_t chunk_lengths[] = { sizeof(header), data.size() };
+
+  for (int i = 0; i < 2 && rc == EXIT_SUCCESS; i++) {
+    size_t written = 0;
+    while (written < chunk_lengths[i]) {
+      ssize_t write_rc = ::write(fd, chunks[i] + written, chunk_lengths[i] - written);
+      if (write_rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        rc = -errno;
+        break;
+      }
+      written += write_rc;
+    }
+  }
+
+  if (rc == EXIT_SUCCESS && fsync(fd) != 0) {
+    rc = -errno;
+  }
+  close(fd);
+
+  // read the new snapshot back before it replaces anything
+  if (rc == EXIT_SUCCESS) {
+    ACA_Snapshot_File written_file;
+    if (written_file.load(temp_file_path) != EXIT_SUCCESS) {
+      rc = -EIO;
+    }
+  }
+
+  // the snapshot being replaced stays as the fallback of the new one
+  std::string previous_file_path = get_previous_path(file_path);
+  if (rc == EXIT_SUCCESS && rename(file_path.c_str(), previous_file_path.c_str()) != 0 &&
+      errno != ENOENT) {
+    rc = -errno;
+  }
+
+  // the rename is atomic, readers see either the old or the new snapshot
+  if (rc == EXIT_SUCCESS && rename(temp_file_path.c_str(), file_path.c_str()) != 0) {
+    rc = -errno;
+  }
+
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to write snapshot %s, rc: %d\n", file_path.c_str(), rc);
+    unlink(temp_file_path.c_str());
+  }
+
+  return rc;
+}
+
+std::string ACA_Snapshot_File::get_previous_path(const std::string &file_path)
+{
+  return file_path + ".prev";
+}
+
+int ACA_Snapshot_File::load(const std::string &file_path)
+{
+  struct stat file_stat;
+  snapshot_header header;
+  int rc;
+
+  if (_mapping != nullptr) {
+    return -EINVAL;
+  }
+
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return -errno;
+  }
+
+  if (fstat(fd, &file_stat) != 0) {
+    rc = -errno;
+    close(fd);
+    return rc;
+  }
+
+  if ((size_t)file_stat.st_size < sizeof(header)) {
+    close(fd);
+    ACA_LOG_ERROR("Snapshot %s is truncated\n", file_path.c_str());
+    return -EINVAL;
+  }
+
+  void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  rc = (mapping == MAP_FAILED) ? -errno : EXIT_SUCCESS;
+  close(fd);
+  if (rc != EXIT_SUCCESS) {
+    ACA_LOG_ERROR("Failed to map snapshot %s, rc: %d\n", file_path.c_str(), rc);
+    return rc;
+  }
+
+  _mapping = static_cast<char *>(mapping);
+  _mapping_length = file_stat.st_size;
+
+  memcpy(&header, _mapping, sizeof(header));
+  if (header.magic != SNAPSHOT_MAGIC || header.format_version != SNAPSHOT_FORMAT_VERSION ||
+      header.data_length != _mapping_length - sizeof(header) ||
+      header.data_crc != aca_crc32(_mapping + sizeof(header), header.data_length)) {
+    ACA_LOG_ERROR("Snapshot %s is damaged or from another format version\n",
+                  file_path.c_str());
+    munmap(_mapping, _mapping_length);
+    _mapping = nullptr;
+    _mapping_length = 0;
+    return -EINVAL;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+ACA_Snapshot_Reader ACA_Snapshot_File::get_reader() const
+{
+  if (_mapping == nullptr) {
+    return ACA_Snapshot_Reader(nullptr, 0);
+  }
+  return ACA_Snapshot_Reader(_mapping + sizeof(snapshot_header),
+                             _mapping_length - sizeof(snapshot_header));
+}
+
+size_t ACA_Snapshot_File::size() const
+{
+  return _mapping_length;
+}
+} // namespace aca_snapshot
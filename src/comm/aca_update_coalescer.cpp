@@ -0,0 +1,161 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_update_coalescer.h"
+
+namespace aca_update_coalescer
+{
+ACA_Update_Coalescer &ACA_Update_Coalescer::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Update_Coalescer instance;
+  return instance;
+}
+
+std::string ACA_Update_Coalescer::make_key(int resource_type, const std::string &resource_id)
+{
+  return std::to_string(resource_type) + "/" + resource_id;
+}
+
+ACA_Update_Coalescer::coalescer_stripe &ACA_Update_Coalescer::get_stripe(const std::string &key)
+{
+  return _stripes[std::hash<std::string>{}(key) % STRIPE_COUNT];
+}
+
+void ACA_Update_Coalescer::add_pending(int resource_type, const std::string &resource_id,
+                                       uint32_t revision_number, Operation operation)
+{
+  if (revision_number == 0) {
+    return;
+  }
+
+  std::string key = make_key(resource_type, resource_id);
+  coalescer_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  pending_resource &resource = stripe.pending_resources[key];
+  resource.pending_revisions[revision_number]++;
+  if (revision_number >= resource.newest_revision) {
+    resource.newest_revision = revision_number;
+    resource.newest_operation = operation;
+  }
+}
+
+void ACA_Update_Coalescer::remove_pending(int resource_type, const std::string &resource_id,
+                                          uint32_t revision_number)
+{
+  if (revision_number == 0) {
+    return;
+  }
+
+  std::string key = make_key(resource_type, resource_id);
+  coalescer_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  auto found_resource = stripe.pending_resources.find(key);
+  if (found_resource == stripe.pending_resources.end()) {
+    return;
+  }
+
+  auto &pending_revisions = found_resource->second.pending_revisions;
+  auto found_revision = pending_revisions.find(revision_number);
+  if (found_revision != pending_revisions.end() && --found_revision->second == 0) {
+    pending_revisions.erase(found_revision);
+  }
+
+  if (pending_revisions.empty()) {
+    stripe.pending_resources.erase(found_resource);
+  }
+}
+
+ACA_Update_Coalescer::Decision
+ACA_Update_Coalescer::decide(int resource_type, const std::string &resource_id,
+                             uint32_t revision_number, Operation operation,
+                             uint32_t applied_revision)
+{
+  if (revision_number == 0) {
+    return APPLY;
+  }
+
+  bool programmed = applied_revision > 0;
+  // a newer revision overtook this DELETE and is programmed already, it would remove it
+  if (operation == DELETE_OPERATION && applied_revision > revision_number) {
+    _coalesced_updates++;
+    return SKIP_SUPERSEDED;
+  }
+
+  std::string key = make_key(resource_type, resource_id);
+  coalescer_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  auto found_resource = stripe.pending_resources.find(key);
+  if (found_resource == stripe.pending_resources.end()) {
+    return APPLY;
+  }
+
+  pending_resource &resource = found_resource->second;
+
+  if (resource.newest_revision > revision_number) {
+    // a newer CREATE leaves behind whatever this DELETE would have removed,
+    // unless it is already being programmed
+    if (operation == DELETE_OPERATION && resource.newest_operation == CREATE_OPERATION &&
+        resource.started_create_revision < revision_number) {
+      return APPLY;
+    }
+    if (operation == CREATE_OPERATION && resource.newest_operation == DELETE_OPERATION &&
+        !programmed) {
+      resource.create_cancelled = true;
+    }
+    _coalesced_updates++;
+    return SKIP_SUPERSEDED;
+  }
+
+  if (operation == DELETE_OPERATION && resource.create_cancelled && !programmed) {
+    resource.create_cancelled = false;
+    _coalesced_updates++;
+    return SKIP_CANCELLED;
+  }
+
+  if (operation == CREATE_OPERATION && resource.started_create_revision < revision_number) {
+    resource.started_create_revision = revision_number;
+  }
+  return APPLY;
+}
+
+size_t ACA_Update_Coalescer::size()
+{
+  size_t total = 0;
+
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    total += stripe.pending_resources.size();
+  }
+
+  return total;
+}
+
+unsigned long ACA_Update_Coalescer::coalesced_count()
+{
+  return _coalesced_updates.load();
+}
+
+void ACA_Update_Coalescer::clear()
+{
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    stripe.pending_resources.clear();
+  }
+}
+} // namespace aca_update_coalescer
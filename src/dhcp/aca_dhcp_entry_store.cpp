@@ -0,0 +1,126 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_dhcp_entry_store.h"
+#include "aca_net_types.h"
+#include <mutex>
+
+using namespace std;
+
+namespace aca_dhcp_server
+{
+ACA_Dhcp_Entry_Store::ACA_Dhcp_Entry_Store() : _entry_count(0)
+{
+}
+
+bool ACA_Dhcp_Entry_Store::parse_mac_address(const string &mac_string, uint64_t &mac_address)
+{
+  aca_net_types::mac_addr parsed_mac_address;
+
+  if (!aca_net_types::mac_addr::parse(mac_string, parsed_mac_address)) {
+    return false;
+  }
+  mac_address = parsed_mac_address.to_u64();
+  return true;
+}
+
+string ACA_Dhcp_Entry_Store::mac_address_to_string(uint64_t mac_address)
+{
+  aca_net_types::mac_addr unpacked_mac_address;
+
+  for (int i = MAC_ADDRESS_LENGTH - 1; i >= 0; i--, mac_address >>= 8) {
+    unpacked_mac_address.bytes[i] = (uint8_t)mac_address;
+  }
+  return unpacked_mac_address.to_string();
+}
+
+ACA_Dhcp_Entry_Store::dhcp_entry_shard &ACA_Dhcp_Entry_Store::_get_shard(uint64_t mac_address)
+{
+  // the vendor prefix is shared by most ports, fold the NIC specific bytes in
+  mac_address ^= mac_address >> 29;
+  mac_address *= 0xbf58476d1ce4e5b9ULL;
+  mac_address ^= mac_address >> 32;
+  return _shards[mac_address & (DHCP_ENTRY_STORE_SHARDS - 1)];
+}
+
+const ACA_Dhcp_Entry_Store::dhcp_entry_shard &
+ACA_Dhcp_Entry_Store::_get_shard(uint64_t mac_address) const
+{
+  return const_cast<ACA_Dhcp_Entry_Store *>(this)->_get_shard(mac_address);
+}
+
+bool ACA_Dhcp_Entry_Store::find(uint64_t mac_address, dhcp_entry_data &entry) const
+{
+  const dhcp_entry_shard &shard = _get_shard(mac_address);
+  std::shared_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+
+  auto pos = shard.entries.find(mac_address);
+  if (pos == shard.entries.end()) {
+    return false;
+  }
+  entry = pos->second;
+  return true;
+}
+
+bool ACA_Dhcp_Entry_Store::insert(uint64_t mac_address, const dhcp_entry_data &entry)
+{
+  dhcp_entry_shard &shard = _get_shard(mac_address);
+  std::unique_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+
+  if (!shard.entries.emplace(mac_address, entry).second) {
+    return false;
+  }
+  _entry_count.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool ACA_Dhcp_Entry_Store::update(uint64_t mac_address, const dhcp_entry_data &entry)
+{
+  dhcp_entry_shard &shard = _get_shard(mac_address);
+  std::unique_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+
+  auto pos = shard.entries.find(mac_address);
+  if (pos == shard.entries.end()) {
+    return false;
+  }
+  pos->second = entry;
+  return true;
+}
+
+bool ACA_Dhcp_Entry_Store::erase(uint64_t mac_address)
+{
+  dhcp_entry_shard &shard = _get_shard(mac_address);
+  std::unique_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+
+  if (shard.entries.erase(mac_address) == 0) {
+    return false;
+  }
+  _entry_count.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ACA_Dhcp_Entry_Store::clear()
+{
+  for (dhcp_entry_shard &shard : _shards) {
+    std::unique_lock<std::shared_timed_mutex> shard_lock(shard.mutex);
+    _entry_count.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+    shard.entries.clear();
+  }
+}
+
+size_t ACA_Dhcp_Entry_Store::size() const
+{
+  return _entry_count.load(std::memory_order_relaxed);
+}
+} // namespace aca_dhcp_server
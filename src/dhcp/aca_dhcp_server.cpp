@@ -18,8 +18,7 @@
 #include "goalstateprovisioner.grpc.pb.h"
 #include <errno.h>
 #include <arpa/inet.h>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 #include "aca_ovs_control.h"
 #include "aca_ovs_l2_programmer.h"
 
@@ -44,22 +43,21 @@ ACA_Dhcp_Server::~ACA_Dhcp_Server()
 
 void ACA_Dhcp_Server::_init_dhcp_db()
 {
-  try {
-    _dhcp_db = new unordered_map<string, dhcp_entry_data>;
-  } catch (const bad_alloc &e) {
-    return;
-  }
-
+  _dhcp_db.clear();
   _dhcp_entry_thresh = 0x10000; //10K
 }
 
 void ACA_Dhcp_Server::_deinit_dhcp_db()
 {
-  delete _dhcp_db;
-  _dhcp_db = nullptr;
+  _dhcp_db.clear();
   _dhcp_entry_thresh = 0;
 }
 
+void ACA_Dhcp_Server::clear_all_data()
+{
+  _dhcp_db.clear();
+}
+
 void ACA_Dhcp_Server::_init_dhcp_ofp()
 {
   unsigned long not_care_culminative_time;
@@ -92,9 +90,10 @@ ACA_Dhcp_Server &ACA_Dhcp_Server::get_instance()
 
 int ACA_Dhcp_Server::add_dhcp_entry(dhcp_config *dhcp_cfg_in)
 {
+  uint64_t mac_address;
   dhcp_entry_data stData;
 
-  if (_validate_dhcp_entry(dhcp_cfg_in)) {
+  if (_get_dhcp_entry(dhcp_cfg_in, mac_address, stData)) {
     ACA_LOG_ERROR("Valiate dhcp cfg failed! (mac = %s)\n",
                   dhcp_cfg_in->mac_address.c_str());
     return EXIT_FAILURE;
@@ -104,18 +103,12 @@ int ACA_Dhcp_Server::add_dhcp_entry(dhcp_config *dhcp_cfg_in)
     ACA_LOG_WARN("Exceed db threshold! (dhcp_db_size = %d)\n", DHCP_DB_SIZE);
   }
 
-  _standardize_mac_address(dhcp_cfg_in->mac_address);
-  DHCP_ENTRY_DATA_SET((dhcp_entry_data *)&stData, dhcp_cfg_in);
-
-  if (_search_dhcp_entry(dhcp_cfg_in->mac_address)) {
+  if (!_dhcp_db.insert(mac_address, stData)) {
     ACA_LOG_ERROR("Entry already existed! (mac = %s)\n",
                   dhcp_cfg_in->mac_address.c_str());
     return EXIT_FAILURE;
   }
 
-  _dhcp_db_mutex.lock();
-  _dhcp_db->insert(make_pair(dhcp_cfg_in->mac_address, stData));
-  _dhcp_db_mutex.unlock();
   ACA_LOG_DEBUG("DHCP Entry with mac: %s added\n", dhcp_cfg_in->mac_address.c_str());
 
   return EXIT_SUCCESS;
@@ -123,7 +116,10 @@ int ACA_Dhcp_Server::add_dhcp_entry(dhcp_config *dhcp_cfg_in)
 
 int ACA_Dhcp_Server::delete_dhcp_entry(dhcp_config *dhcp_cfg_in)
 {
-  if (_validate_dhcp_entry(dhcp_cfg_in)) {
+  uint64_t mac_address;
+  dhcp_entry_data stData;
+
+  if (_get_dhcp_entry(dhcp_cfg_in, mac_address, stData)) {
     ACA_LOG_ERROR("Valiate dhcp cfg failed! (mac = %s)\n",
                   dhcp_cfg_in->mac_address.c_str());
     return EXIT_FAILURE;
@@ -134,73 +130,81 @@ int ACA_Dhcp_Server::delete_dhcp_entry(dhcp_config *dhcp_cfg_in)
     return EXIT_FAILURE;
   }
 
-  _standardize_mac_address(dhcp_cfg_in->mac_address);
-
-  if (!_search_dhcp_entry(dhcp_cfg_in->mac_address)) {
+  if (!_dhcp_db.erase(mac_address)) {
     ACA_LOG_INFO("Entry not exist!  (mac = %s)\n", dhcp_cfg_in->mac_address.c_str());
-    return EXIT_SUCCESS;
   }
 
-  _dhcp_db_mutex.lock();
-  _dhcp_db->erase(dhcp_cfg_in->mac_address);
-  _dhcp_db_mutex.unlock();
-
   return EXIT_SUCCESS;
 }
 
 int ACA_Dhcp_Server::update_dhcp_entry(dhcp_config *dhcp_cfg_in)
 {
-  std::unordered_map<string, dhcp_entry_data>::iterator pos;
-  dhcp_entry_data *pData = nullptr;
+  uint64_t mac_address;
+  dhcp_entry_data stData;
 
-  if (_validate_dhcp_entry(dhcp_cfg_in)) {
+  if (_get_dhcp_entry(dhcp_cfg_in, mac_address, stData)) {
     ACA_LOG_ERROR("Valiate dhcp cfg failed! (mac = %s)\n",
                   dhcp_cfg_in->mac_address.c_str());
     return EXIT_FAILURE;
   }
 
-  _standardize_mac_address(dhcp_cfg_in->mac_address);
-
-  pData = _search_dhcp_entry(dhcp_cfg_in->mac_address);
-  if (!pData) {
+  if (!_dhcp_db.update(mac_address, stData)) {
     ACA_LOG_ERROR("Entry not exist! (mac = %s)\n", dhcp_cfg_in->mac_address.c_str());
     return EXIT_FAILURE;
   }
 
-  _dhcp_db_mutex.lock();
-  DHCP_ENTRY_DATA_SET(pData, dhcp_cfg_in);
-  _dhcp_db_mutex.unlock();
-
   return EXIT_SUCCESS;
 }
 
-dhcp_entry_data *ACA_Dhcp_Server::_search_dhcp_entry(string mac_address)
+int ACA_Dhcp_Server::_get_dhcp_entry(dhcp_config *dhcp_cfg_in, uint64_t &mac_address,
+                                     dhcp_entry_data &stData)
 {
-  std::unordered_map<string, dhcp_entry_data>::iterator pos;
+  try {
+    _validate_dhcp_entry(dhcp_cfg_in);
+  } catch (std::invalid_argument &ia) {
+    ACA_LOG_ERROR("%s\n", ia.what());
+    return EXIT_FAILURE;
+  }
 
-  pos = _dhcp_db->find(mac_address);
-  if (_dhcp_db->end() == pos) {
-    return nullptr;
+  if (!ACA_Dhcp_Entry_Store::parse_mac_address(dhcp_cfg_in->mac_address, mac_address)) {
+    return EXIT_FAILURE;
+  }
+
+  // parse the addresses once here, DHCP replies copy them as they are
+  memset(&stData, 0, sizeof(stData));
+  try {
+    if (!dhcp_cfg_in->ipv4_address.empty()) {
+      stData.ipv4_address = ip4tol(dhcp_cfg_in->ipv4_address);
+    }
+    if (!dhcp_cfg_in->subnet_mask.empty()) {
+      stData.subnet_mask = ip4tol(dhcp_cfg_in->subnet_mask);
+    }
+    if (!dhcp_cfg_in->gateway_address.empty()) {
+      stData.gateway_address = ip4tol(dhcp_cfg_in->gateway_address);
+    }
+    for (int i = 0; i < DHCP_MSG_OPTS_DNS_LENGTH; i++) {
+      if (dhcp_cfg_in->dns_addresses[i].empty()) {
+        break;
+      }
+      stData.dns_addresses[stData.dns_address_count++] = ip4tol(dhcp_cfg_in->dns_addresses[i]);
+    }
+  } catch (std::invalid_argument &ia) {
+    ACA_LOG_ERROR("%s\n", ia.what());
+    return EXIT_FAILURE;
   }
 
-  return (dhcp_entry_data *)&(pos->second);
+  return EXIT_SUCCESS;
 }
 
 void ACA_Dhcp_Server::_validate_mac_address(const char *mac_string)
 {
-  unsigned char mac[6];
+  aca_net_types::mac_addr mac_address;
 
   if (!mac_string) {
     throw std::invalid_argument("Input mac_string is null");
   }
 
-  if (sscanf(mac_string, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &mac[0], &mac[1],
-             &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
-    return;
-  }
-
-  if (sscanf(mac_string, "%hhx-%hhx-%hhx-%hhx-%hhx-%hhx", &mac[0], &mac[1],
-             &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
+  if (aca_net_types::mac_addr::parse(mac_string, mac_address)) {
     return;
   }
 
@@ -212,10 +216,9 @@ void ACA_Dhcp_Server::_validate_mac_address(const char *mac_string)
 
 void ACA_Dhcp_Server::_validate_ipv4_address(const char *ip_address)
 {
-  struct sockaddr_in sa;
+  aca_net_types::ipv4_addr ipv4_address;
 
-  // inet_pton returns 1 for success 0 for failure
-  if (inet_pton(AF_INET, ip_address, &(sa.sin_addr)) != 1) {
+  if (!aca_net_types::ipv4_addr::parse(ip_address, ipv4_address)) {
     throw std::invalid_argument("Virtual ipv4 address is not in the expect format");
   }
 }
@@ -253,22 +256,9 @@ int ACA_Dhcp_Server::_validate_dhcp_entry(dhcp_config *dhcp_cfg_in)
   return EXIT_SUCCESS;
 }
 
-void ACA_Dhcp_Server::_standardize_mac_address(string &mac_string)
-{
-  // standardize the mac address to aa:bb:cc:dd:ee:ff
-  std::transform(mac_string.begin(), mac_string.end(), mac_string.begin(),
-                 [](unsigned char c) { return std::tolower(c); });
-  std::replace(mac_string.begin(), mac_string.end(), '-', ':');
-}
-
 int ACA_Dhcp_Server::_get_db_size() const
 {
-  if (_dhcp_db) {
-    return _dhcp_db->size();
-  } else {
-    ACA_LOG_ERROR("%s", "DHCP-DB does not exist!\n");
-    return EXIT_FAILURE;
-  }
+  return _dhcp_db.size();
 }
 
 /************* Operation and procedure for dataplane *******************/
@@ -433,41 +423,35 @@ uint32_t ACA_Dhcp_Server::_get_requested_ip(dhcp_message *dhcpmsg)
   return unopt.reqip->req_ip;
 }
 
-string ACA_Dhcp_Server::_get_client_id(dhcp_message *dhcpmsg)
+bool ACA_Dhcp_Server::_get_client_mac_address(dhcp_message *dhcpmsg, uint64_t &mac_address)
 {
   dhcp_message_options unopt;
-  string cid;
-  stringstream ss;
+  const uint8_t *client_mac = nullptr;
 
   if (!dhcpmsg) {
     ACA_LOG_ERROR("%s", "DHCP message is null!\n");
-    return nullptr;
+    return false;
   }
 
-  // get client identifier from option
+  // get client identifier from option, or from chaddr
   unopt.clientid = (dhcp_client_id *)_get_option(dhcpmsg, DHCP_OPT_CODE_CLIENT_ID);
   if (unopt.clientid && unopt.clientid->type == 1) {
-    for (int i = 0; i < unopt.clientid->len - 1; i++) {
-      ss << std::hex << std::setw(2) << std::setfill('0')
-         << static_cast<unsigned int>(unopt.clientid->cid[i]);
-      ss << ":";
+    if (unopt.clientid->len - 1 != DHCP_MSG_HWTYPE_ETH_LEN) {
+      return false;
     }
-    ss >> cid;
-    cid.pop_back();
-
-    return cid;
+    client_mac = unopt.clientid->cid;
+  } else {
+    if (dhcpmsg->hlen != DHCP_MSG_HWTYPE_ETH_LEN) {
+      return false;
+    }
+    client_mac = dhcpmsg->chaddr;
   }
 
-  // get client identifier from chaddr
-  for (int i = 0; i < dhcpmsg->hlen; i++) {
-    ss << std::hex << std::setw(2) << std::setfill('0')
-       << static_cast<unsigned int>(dhcpmsg->chaddr[i]);
-    ss << ":";
+  mac_address = 0;
+  for (int i = 0; i < DHCP_MSG_HWTYPE_ETH_LEN; i++) {
+    mac_address = mac_address << 8 | client_mac[i];
   }
-  ss >> cid;
-  cid.pop_back();
-
-  return cid;
+  return true;
 }
 
 void ACA_Dhcp_Server::_pack_dhcp_message(dhcp_message *rpl, dhcp_message *req)
@@ -545,7 +529,7 @@ void ACA_Dhcp_Server::_pack_dhcp_opt_server_id(uint8_t *option, uint32_t server_
   sid->sid = htonl(server_id);
 }
 
-void ACA_Dhcp_Server::_pack_dhcp_opt_subnet_mask(uint8_t *option, string subnet_mask)
+void ACA_Dhcp_Server::_pack_dhcp_opt_subnet_mask(uint8_t *option, uint32_t subnet_mask)
 {
   dhcp_subnet_mask *sm = nullptr;
 
@@ -556,10 +540,10 @@ void ACA_Dhcp_Server::_pack_dhcp_opt_subnet_mask(uint8_t *option, string subnet_
   sm = (dhcp_subnet_mask *)option;
   sm->code = DHCP_OPT_CODE_SUBNET_MASK;
   sm->len = DHCP_OPT_LEN_4BYTE;
-  sm->subnet_mask = ip4tol(subnet_mask);
+  sm->subnet_mask = subnet_mask;
 }
 
-void ACA_Dhcp_Server::_pack_dhcp_opt_router(uint8_t *option, string router_address)
+void ACA_Dhcp_Server::_pack_dhcp_opt_router(uint8_t *option, uint32_t router_address)
 {
   dhcp_router *dr = nullptr;
 
@@ -570,10 +554,10 @@ void ACA_Dhcp_Server::_pack_dhcp_opt_router(uint8_t *option, string router_addre
   dr = (dhcp_router *)option;
   dr->code = DHCP_OPT_CODE_ROUTER;
   dr->len = DHCP_OPT_LEN_4BYTE;
-  dr->router_address = ip4tol(router_address);
+  dr->router_address = router_address;
 }
 
-int ACA_Dhcp_Server::_pack_dhcp_opt_dns(uint8_t *option, string dns_addresses[])
+int ACA_Dhcp_Server::_pack_dhcp_opt_dns(uint8_t *option, const dhcp_entry_data *pData)
 {
   dhcp_dns *dr = nullptr;
 
@@ -583,16 +567,9 @@ int ACA_Dhcp_Server::_pack_dhcp_opt_dns(uint8_t *option, string dns_addresses[])
 
   dr = (dhcp_dns *)option;
   dr->code = DHCP_OPT_CODE_DNS_NAME_SERVER;
+  dr->len = pData->dns_address_count * 4;
+  memcpy(dr->dns, pData->dns_addresses, dr->len);
 
-  uint32_t *dns_address_options = (uint32_t *)dr->dns;
-  for (int i = 0; i < DHCP_MSG_OPTS_DNS_LENGTH; i++) {
-    if (dns_addresses[i] == "") {
-      dr->len = i * 4;
-      break;
-    }
-
-    dns_address_options[i] = ip4tol(dns_addresses[i]);
-  }
   return dr->len;
 }
 
@@ -620,19 +597,21 @@ void ACA_Dhcp_Server::_parse_dhcp_none(uint32_t /* in_port */, dhcp_message *dhc
 
 void ACA_Dhcp_Server::_parse_dhcp_discover(uint32_t in_port, dhcp_message *dhcpmsg)
 {
-  string mac_address;
-  dhcp_entry_data *pData = nullptr;
+  uint64_t mac_address;
+  dhcp_entry_data stData;
   dhcp_message *dhcpoffer = nullptr;
 
-  mac_address = _get_client_id(dhcpmsg);
-  _standardize_mac_address(mac_address);
-  pData = _search_dhcp_entry(mac_address);
-  if (!pData) {
-    ACA_LOG_ERROR("DHCP entry does not exist! (mac = %s)\n", mac_address.c_str());
+  if (!_get_client_mac_address(dhcpmsg, mac_address)) {
+    ACA_LOG_ERROR("%s", "DHCP discover without an ethernet client address!\n");
+    return;
+  }
+  if (!_dhcp_db.find(mac_address, stData)) {
+    ACA_LOG_ERROR("DHCP entry does not exist! (mac = %s)\n",
+                  ACA_Dhcp_Entry_Store::mac_address_to_string(mac_address).c_str());
     return;
   }
 
-  dhcpoffer = _pack_dhcp_offer(dhcpmsg, pData);
+  dhcpoffer = _pack_dhcp_offer(dhcpmsg, &stData);
   if (!dhcpoffer) {
     return;
   }
@@ -641,22 +620,23 @@ void ACA_Dhcp_Server::_parse_dhcp_discover(uint32_t in_port, dhcp_message *dhcpm
 }
 
 dhcp_message *
-ACA_Dhcp_Server::_pack_dhcp_offer(dhcp_message *dhcpdiscover, dhcp_entry_data *pData)
+ACA_Dhcp_Server::_pack_dhcp_offer(dhcp_message *dhcpdiscover, const dhcp_entry_data *pData)
 {
   dhcp_message *dhcpoffer = nullptr;
-  struct sockaddr_in sa;
   uint8_t *pos = nullptr;
   int opts_len = 0;
 
+  if (0 == pData->ipv4_address) {
+    ACA_LOG_ERROR("%s", "DHCP entry has no ipv4 address to offer!\n");
+    return nullptr;
+  }
+
   dhcpoffer = new dhcp_message();
 
   //Pack DHCP header
   _pack_dhcp_message(dhcpoffer, dhcpdiscover);
 
-  if (inet_pton(AF_INET, pData->ipv4_address.c_str(), &(sa.sin_addr)) != 1) {
-    throw std::invalid_argument("Virtual ipv4 address is not in the expect format");
-  }
-  dhcpoffer->yiaddr = htonl(sa.sin_addr.s_addr);
+  dhcpoffer->yiaddr = htonl(pData->ipv4_address);
 
   //DHCP Options
   pos = dhcpoffer->options;
@@ -674,20 +654,20 @@ ACA_Dhcp_Server::_pack_dhcp_offer(dhcp_message *dhcpdiscover, dhcp_entry_data *p
   opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
 
   //DHCP Options: subnet mask
-  if (!pData->subnet_mask.empty()) {
+  if (0 != pData->subnet_mask) {
     _pack_dhcp_opt_subnet_mask(&pos[opts_len], pData->subnet_mask);
     opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
   }
 
   //DHCP Options: router
-  if (!pData->gateway_address.empty()) {
+  if (0 != pData->gateway_address) {
     _pack_dhcp_opt_router(&pos[opts_len], pData->gateway_address);
     opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
   }
 
   //DHCP Options: dns
-  if (!pData->dns_addresses[0].empty()) {
-    int len = _pack_dhcp_opt_dns(&pos[opts_len], pData->dns_addresses);
+  if (0 < pData->dns_address_count) {
+    int len = _pack_dhcp_opt_dns(&pos[opts_len], pData);
     opts_len += DHCP_OPT_CLV_HEADER + len;
   }
 
@@ -699,19 +679,20 @@ ACA_Dhcp_Server::_pack_dhcp_offer(dhcp_message *dhcpdiscover, dhcp_entry_data *p
 
 void ACA_Dhcp_Server::_parse_dhcp_request(uint32_t in_port, dhcp_message *dhcpmsg)
 {
-  string mac_address;
-  dhcp_entry_data *pData = nullptr;
+  uint64_t mac_address;
+  dhcp_entry_data stData;
   dhcp_message *dhcpack = nullptr;
   dhcp_message *dhcpnak = nullptr;
-  struct sockaddr_in sa;
   uint32_t self_sid = DHCP_MSG_SERVER_ID;
 
   // Fetch the record in DB
-  mac_address = _get_client_id(dhcpmsg);
-  _standardize_mac_address(mac_address);
-  pData = _search_dhcp_entry(mac_address);
-  if (!pData) {
-    ACA_LOG_ERROR("DHCP entry does not exist! (mac = %s)\n", mac_address.c_str());
+  if (!_get_client_mac_address(dhcpmsg, mac_address)) {
+    ACA_LOG_ERROR("%s", "DHCP request without an ethernet client address!\n");
+    return;
+  }
+  if (!_dhcp_db.find(mac_address, stData)) {
+    ACA_LOG_ERROR("DHCP entry does not exist! (mac = %s)\n",
+                  ACA_Dhcp_Entry_Store::mac_address_to_string(mac_address).c_str());
     return;
   }
 
@@ -719,25 +700,22 @@ void ACA_Dhcp_Server::_parse_dhcp_request(uint32_t in_port, dhcp_message *dhcpms
   //Need the fetch self server id here!!
   if (self_sid == _get_server_id(dhcpmsg)) { //request to me
     //Verify the ip address from client is the one assigned in DHCPOFFER
-    if (inet_pton(AF_INET, pData->ipv4_address.c_str(), &(sa.sin_addr)) != 1) {
-      throw std::invalid_argument("Virtual ipv4 address is not in the expect format");
-    }
-    if (htonl(sa.sin_addr.s_addr) != _get_requested_ip(dhcpmsg)) {
+    if (ntohl(stData.ipv4_address) != _get_requested_ip(dhcpmsg)) {
       ACA_LOG_ERROR("IP address %u in DHCP request is not same as the one in DB!",
-                    sa.sin_addr.s_addr);
+                    stData.ipv4_address);
       dhcpnak = _pack_dhcp_nak(dhcpmsg);
       dhcps_xmit(in_port, dhcpnak);
       return;
     }
 
-    dhcpack = _pack_dhcp_ack(dhcpmsg, pData);
+    dhcpack = _pack_dhcp_ack(dhcpmsg, &stData);
     dhcps_xmit(in_port, dhcpack);
 
   } else { //not to me
   }
 }
 
-dhcp_message *ACA_Dhcp_Server::_pack_dhcp_ack(dhcp_message *dhcpreq, dhcp_entry_data *pData)
+dhcp_message *ACA_Dhcp_Server::_pack_dhcp_ack(dhcp_message *dhcpreq, const dhcp_entry_data *pData)
 {
   dhcp_message *dhcpack = nullptr;
   uint8_t *pos = nullptr;
@@ -766,20 +744,20 @@ dhcp_message *ACA_Dhcp_Server::_pack_dhcp_ack(dhcp_message *dhcpreq, dhcp_entry_
   opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
 
   //DHCP Options: subnet mask
-  if (!pData->subnet_mask.empty()) {
+  if (0 != pData->subnet_mask) {
     _pack_dhcp_opt_subnet_mask(&pos[opts_len], pData->subnet_mask);
     opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
   }
 
   //DHCP Options: router
-  if (!pData->gateway_address.empty()) {
+  if (0 != pData->gateway_address) {
     _pack_dhcp_opt_router(&pos[opts_len], pData->gateway_address);
     opts_len += DHCP_OPT_CLV_HEADER + DHCP_OPT_LEN_4BYTE;
   }
 
   //DHCP Options: dns
-  if (!pData->dns_addresses[0].empty()) {
-    int len = _pack_dhcp_opt_dns(&pos[opts_len], pData->dns_addresses);
+  if (0 < pData->dns_address_count) {
+    int len = _pack_dhcp_opt_dns(&pos[opts_len], pData);
     opts_len += DHCP_OPT_CLV_HEADER + len;
   }
 
@@ -999,4 +977,64 @@ string ACA_Dhcp_Server::_serialize_dhcp_ip_header_message(dhcp_message *dhcpmsg,
   return packet_header;
 }
 
+void ACA_Dhcp_Server::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  uint32_t entry_count = 0;
+  aca_snapshot::ACA_Snapshot_Writer entries_writer;
+
+  _dhcp_db.for_each([&](uint64_t mac_address, const dhcp_entry_data &stData) {
+    entries_writer.put_u64(mac_address);
+    entries_writer.put_u32(stData.ipv4_address);
+    entries_writer.put_u32(stData.subnet_mask);
+    entries_writer.put_u32(stData.gateway_address);
+    entries_writer.put_u32(stData.dns_address_count);
+    for (uint32_t i = 0; i < stData.dns_address_count; i++) {
+      entries_writer.put_u32(stData.dns_addresses[i]);
+    }
+    entry_count++;
+  });
+
+  snapshot_writer.put_u32(entry_count);
+  snapshot_writer.put_bytes(entries_writer.get_data());
+}
+
+int ACA_Dhcp_Server::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  uint32_t entry_count = 0;
+  int overall_rc = EXIT_SUCCESS;
+
+  snapshot_reader.get_u32(entry_count);
+
+  for (uint32_t i = 0; i < entry_count && snapshot_reader.is_good(); i++) {
+    uint64_t mac_address = 0;
+    dhcp_entry_data stData;
+
+    memset(&stData, 0, sizeof(stData));
+    snapshot_reader.get_u64(mac_address);
+    snapshot_reader.get_u32(stData.ipv4_address);
+    snapshot_reader.get_u32(stData.subnet_mask);
+    snapshot_reader.get_u32(stData.gateway_address);
+    snapshot_reader.get_u32(stData.dns_address_count);
+    if (stData.dns_address_count > DHCP_MSG_OPTS_DNS_LENGTH) {
+      overall_rc = -EINVAL;
+      break;
+    }
+    for (uint32_t j = 0; j < stData.dns_address_count; j++) {
+      snapshot_reader.get_u32(stData.dns_addresses[j]);
+    }
+
+    if (snapshot_reader.is_good() && !_dhcp_db.update(mac_address, stData)) {
+      _dhcp_db.insert(mac_address, stData);
+    }
+  }
+
+  if (!snapshot_reader.is_good()) {
+    overall_rc = -EINVAL;
+  }
+
+  ACA_LOG_DEBUG("ACA_Dhcp_Server::restore <--- Exiting, %u entries, overall_rc = %d\n",
+                entry_count, overall_rc);
+  return overall_rc;
+}
+
 } //namespace aca_dhcp_server
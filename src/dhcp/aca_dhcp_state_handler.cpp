@@ -17,12 +17,15 @@
 #include "aca_dhcp_server.h"
 #include "aca_dhcp_state_handler.h"
 #include "aca_goal_state_handler.h"
+#include "aca_work_stealing_pool.h"
+#include "aca_goal_state_index.h"
 #include "goalstateprovisioner.grpc.pb.h"
-#include <future>
 #include <string>
 
 using namespace aca_dhcp_programming_if;
 using namespace alcor::schema;
+using aca_work_stealing_pool::ACA_Work_Stealing_Pool;
+using aca_goal_state_index::ACA_Goal_State_Index;
 
 namespace aca_dhcp_state_handler
 {
@@ -45,8 +48,9 @@ Aca_Dhcp_State_Handler &Aca_Dhcp_State_Handler::get_instance()
   return instance;
 }
 
-int Aca_Dhcp_State_Handler::update_dhcp_state_workitem(const DHCPState current_DhcpState,
+int Aca_Dhcp_State_Handler::update_dhcp_state_workitem(const DHCPState &current_DhcpState,
                                                        GoalState &parsed_struct,
+                                                       const ACA_Goal_State_Index &goal_state_index,
                                                        GoalStateOperationReply &gsOperationReply)
 {
   dhcp_config stDhcpCfg;
@@ -56,28 +60,33 @@ int Aca_Dhcp_State_Handler::update_dhcp_state_workitem(const DHCPState current_D
 
   auto operation_start = chrono::steady_clock::now();
 
-  DHCPConfiguration current_DhcpConfiguration = current_DhcpState.configuration();
+  const DHCPConfiguration &current_DhcpConfiguration = current_DhcpState.configuration();
+
+  if (aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().skip_applied_revision(
+              gsOperationReply, current_DhcpConfiguration.id(), DHCP,
+              current_DhcpState.operation_type(), current_DhcpConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+  uint64_t revision_generation =
+          aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().get_revision_generation();
+
   stDhcpCfg.mac_address = current_DhcpConfiguration.mac_address();
   stDhcpCfg.ipv4_address = current_DhcpConfiguration.ipv4_address();
   stDhcpCfg.ipv6_address = current_DhcpConfiguration.ipv6_address();
   stDhcpCfg.port_host_name = current_DhcpConfiguration.port_host_name();
 
   string subnet_id = current_DhcpConfiguration.subnet_id();
-  for (int i = 0; i < parsed_struct.subnet_states_size(); i++) {
-    SubnetState current_SubnetState = parsed_struct.subnet_states(i);
-    SubnetConfiguration current_SubnetConfiguration = current_SubnetState.configuration();
-
-    if (subnet_id == current_SubnetConfiguration.id()) {
-      stDhcpCfg.gateway_address = current_SubnetConfiguration.gateway().ip_address();
-      stDhcpCfg.subnet_mask =
-              aca_convert_cidr_to_netmask(current_SubnetConfiguration.cidr());
-      // handle dhcp dns entries
-      for (int j = 0; j < current_SubnetConfiguration.dns_entry_list_size() && j < DHCP_MSG_OPTS_DNS_LENGTH;
-           j++) {
-        stDhcpCfg.dns_addresses[j] =
-                current_SubnetConfiguration.dns_entry_list(j).entry();
-      }
-      break;
+  const SubnetState *found_SubnetState = goal_state_index.find_subnet(subnet_id);
+
+  if (found_SubnetState != nullptr) {
+    const SubnetConfiguration &current_SubnetConfiguration = found_SubnetState->configuration();
+
+    stDhcpCfg.gateway_address = current_SubnetConfiguration.gateway().ip_address();
+    stDhcpCfg.subnet_mask = aca_convert_cidr_to_netmask(current_SubnetConfiguration.cidr());
+    // handle dhcp dns entries
+    for (int j = 0; j < current_SubnetConfiguration.dns_entry_list_size() && j < DHCP_MSG_OPTS_DNS_LENGTH;
+         j++) {
+      stDhcpCfg.dns_addresses[j] = current_SubnetConfiguration.dns_entry_list(j).entry();
     }
   }
 
@@ -107,36 +116,43 @@ int Aca_Dhcp_State_Handler::update_dhcp_state_workitem(const DHCPState current_D
           current_DhcpState.operation_type(), overall_rc, culminative_dataplane_programming_time,
           culminative_network_configuration_time, operation_total_time);
 
+  aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().record_applied_revision(
+          current_DhcpConfiguration.id(), DHCP, current_DhcpState.operation_type(),
+          current_DhcpConfiguration.revision_number(), overall_rc, revision_generation);
+
   return overall_rc;
 }
 
 int Aca_Dhcp_State_Handler::update_dhcp_states(GoalState &parsed_struct,
+                                               const ACA_Goal_State_Index &goal_state_index,
                                                GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
+  int workitem_count = parsed_struct.dhcp_states_size();
   int overall_rc = EXIT_SUCCESS;
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(workitem_count);
+  std::vector<int> workitem_rc(workitem_count, EXIT_SUCCESS);
 
-  for (int i = 0; i < parsed_struct.dhcp_states_size(); i++) {
-    ACA_LOG_DEBUG("=====>parsing dhcp states #%d\n", i);
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(workitem_count, 0, [&](size_t i) {
+    ACA_LOG_DEBUG("=====>parsing dhcp states #%zu\n", i);
 
-    DHCPState current_DhcpState = parsed_struct.dhcp_states(i);
+    workitem_rc[i] = update_dhcp_state_workitem(parsed_struct.dhcp_states(i),
+                                                parsed_struct, goal_state_index,
+                                                workitem_replies[i]);
+  });
 
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Dhcp_State_Handler::update_dhcp_state_workitem, this,
-            current_DhcpState, std::ref(parsed_struct), std::ref(gsOperationReply)));
-  } // for (int i = 0; i < parsed_struct.dhcp_states_size(); i++)
-
-  for (int i = 0; i < parsed_struct.dhcp_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.dhcp_states_size(); i++)
+  }
+
+  aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().merge_goal_state_operation_replies(
+          gsOperationReply, workitem_replies);
 
   return overall_rc;
 }
 
-int Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2(const DHCPState current_DhcpState,
+int Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2(const DHCPState &current_DhcpState,
                                                           GoalStateV2 &parsed_struct,
                                                           GoalStateOperationReply &gsOperationReply)
 {
@@ -147,7 +163,16 @@ int Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2(const DHCPState curren
 
   auto operation_start = chrono::steady_clock::now();
 
-  DHCPConfiguration current_DhcpConfiguration = current_DhcpState.configuration();
+  const DHCPConfiguration &current_DhcpConfiguration = current_DhcpState.configuration();
+
+  if (aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().skip_applied_revision(
+              gsOperationReply, current_DhcpConfiguration.id(), DHCP,
+              current_DhcpState.operation_type(), current_DhcpConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+  uint64_t revision_generation =
+          aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().get_revision_generation();
+
   stDhcpCfg.mac_address = current_DhcpConfiguration.mac_address();
   stDhcpCfg.ipv4_address = current_DhcpConfiguration.ipv4_address();
   stDhcpCfg.ipv6_address = current_DhcpConfiguration.ipv6_address();
@@ -158,8 +183,8 @@ int Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2(const DHCPState curren
   auto subnetStateFound = parsed_struct.subnet_states().find(subnet_id);
 
   if (subnetStateFound != parsed_struct.subnet_states().end()) {
-    SubnetState current_SubnetState = subnetStateFound->second;
-    SubnetConfiguration current_SubnetConfiguration = current_SubnetState.configuration();
+    const SubnetState &current_SubnetState = subnetStateFound->second;
+    const SubnetConfiguration &current_SubnetConfiguration = current_SubnetState.configuration();
 
     stDhcpCfg.gateway_address = current_SubnetConfiguration.gateway().ip_address();
     stDhcpCfg.subnet_mask =
@@ -202,29 +227,41 @@ int Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2(const DHCPState curren
           current_DhcpState.operation_type(), overall_rc, culminative_dataplane_programming_time,
           culminative_network_configuration_time, operation_total_time);
 
+  aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().record_applied_revision(
+          current_DhcpConfiguration.id(), DHCP, current_DhcpState.operation_type(),
+          current_DhcpConfiguration.revision_number(), overall_rc, revision_generation);
+
   return overall_rc;
 }
 
 int Aca_Dhcp_State_Handler::update_dhcp_states(GoalStateV2 &parsed_struct,
                                                GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
   int overall_rc = EXIT_SUCCESS;
+  std::vector<const DHCPState *> dhcp_states;
 
+  dhcp_states.reserve(parsed_struct.dhcp_states_size());
   for (auto &[dhcp_id, current_DhcpState] : parsed_struct.dhcp_states()) {
     ACA_LOG_DEBUG("=====>parsing dhcp state: %s\n", dhcp_id.c_str());
+    dhcp_states.push_back(&current_DhcpState);
+  }
+
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(dhcp_states.size());
+  std::vector<int> workitem_rc(dhcp_states.size(), EXIT_SUCCESS);
 
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Dhcp_State_Handler::update_dhcp_state_workitem_v2, this,
-            current_DhcpState, std::ref(parsed_struct), std::ref(gsOperationReply)));
-  } // for (int i = 0; i < parsed_struct.dhcp_states_size(); i++)
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(dhcp_states.size(), 0, [&](size_t i) {
+    workitem_rc[i] = update_dhcp_state_workitem_v2(*dhcp_states[i], parsed_struct,
+                                                   workitem_replies[i]);
+  });
 
-  for (int i = 0; i < parsed_struct.dhcp_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.dhcp_states_size(); i++)
+  }
+
+  aca_goal_state_handler::Aca_Goal_State_Handler::get_instance().merge_goal_state_operation_replies(
+          gsOperationReply, workitem_replies);
 
   return overall_rc;
 }
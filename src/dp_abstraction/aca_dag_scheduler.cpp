@@ -0,0 +1,113 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_dag_scheduler.h"
+#include "aca_work_stealing_pool.h"
+#include <errno.h>
+#include <exception>
+
+using aca_work_stealing_pool::ACA_Work_Stealing_Pool;
+
+namespace aca_dag_scheduler
+{
+ACA_Dag_Scheduler::node_id ACA_Dag_Scheduler::add_node(std::function<int()> task)
+{
+  _nodes.emplace_back(new dag_node);
+  _nodes.back()->task = std::move(task);
+  return _nodes.size() - 1;
+}
+
+ACA_Dag_Scheduler::node_id ACA_Dag_Scheduler::add_join_node()
+{
+  return add_node(nullptr);
+}
+
+int ACA_Dag_Scheduler::add_dependency(node_id before, node_id after)
+{
+  if (after >= _nodes.size() || before >= after) {
+    ACA_LOG_ERROR("Invalid dependency from node %zu to node %zu, node count: %zu\n",
+                  before, after, _nodes.size());
+    return -EINVAL;
+  }
+
+  _nodes[before]->successors.push_back(after);
+  _nodes[after]->dependency_count++;
+  return EXIT_SUCCESS;
+}
+
+size_t ACA_Dag_Scheduler::node_count()
+{
+  return _nodes.size();
+}
+
+void ACA_Dag_Scheduler::record_rc(int rc)
+{
+  if (rc == EXIT_SUCCESS) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> rc_lock(_rc_mutex);
+  if (_overall_rc == EXIT_SUCCESS || _overall_rc == EINPROGRESS) {
+    _overall_rc = rc;
+  }
+}
+
+void ACA_Dag_Scheduler::run_nodes(const std::vector<node_id> &ready_nodes)
+{
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(ready_nodes.size(), 1, [&](size_t i) {
+    dag_node &node = *_nodes[ready_nodes[i]];
+
+    if (node.task) {
+      try {
+        record_rc(node.task());
+      } catch (const std::exception &e) {
+        ACA_LOG_ERROR("DAG node %zu threw: %s\n", ready_nodes[i], e.what());
+        record_rc(EXIT_FAILURE);
+      }
+    }
+
+    // the last dependency to finish starts the successor
+    std::vector<node_id> next_ready_nodes;
+    for (node_id successor : node.successors) {
+      if (--_nodes[successor]->remaining_dependencies == 0) {
+        next_ready_nodes.push_back(successor);
+      }
+    }
+
+    if (!next_ready_nodes.empty()) {
+      run_nodes(next_ready_nodes);
+    }
+  });
+}
+
+int ACA_Dag_Scheduler::run()
+{
+  std::vector<node_id> root_nodes;
+
+  _overall_rc = EXIT_SUCCESS;
+
+  for (node_id i = 0; i < _nodes.size(); i++) {
+    _nodes[i]->remaining_dependencies = _nodes[i]->dependency_count;
+    if (_nodes[i]->dependency_count == 0) {
+      root_nodes.push_back(i);
+    }
+  }
+
+  run_nodes(root_nodes);
+
+  return _overall_rc;
+}
+
+} // namespace aca_dag_scheduler
@@ -191,7 +191,7 @@ int ACA_Dataplane_Mizar::initialize()
   return EXIT_SUCCESS;
 }
 
-int ACA_Dataplane_Mizar::update_vpc_state_workitem(const VpcState current_VpcState,
+int ACA_Dataplane_Mizar::update_vpc_state_workitem(const VpcState &current_VpcState,
                                                    GoalStateOperationReply &gsOperationReply)
 {
   int transitd_command;
@@ -207,7 +207,7 @@ int ACA_Dataplane_Mizar::update_vpc_state_workitem(const VpcState current_VpcSta
 
   auto operation_start = chrono::steady_clock::now();
 
-  VpcConfiguration current_VpcConfiguration = current_VpcState.configuration();
+  const VpcConfiguration &current_VpcConfiguration = current_VpcState.configuration();
 
   switch (current_VpcState.operation_type()) {
   case OperationType::CREATE_UPDATE_SWITCH:
@@ -340,7 +340,7 @@ int ACA_Dataplane_Mizar::update_vpc_state_workitem(const VpcState current_VpcSta
   return overall_rc;
 }
 
-int ACA_Dataplane_Mizar::update_subnet_state_workitem(const SubnetState current_SubnetState,
+int ACA_Dataplane_Mizar::update_subnet_state_workitem(const SubnetState &current_SubnetState,
                                                       GoalStateOperationReply &gsOperationReply)
 {
   int transitd_command;
@@ -362,7 +362,7 @@ int ACA_Dataplane_Mizar::update_subnet_state_workitem(const SubnetState current_
 
   auto operation_start = chrono::steady_clock::now();
 
-  SubnetConfiguration current_SubnetConfiguration = current_SubnetState.configuration();
+  const SubnetConfiguration &current_SubnetConfiguration = current_SubnetState.configuration();
 
   switch (current_SubnetState.operation_type()) {
   case OperationType::INFO:
@@ -571,8 +571,9 @@ int ACA_Dataplane_Mizar::update_subnet_state_workitem(const SubnetState current_
   return overall_rc;
 }
 
-int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState current_PortState,
+int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState &current_PortState,
                                                     alcor::schema::GoalState &parsed_struct,
+                                                    const aca_goal_state_index::ACA_Goal_State_Index &goal_state_index,
                                                     GoalStateOperationReply &gsOperationReply)
 {
   int transitd_command;
@@ -605,7 +606,7 @@ int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState current_Port
 
   auto operation_start = chrono::steady_clock::now();
 
-  PortConfiguration current_PortConfiguration = current_PortState.configuration();
+  const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
 
   string veth_name_string = current_PortConfiguration.veth_name();
   aca_truncate_device_name(veth_name_string, VETH_NAME_TRUNCATION_LEN);
@@ -676,7 +677,7 @@ int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState current_Port
       // cache miss.
       // Look up the subnet configuration to query for tunnel_id
       for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-        SubnetConfiguration current_SubnetConfiguration =
+        const SubnetConfiguration &current_SubnetConfiguration =
                 parsed_struct.subnet_states(j).configuration();
 
         ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
@@ -812,7 +813,7 @@ int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState current_Port
 
       // Look up the subnet configuration
       for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-        SubnetConfiguration current_SubnetConfiguration =
+        const SubnetConfiguration &current_SubnetConfiguration =
                 parsed_struct.subnet_states(j).configuration();
 
         ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
@@ -1067,7 +1068,7 @@ int ACA_Dataplane_Mizar::update_port_state_workitem(const PortState current_Port
     try {
       // Look up the subnet info
       for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-        SubnetConfiguration current_SubnetConfiguration =
+        const SubnetConfiguration &current_SubnetConfiguration =
                 parsed_struct.subnet_states(j).configuration();
 
         ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
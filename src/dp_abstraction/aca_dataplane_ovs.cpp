@@ -23,50 +23,44 @@
 #include <errno.h>
 #include <arpa/inet.h>
 #include "aca_zeta_programming.h"
+#include "aca_goal_state_index.h"
 
 using namespace std;
 using namespace alcor::schema;
 using namespace aca_ovs_l2_programmer;
 using namespace aca_ovs_l3_programmer;
 using namespace aca_zeta_programming;
+using aca_goal_state_index::ACA_Goal_State_Index;
 
 namespace aca_dataplane_ovs
 {
-static bool aca_lookup_subnet_info(GoalState &parsed_struct, const string targeted_subnet_id,
+static bool aca_lookup_subnet_info(const ACA_Goal_State_Index &goal_state_index,
+                                   const string targeted_subnet_id,
                                    NetworkType &found_network_type,
                                    uint &found_tunnel_id, string &found_prefix_len)
 {
-  // TODO: cache the subnet information to a dictionary to provide
-  // a faster look up for the next run, only use the below loop for
-  // cache miss.
   // Look up the subnet configuration to query for tunnel_id
-  for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-    SubnetConfiguration current_SubnetConfiguration =
-            parsed_struct.subnet_states(j).configuration();
-
-    ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
-                  current_SubnetConfiguration.id().c_str());
-
-    if (parsed_struct.subnet_states(j).operation_type() == OperationType::INFO) {
-      if (current_SubnetConfiguration.id() == targeted_subnet_id) {
-        found_network_type = current_SubnetConfiguration.network_type();
-        found_tunnel_id = current_SubnetConfiguration.tunnel_id();
-        if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
-          throw std::invalid_argument("found_tunnel_id is invalid");
-        }
+  const SubnetState *found_SubnetState = goal_state_index.find_subnet(targeted_subnet_id);
 
-        string found_cidr = current_SubnetConfiguration.cidr();
-        size_t slash_pos = found_cidr.find('/');
-        if (slash_pos == string::npos) {
-          throw std::invalid_argument("'/' not found in cidr");
-        }
+  if (found_SubnetState != nullptr && found_SubnetState->operation_type() == OperationType::INFO) {
+    const SubnetConfiguration &current_SubnetConfiguration = found_SubnetState->configuration();
 
-        // substr can throw out_of_range and bad_alloc exceptions
-        found_prefix_len = found_cidr.substr(slash_pos + 1);
+    found_network_type = current_SubnetConfiguration.network_type();
+    found_tunnel_id = current_SubnetConfiguration.tunnel_id();
+    if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
+      throw std::invalid_argument("found_tunnel_id is invalid");
+    }
 
-        return true;
-      }
+    const string &found_cidr = current_SubnetConfiguration.cidr();
+    size_t slash_pos = found_cidr.find('/');
+    if (slash_pos == string::npos) {
+      throw std::invalid_argument("'/' not found in cidr");
     }
+
+    // substr can throw out_of_range and bad_alloc exceptions
+    found_prefix_len = found_cidr.substr(slash_pos + 1);
+
+    return true;
   }
 
   ACA_LOG_ERROR("Not able to find the info for port with subnet ID: %s.\n",
@@ -74,34 +68,17 @@ static bool aca_lookup_subnet_info(GoalState &parsed_struct, const string target
   return false;
 }
 
-static bool aca_lookup_zeta_gateway_info(GoalState &parsed_struct, const string targeted_vpc_id,
+static bool aca_lookup_zeta_gateway_info(const ACA_Goal_State_Index &goal_state_index,
+                                         const string targeted_vpc_id,
                                          GatewayConfiguration &found_zeta_gateway)
 {
-  // TODO: cache the zeta gateway information to a dictionary to provide
-  // a faster look up for the next run, only use the below loop for
-  // cache miss.
   // Look up the vpc configuration to query for zeta gateway
-  for (int i = 0; i < parsed_struct.vpc_states_size(); i++) {
-    VpcConfiguration current_VpcConfiguration =
-            parsed_struct.vpc_states(i).configuration();
-
-    ACA_LOG_DEBUG("current_VpcConfiguration Vpc ID: %s.\n",
-                  current_VpcConfiguration.id().c_str());
-
-    if (parsed_struct.vpc_states(i).operation_type() == OperationType::INFO) {
-      if (current_VpcConfiguration.id() == targeted_vpc_id) {
-        for (int j = 0; j < current_VpcConfiguration.gateway_ids_size(); j++) {
-          for (int k = 0; k < parsed_struct.gateway_states_size(); k++) {
-            if (parsed_struct.gateway_states(k).configuration().id() ==
-                        current_VpcConfiguration.gateway_ids(j) &&
-                parsed_struct.gateway_states(k).configuration().gateway_type() == ZETA) {
-              found_zeta_gateway = parsed_struct.gateway_states(k).configuration();
-              return true;
-            }
-          }
-        }
-      }
-    }
+  const GatewayConfiguration *found_GatewayConfiguration =
+          goal_state_index.find_zeta_gateway(targeted_vpc_id);
+
+  if (found_GatewayConfiguration != nullptr) {
+    found_zeta_gateway = *found_GatewayConfiguration;
+    return true;
   }
 
   ACA_LOG_ERROR("Not able to find zeta gateway info for port with vpc ID: %s.\n",
@@ -123,7 +100,7 @@ int ACA_Dataplane_OVS::update_vpc_state_workitem(const VpcState /* current_VpcSt
   return ENOSYS;
 }
 
-int ACA_Dataplane_OVS::update_subnet_state_workitem(const SubnetState current_SubnetState,
+int ACA_Dataplane_OVS::update_subnet_state_workitem(const SubnetState &current_SubnetState,
                                                     GoalStateOperationReply &gsOperationReply)
 {
   int overall_rc;
@@ -132,7 +109,7 @@ int ACA_Dataplane_OVS::update_subnet_state_workitem(const SubnetState current_Su
 
   auto operation_start = chrono::steady_clock::now();
 
-  SubnetConfiguration current_SubnetConfiguration = current_SubnetState.configuration();
+  const SubnetConfiguration &current_SubnetConfiguration = current_SubnetState.configuration();
 
   switch (current_SubnetState.operation_type()) {
   case OperationType::INFO:
@@ -160,8 +137,9 @@ int ACA_Dataplane_OVS::update_subnet_state_workitem(const SubnetState current_Su
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortState,
+int ACA_Dataplane_OVS::update_port_state_workitem(const PortState &current_PortState,
                                                   GoalState &parsed_struct,
+                                                  const ACA_Goal_State_Index &goal_state_index,
                                                   GoalStateOperationReply &gsOperationReply)
 {
   int overall_rc;
@@ -180,10 +158,10 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
 
   auto operation_start = chrono::steady_clock::now();
 
-  PortConfiguration current_PortConfiguration = current_PortState.configuration();
+  const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
 
   try {
-    // TODO: need to design the usage of current_PortConfiguration.revision_number()
+    // an already applied revision_number() is skipped by the goal state handler
     assert(current_PortConfiguration.revision_number() > 0);
 
     // TODO: handle current_PortConfiguration.admin_state_up = false
@@ -199,7 +177,7 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
     }
 
     if (!aca_lookup_subnet_info(
-                parsed_struct, current_PortConfiguration.fixed_ips(0).subnet_id(),
+                goal_state_index, current_PortConfiguration.fixed_ips(0).subnet_id(),
                 found_network_type, found_tunnel_id, found_prefix_len)) {
       ACA_LOG_ERROR("Not able to find the info for port with subnet ID: %s.\n",
                     current_PortConfiguration.fixed_ips(0).subnet_id().c_str());
@@ -207,7 +185,7 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
       goto EXIT;
     }
 
-    if (!aca_lookup_zeta_gateway_info(parsed_struct, current_PortConfiguration.vpc_id(),
+    if (!aca_lookup_zeta_gateway_info(goal_state_index, current_PortConfiguration.vpc_id(),
                                       found_zeta_gateway)) {
       // mark as warning for now to support the current workflow
       // the code should proceed assuming this is a non aux gateway (zeta) supported port
@@ -339,7 +317,7 @@ EXIT:
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortState,
+int ACA_Dataplane_OVS::update_port_state_workitem(const PortState &current_PortState,
                                                   GoalStateV2 &parsed_struct,
                                                   GoalStateOperationReply &gsOperationReply)
 {
@@ -359,10 +337,10 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
 
   auto operation_start = chrono::steady_clock::now();
 
-  PortConfiguration current_PortConfiguration = current_PortState.configuration();
+  const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
 
   try {
-    // TODO: need to design the usage of current_PortConfiguration.revision_number()
+    // an already applied revision_number() is skipped by the goal state handler
     assert(current_PortConfiguration.revision_number() > 0);
 
     // TODO: handle current_PortConfiguration.admin_state_up = false
@@ -382,8 +360,8 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
             current_PortConfiguration.fixed_ips(0).subnet_id());
 
     if (subnetStateFound != parsed_struct.subnet_states().end()) {
-      SubnetState current_SubnetState = subnetStateFound->second;
-      SubnetConfiguration current_SubnetConfiguration =
+      const SubnetState &current_SubnetState = subnetStateFound->second;
+      const SubnetConfiguration &current_SubnetConfiguration =
               current_SubnetState.configuration();
 
       ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
@@ -414,8 +392,8 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
             parsed_struct.vpc_states().find(current_PortConfiguration.vpc_id());
 
     if (vpcStateFound != parsed_struct.vpc_states().end()) {
-      VpcState current_VpcState = vpcStateFound->second;
-      VpcConfiguration current_VpcConfiguration = current_VpcState.configuration();
+      const VpcState &current_VpcState = vpcStateFound->second;
+      const VpcConfiguration &current_VpcConfiguration = current_VpcState.configuration();
 
       ACA_LOG_DEBUG("current_VpcConfiguration VPC ID: %s.\n",
                     current_VpcConfiguration.id().c_str());
@@ -425,7 +403,7 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
                 current_VpcConfiguration.gateway_ids(j));
 
         if (gatewayStateFound != parsed_struct.gateway_states().end()) {
-          GatewayState current_GatewayState = gatewayStateFound->second;
+          const GatewayState &current_GatewayState = gatewayStateFound->second;
           auto gateway_type = current_GatewayState.configuration().gateway_type();
 
           if (gateway_type == ZETA) {
@@ -551,15 +529,18 @@ int ACA_Dataplane_OVS::update_port_state_workitem(const PortState current_PortSt
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_NeighborState,
+int ACA_Dataplane_OVS::update_neighbor_state_workitem(const NeighborState &current_NeighborState,
                                                       GoalState &parsed_struct,
+                                                      const ACA_Goal_State_Index &goal_state_index,
                                                       GoalStateOperationReply &gsOperationReply)
 {
   int overall_rc;
-  struct sockaddr_in sa;
   string virtual_ip_address;
   string virtual_mac_address;
   string host_ip_address;
+  ipv4_addr virtual_ip;
+  mac_addr virtual_mac;
+  ipv4_addr host_ip;
   NetworkType found_network_type;
   uint found_tunnel_id = 0;
   string found_gateway_mac;
@@ -569,62 +550,56 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
 
   auto operation_start = chrono::steady_clock::now();
 
-  auto current_NeighborConfiguration = current_NeighborState.configuration();
+  auto &current_NeighborConfiguration = current_NeighborState.configuration();
 
   try {
     if (!aca_validate_fixed_ips_size(current_NeighborConfiguration.fixed_ips_size())) {
       throw std::invalid_argument("NeighborConfiguration.fixed_ips_size is less than zero");
     }
 
-    // TODO: need to design the usage of current_NeighborConfiguration.revision_number()
+    // an already applied revision_number() is skipped by the goal state handler
     assert(current_NeighborConfiguration.revision_number() > 0);
 
     for (int ip_index = 0;
          ip_index < current_NeighborConfiguration.fixed_ips_size(); ip_index++) {
-      auto current_fixed_ip = current_NeighborConfiguration.fixed_ips(ip_index);
+      auto &current_fixed_ip = current_NeighborConfiguration.fixed_ips(ip_index);
 
       if (current_fixed_ip.neighbor_type() == NeighborType::L2 ||
           current_fixed_ip.neighbor_type() == NeighborType::L3) {
+        // parse the addresses once, the typed values are used for the
+        // host lookup and the L3 tables, the strings for OVS commands
         virtual_ip_address = current_fixed_ip.ip_address();
-
-        // inet_pton returns 1 for success 0 for failure
-        if (inet_pton(AF_INET, virtual_ip_address.c_str(), &(sa.sin_addr)) != 1) {
+        if (!ipv4_addr::parse(virtual_ip_address, virtual_ip)) {
           throw std::invalid_argument("Virtual ip address is not in the expect format");
         }
 
         virtual_mac_address = current_NeighborConfiguration.mac_address();
-        if (!aca_validate_mac_address(virtual_mac_address.c_str())) {
+        if (!mac_addr::parse(virtual_mac_address, virtual_mac)) {
           throw std::invalid_argument("virtual_mac_address is invalid");
         }
 
         host_ip_address = current_NeighborConfiguration.host_ip_address();
-
-        // inet_pton returns 1 for success 0 for failure
-        if (inet_pton(AF_INET, host_ip_address.c_str(), &(sa.sin_addr)) != 1) {
+        if (!ipv4_addr::parse(host_ip_address, host_ip)) {
           throw std::invalid_argument("Neighbor host ip address is not in the expect format");
         }
 
         // Look up the subnet configuration to query for tunnel_id
-        for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-          SubnetConfiguration current_SubnetConfiguration =
-                  parsed_struct.subnet_states(j).configuration();
+        const SubnetState *found_SubnetState =
+                goal_state_index.find_subnet(current_fixed_ip.subnet_id());
 
-          ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
-                        current_SubnetConfiguration.id().c_str());
+        if (found_SubnetState != nullptr &&
+            found_SubnetState->operation_type() == OperationType::INFO) {
+          const SubnetConfiguration &current_SubnetConfiguration =
+                  found_SubnetState->configuration();
 
-          if (parsed_struct.subnet_states(j).operation_type() == OperationType::INFO) {
-            if (current_SubnetConfiguration.id() == current_fixed_ip.subnet_id()) {
-              found_network_type = current_SubnetConfiguration.network_type();
-
-              found_tunnel_id = current_SubnetConfiguration.tunnel_id();
-              if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
-                throw std::invalid_argument("found_tunnel_id is invalid");
-              }
+          found_network_type = current_SubnetConfiguration.network_type();
 
-              subnet_info_found = true;
-              break;
-            }
+          found_tunnel_id = current_SubnetConfiguration.tunnel_id();
+          if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
+            throw std::invalid_argument("found_tunnel_id is invalid");
           }
+
+          subnet_info_found = true;
         }
 
         if (!subnet_info_found) {
@@ -648,7 +623,7 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
 
           // only need to update L2 neighbor info if it is not on the same compute host
           bool is_neighbor_port_on_same_host =
-                  ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(host_ip_address);
+                  ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(host_ip);
 
           if (is_neighbor_port_on_same_host) {
             ACA_LOG_DEBUG("neighbor host: %s is on the same compute node, don't need to update L2 neighbor info.\n",
@@ -683,13 +658,13 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
                 overall_rc = ACA_OVS_L3_Programmer::get_instance().create_or_update_l3_neighbor(
                         current_NeighborConfiguration.id(),
                         current_NeighborConfiguration.vpc_id(),
-                        current_fixed_ip.subnet_id(), virtual_ip_address,
-                        virtual_mac_address, host_ip_address, found_tunnel_id,
+                        current_fixed_ip.subnet_id(), virtual_ip, virtual_mac,
+                        host_ip, found_tunnel_id,
                         culminative_dataplane_programming_time);
               } else if (current_NeighborState.operation_type() == OperationType::DELETE) {
                 overall_rc = ACA_OVS_L3_Programmer::get_instance().delete_l3_neighbor(
                         current_NeighborConfiguration.id(), current_fixed_ip.subnet_id(),
-                        virtual_ip_address, culminative_dataplane_programming_time);
+                        virtual_ip, culminative_dataplane_programming_time);
               } else {
                 ACA_LOG_ERROR("Invalid neighbor state operation type %d\n",
                               current_NeighborState.operation_type());
@@ -739,15 +714,17 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_NeighborState,
+int ACA_Dataplane_OVS::update_neighbor_state_workitem(const NeighborState &current_NeighborState,
                                                       GoalStateV2 &parsed_struct,
                                                       GoalStateOperationReply &gsOperationReply)
 {
   int overall_rc;
-  struct sockaddr_in sa;
   string virtual_ip_address;
   string virtual_mac_address;
   string host_ip_address;
+  ipv4_addr virtual_ip;
+  mac_addr virtual_mac;
+  ipv4_addr host_ip;
   NetworkType found_network_type;
   uint found_tunnel_id = 0;
   string found_gateway_mac;
@@ -767,7 +744,7 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
 
   auto init_time_vars_time = chrono::high_resolution_clock::now();
 
-  alcor::schema::NeighborConfiguration current_NeighborConfiguration =
+  const alcor::schema::NeighborConfiguration &current_NeighborConfiguration =
           current_NeighborState.configuration();
 
   got_neighbor_configuration_time = chrono::high_resolution_clock::now();
@@ -777,33 +754,31 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
       throw std::invalid_argument("NeighborConfiguration.fixed_ips_size is less than zero");
     }
     validate_fixed_ip_size_time = chrono::high_resolution_clock::now();
-    // TODO: need to design the usage of current_NeighborConfiguration.revision_number()
+    // an already applied revision_number() is skipped by the goal state handler
     assert(current_NeighborConfiguration.revision_number() > 0);
     assert_revision_number_time = chrono::high_resolution_clock::now();
     for (int ip_index = 0;
          ip_index < current_NeighborConfiguration.fixed_ips_size(); ip_index++) {
       ACA_LOG_DEBUG("In fixed ip loop, index: %ld\n", ip_index);
       fixed_ip_loop_start = chrono::high_resolution_clock::now();
-      auto current_fixed_ip = current_NeighborConfiguration.fixed_ips(ip_index);
+      auto &current_fixed_ip = current_NeighborConfiguration.fixed_ips(ip_index);
 
       if (current_fixed_ip.neighbor_type() == NeighborType::L2 ||
           current_fixed_ip.neighbor_type() == NeighborType::L3) {
+        // parse the addresses once, the typed values are used for the
+        // host lookup and the L3 tables, the strings for OVS commands
         virtual_ip_address = current_fixed_ip.ip_address();
-
-        // inet_pton returns 1 for success 0 for failure
-        if (inet_pton(AF_INET, virtual_ip_address.c_str(), &(sa.sin_addr)) != 1) {
+        if (!ipv4_addr::parse(virtual_ip_address, virtual_ip)) {
           throw std::invalid_argument("Virtual ip address is not in the expect format");
         }
 
         virtual_mac_address = current_NeighborConfiguration.mac_address();
-        if (!aca_validate_mac_address(virtual_mac_address.c_str())) {
+        if (!mac_addr::parse(virtual_mac_address, virtual_mac)) {
           throw std::invalid_argument("virtual_mac_address is invalid");
         }
 
         host_ip_address = current_NeighborConfiguration.host_ip_address();
-
-        // inet_pton returns 1 for success 0 for failure
-        if (inet_pton(AF_INET, host_ip_address.c_str(), &(sa.sin_addr)) != 1) {
+        if (!ipv4_addr::parse(host_ip_address, host_ip)) {
           throw std::invalid_argument("Neighbor host ip address is not in the expect format");
         }
 
@@ -812,8 +787,8 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
                 parsed_struct.subnet_states().find(current_fixed_ip.subnet_id());
 
         if (subnetStateFound != parsed_struct.subnet_states().end()) {
-          SubnetState current_SubnetState = subnetStateFound->second;
-          SubnetConfiguration current_SubnetConfiguration =
+          const SubnetState &current_SubnetState = subnetStateFound->second;
+          const SubnetConfiguration &current_SubnetConfiguration =
                   current_SubnetState.configuration();
 
           ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
@@ -851,7 +826,7 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
 
           // only need to update L2 neighbor info if it is not on the same compute host
           bool is_neighbor_port_on_same_host =
-                  ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(host_ip_address);
+                  ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(host_ip);
           determined_same_host_time = chrono::high_resolution_clock::now();
 
           if (is_neighbor_port_on_same_host) {
@@ -887,13 +862,13 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
                 overall_rc = ACA_OVS_L3_Programmer::get_instance().create_or_update_l3_neighbor(
                         current_NeighborConfiguration.id(),
                         current_NeighborConfiguration.vpc_id(),
-                        current_fixed_ip.subnet_id(), virtual_ip_address,
-                        virtual_mac_address, host_ip_address, found_tunnel_id,
+                        current_fixed_ip.subnet_id(), virtual_ip, virtual_mac,
+                        host_ip, found_tunnel_id,
                         culminative_dataplane_programming_time);
               } else if (current_NeighborState.operation_type() == OperationType::DELETE) {
                 overall_rc = ACA_OVS_L3_Programmer::get_instance().delete_l3_neighbor(
                         current_NeighborConfiguration.id(), current_fixed_ip.subnet_id(),
-                        virtual_ip_address, culminative_dataplane_programming_time);
+                        virtual_ip, culminative_dataplane_programming_time);
               } else {
                 ACA_LOG_ERROR("Invalid neighbor state operation type %d\n",
                               current_NeighborState.operation_type());
@@ -983,8 +958,9 @@ int ACA_Dataplane_OVS::update_neighbor_state_workitem(NeighborState current_Neig
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterState,
+int ACA_Dataplane_OVS::update_router_state_workitem(const RouterState &current_RouterState,
                                                     GoalState &parsed_struct,
+                                                    const ACA_Goal_State_Index &goal_state_index,
                                                     GoalStateOperationReply &gsOperationReply)
 {
   int overall_rc;
@@ -993,9 +969,9 @@ int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterSt
 
   auto operation_start = chrono::steady_clock::now();
 
-  RouterConfiguration current_RouterConfiguration = current_RouterState.configuration();
+  const RouterConfiguration &current_RouterConfiguration = current_RouterState.configuration();
 
-  // TODO: need to design the usage of current_RouterConfiguration.revision_number()
+  // an already applied revision_number() is skipped by the goal state handler
   assert(current_RouterConfiguration.revision_number() > 0);
 
   switch (current_RouterState.operation_type()) {
@@ -1005,7 +981,8 @@ int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterSt
     [[fallthrough]];
   case OperationType::INFO:
     overall_rc = ACA_OVS_L3_Programmer::get_instance().create_or_update_router(
-            current_RouterConfiguration, parsed_struct, culminative_dataplane_programming_time);
+            current_RouterConfiguration, parsed_struct, goal_state_index,
+            culminative_dataplane_programming_time);
     break;
 
   case OperationType::DELETE:
@@ -1040,7 +1017,7 @@ int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterSt
   return overall_rc;
 }
 
-int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterState,
+int ACA_Dataplane_OVS::update_router_state_workitem(const RouterState &current_RouterState,
                                                     GoalStateV2 &parsed_struct,
                                                     GoalStateOperationReply &gsOperationReply)
 {
@@ -1050,9 +1027,9 @@ int ACA_Dataplane_OVS::update_router_state_workitem(RouterState current_RouterSt
 
   auto operation_start = chrono::steady_clock::now();
 
-  RouterConfiguration current_RouterConfiguration = current_RouterState.configuration();
+  const RouterConfiguration &current_RouterConfiguration = current_RouterState.configuration();
 
-  // TODO: need to design the usage of current_RouterConfiguration.revision_number()
+  // an already applied revision_number() is skipped by the goal state handler
   assert(current_RouterConfiguration.revision_number() > 0);
 
   switch (current_RouterState.operation_type()) {
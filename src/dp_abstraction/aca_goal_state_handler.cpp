@@ -15,15 +15,69 @@
 #include "aca_log.h"
 #include "aca_dataplane_ovs.h"
 #include "aca_goal_state_handler.h"
+#include "aca_work_stealing_pool.h"
+#include "aca_revision_tracker.h"
+#include "aca_update_coalescer.h"
 #include "goalstateprovisioner.grpc.pb.h"
-#include <future>
 
 using namespace alcor::schema;
-
-std::mutex gs_reply_mutex; // mutex for writing gs reply object
+using aca_work_stealing_pool::ACA_Work_Stealing_Pool;
+using aca_revision_tracker::ACA_Revision_Tracker;
+using aca_update_coalescer::ACA_Update_Coalescer;
+using aca_goal_state_index::ACA_Goal_State_Index;
 
 namespace aca_goal_state_handler
 {
+static const SubnetState *aca_find_subnet_state(const ACA_Goal_State_Index &goal_state_index,
+                                                const std::string &subnet_id)
+{
+  return goal_state_index.find_subnet(subnet_id);
+}
+
+static const SubnetState *aca_find_subnet_state(const GoalStateV2 &parsed_struct,
+                                                const std::string &subnet_id)
+{
+  auto subnet_state_it = parsed_struct.subnet_states().find(subnet_id);
+  return (subnet_state_it == parsed_struct.subnet_states().end()) ? nullptr :
+                                                                     &subnet_state_it->second;
+}
+
+// VPCs whose vlan the flows of a neighbor match, recorded with its revision
+template <typename Subnet_States>
+static std::vector<uint32_t>
+aca_get_neighbor_tunnel_ids(const NeighborConfiguration &current_NeighborConfiguration,
+                            const Subnet_States &subnet_states)
+{
+  std::vector<uint32_t> tunnel_ids;
+
+  for (auto &current_fixed_ip : current_NeighborConfiguration.fixed_ips()) {
+    const SubnetState *current_SubnetState =
+            aca_find_subnet_state(subnet_states, current_fixed_ip.subnet_id());
+    if (current_SubnetState != nullptr) {
+      tunnel_ids.push_back(current_SubnetState->configuration().tunnel_id());
+    }
+  }
+  return tunnel_ids;
+}
+
+// VPCs whose vlan the flows of a router match, recorded with its revision
+template <typename Subnet_States>
+static std::vector<uint32_t>
+aca_get_router_tunnel_ids(const RouterConfiguration &current_RouterConfiguration,
+                          const Subnet_States &subnet_states)
+{
+  std::vector<uint32_t> tunnel_ids;
+
+  for (auto &current_subnet_routing_table : current_RouterConfiguration.subnet_routing_tables()) {
+    const SubnetState *current_SubnetState =
+            aca_find_subnet_state(subnet_states, current_subnet_routing_table.subnet_id());
+    if (current_SubnetState != nullptr) {
+      tunnel_ids.push_back(current_SubnetState->configuration().tunnel_id());
+    }
+  }
+  return tunnel_ids;
+}
+
 Aca_Goal_State_Handler::Aca_Goal_State_Handler()
 {
   ACA_LOG_INFO("%s", "Goal State Handler: initialize\n");
@@ -57,7 +111,7 @@ Aca_Goal_State_Handler &Aca_Goal_State_Handler::get_instance()
 }
 
 // not being used now and the forseeable future
-// int Aca_Goal_State_Handler::update_vpc_state_workitem(const VpcState current_VpcState,
+// int Aca_Goal_State_Handler::update_vpc_state_workitem(const VpcState &current_VpcState,
 //                                                       GoalStateOperationReply &gsOperationReply)
 // {
 //   return this->core_net_programming_if->update_vpc_state_workitem(
@@ -91,7 +145,7 @@ Aca_Goal_State_Handler &Aca_Goal_State_Handler::get_instance()
 //   return overall_rc;
 // }
 
-// int Aca_Goal_State_Handler::update_subnet_state_workitem(const SubnetState current_SubnetState,
+// int Aca_Goal_State_Handler::update_subnet_state_workitem(const SubnetState &current_SubnetState,
 //                                                          GoalStateOperationReply &gsOperationReply)
 // {
 //   return this->core_net_programming_if->update_subnet_state_workitem(
@@ -125,216 +179,357 @@ Aca_Goal_State_Handler &Aca_Goal_State_Handler::get_instance()
 //   return overall_rc;
 // }
 
-int Aca_Goal_State_Handler::update_port_state_workitem(const PortState current_PortState,
+int Aca_Goal_State_Handler::update_port_state_workitem(const PortState &current_PortState,
                                                        GoalState &parsed_struct,
+                                                       const ACA_Goal_State_Index &goal_state_index,
                                                        GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_port_state_workitem(
-          current_PortState, std::ref(parsed_struct), std::ref(gsOperationReply));
+  const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
+
+  if (skip_superseded_update(gsOperationReply, current_PortConfiguration.id(), PORT,
+                             current_PortState.operation_type(),
+                             current_PortConfiguration.revision_number()) ||
+      skip_applied_revision(gsOperationReply, current_PortConfiguration.id(), PORT,
+                            current_PortState.operation_type(),
+                            current_PortConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_port_state_workitem(
+          current_PortState, std::ref(parsed_struct), goal_state_index,
+          std::ref(gsOperationReply));
+
+  record_applied_revision(current_PortConfiguration.id(), PORT,
+                          current_PortState.operation_type(),
+                          current_PortConfiguration.revision_number(), rc,
+                          revision_generation);
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_port_states(GoalState &parsed_struct,
+                                               const ACA_Goal_State_Index &goal_state_index,
                                                GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
+  int workitem_count = parsed_struct.port_states_size();
   int overall_rc = EXIT_SUCCESS;
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(workitem_count);
+  std::vector<int> workitem_rc(workitem_count, EXIT_SUCCESS);
 
-  for (int i = 0; i < parsed_struct.port_states_size(); i++) {
-    ACA_LOG_DEBUG("=====>parsing port states #%d\n", i);
-
-    PortState current_PortState = parsed_struct.port_states(i);
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(workitem_count, 0, [&](size_t i) {
+    ACA_LOG_DEBUG("=====>parsing port states #%zu\n", i);
 
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_port_state_workitem, this,
-            current_PortState, std::ref(parsed_struct), std::ref(gsOperationReply)));
+    workitem_rc[i] = update_port_state_workitem(parsed_struct.port_states(i),
+                                                parsed_struct, goal_state_index,
+                                                workitem_replies[i]);
+  });
 
-    // keeping below just in case if we want to call it serially
-    // rc = update_port_state_workitem(current_PortState, parsed_struct, gsOperationReply);
-    // if (rc != EXIT_SUCCESS)
-    //   overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.port_states_size(); i++)
-
-  for (int i = 0; i < parsed_struct.port_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.port_states_size(); i++)
+  }
+
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
 
   return overall_rc;
 }
 
 // function overloading doesn't work when called by function pointer in update_port_states
 // therefore, naming this function as "v2"
-int Aca_Goal_State_Handler::update_port_state_workitem_v2(const PortState current_PortState,
+int Aca_Goal_State_Handler::update_port_state_workitem_v2(const PortState &current_PortState,
                                                           GoalStateV2 &parsed_struct,
                                                           GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_port_state_workitem(
+  const PortConfiguration &current_PortConfiguration = current_PortState.configuration();
+
+  if (skip_superseded_update(gsOperationReply, current_PortConfiguration.id(), PORT,
+                             current_PortState.operation_type(),
+                             current_PortConfiguration.revision_number()) ||
+      skip_applied_revision(gsOperationReply, current_PortConfiguration.id(), PORT,
+                            current_PortState.operation_type(),
+                            current_PortConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_port_state_workitem(
           current_PortState, std::ref(parsed_struct), std::ref(gsOperationReply));
+
+  record_applied_revision(current_PortConfiguration.id(), PORT,
+                          current_PortState.operation_type(),
+                          current_PortConfiguration.revision_number(), rc,
+                          revision_generation);
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_port_states(GoalStateV2 &parsed_struct,
                                                GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
   int overall_rc = EXIT_SUCCESS;
+  std::vector<const PortState *> port_states;
 
+  port_states.reserve(parsed_struct.port_states_size());
   // below is a c++ 17 feature
   for (auto &[port_id, current_PortState] : parsed_struct.port_states()) {
     ACA_LOG_DEBUG("=====>parsing port state: %s\n", port_id.c_str());
+    port_states.push_back(&current_PortState);
+  }
 
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_port_state_workitem_v2, this,
-            current_PortState, std::ref(parsed_struct), std::ref(gsOperationReply)));
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(port_states.size());
+  std::vector<int> workitem_rc(port_states.size(), EXIT_SUCCESS);
 
-    // keeping below just in case if we want to call it serially
-    // rc = update_port_state_workitem(current_PortState, parsed_struct, gsOperationReply);
-    // if (rc != EXIT_SUCCESS)
-    //   overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.port_states_size(); i++)
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(port_states.size(), 0, [&](size_t i) {
+    workitem_rc[i] = update_port_state_workitem_v2(*port_states[i], parsed_struct,
+                                                   workitem_replies[i]);
+  });
 
-  for (int i = 0; i < parsed_struct.port_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
-  } // for (int i = 0; i < parsed_struct.port_states_size(); i++)
+  }
+
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
 
   return overall_rc;
 }
 
-int Aca_Goal_State_Handler::update_neighbor_state_workitem(const NeighborState current_NeighborState,
+int Aca_Goal_State_Handler::update_neighbor_state_workitem(const NeighborState &current_NeighborState,
                                                            GoalState &parsed_struct,
+                                                           const ACA_Goal_State_Index &goal_state_index,
                                                            GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_neighbor_state_workitem(
-          current_NeighborState, std::ref(parsed_struct), std::ref(gsOperationReply));
+  const NeighborConfiguration &current_NeighborConfiguration =
+          current_NeighborState.configuration();
+
+  if (skip_superseded_update(gsOperationReply, current_NeighborConfiguration.id(), NEIGHBOR,
+                             current_NeighborState.operation_type(),
+                             current_NeighborConfiguration.revision_number()) ||
+      skip_applied_revision(gsOperationReply, current_NeighborConfiguration.id(), NEIGHBOR,
+                            current_NeighborState.operation_type(),
+                            current_NeighborConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_neighbor_state_workitem(
+          current_NeighborState, std::ref(parsed_struct), goal_state_index,
+          std::ref(gsOperationReply));
+
+  record_applied_revision(current_NeighborConfiguration.id(), NEIGHBOR,
+                          current_NeighborState.operation_type(),
+                          current_NeighborConfiguration.revision_number(), rc,
+                          revision_generation,
+                          aca_get_neighbor_tunnel_ids(current_NeighborConfiguration,
+                                                      goal_state_index));
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_neighbor_states(GoalState &parsed_struct,
+                                                   const ACA_Goal_State_Index &goal_state_index,
                                                    GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
+  int workitem_count = parsed_struct.neighbor_states_size();
   int overall_rc = EXIT_SUCCESS;
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(workitem_count);
+  std::vector<int> workitem_rc(workitem_count, EXIT_SUCCESS);
 
-  for (int i = 0; i < parsed_struct.neighbor_states_size(); i++) {
-    ACA_LOG_DEBUG("=====>parsing neighbor states #%d\n", i);
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(workitem_count, 0, [&](size_t i) {
+    ACA_LOG_DEBUG("=====>parsing neighbor states #%zu\n", i);
 
-    NeighborState current_NeighborState = parsed_struct.neighbor_states(i);
-
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_neighbor_state_workitem,
-            this, current_NeighborState, std::ref(parsed_struct),
-            std::ref(gsOperationReply)));
-  }
+    workitem_rc[i] = update_neighbor_state_workitem(parsed_struct.neighbor_states(i),
+                                                    parsed_struct, goal_state_index,
+                                                    workitem_replies[i]);
+  });
 
-  for (int i = 0; i < parsed_struct.neighbor_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
   }
 
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
+
   return overall_rc;
 }
 
-int Aca_Goal_State_Handler::update_router_state_workitem(const RouterState current_RouterState,
+int Aca_Goal_State_Handler::update_router_state_workitem(const RouterState &current_RouterState,
                                                          GoalState &parsed_struct,
+                                                         const ACA_Goal_State_Index &goal_state_index,
                                                          GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_router_state_workitem(
-          current_RouterState, std::ref(parsed_struct), std::ref(gsOperationReply));
+  const RouterConfiguration &current_RouterConfiguration = current_RouterState.configuration();
+
+  if (skip_applied_revision(gsOperationReply, current_RouterConfiguration.id(), ROUTER,
+                            current_RouterState.operation_type(),
+                            current_RouterConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_router_state_workitem(
+          current_RouterState, std::ref(parsed_struct), goal_state_index,
+          std::ref(gsOperationReply));
+
+  record_applied_revision(current_RouterConfiguration.id(), ROUTER,
+                          current_RouterState.operation_type(),
+                          current_RouterConfiguration.revision_number(), rc,
+                          revision_generation,
+                          aca_get_router_tunnel_ids(current_RouterConfiguration,
+                                                    goal_state_index));
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_router_states(GoalState &parsed_struct,
+                                                 const ACA_Goal_State_Index &goal_state_index,
                                                  GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
+  int workitem_count = parsed_struct.router_states_size();
   int overall_rc = EXIT_SUCCESS;
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(workitem_count);
+  std::vector<int> workitem_rc(workitem_count, EXIT_SUCCESS);
 
-  for (int i = 0; i < parsed_struct.router_states_size(); i++) {
-    ACA_LOG_DEBUG("=====>parsing router states #%d\n", i);
-
-    RouterState current_RouterState = parsed_struct.router_states(i);
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(workitem_count, 0, [&](size_t i) {
+    ACA_LOG_DEBUG("=====>parsing router states #%zu\n", i);
 
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_router_state_workitem, this,
-            current_RouterState, std::ref(parsed_struct), std::ref(gsOperationReply)));
-  }
+    workitem_rc[i] = update_router_state_workitem(parsed_struct.router_states(i),
+                                                  parsed_struct, goal_state_index,
+                                                  workitem_replies[i]);
+  });
 
-  for (int i = 0; i < parsed_struct.router_states_size(); i++) {
-    rc = workitem_future[i].get();
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
   }
 
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
+
   return overall_rc;
 }
 
 int Aca_Goal_State_Handler::update_neighbor_state_workitem_v2(
-        const NeighborState current_NeighborState, GoalStateV2 &parsed_struct,
+        const NeighborState &current_NeighborState, GoalStateV2 &parsed_struct,
         GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_neighbor_state_workitem(
+  const NeighborConfiguration &current_NeighborConfiguration =
+          current_NeighborState.configuration();
+
+  if (skip_superseded_update(gsOperationReply, current_NeighborConfiguration.id(), NEIGHBOR,
+                             current_NeighborState.operation_type(),
+                             current_NeighborConfiguration.revision_number()) ||
+      skip_applied_revision(gsOperationReply, current_NeighborConfiguration.id(), NEIGHBOR,
+                            current_NeighborState.operation_type(),
+                            current_NeighborConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_neighbor_state_workitem(
           current_NeighborState, std::ref(parsed_struct), std::ref(gsOperationReply));
+
+  record_applied_revision(current_NeighborConfiguration.id(), NEIGHBOR,
+                          current_NeighborState.operation_type(),
+                          current_NeighborConfiguration.revision_number(), rc,
+                          revision_generation,
+                          aca_get_neighbor_tunnel_ids(current_NeighborConfiguration,
+                                                      parsed_struct));
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_neighbor_states(GoalStateV2 &parsed_struct,
                                                    GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
   int overall_rc = EXIT_SUCCESS;
+  std::vector<const NeighborState *> neighbor_states;
 
+  neighbor_states.reserve(parsed_struct.neighbor_states_size());
+  // below is a c++ 17 feature
   for (auto &[neighbor_id, current_NeighborState] : parsed_struct.neighbor_states()) {
     ACA_LOG_DEBUG("=====>parsing neighbor state: %s\n", neighbor_id.c_str());
-
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_neighbor_state_workitem_v2,
-            this, current_NeighborState, std::ref(parsed_struct),
-            std::ref(gsOperationReply)));
+    neighbor_states.push_back(&current_NeighborState);
   }
 
-  for (int i = 0; i < parsed_struct.neighbor_states_size(); i++) {
-    rc = workitem_future[i].get();
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(neighbor_states.size());
+  std::vector<int> workitem_rc(neighbor_states.size(), EXIT_SUCCESS);
+
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(neighbor_states.size(), 0, [&](size_t i) {
+    workitem_rc[i] = update_neighbor_state_workitem_v2(*neighbor_states[i], parsed_struct,
+                                                       workitem_replies[i]);
+  });
+
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
   }
 
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
+
   return overall_rc;
 }
 
-int Aca_Goal_State_Handler::update_router_state_workitem_v2(const RouterState current_RouterState,
+int Aca_Goal_State_Handler::update_router_state_workitem_v2(const RouterState &current_RouterState,
                                                             GoalStateV2 &parsed_struct,
                                                             GoalStateOperationReply &gsOperationReply)
 {
-  return this->core_net_programming_if->update_router_state_workitem(
+  const RouterConfiguration &current_RouterConfiguration = current_RouterState.configuration();
+
+  if (skip_applied_revision(gsOperationReply, current_RouterConfiguration.id(), ROUTER,
+                            current_RouterState.operation_type(),
+                            current_RouterConfiguration.revision_number())) {
+    return EXIT_SUCCESS;
+  }
+
+  uint64_t revision_generation = get_revision_generation();
+  int rc = this->core_net_programming_if->update_router_state_workitem(
           current_RouterState, std::ref(parsed_struct), std::ref(gsOperationReply));
+
+  record_applied_revision(current_RouterConfiguration.id(), ROUTER,
+                          current_RouterState.operation_type(),
+                          current_RouterConfiguration.revision_number(), rc,
+                          revision_generation,
+                          aca_get_router_tunnel_ids(current_RouterConfiguration,
+                                                    parsed_struct));
+
+  return rc;
 }
 
 int Aca_Goal_State_Handler::update_router_states(GoalStateV2 &parsed_struct,
                                                  GoalStateOperationReply &gsOperationReply)
 {
-  std::vector<std::future<int> > workitem_future;
-  int rc;
   int overall_rc = EXIT_SUCCESS;
+  std::vector<const RouterState *> router_states;
 
+  router_states.reserve(parsed_struct.router_states_size());
+  // below is a c++ 17 feature
   for (auto &[router_id, current_RouterState] : parsed_struct.router_states()) {
     ACA_LOG_DEBUG("=====>parsing router state: %s\n", router_id.c_str());
-
-    workitem_future.push_back(std::async(
-            std::launch::async, &Aca_Goal_State_Handler::update_router_state_workitem_v2, this,
-            current_RouterState, std::ref(parsed_struct), std::ref(gsOperationReply)));
+    router_states.push_back(&current_RouterState);
   }
 
-  for (int i = 0; i < parsed_struct.router_states_size(); i++) {
-    rc = workitem_future[i].get();
+  // each workitem appends to its own reply, merged below once all of them are done
+  std::vector<GoalStateOperationReply> workitem_replies(router_states.size());
+  std::vector<int> workitem_rc(router_states.size(), EXIT_SUCCESS);
+
+  ACA_Work_Stealing_Pool::get_instance().parallel_for(router_states.size(), 0, [&](size_t i) {
+    workitem_rc[i] = update_router_state_workitem_v2(*router_states[i], parsed_struct,
+                                                     workitem_replies[i]);
+  });
+
+  for (int rc : workitem_rc) {
     if (rc != EXIT_SUCCESS)
       overall_rc = rc;
   }
 
+  merge_goal_state_operation_replies(gsOperationReply, workitem_replies);
+
   return overall_rc;
 }
 
@@ -366,9 +561,7 @@ void Aca_Goal_State_Handler::add_goal_state_operation_status(
                 culminative_network_configuration_time);
   ACA_LOG_DEBUG("gsOperationReply - total_operation_time: %lu\n", state_elapse_time);
 
-  // -----critical section starts-----
-  // (exclusive write access to gsOperationReply signaled by locking gs_reply_mutex):
-  gs_reply_mutex.lock();
+  // gsOperationReply is owned by the calling workitem, no locking needed
   GoalStateOperationReply_GoalStateOperationStatus *new_operation_statuses =
           gsOperationReply.add_operation_statuses();
   new_operation_statuses->set_resource_id(id);
@@ -378,8 +571,194 @@ void Aca_Goal_State_Handler::add_goal_state_operation_status(
   new_operation_statuses->set_dataplane_programming_time(culminative_dataplane_programming_time);
   new_operation_statuses->set_network_configuration_time(culminative_network_configuration_time);
   new_operation_statuses->set_state_elapse_time(state_elapse_time);
-  gs_reply_mutex.unlock();
-  // -----critical section ends-----
+}
+
+// only the full replacements are coalesced, an UPDATE is neither skipped nor allowed to
+// supersede anything: for a port it becomes a CREATE, a DELETE or nothing depending on
+// device_id and device_owner
+static bool aca_get_coalescer_operation(OperationType operation_type,
+                                        ACA_Update_Coalescer::Operation &operation)
+{
+  switch (operation_type) {
+  case OperationType::CREATE:
+    operation = ACA_Update_Coalescer::CREATE_OPERATION;
+    return true;
+  case OperationType::DELETE:
+    operation = ACA_Update_Coalescer::DELETE_OPERATION;
+    return true;
+  default:
+    return false;
+  }
+}
+
+// works for the port and neighbor states of both GoalState and GoalStateV2
+template <class ResourceState>
+static void aca_add_pending_update(ResourceType resource_type, const ResourceState &current_State)
+{
+  ACA_Update_Coalescer::Operation operation;
+
+  if (aca_get_coalescer_operation(current_State.operation_type(), operation)) {
+    ACA_Update_Coalescer::get_instance().add_pending(
+            resource_type, current_State.configuration().id(),
+            current_State.configuration().revision_number(), operation);
+  }
+}
+
+template <class ResourceState>
+static void aca_remove_pending_update(ResourceType resource_type,
+                                      const ResourceState &current_State)
+{
+  ACA_Update_Coalescer::Operation operation;
+
+  if (aca_get_coalescer_operation(current_State.operation_type(), operation)) {
+    ACA_Update_Coalescer::get_instance().remove_pending(
+            resource_type, current_State.configuration().id(),
+            current_State.configuration().revision_number());
+  }
+}
+
+void Aca_Goal_State_Handler::add_pending_updates(const GoalState &parsed_struct)
+{
+  for (auto &current_PortState : parsed_struct.port_states()) {
+    aca_add_pending_update(PORT, current_PortState);
+  }
+  for (auto &current_NeighborState : parsed_struct.neighbor_states()) {
+    aca_add_pending_update(NEIGHBOR, current_NeighborState);
+  }
+}
+
+void Aca_Goal_State_Handler::add_pending_updates(const GoalStateV2 &parsed_struct)
+{
+  for (auto &port_state_entry : parsed_struct.port_states()) {
+    aca_add_pending_update(PORT, port_state_entry.second);
+  }
+  for (auto &neighbor_state_entry : parsed_struct.neighbor_states()) {
+    aca_add_pending_update(NEIGHBOR, neighbor_state_entry.second);
+  }
+}
+
+void Aca_Goal_State_Handler::remove_pending_updates(const GoalState &parsed_struct)
+{
+  for (auto &current_PortState : parsed_struct.port_states()) {
+    aca_remove_pending_update(PORT, current_PortState);
+  }
+  for (auto &current_NeighborState : parsed_struct.neighbor_states()) {
+    aca_remove_pending_update(NEIGHBOR, current_NeighborState);
+  }
+}
+
+void Aca_Goal_State_Handler::remove_pending_updates(const GoalStateV2 &parsed_struct)
+{
+  for (auto &port_state_entry : parsed_struct.port_states()) {
+    aca_remove_pending_update(PORT, port_state_entry.second);
+  }
+  for (auto &neighbor_state_entry : parsed_struct.neighbor_states()) {
+    aca_remove_pending_update(NEIGHBOR, neighbor_state_entry.second);
+  }
+}
+
+bool Aca_Goal_State_Handler::skip_superseded_update(GoalStateOperationReply &gsOperationReply,
+                                                    const std::string &id,
+                                                    ResourceType resource_type,
+                                                    OperationType operation_type,
+                                                    uint32_t revision_number)
+{
+  ACA_Update_Coalescer::Operation operation;
+
+  if (!aca_get_coalescer_operation(operation_type, operation)) {
+    return false;
+  }
+
+  uint32_t applied_revision =
+          ACA_Revision_Tracker::get_instance().get_applied_revision(resource_type, id);
+  auto decision = ACA_Update_Coalescer::get_instance().decide(
+          resource_type, id, revision_number, operation, applied_revision);
+  if (decision == ACA_Update_Coalescer::APPLY) {
+    return false;
+  }
+
+  ACA_LOG_DEBUG("Resource type: %d, id: %s at revision %u %s, skipping\n", resource_type,
+                id.c_str(), revision_number,
+                (decision == ACA_Update_Coalescer::SKIP_CANCELLED) ? "cancelled out by its create" :
+                                                                      "superseded by a newer update");
+
+  add_goal_state_operation_status(gsOperationReply, id, resource_type, operation_type,
+                                  EXIT_SUCCESS, 0, 0, 0);
+  return true;
+}
+
+// only operations programming the resource are worth skipping,
+// a delete is always carried out
+static bool aca_is_revisioned_operation(OperationType operation_type)
+{
+  return operation_type == OperationType::CREATE || operation_type == OperationType::UPDATE ||
+         operation_type == OperationType::INFO;
+}
+
+bool Aca_Goal_State_Handler::skip_applied_revision(GoalStateOperationReply &gsOperationReply,
+                                                   const std::string &id,
+                                                   ResourceType resource_type,
+                                                   OperationType operation_type,
+                                                   uint32_t revision_number)
+{
+  if (!aca_is_revisioned_operation(operation_type) ||
+      !ACA_Revision_Tracker::get_instance().is_applied(resource_type, id, revision_number)) {
+    return false;
+  }
+
+  ACA_LOG_DEBUG("Resource type: %d, id: %s already applied at revision %u, skipping\n",
+                resource_type, id.c_str(), revision_number);
+
+  add_goal_state_operation_status(gsOperationReply, id, resource_type, operation_type,
+                                  EXIT_SUCCESS, 0, 0, 0);
+  return true;
+}
+
+uint64_t Aca_Goal_State_Handler::get_revision_generation()
+{
+  return ACA_Revision_Tracker::get_instance().get_generation();
+}
+
+void Aca_Goal_State_Handler::record_applied_revision(const std::string &id,
+                                                     ResourceType resource_type,
+                                                     OperationType operation_type,
+                                                     uint32_t revision_number, int operation_rc,
+                                                     uint64_t revision_generation,
+                                                     const std::vector<uint32_t> &tunnel_ids)
+{
+  if (operation_rc == EXIT_SUCCESS && aca_is_revisioned_operation(operation_type)) {
+    // dropped if the dataplane was reset while the workitem was programming
+    ACA_Revision_Tracker::get_instance().record_applied(resource_type, id, revision_number,
+                                                        revision_generation, tunnel_ids);
+  } else if (operation_rc != EXIT_SUCCESS || operation_type == OperationType::DELETE) {
+    // the dataplane state is unknown after a failure, let the next revision go through
+    ACA_Revision_Tracker::get_instance().forget(resource_type, id);
+  }
+}
+
+void Aca_Goal_State_Handler::merge_goal_state_operation_replies(
+        GoalStateOperationReply &gsOperationReply,
+        std::vector<GoalStateOperationReply> &workitem_replies)
+{
+  int total_operation_statuses = gsOperationReply.operation_statuses_size();
+  for (auto &workitem_reply : workitem_replies) {
+    total_operation_statuses += workitem_reply.operation_statuses_size();
+  }
+
+  auto *operation_statuses = gsOperationReply.mutable_operation_statuses();
+  operation_statuses->Reserve(total_operation_statuses);
+
+  // move the status messages over instead of copying them
+  std::vector<GoalStateOperationReply_GoalStateOperationStatus *> extracted_statuses;
+  for (auto &workitem_reply : workitem_replies) {
+    int statuses_size = workitem_reply.operation_statuses_size();
+    extracted_statuses.resize(statuses_size);
+    workitem_reply.mutable_operation_statuses()->ExtractSubrange(
+            0, statuses_size, extracted_statuses.data());
+    for (auto *operation_status : extracted_statuses) {
+      operation_statuses->AddAllocated(operation_status);
+    }
+  }
 }
 
 } // namespace aca_goal_state_handler
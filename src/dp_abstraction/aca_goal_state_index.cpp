@@ -0,0 +1,95 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_goal_state_index.h"
+
+using namespace alcor::schema;
+
+namespace aca_goal_state_index
+{
+ACA_Goal_State_Index::ACA_Goal_State_Index(const GoalState &goal_state)
+{
+  std::unordered_map<std::string, const GatewayConfiguration *> zeta_gateways;
+
+  _subnets.reserve(goal_state.subnet_states_size());
+  for (int i = 0; i < goal_state.subnet_states_size(); i++) {
+    const SubnetState &current_SubnetState = goal_state.subnet_states(i);
+    auto subnet = _subnets.emplace(current_SubnetState.configuration().id(), &current_SubnetState);
+
+    if (!subnet.second && subnet.first->second->operation_type() != OperationType::INFO &&
+        current_SubnetState.operation_type() == OperationType::INFO) {
+      subnet.first->second = &current_SubnetState;
+    }
+  }
+
+  for (int i = 0; i < goal_state.gateway_states_size(); i++) {
+    const GatewayConfiguration &current_GatewayConfiguration =
+            goal_state.gateway_states(i).configuration();
+    if (current_GatewayConfiguration.gateway_type() == ZETA) {
+      zeta_gateways.emplace(current_GatewayConfiguration.id(), &current_GatewayConfiguration);
+    }
+  }
+
+  for (int i = 0; i < goal_state.vpc_states_size(); i++) {
+    if (goal_state.vpc_states(i).operation_type() != OperationType::INFO) {
+      continue;
+    }
+    const VpcConfiguration &current_VpcConfiguration = goal_state.vpc_states(i).configuration();
+    for (int j = 0; j < current_VpcConfiguration.gateway_ids_size(); j++) {
+      auto zeta_gateway = zeta_gateways.find(current_VpcConfiguration.gateway_ids(j));
+      if (zeta_gateway != zeta_gateways.end()) {
+        _vpc_zeta_gateways.emplace(current_VpcConfiguration.id(), zeta_gateway->second);
+        break;
+      }
+    }
+  }
+
+  for (int i = 0; i < goal_state.neighbor_states_size(); i++) {
+    const NeighborConfiguration &current_NeighborConfiguration =
+            goal_state.neighbor_states(i).configuration();
+    for (int j = 0; j < current_NeighborConfiguration.fixed_ips_size(); j++) {
+      const NeighborConfiguration_FixedIp &current_fixed_ip =
+              current_NeighborConfiguration.fixed_ips(j);
+      _neighbor_fixed_ips.emplace(current_fixed_ip.ip_address(),
+                                  neighbor_fixed_ip_entry{ &current_NeighborConfiguration,
+                                                           &current_fixed_ip });
+    }
+  }
+}
+
+const SubnetState *ACA_Goal_State_Index::find_subnet(const std::string &subnet_id) const
+{
+  auto subnet = _subnets.find(subnet_id);
+  return (subnet == _subnets.end()) ? nullptr : subnet->second;
+}
+
+const GatewayConfiguration *ACA_Goal_State_Index::find_zeta_gateway(const std::string &vpc_id) const
+{
+  auto zeta_gateway = _vpc_zeta_gateways.find(vpc_id);
+  return (zeta_gateway == _vpc_zeta_gateways.end()) ? nullptr : zeta_gateway->second;
+}
+
+bool ACA_Goal_State_Index::find_neighbor_fixed_ip(const std::string &ip_address,
+                                                  neighbor_fixed_ip_entry &found_entry) const
+{
+  auto neighbor_fixed_ip = _neighbor_fixed_ips.find(ip_address);
+  if (neighbor_fixed_ip == _neighbor_fixed_ips.end()) {
+    return false;
+  }
+  found_entry = neighbor_fixed_ip->second;
+  return true;
+}
+
+} // namespace aca_goal_state_index
@@ -0,0 +1,210 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_id_table.h"
+#include <mutex>
+
+using namespace std;
+
+namespace aca_id_table
+{
+ACA_Id_Table &ACA_Id_Table::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Id_Table instance;
+  return instance;
+}
+
+ACA_Id_Table::ACA_Id_Table() : _next_handle(NO_HANDLE + 1), _id_count(0)
+{
+  for (auto &chunk : _chunks) {
+    chunk.store(nullptr, memory_order_relaxed);
+  }
+}
+
+ACA_Id_Table::~ACA_Id_Table()
+{
+  for (auto &chunk : _chunks) {
+    delete[] chunk.load();
+  }
+}
+
+size_t ACA_Id_Table::_get_stripe_index(const string &id) const
+{
+  return hash<string>{}(id) % ID_TABLE_STRIPES;
+}
+
+id_handle ACA_Id_Table::_allocate_handle()
+{
+  {
+    lock_guard<mutex> free_handles_lock(_free_handles_mutex);
+    if (!_free_handles.empty()) {
+      id_handle handle = _free_handles.back();
+      _free_handles.pop_back();
+      return handle;
+    }
+  }
+
+  id_handle handle = _next_handle.load();
+  do {
+    if (handle >= (id_handle)ID_TABLE_CHUNK_SIZE * ID_TABLE_MAX_CHUNKS) {
+      return NO_HANDLE;
+    }
+  } while (!_next_handle.compare_exchange_weak(handle, handle + 1));
+
+  return handle;
+}
+
+void ACA_Id_Table::_store_id(id_handle handle, const string *id)
+{
+  auto &chunk = _chunks[handle / ID_TABLE_CHUNK_SIZE];
+  atomic<const string *> *ids = chunk.load(memory_order_acquire);
+
+  if (ids == nullptr) {
+    atomic<const string *> *new_ids = new atomic<const string *>[ID_TABLE_CHUNK_SIZE]();
+    // another stripe could be filling the same chunk
+    if (chunk.compare_exchange_strong(ids, new_ids, memory_order_acq_rel)) {
+      ids = new_ids;
+    } else {
+      delete[] new_ids;
+    }
+  }
+  ids[handle % ID_TABLE_CHUNK_SIZE].store(id, memory_order_release);
+}
+
+id_handle ACA_Id_Table::intern(const string &id)
+{
+  id_stripe &stripe = _stripes[_get_stripe_index(id)];
+
+  {
+    shared_lock<shared_timed_mutex> reader_lock(stripe.stripe_mutex);
+    auto found = stripe.handles.find(id);
+    if (found != stripe.handles.end()) {
+      found->second.reference_count.fetch_add(1);
+      return found->second.handle;
+    }
+  }
+
+  unique_lock<shared_timed_mutex> writer_lock(stripe.stripe_mutex);
+  auto [handle_it, inserted] = stripe.handles.try_emplace(id);
+  if (!inserted) {
+    handle_it->second.reference_count.fetch_add(1);
+    return handle_it->second.handle;
+  }
+
+  id_handle handle = _allocate_handle();
+  if (handle == NO_HANDLE) {
+    stripe.handles.erase(handle_it);
+    ACA_LOG_CRIT("Id table is full, not able to intern id %s\n", id.c_str());
+    return NO_HANDLE;
+  }
+
+  // published before the handle leaves the stripe lock
+  _store_id(handle, &handle_it->first);
+  handle_it->second.handle = handle;
+  handle_it->second.reference_count.store(1);
+  _id_count++;
+  return handle;
+}
+
+void ACA_Id_Table::retain(id_handle handle)
+{
+  // the caller's reference keeps the count above 0, so the reader lock is enough
+  const string &id = get_id(handle);
+  if (id.empty()) {
+    ACA_LOG_ERROR("Retaining handle %u which is not interned\n", handle);
+    return;
+  }
+  id_stripe &stripe = _stripes[_get_stripe_index(id)];
+  shared_lock<shared_timed_mutex> reader_lock(stripe.stripe_mutex);
+
+  auto found = stripe.handles.find(id);
+  if (found != stripe.handles.end()) {
+    found->second.reference_count.fetch_add(1);
+  }
+}
+
+void ACA_Id_Table::release(id_handle handle)
+{
+  // the caller's reference keeps the id alive until it is dropped below
+  const string &id = get_id(handle);
+  if (id.empty()) {
+    ACA_LOG_ERROR("Releasing handle %u which is not interned\n", handle);
+    return;
+  }
+  id_stripe &stripe = _stripes[_get_stripe_index(id)];
+
+  {
+    shared_lock<shared_timed_mutex> reader_lock(stripe.stripe_mutex);
+    auto found = stripe.handles.find(id);
+    if (found == stripe.handles.end()) {
+      return;
+    }
+    // not the last reference, or someone else is forgetting the id
+    uint64_t reference_count = found->second.reference_count.load();
+    while (reference_count > 1) {
+      if (found->second.reference_count.compare_exchange_weak(reference_count,
+                                                              reference_count - 1)) {
+        return;
+      }
+    }
+  }
+
+  unique_lock<shared_timed_mutex> writer_lock(stripe.stripe_mutex);
+  auto found = stripe.handles.find(id);
+  if (found == stripe.handles.end() || found->second.reference_count.fetch_sub(1) > 1) {
+    return;
+  }
+
+  _store_id(handle, nullptr);
+  stripe.handles.erase(found);
+  _id_count--;
+
+  lock_guard<mutex> free_handles_lock(_free_handles_mutex);
+  _free_handles.push_back(handle);
+}
+
+id_handle ACA_Id_Table::find(const string &id) const
+{
+  const id_stripe &stripe = _stripes[_get_stripe_index(id)];
+  shared_lock<shared_timed_mutex> reader_lock(stripe.stripe_mutex);
+
+  auto found = stripe.handles.find(id);
+  return (found == stripe.handles.end()) ? NO_HANDLE : found->second.handle;
+}
+
+const string &ACA_Id_Table::get_id(id_handle handle) const
+{
+  static const string no_id;
+
+  if (handle == NO_HANDLE || handle >= _next_handle.load()) {
+    return no_id;
+  }
+
+  const atomic<const string *> *ids =
+          _chunks[handle / ID_TABLE_CHUNK_SIZE].load(memory_order_acquire);
+  if (ids == nullptr) {
+    return no_id;
+  }
+  const string *id = ids[handle % ID_TABLE_CHUNK_SIZE].load(memory_order_acquire);
+  return (id == nullptr) ? no_id : *id;
+}
+
+size_t ACA_Id_Table::size() const
+{
+  return _id_count.load();
+}
+} // namespace aca_id_table
@@ -0,0 +1,266 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_revision_tracker.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+namespace aca_revision_tracker
+{
+ACA_Revision_Tracker &ACA_Revision_Tracker::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Revision_Tracker instance;
+  return instance;
+}
+
+uint64_t ACA_Revision_Tracker::make_key(int resource_type,
+                                        aca_id_table::id_handle resource_handle)
+{
+  return (uint64_t)(uint32_t)resource_type << 32 | resource_handle;
+}
+
+uint64_t ACA_Revision_Tracker::find_key(int resource_type, const std::string &resource_id)
+{
+  aca_id_table::id_handle resource_handle =
+          aca_id_table::ACA_Id_Table::get_instance().find(resource_id);
+
+  if (resource_handle == aca_id_table::ACA_Id_Table::NO_HANDLE) {
+    return NO_KEY;
+  }
+  return make_key(resource_type, resource_handle);
+}
+
+ACA_Revision_Tracker::revision_stripe &ACA_Revision_Tracker::get_stripe(uint64_t key)
+{
+  return _stripes[(key ^ (key >> 32)) % STRIPE_COUNT];
+}
+
+bool ACA_Revision_Tracker::is_applied(int resource_type, const std::string &resource_id,
+                                      uint32_t revision_number)
+{
+  if (revision_number == 0) {
+    return false;
+  }
+
+  uint64_t key = find_key(resource_type, resource_id);
+  if (key == NO_KEY) {
+    return false;
+  }
+  revision_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  auto found = stripe.applied_revisions.find(key);
+  if (found == stripe.applied_revisions.end() ||
+      found->second.revision_number < revision_number) {
+    return false;
+  }
+
+  _cache_hits++;
+  return true;
+}
+
+uint64_t ACA_Revision_Tracker::get_generation()
+{
+  return _generation.load(std::memory_order_acquire);
+}
+
+void ACA_Revision_Tracker::record_applied(int resource_type, const std::string &resource_id,
+                                          uint32_t revision_number, uint64_t generation,
+                                          const std::vector<uint32_t> &tunnel_ids)
+{
+  if (revision_number == 0) {
+    return;
+  }
+
+  aca_id_table::ACA_Id_Table &id_table = aca_id_table::ACA_Id_Table::get_instance();
+  aca_id_table::id_handle resource_handle = id_table.intern(resource_id);
+  if (resource_handle == aca_id_table::ACA_Id_Table::NO_HANDLE) {
+    return;
+  }
+
+  uint64_t key = make_key(resource_type, resource_handle);
+  revision_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  // clear() moves to the next generation before it empties the stripes, so either
+  // the reset is seen here or the entry written below is erased by it
+  if (_generation.load(std::memory_order_acquire) != generation) {
+    id_table.release(resource_handle);
+    return;
+  }
+
+  // every entry holds one reference to its handle
+  auto [applied_it, inserted] = stripe.applied_revisions.try_emplace(key);
+  if (!inserted) {
+    id_table.release(resource_handle);
+  }
+  if (applied_it->second.revision_number < revision_number) {
+    applied_it->second.revision_number = revision_number;
+    applied_it->second.tunnel_ids = tunnel_ids;
+  }
+}
+
+void ACA_Revision_Tracker::forget(int resource_type, const std::string &resource_id)
+{
+  uint64_t key = find_key(resource_type, resource_id);
+  if (key == NO_KEY) {
+    return;
+  }
+  revision_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  if (stripe.applied_revisions.erase(key)) {
+    aca_id_table::ACA_Id_Table::get_instance().release((aca_id_table::id_handle)key);
+  }
+}
+
+size_t ACA_Revision_Tracker::forget_tunnel(uint32_t tunnel_id)
+{
+  size_t forgotten_count = 0;
+
+  // only called when the last port of a VPC goes away, walking every entry is fine
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    for (auto applied_it = stripe.applied_revisions.begin();
+         applied_it != stripe.applied_revisions.end();) {
+      auto &tunnel_ids = applied_it->second.tunnel_ids;
+      if (std::find(tunnel_ids.begin(), tunnel_ids.end(), tunnel_id) == tunnel_ids.end()) {
+        ++applied_it;
+        continue;
+      }
+      aca_id_table::ACA_Id_Table::get_instance().release(
+              (aca_id_table::id_handle)applied_it->first);
+      applied_it = stripe.applied_revisions.erase(applied_it);
+      forgotten_count++;
+    }
+  }
+  return forgotten_count;
+}
+
+uint32_t ACA_Revision_Tracker::get_applied_revision(int resource_type,
+                                                    const std::string &resource_id)
+{
+  uint64_t key = find_key(resource_type, resource_id);
+  if (key == NO_KEY) {
+    return 0;
+  }
+  revision_stripe &stripe = get_stripe(key);
+  std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+
+  auto found = stripe.applied_revisions.find(key);
+  return (found == stripe.applied_revisions.end()) ? 0 : found->second.revision_number;
+}
+
+size_t ACA_Revision_Tracker::size()
+{
+  size_t total = 0;
+
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    total += stripe.applied_revisions.size();
+  }
+
+  return total;
+}
+
+unsigned long ACA_Revision_Tracker::cache_hit_count()
+{
+  return _cache_hits.load();
+}
+
+void ACA_Revision_Tracker::clear()
+{
+  _generation.fetch_add(1, std::memory_order_acq_rel);
+
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    for (auto &applied_revision : stripe.applied_revisions) {
+      aca_id_table::ACA_Id_Table::get_instance().release(
+              (aca_id_table::id_handle)applied_revision.first);
+    }
+    stripe.applied_revisions.clear();
+  }
+  _cache_hits = 0;
+}
+
+void ACA_Revision_Tracker::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  snapshot_writer.put_u32(size());
+
+  for (auto &stripe : _stripes) {
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    for (auto &applied_revision : stripe.applied_revisions) {
+      // stored as "<resource type>/<resource id>", handles do not survive a restart
+      int resource_type = (int)(uint32_t)(applied_revision.first >> 32);
+      auto resource_handle = (aca_id_table::id_handle)applied_revision.first;
+      snapshot_writer.put_string(
+              std::to_string(resource_type) + "/" +
+              aca_id_table::ACA_Id_Table::get_instance().get_id(resource_handle));
+      snapshot_writer.put_u32(applied_revision.second.revision_number);
+      snapshot_writer.put_u32(applied_revision.second.tunnel_ids.size());
+      for (uint32_t tunnel_id : applied_revision.second.tunnel_ids) {
+        snapshot_writer.put_u32(tunnel_id);
+      }
+    }
+  }
+}
+
+int ACA_Revision_Tracker::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  uint32_t entry_count = 0;
+  std::string key;
+
+  snapshot_reader.get_u32(entry_count);
+  for (uint32_t i = 0; i < entry_count && snapshot_reader.is_good(); i++) {
+    applied_revision restored_revision;
+    uint32_t tunnel_count = 0;
+
+    snapshot_reader.get_string(key);
+    snapshot_reader.get_u32(restored_revision.revision_number);
+    snapshot_reader.get_u32(tunnel_count);
+    for (uint32_t j = 0; j < tunnel_count && snapshot_reader.is_good(); j++) {
+      uint32_t tunnel_id = 0;
+      snapshot_reader.get_u32(tunnel_id);
+      restored_revision.tunnel_ids.push_back(tunnel_id);
+    }
+    if (!snapshot_reader.is_good()) {
+      break;
+    }
+
+    size_t separator_pos = key.find('/');
+    if (separator_pos == std::string::npos) {
+      continue;
+    }
+    int resource_type = (int)strtol(key.substr(0, separator_pos).c_str(), nullptr, 10);
+    aca_id_table::id_handle resource_handle =
+            aca_id_table::ACA_Id_Table::get_instance().intern(key.substr(separator_pos + 1));
+    if (resource_handle == aca_id_table::ACA_Id_Table::NO_HANDLE) {
+      continue;
+    }
+    uint64_t resource_key = make_key(resource_type, resource_handle);
+    revision_stripe &stripe = get_stripe(resource_key);
+    std::lock_guard<std::mutex> lock(stripe.stripe_mutex);
+    auto [applied_it, inserted] = stripe.applied_revisions.try_emplace(resource_key);
+    if (!inserted) {
+      aca_id_table::ACA_Id_Table::get_instance().release(resource_handle);
+    }
+    applied_it->second = std::move(restored_revision);
+  }
+
+  return snapshot_reader.is_good() ? EXIT_SUCCESS : -EINVAL;
+}
+} // namespace aca_revision_tracker
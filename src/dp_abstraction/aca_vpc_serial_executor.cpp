@@ -0,0 +1,112 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_vpc_serial_executor.h"
+#include <future>
+
+namespace aca_vpc_serial_executor
+{
+// index of the shard running on this thread, -1 for other threads
+static thread_local int t_shard_index = -1;
+
+ACA_Vpc_Serial_Executor &ACA_Vpc_Serial_Executor::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Vpc_Serial_Executor instance;
+  return instance;
+}
+
+ACA_Vpc_Serial_Executor::ACA_Vpc_Serial_Executor()
+{
+  ACA_LOG_INFO("VPC serial executor: starting %d shards\n", VPC_SERIAL_EXECUTOR_SHARDS);
+
+  for (int i = 0; i < VPC_SERIAL_EXECUTOR_SHARDS; i++) {
+    _shards.emplace_back(new executor_shard);
+  }
+  for (int i = 0; i < VPC_SERIAL_EXECUTOR_SHARDS; i++) {
+    _shards[i]->shard_thread = std::thread(&ACA_Vpc_Serial_Executor::shard_loop, this, i);
+  }
+}
+
+ACA_Vpc_Serial_Executor::~ACA_Vpc_Serial_Executor()
+{
+  for (auto &shard : _shards) {
+    shard->shard_mutex.lock();
+    shard->stopping = true;
+    shard->shard_mutex.unlock();
+    shard->shard_cv.notify_one();
+  }
+
+  for (auto &shard : _shards) {
+    if (shard->shard_thread.joinable()) {
+      shard->shard_thread.join();
+    }
+  }
+}
+
+int ACA_Vpc_Serial_Executor::shard_count()
+{
+  return static_cast<int>(_shards.size());
+}
+
+bool ACA_Vpc_Serial_Executor::is_on_shard(uint tunnel_id)
+{
+  return t_shard_index == static_cast<int>(tunnel_id % _shards.size());
+}
+
+int ACA_Vpc_Serial_Executor::execute(uint tunnel_id, const std::function<int()> &operation)
+{
+  if (is_on_shard(tunnel_id)) {
+    return operation();
+  }
+
+  executor_shard &shard = *_shards[tunnel_id % _shards.size()];
+  auto shard_operation = std::make_shared<std::packaged_task<int()> >(operation);
+  std::future<int> operation_rc = shard_operation->get_future();
+
+  shard.shard_mutex.lock();
+  shard.operations.emplace_back([shard_operation] { (*shard_operation)(); });
+  shard.shard_mutex.unlock();
+  shard.shard_cv.notify_one();
+
+  return operation_rc.get();
+}
+
+void ACA_Vpc_Serial_Executor::shard_loop(int shard_index)
+{
+  executor_shard &shard = *_shards[shard_index];
+  t_shard_index = shard_index;
+
+  while (true) {
+    std::function<void()> operation;
+    {
+      std::unique_lock<std::mutex> shard_lock(shard.shard_mutex);
+      shard.shard_cv.wait(shard_lock,
+                          [&shard] { return shard.stopping || !shard.operations.empty(); });
+      if (shard.operations.empty()) {
+        // stopping and nothing left to run
+        return;
+      }
+      operation = std::move(shard.operations.front());
+      shard.operations.pop_front();
+    }
+
+    operation();
+  }
+}
+
+} // namespace aca_vpc_serial_executor
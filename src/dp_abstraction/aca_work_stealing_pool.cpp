@@ -0,0 +1,220 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_work_stealing_pool.h"
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace aca_work_stealing_pool
+{
+// index of the pool worker running on this thread, -1 for other threads
+static thread_local int t_worker_index = -1;
+
+ACA_Work_Stealing_Pool &ACA_Work_Stealing_Pool::get_instance()
+{
+  // Instance is destroyed when program exits.
+  // It is instantiated on first use.
+  static ACA_Work_Stealing_Pool instance;
+  return instance;
+}
+
+ACA_Work_Stealing_Pool::ACA_Work_Stealing_Pool()
+{
+  int cores = std::thread::hardware_concurrency();
+  int pool_size = (cores == 0) ? 1 : cores * WORK_STEALING_POOL_THREADS_PER_CORE;
+
+  _pending_tasks = 0;
+  _next_queue = 0;
+  _stopping = false;
+
+  ACA_LOG_INFO("Work stealing pool: starting %d workers\n", pool_size);
+
+  for (int i = 0; i < pool_size; i++) {
+    _queues.emplace_back(new worker_queue);
+  }
+  for (int i = 0; i < pool_size; i++) {
+    _workers.emplace_back(&ACA_Work_Stealing_Pool::worker_loop, this, i);
+  }
+}
+
+ACA_Work_Stealing_Pool::~ACA_Work_Stealing_Pool()
+{
+  _sleep_mutex.lock();
+  _stopping = true;
+  _sleep_mutex.unlock();
+  _sleep_cv.notify_all();
+
+  for (auto &worker : _workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+int ACA_Work_Stealing_Pool::size()
+{
+  return static_cast<int>(_workers.size());
+}
+
+void ACA_Work_Stealing_Pool::submit(std::function<void()> task, const void *batch)
+{
+  // a worker keeps its own tasks local, others spread them round-robin
+  size_t queue_index = (t_worker_index >= 0) ? t_worker_index :
+                                               _next_queue++ % _queues.size();
+  worker_queue &target_queue = *_queues[queue_index];
+
+  target_queue.queue_mutex.lock();
+  target_queue.tasks.push_back({ std::move(task), batch });
+  _pending_tasks++;
+  target_queue.queue_mutex.unlock();
+
+  // lock to not race with a worker about to sleep
+  _sleep_mutex.lock();
+  _sleep_mutex.unlock();
+  _sleep_cv.notify_one();
+}
+
+bool ACA_Work_Stealing_Pool::try_run_one(const void *batch)
+{
+  std::function<void()> task;
+  size_t queue_count = _queues.size();
+  auto is_wanted = [batch](const pool_task &queued_task) {
+    return batch == nullptr || queued_task.batch == batch;
+  };
+
+  if (t_worker_index >= 0) {
+    worker_queue &own_queue = *_queues[t_worker_index];
+    own_queue.queue_mutex.lock();
+    auto found_task = std::find_if(own_queue.tasks.rbegin(), own_queue.tasks.rend(), is_wanted);
+    if (found_task != own_queue.tasks.rend()) {
+      task = std::move(found_task->run);
+      own_queue.tasks.erase(std::next(found_task).base());
+    }
+    own_queue.queue_mutex.unlock();
+  }
+
+  if (!task) {
+    size_t start = (t_worker_index >= 0) ? t_worker_index + 1 : _next_queue.load();
+    for (size_t i = 0; i < queue_count && !task; i++) {
+      worker_queue &victim_queue = *_queues[(start + i) % queue_count];
+      victim_queue.queue_mutex.lock();
+      auto found_task =
+              std::find_if(victim_queue.tasks.begin(), victim_queue.tasks.end(), is_wanted);
+      if (found_task != victim_queue.tasks.end()) {
+        task = std::move(found_task->run);
+        victim_queue.tasks.erase(found_task);
+      }
+      victim_queue.queue_mutex.unlock();
+    }
+  }
+
+  if (!task) {
+    return false;
+  }
+
+  _pending_tasks--;
+  task();
+  return true;
+}
+
+void ACA_Work_Stealing_Pool::worker_loop(int worker_index)
+{
+  t_worker_index = worker_index;
+
+  while (true) {
+    if (try_run_one()) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> sleep_lock(_sleep_mutex);
+    _sleep_cv.wait(sleep_lock, [this] { return _stopping || _pending_tasks > 0; });
+    if (_stopping && _pending_tasks == 0) {
+      return;
+    }
+  }
+}
+
+void ACA_Work_Stealing_Pool::parallel_for(size_t count, size_t chunk_size,
+                                          const std::function<void(size_t)> &fn)
+{
+  if (count == 0) {
+    return;
+  }
+
+  if (chunk_size == 0) {
+    // a few chunks per worker so that stealing can even out slow items
+    chunk_size = count / (_workers.size() * 4);
+    if (chunk_size == 0) {
+      chunk_size = 1;
+    }
+  }
+
+  size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+  std::exception_ptr first_exception;
+
+  if (chunk_count == 1) {
+    // nothing to spread, skip the queue and the wakeups
+    for (size_t i = 0; i < count; i++) {
+      try {
+        fn(i);
+      } catch (...) {
+        if (!first_exception) {
+          first_exception = std::current_exception();
+        }
+      }
+    }
+    if (first_exception) {
+      std::rethrow_exception(first_exception);
+    }
+    return;
+  }
+
+  aca_latch chunks_latch(chunk_count);
+  std::mutex exception_mutex;
+
+  for (size_t chunk_start = 0; chunk_start < count; chunk_start += chunk_size) {
+    size_t chunk_end = std::min(chunk_start + chunk_size, count);
+    submit([&, chunk_start, chunk_end] {
+      for (size_t i = chunk_start; i < chunk_end; i++) {
+        try {
+          fn(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> exception_lock(exception_mutex);
+          if (!first_exception) {
+            first_exception = std::current_exception();
+          }
+        }
+      }
+      chunks_latch.count_down();
+    }, &chunks_latch);
+  }
+
+  // help out instead of just blocking, until none of this call's chunks are left to
+  // pick up; an unrelated task could keep the caller busy long after its own are done
+  while (!chunks_latch.try_wait()) {
+    if (!try_run_one(&chunks_latch)) {
+      chunks_latch.wait();
+      break;
+    }
+  }
+
+  if (first_exception) {
+    std::rethrow_exception(first_exception);
+  }
+}
+
+} // namespace aca_work_stealing_pool
@@ -164,44 +164,40 @@ void ACA_On_Demand_Engine::process_async_grpc_replies()
     std::chrono::_V2::high_resolution_clock::time_point received_ncm_reply_time =
             std::chrono::high_resolution_clock::now();
 
-    if (ok) {
-      ACA_LOG_DEBUG("%s\n", "_cq->Next is good, ready to static cast the Async Client Call");
-      auto received_ncm_reply_interval =
-              cast_to_microseconds(received_ncm_reply_time - received_ncm_reply_time_prev)
-                      .count();
-      ACA_LOG_DEBUG("[METRICS] Elapsed time between receiving the last and current hostOperationReply took: %ld microseconds or %ld milliseconds\n",
-                   received_ncm_reply_interval, (received_ncm_reply_interval / 1000));
-      received_ncm_reply_time_prev = received_ncm_reply_time;
-
-      AsyncClientCall *call = static_cast<AsyncClientCall *>(got_tag);
-      auto call_status_copy = call->status;
-      auto call_reply_copy = call->reply;
-      ACA_LOG_DEBUG("%s\n", "Async Client Call casted successfully.");
-
-      if (call->status.ok()) {
-        ACA_LOG_DEBUG("%s\n", "Got an GRPC reply that is OK, need to process it.");
-        for (int i = 0; i < call->reply.operation_statuses_size(); i++) {
-          hostOperationStatus = call->reply.operation_statuses(i);
-          replyStatus = hostOperationStatus.operation_status();
-          request_id = hostOperationStatus.request_id();
-        }
-        ACA_LOG_DEBUG("For UUID: [%s], NCM called returned at: %ld milliseconds\n",
-                      request_id.c_str(),
-                      chrono::duration_cast<chrono::milliseconds>(
-                              received_ncm_reply_time.time_since_epoch())
-                              .count());
-        ACA_LOG_DEBUG("Return from NCM - Reply Status: %s\n",
-                      to_string(replyStatus).c_str());
-        ACA_LOG_DEBUG("Received hostOperationReply in thread id: [%ld]\n",
-                     std::this_thread::get_id());
-        thread_pool_.push(std::bind(&ACA_On_Demand_Engine::process_async_replies_asyncly, this,
-                             request_id, replyStatus, received_ncm_reply_time));
-        ACA_LOG_DEBUG("After using the thread pool, we have %ld idle threads in the pool, thread pool size: %ld\n",
-                      thread_pool_.n_idle(), thread_pool_.size());
-      }
-    } else {
-      ACA_LOG_INFO("%s\n", "Got an GRPC reply that is NOT OK, don't need to process the data");
+    // hedge timers, failed calls and duplicate replies are consumed by the client
+    AsyncClientCall *call = g_grpc_client->HandleAsyncEvent(got_tag, ok);
+    if (call == nullptr) {
+      continue;
+    }
+
+    ACA_LOG_DEBUG("%s\n", "_cq->Next is good, ready to static cast the Async Client Call");
+    auto received_ncm_reply_interval =
+            cast_to_microseconds(received_ncm_reply_time - received_ncm_reply_time_prev)
+                    .count();
+    ACA_LOG_DEBUG("[METRICS] Elapsed time between receiving the last and current hostOperationReply took: %ld microseconds or %ld milliseconds\n",
+                  received_ncm_reply_interval, (received_ncm_reply_interval / 1000));
+    received_ncm_reply_time_prev = received_ncm_reply_time;
+
+    ACA_LOG_DEBUG("%s\n", "Got an GRPC reply that is OK, need to process it.");
+    for (int i = 0; i < call->reply.operation_statuses_size(); i++) {
+      hostOperationStatus = call->reply.operation_statuses(i);
+      replyStatus = hostOperationStatus.operation_status();
+      request_id = hostOperationStatus.request_id();
     }
+    delete call;
+
+    ACA_LOG_DEBUG("For UUID: [%s], NCM called returned at: %ld milliseconds\n",
+                  request_id.c_str(),
+                  chrono::duration_cast<chrono::milliseconds>(
+                          received_ncm_reply_time.time_since_epoch())
+                          .count());
+    ACA_LOG_DEBUG("Return from NCM - Reply Status: %s\n", to_string(replyStatus).c_str());
+    ACA_LOG_DEBUG("Received hostOperationReply in thread id: [%ld]\n",
+                  std::this_thread::get_id());
+    thread_pool_.push(std::bind(&ACA_On_Demand_Engine::process_async_replies_asyncly,
+                                this, request_id, replyStatus, received_ncm_reply_time));
+    ACA_LOG_DEBUG("After using the thread pool, we have %ld idle threads in the pool, thread pool size: %ld\n",
+                  thread_pool_.n_idle(), thread_pool_.size());
   }
 }
 
@@ -263,15 +259,12 @@ void ACA_On_Demand_Engine::on_demand(string uuid_for_call, OperationStatus statu
       vlan_message *vlanmsg = (vlan_message *)vlan_hdr;
       unsigned char *arp_hdr = (unsigned char *)(base + SIZE_ETHERNET + 4);
       arp_message *arpmsg = (arp_message *)arp_hdr;
-      arp_entry_data stData;
-      // get the ip address from arp message
-      stData.ipv4_address =
-              aca_arp_responder::ACA_ARP_Responder::get_instance()._get_requested_ip(arpmsg);
+      uint16_t vlan_id;
       // get the vlan id from vlan header
       if (vlanmsg) {
-        stData.vlan_id = ntohs(vlanmsg->vlan_tci) & 0x0fff;
+        vlan_id = ntohs(vlanmsg->vlan_tci) & 0x0fff;
       } else {
-        stData.vlan_id = 0;
+        vlan_id = 0;
       }
       /*
         Implementing a "Smart" sleep here, which checks if the target arp entry exists,
@@ -288,8 +281,8 @@ void ACA_On_Demand_Engine::on_demand(string uuid_for_call, OperationStatus statu
               std::chrono::steady_clock::now();
 
       do {
-        found_arp_entry =
-                aca_arp_responder::ACA_ARP_Responder::get_instance().does_arp_entry_exist(stData);
+        found_arp_entry = aca_arp_responder::ACA_ARP_Responder::get_instance().does_arp_entry_exist(
+                vlan_id, arpmsg->tpa);
         if (!found_arp_entry) {
           i++;
           usleep(check_frequency_us);
@@ -17,10 +17,10 @@
 #include "aca_ovs_l2_programmer.h"
 #include "aca_ovs_control.h"
 #include "aca_util.h"
-#include <shared_mutex>
 #include <arpa/inet.h>
 #include <errno.h>
 #include <unistd.h>
+#include <vector>
 
 using namespace std;
 
@@ -48,6 +48,27 @@ void ACA_ARP_Responder::_deinit_arp_db()
   _arp_db.clear();
 }
 
+void ACA_ARP_Responder::clear_all_data()
+{
+  _arp_db.clear();
+}
+
+size_t ACA_ARP_Responder::delete_vlan_arp_entries(uint16_t vlan_id)
+{
+  vector<uint64_t> vlan_keys;
+
+  // for_each holds the writer lock, erase after it returns
+  _arp_db.for_each([&vlan_keys, vlan_id](uint64_t key, const uint8_t * /* mac_address */) {
+    if (ACA_Arp_Table::get_vlan_id(key) == vlan_id) {
+      vlan_keys.push_back(key);
+    }
+  });
+  for (uint64_t key : vlan_keys) {
+    _arp_db.erase(key);
+  }
+  return vlan_keys.size();
+}
+
 void ACA_ARP_Responder::_init_arp_ofp()
 {
   // int overall_rc = EXIT_SUCCESS;
@@ -74,130 +95,89 @@ ACA_ARP_Responder &ACA_ARP_Responder::get_instance()
   static ACA_ARP_Responder instance;
   return instance;
 }
-bool ACA_ARP_Responder::does_arp_entry_exist(arp_entry_data stData)
+bool ACA_ARP_Responder::does_arp_entry_exist(uint16_t vlan_id, uint32_t ipv4_address)
 {
-  bool entry_exist = false;
-  arp_table_data *current_arp_data = nullptr;
-  entry_exist = _arp_db.find(stData, current_arp_data);
-  return entry_exist;
+  return _arp_db.contains(ACA_Arp_Table::make_key(vlan_id, ipv4_address));
 }
 
 int ACA_ARP_Responder::add_arp_entry(arp_config *arp_cfg_in)
 {
-  arp_entry_data stData;
-  arp_table_data *current_arp_data = new arp_table_data;
-
-  try {
-    _validate_arp_entry(arp_cfg_in);
-
-    ARP_ENTRY_DATA_SET((arp_entry_data *)&stData, arp_cfg_in);
-    ARP_TABLE_DATA_SET(current_arp_data, arp_cfg_in);
+  uint64_t key;
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
 
-    if (_arp_db.find(stData, current_arp_data)) {
-      ACA_LOG_ERROR("Entry already existed! (ip = %s and vlan id = %u)\n",
-                    arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-      return EXIT_FAILURE;
-    }
-
-    _arp_db.insert(stData, current_arp_data);
+  int rc = _get_arp_entry(arp_cfg_in, key, mac_address);
+  if (rc != EXIT_SUCCESS) {
+    return (rc == -ENOENT) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
 
-    ACA_LOG_DEBUG("Arp Entry with ip: %s and vlan id %u added\n",
+  if (!_arp_db.insert(key, mac_address)) {
+    ACA_LOG_ERROR("Entry already existed! (ip = %s and vlan id = %u)\n",
                   arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-
-    return EXIT_SUCCESS;
-  } catch (std::invalid_argument &ia) {
-    ACA_LOG_ERROR("%s,validate arp config failed! (ip = %s and vlan id = %u)\n",
-                  ia.what(), arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
     return EXIT_FAILURE;
   }
+
+  ACA_LOG_DEBUG("Arp Entry with ip: %s and vlan id %u added\n",
+                arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
+
+  return EXIT_SUCCESS;
 }
 
 int ACA_ARP_Responder::create_or_update_arp_entry(arp_config *arp_cfg_in)
 {
-  arp_entry_data stData;
-  arp_table_data *current_arp_data = new arp_table_data;
-
-  try {
-    _validate_arp_entry(arp_cfg_in);
-    ARP_ENTRY_DATA_SET((arp_entry_data *)&stData, arp_cfg_in);
-    ARP_TABLE_DATA_SET(current_arp_data, arp_cfg_in);
-
-    if (!_arp_db.find(stData, current_arp_data)) {
-      ACA_LOG_DEBUG("Entry not exist! (ip = %s and vlan id = %u)\n",
-                    arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-      add_arp_entry(arp_cfg_in);
-    } else {
-      current_arp_data->mac_address = arp_cfg_in->mac_address;
-    }
-    return EXIT_SUCCESS;
-  } catch (std::invalid_argument &ia) {
-    ACA_LOG_ERROR("%s,validate arp config failed! (ip = %s and vlan id = %u)\n",
-                  ia.what(), arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-    return EXIT_FAILURE;
+  uint64_t key;
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+
+  int rc = _get_arp_entry(arp_cfg_in, key, mac_address);
+  if (rc != EXIT_SUCCESS) {
+    return (rc == -ENOENT) ? EXIT_SUCCESS : EXIT_FAILURE;
   }
+
+  _arp_db.insert_or_update(key, mac_address);
+  return EXIT_SUCCESS;
 }
 int ACA_ARP_Responder::delete_arp_entry(arp_config *arp_cfg_in)
 {
-  arp_entry_data stData;
-  arp_table_data *current_arp_data = new arp_table_data;
-
-  try {
-    _validate_arp_entry(arp_cfg_in);
-    ARP_ENTRY_DATA_SET((arp_entry_data *)&stData, arp_cfg_in);
-    ARP_TABLE_DATA_SET(current_arp_data, arp_cfg_in);
-
-    if (!_arp_db.find(stData, current_arp_data)) {
-      ACA_LOG_DEBUG("Entry not exist! (ip = %s and vlan id = %u)\n",
-                    arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-      return EXIT_SUCCESS;
-    }
-    _arp_db.erase(stData);
-    return EXIT_SUCCESS;
-  } catch (std::invalid_argument &ia) {
-    ACA_LOG_ERROR("%s,validate arp config failed! (ip = %s and vlan id = %u)\n",
-                  ia.what(), arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
-    return EXIT_FAILURE;
-  }
-}
+  uint64_t key;
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
 
-void ACA_ARP_Responder::_validate_ipv4_address(const char *ip_address)
-{
-  struct sockaddr_in sa;
-
-  // inet_pton returns 1 for success 0 for failure
-  if (inet_pton(AF_INET, ip_address, &(sa.sin_addr)) != 1) {
-    throw std::invalid_argument("Virtual ipv4 address is not in the expect format");
+  int rc = _get_arp_entry(arp_cfg_in, key, mac_address);
+  if (rc != EXIT_SUCCESS && rc != -ENOENT) {
+    return EXIT_FAILURE;
   }
-}
-
-void ACA_ARP_Responder::_validate_ipv6_address(const char *ip_address)
-{
-  struct sockaddr_in sa;
 
-  // inet_pton returns 1 for success 0 for failure
-  if (inet_pton(AF_INET6, ip_address, &(sa.sin_addr)) != 1) {
-    throw std::invalid_argument("Virtual ipv6 address is not in the expect format");
+  if (rc == -ENOENT || !_arp_db.erase(key)) {
+    ACA_LOG_DEBUG("Entry not exist! (ip = %s and vlan id = %u)\n",
+                  arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
   }
+  return EXIT_SUCCESS;
 }
 
-int ACA_ARP_Responder::_validate_arp_entry(arp_config *arp_cfg_in)
+int ACA_ARP_Responder::_get_arp_entry(arp_config *arp_cfg_in, uint64_t &key,
+                                      uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH])
 {
-  if (0 >= arp_cfg_in->mac_address.size()) {
-    throw std::invalid_argument("Input mac_string is null");
-  }
+  aca_net_types::ipv4_addr ipv4_address;
+  aca_net_types::mac_addr parsed_mac_address;
 
-  if (!aca_validate_mac_address(arp_cfg_in->mac_address.c_str())) {
-    throw std::invalid_argument("Virtual mac address is not in the expect format");
+  if (!aca_net_types::mac_addr::parse(arp_cfg_in->mac_address, parsed_mac_address)) {
+    ACA_LOG_ERROR("Invalid mac address, validate arp config failed! (mac = %s and vlan id = %u)\n",
+                  arp_cfg_in->mac_address.c_str(), arp_cfg_in->vlan_id);
+    return -EINVAL;
   }
 
-  if (0 < arp_cfg_in->ipv4_address.size()) {
-    _validate_ipv4_address(arp_cfg_in->ipv4_address.c_str());
+  // only IPv4 addresses are answered by ARP
+  if (arp_cfg_in->ipv4_address.empty()) {
+    ACA_LOG_DEBUG("No IPv4 address to answer for (vlan id = %u)\n", arp_cfg_in->vlan_id);
+    return -ENOENT;
   }
 
-  if (0 < arp_cfg_in->ipv6_address.size()) {
-    _validate_ipv6_address(arp_cfg_in->ipv4_address.c_str());
+  if (!aca_net_types::ipv4_addr::parse(arp_cfg_in->ipv4_address, ipv4_address)) {
+    ACA_LOG_ERROR("Invalid ipv4 address, validate arp config failed! (ip = %s and vlan id = %u)\n",
+                  arp_cfg_in->ipv4_address.c_str(), arp_cfg_in->vlan_id);
+    return -EINVAL;
   }
 
+  key = ACA_Arp_Table::make_key(arp_cfg_in->vlan_id, ipv4_address.value);
+  memcpy(mac_address, parsed_mac_address.bytes, ARP_MAC_ADDRESS_LENGTH);
   return EXIT_SUCCESS;
 }
 
@@ -264,41 +244,39 @@ void ACA_ARP_Responder::arp_xmit(uint32_t in_port, void *vlanmsg, void *message,
 int ACA_ARP_Responder::_parse_arp_request(uint32_t in_port, vlan_message *vlanmsg,
                                           arp_message *arpmsg)
 {
-  arp_entry_data stData;
-  arp_table_data *current_arp_data = new arp_table_data;
+  uint16_t vlan_id;
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
   arp_message *arpreply = nullptr;
 
-  // get the ip address from arp message
-  stData.ipv4_address = _get_requested_ip(arpmsg);
-
   // get the vlan id from vlan header
   if (vlanmsg) {
-    stData.vlan_id = ntohs(vlanmsg->vlan_tci) & 0x0fff;
+    vlan_id = ntohs(vlanmsg->vlan_tci) & 0x0fff;
   } else {
-    stData.vlan_id = 0;
+    vlan_id = 0;
   }
 
   // if not find the corresponding mac address in the db based on ip and vlan id, resubmit to table 22
   // else construct an arp reply
-  if (!_arp_db.find(stData, current_arp_data)) {
+  if (!_arp_db.find(ACA_Arp_Table::make_key(vlan_id, arpmsg->tpa), mac_address)) {
     ACA_LOG_DEBUG("ARP entry does not exist! (ip = %s and vlan id = %u)\n",
-                  stData.ipv4_address.c_str(), stData.vlan_id);
+                  _get_requested_ip(arpmsg).c_str(), vlan_id);
     return ENOTSUP;
   } else {
-    ACA_LOG_DEBUG("ARP entry exist (ip = %s and vlan id = %u) with mac = %s\n",
-                  stData.ipv4_address.c_str(), stData.vlan_id,
-                  current_arp_data->mac_address.c_str());
-    arpreply = _pack_arp_reply(arpmsg, current_arp_data->mac_address);
+    ACA_LOG_DEBUG("ARP entry exist (ip = %s and vlan id = %u) with mac = "
+                  "%02x:%02x:%02x:%02x:%02x:%02x\n",
+                  _get_requested_ip(arpmsg).c_str(), vlan_id, mac_address[0],
+                  mac_address[1], mac_address[2], mac_address[3], mac_address[4],
+                  mac_address[5]);
+    arpreply = _pack_arp_reply(arpmsg, mac_address);
     arp_xmit(in_port, vlanmsg, arpreply, 1);
     return EXIT_SUCCESS;
   }
 }
 
-arp_message *ACA_ARP_Responder::_pack_arp_reply(arp_message *arpreq, string mac_address)
+arp_message *ACA_ARP_Responder::_pack_arp_reply(arp_message *arpreq, const uint8_t *mac_address)
 {
   arp_message *arpreply = nullptr;
   arpreply = new arp_message();
-  unsigned int tmp_mac[6];
 
   //construct arp reply form arp request and mac address in the db
   arpreply->hrd = arpreq->hrd;
@@ -308,11 +286,7 @@ arp_message *ACA_ARP_Responder::_pack_arp_reply(arp_message *arpreq, string mac_
   arpreply->op = htons(2);
   memcpy(arpreply->tha, arpreq->sha, 6);
   arpreply->spa = arpreq->tpa;
-  sscanf(mac_address.c_str(), "%02x:%02x:%02x:%02x:%02x:%02x", tmp_mac,
-         tmp_mac + 1, tmp_mac + 2, tmp_mac + 3, tmp_mac + 4, tmp_mac + 5);
-  for (int i = 0; i < 6; i++) {
-    arpreply->sha[i] = tmp_mac[i];
-  }
+  memcpy(arpreply->sha, mac_address, ARP_MAC_ADDRESS_LENGTH);
   arpreply->tpa = arpreq->spa;
 
   return arpreply;
@@ -335,32 +309,22 @@ int ACA_ARP_Responder::_validate_arp_message(arp_message *arpmsg)
 
 string ACA_ARP_Responder::_get_requested_ip(arp_message *arpmsg)
 {
-  string requested_ip;
-  struct in_addr inaddr;
   if (!arpmsg) {
     ACA_LOG_ERROR("%s", "ARP message is null!\n");
     return string();
   }
 
-  inaddr.s_addr = arpmsg->tpa;
-  requested_ip = inet_ntoa(inaddr);
-
-  return requested_ip;
+  return aca_net_types::ipv4_addr{ arpmsg->tpa }.to_string();
 }
 
 string ACA_ARP_Responder::_get_source_ip(arp_message *arpmsg)
 {
-  string source_ip;
-  struct in_addr inaddr;
   if (!arpmsg) {
     ACA_LOG_ERROR("%s", "ARP message is null!\n");
     return string();
   }
 
-  inaddr.s_addr = arpmsg->spa;
-  source_ip = inet_ntoa(inaddr);
-
-  return source_ip;
+  return aca_net_types::ipv4_addr{ arpmsg->spa }.to_string();
 }
 
 string ACA_ARP_Responder::_serialize_arp_message(vlan_message *vlanmsg, arp_message *arpmsg)
@@ -423,4 +387,46 @@ string ACA_ARP_Responder::_serialize_arp_message(vlan_message *vlanmsg, arp_mess
   packet.insert(0, packet_header);
   return packet;
 }
+
+void ACA_ARP_Responder::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  uint32_t entry_count = 0;
+  aca_snapshot::ACA_Snapshot_Writer entries_writer;
+
+  _arp_db.for_each([&](uint64_t key, const uint8_t *mac_address) {
+    entries_writer.put_u64(key);
+    for (int i = 0; i < ARP_MAC_ADDRESS_LENGTH; i++) {
+      entries_writer.put_u8(mac_address[i]);
+    }
+    entry_count++;
+  });
+
+  snapshot_writer.put_u32(entry_count);
+  snapshot_writer.put_bytes(entries_writer.get_data());
+}
+
+int ACA_ARP_Responder::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  uint32_t entry_count = 0;
+
+  snapshot_reader.get_u32(entry_count);
+  for (uint32_t i = 0; i < entry_count && snapshot_reader.is_good(); i++) {
+    uint64_t key = 0;
+    uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+
+    snapshot_reader.get_u64(key);
+    for (int j = 0; j < ARP_MAC_ADDRESS_LENGTH; j++) {
+      snapshot_reader.get_u8(mac_address[j]);
+    }
+
+    if (!snapshot_reader.is_good()) {
+      break;
+    }
+    _arp_db.insert_or_update(key, mac_address);
+  }
+
+  ACA_LOG_DEBUG("Restored %u ARP entries\n", entry_count);
+
+  return snapshot_reader.is_good() ? EXIT_SUCCESS : -EINVAL;
+}
 } // namespace aca_arp_responder
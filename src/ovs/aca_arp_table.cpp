@@ -0,0 +1,232 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_arp_table.h"
+#include <thread>
+
+namespace aca_arp_responder
+{
+arp_table_slots::arp_table_slots(size_t slot_count)
+        : mask(slot_count - 1), slots(new arp_table_slot[slot_count])
+{
+  for (size_t i = 0; i < slot_count; i++) {
+    slots[i].key.store(UINT64_MAX, std::memory_order_relaxed); // empty slot
+    slots[i].mac_address.store(0, std::memory_order_relaxed);
+  }
+}
+
+ACA_Arp_Table::ACA_Arp_Table()
+        : _slots(new arp_table_slots(ARP_TABLE_INITIAL_SLOTS)), _reader_epoch(0),
+          _reader_counts{}, _entry_count(0), _used_slot_count(0)
+{
+}
+
+ACA_Arp_Table::~ACA_Arp_Table()
+{
+  delete _slots.load();
+}
+
+uint64_t ACA_Arp_Table::pack_mac_address(const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH])
+{
+  uint64_t packed_mac_address = 0;
+
+  for (int i = 0; i < ARP_MAC_ADDRESS_LENGTH; i++) {
+    packed_mac_address = packed_mac_address << 8 | mac_address[i];
+  }
+  return packed_mac_address;
+}
+
+void ACA_Arp_Table::unpack_mac_address(uint64_t packed_mac_address,
+                                       uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH])
+{
+  for (int i = ARP_MAC_ADDRESS_LENGTH - 1; i >= 0; i--) {
+    mac_address[i] = (uint8_t)packed_mac_address;
+    packed_mac_address >>= 8;
+  }
+}
+
+size_t ACA_Arp_Table::_hash(uint64_t key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return key;
+}
+
+bool ACA_Arp_Table::_lookup(uint64_t key, uint64_t &packed_mac_address) const
+{
+  bool found = false;
+
+  // a writer frees an old array only after this counter went back to 0
+  std::atomic<uint64_t> &reader_count = _reader_counts[_reader_epoch.load() & 1];
+  reader_count.fetch_add(1);
+
+  arp_table_slots *current_slots = _slots.load();
+
+  // there is always an empty slot, so the probe ends
+  for (size_t i = _hash(key) & current_slots->mask;; i = (i + 1) & current_slots->mask) {
+    uint64_t slot_key = current_slots->slots[i].key.load(std::memory_order_acquire);
+    if (slot_key == key) {
+      packed_mac_address =
+              current_slots->slots[i].mac_address.load(std::memory_order_acquire);
+      found = true;
+      break;
+    }
+    if (slot_key == EMPTY_KEY) {
+      break;
+    }
+  }
+
+  reader_count.fetch_sub(1);
+  return found;
+}
+
+bool ACA_Arp_Table::find(uint64_t key, uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH]) const
+{
+  uint64_t packed_mac_address = 0;
+
+  if (!_lookup(key, packed_mac_address)) {
+    return false;
+  }
+  unpack_mac_address(packed_mac_address, mac_address);
+  return true;
+}
+
+bool ACA_Arp_Table::contains(uint64_t key) const
+{
+  uint64_t not_used;
+  return _lookup(key, not_used);
+}
+
+arp_table_slot *ACA_Arp_Table::_find_slot(arp_table_slots *current_slots, uint64_t key)
+{
+  for (size_t i = _hash(key) & current_slots->mask;; i = (i + 1) & current_slots->mask) {
+    uint64_t slot_key = current_slots->slots[i].key.load(std::memory_order_relaxed);
+    if (slot_key == key || slot_key == EMPTY_KEY) {
+      return &current_slots->slots[i];
+    }
+  }
+}
+
+bool ACA_Arp_Table::insert(uint64_t key, const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH])
+{
+  std::lock_guard<std::mutex> writer_lock(_writer_mutex);
+
+  arp_table_slot *slot = _find_slot(_slots.load(std::memory_order_relaxed), key);
+  if (slot->key.load(std::memory_order_relaxed) == key) {
+    return false;
+  }
+
+  // keep at least half of the slots empty so probes stay short
+  if ((_used_slot_count + 1) * 2 > _slots.load(std::memory_order_relaxed)->mask + 1) {
+    _resize();
+    slot = _find_slot(_slots.load(std::memory_order_relaxed), key);
+  }
+
+  // the MAC has to be visible before a reader can match the key
+  slot->mac_address.store(pack_mac_address(mac_address), std::memory_order_relaxed);
+  slot->key.store(key, std::memory_order_release);
+  _used_slot_count++;
+  _entry_count.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ACA_Arp_Table::insert_or_update(uint64_t key,
+                                     const uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH])
+{
+  if (insert(key, mac_address)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> writer_lock(_writer_mutex);
+
+  arp_table_slot *slot = _find_slot(_slots.load(std::memory_order_relaxed), key);
+  if (slot->key.load(std::memory_order_relaxed) == key) {
+    // readers see either the old or the new MAC
+    slot->mac_address.store(pack_mac_address(mac_address), std::memory_order_release);
+  }
+}
+
+bool ACA_Arp_Table::erase(uint64_t key)
+{
+  std::lock_guard<std::mutex> writer_lock(_writer_mutex);
+
+  arp_table_slot *slot = _find_slot(_slots.load(std::memory_order_relaxed), key);
+  if (slot->key.load(std::memory_order_relaxed) != key) {
+    return false;
+  }
+
+  // the slot stays used until the next resize, a probe must not stop on it
+  slot->key.store(ERASED_KEY, std::memory_order_release);
+  _entry_count.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ACA_Arp_Table::clear()
+{
+  std::lock_guard<std::mutex> writer_lock(_writer_mutex);
+
+  _replace_slots(new arp_table_slots(ARP_TABLE_INITIAL_SLOTS));
+  _used_slot_count = 0;
+  _entry_count.store(0, std::memory_order_relaxed);
+}
+
+size_t ACA_Arp_Table::size() const
+{
+  return _entry_count.load(std::memory_order_relaxed);
+}
+
+void ACA_Arp_Table::_resize()
+{
+  arp_table_slots *current_slots = _slots.load(std::memory_order_relaxed);
+  size_t entry_count = _entry_count.load(std::memory_order_relaxed);
+  size_t slot_count = ARP_TABLE_INITIAL_SLOTS;
+
+  // room for twice the live entries, dropping the tombstones may be enough
+  while (slot_count < (entry_count + 1) * 4) {
+    slot_count *= 2;
+  }
+
+  arp_table_slots *new_slots = new arp_table_slots(slot_count);
+  for (size_t i = 0; i <= current_slots->mask; i++) {
+    uint64_t key = current_slots->slots[i].key.load(std::memory_order_relaxed);
+    if (key != EMPTY_KEY && key != ERASED_KEY) {
+      arp_table_slot *new_slot = _find_slot(new_slots, key);
+      new_slot->mac_address.store(
+              current_slots->slots[i].mac_address.load(std::memory_order_relaxed),
+              std::memory_order_relaxed);
+      new_slot->key.store(key, std::memory_order_relaxed);
+    }
+  }
+
+  _replace_slots(new_slots);
+  _used_slot_count = entry_count;
+}
+
+void ACA_Arp_Table::_replace_slots(arp_table_slots *new_slots)
+{
+  arp_table_slots *old_slots = _slots.exchange(new_slots);
+
+  // a reader that saw old_slots is counted under the epoch it read, flip the epoch
+  // twice and wait for each side to drain, then nobody can still be using old_slots
+  for (int i = 0; i < 2; i++) {
+    std::atomic<uint64_t> &reader_count = _reader_counts[_reader_epoch.fetch_add(1) & 1];
+    while (reader_count.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  delete old_slots;
+}
+} // namespace aca_arp_responder
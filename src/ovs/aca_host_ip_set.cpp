@@ -0,0 +1,428 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_host_ip_set.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace aca_ovs_l2_programmer
+{
+ACA_Host_Ip_Set::ACA_Host_Ip_Set()
+        : _slots(HOST_IP_SET_INITIAL_SLOTS, host_ip_slot{ { 0, 0 }, false }),
+          _entry_count(0), _netlink_socket(-1), _stop_event(-1)
+{
+}
+
+ACA_Host_Ip_Set::~ACA_Host_Ip_Set()
+{
+  stop_monitor();
+}
+
+bool ACA_Host_Ip_Set::parse_ip_address(const string &ip_address, host_ip_address &address)
+{
+  uint32_t ipv4_address;
+  uint8_t ipv6_address[16];
+
+  if (inet_pton(AF_INET, ip_address.c_str(), &ipv4_address) == 1) {
+    address = from_ipv4(ipv4_address);
+    return true;
+  }
+  if (inet_pton(AF_INET6, ip_address.c_str(), ipv6_address) == 1) {
+    address = from_ipv6(ipv6_address);
+    return true;
+  }
+  return false;
+}
+
+host_ip_address ACA_Host_Ip_Set::from_ipv4(uint32_t ipv4_address)
+{
+  return host_ip_address{ 0, 0x0000ffff00000000ULL | ntohl(ipv4_address) };
+}
+
+host_ip_address ACA_Host_Ip_Set::from_ipv6(const uint8_t ipv6_address[16])
+{
+  host_ip_address address{ 0, 0 };
+
+  for (int i = 0; i < 8; i++) {
+    address.high = address.high << 8 | ipv6_address[i];
+    address.low = address.low << 8 | ipv6_address[i + 8];
+  }
+  return address;
+}
+
+string ACA_Host_Ip_Set::to_string(const host_ip_address &address)
+{
+  char ip_buffer[INET6_ADDRSTRLEN];
+
+  if (address.high == 0 && (address.low >> 32) == 0x0000ffff) {
+    uint32_t ipv4_address = htonl((uint32_t)address.low);
+    inet_ntop(AF_INET, &ipv4_address, ip_buffer, sizeof(ip_buffer));
+  } else {
+    uint8_t ipv6_address[16];
+    for (int i = 0; i < 8; i++) {
+      ipv6_address[i] = (uint8_t)(address.high >> (56 - 8 * i));
+      ipv6_address[i + 8] = (uint8_t)(address.low >> (56 - 8 * i));
+    }
+    inet_ntop(AF_INET6, ipv6_address, ip_buffer, sizeof(ip_buffer));
+  }
+  return string(ip_buffer);
+}
+
+size_t ACA_Host_Ip_Set::_hash(const host_ip_address &address)
+{
+  uint64_t key = address.high ^ (address.low * 0x9e3779b97f4a7c15ULL);
+
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return key;
+}
+
+size_t ACA_Host_Ip_Set::_find_slot(const host_ip_address &address) const
+{
+  size_t mask = _slots.size() - 1;
+
+  // at most half of the slots are used, so the probe ends
+  for (size_t i = _hash(address) & mask;; i = (i + 1) & mask) {
+    if (!_slots[i].used || _slots[i].address == address) {
+      return i;
+    }
+  }
+}
+
+bool ACA_Host_Ip_Set::contains(const string &ip_address) const
+{
+  host_ip_address address;
+
+  if (!parse_ip_address(ip_address, address)) {
+    return false;
+  }
+  return contains(address);
+}
+
+bool ACA_Host_Ip_Set::contains(const host_ip_address &address) const
+{
+  shared_lock<shared_timed_mutex> reader_lock(_set_mutex);
+  return _slots[_find_slot(address)].used;
+}
+
+void ACA_Host_Ip_Set::_grow_locked()
+{
+  vector<host_ip_slot> old_slots(_slots.size() * 2, host_ip_slot{ { 0, 0 }, false });
+
+  old_slots.swap(_slots);
+  for (auto &slot : old_slots) {
+    if (slot.used) {
+      _slots[_find_slot(slot.address)] = slot;
+    }
+  }
+}
+
+bool ACA_Host_Ip_Set::_insert_locked(const host_ip_address &address)
+{
+  if ((_entry_count + 1) * 2 > _slots.size()) {
+    _grow_locked();
+  }
+
+  size_t i = _find_slot(address);
+  if (_slots[i].used) {
+    return false;
+  }
+  _slots[i] = host_ip_slot{ address, true };
+  _entry_count++;
+  return true;
+}
+
+bool ACA_Host_Ip_Set::insert(const host_ip_address &address)
+{
+  unique_lock<shared_timed_mutex> writer_lock(_set_mutex);
+  return _insert_locked(address);
+}
+
+bool ACA_Host_Ip_Set::erase(const host_ip_address &address)
+{
+  unique_lock<shared_timed_mutex> writer_lock(_set_mutex);
+  size_t mask = _slots.size() - 1;
+  size_t hole = _find_slot(address);
+
+  if (!_slots[hole].used) {
+    return false;
+  }
+
+  // shift the rest of the probe sequence back instead of leaving a tombstone,
+  // an entry moves into the hole unless its home slot lies in (hole, i]
+  for (size_t i = (hole + 1) & mask; _slots[i].used; i = (i + 1) & mask) {
+    size_t home = _hash(_slots[i].address) & mask;
+    bool home_in_range = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+    if (!home_in_range) {
+      _slots[hole] = _slots[i];
+      hole = i;
+    }
+  }
+  _slots[hole].used = false;
+  _entry_count--;
+  return true;
+}
+
+void ACA_Host_Ip_Set::clear()
+{
+  unique_lock<shared_timed_mutex> writer_lock(_set_mutex);
+  fill(_slots.begin(), _slots.end(), host_ip_slot{ { 0, 0 }, false });
+  _entry_count = 0;
+}
+
+size_t ACA_Host_Ip_Set::size() const
+{
+  shared_lock<shared_timed_mutex> reader_lock(_set_mutex);
+  return _entry_count;
+}
+
+int ACA_Host_Ip_Set::load_local_addresses()
+{
+  struct ifaddrs *interface_addresses;
+  vector<host_ip_address> addresses;
+
+  if (getifaddrs(&interface_addresses) == -1) {
+    int error = errno;
+    ACA_LOG_ERROR("getifaddrs failed: %s\n", strerror(error));
+    return -error;
+  }
+
+  for (auto ifa = interface_addresses; ifa != nullptr; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr == nullptr) {
+      continue;
+    }
+
+    host_ip_address address;
+    if (ifa->ifa_addr->sa_family == AF_INET) {
+      address = from_ipv4(((struct sockaddr_in *)ifa->ifa_addr)->sin_addr.s_addr);
+    } else if (ifa->ifa_addr->sa_family == AF_INET6) {
+      address = from_ipv6(((struct sockaddr_in6 *)ifa->ifa_addr)->sin6_addr.s6_addr);
+    } else {
+      continue;
+    }
+
+    ACA_LOG_INFO("%-8s address: <%s>\n", ifa->ifa_name, to_string(address).c_str());
+    addresses.push_back(address);
+  }
+
+  freeifaddrs(interface_addresses);
+
+  unique_lock<shared_timed_mutex> writer_lock(_set_mutex);
+  fill(_slots.begin(), _slots.end(), host_ip_slot{ { 0, 0 }, false });
+  _entry_count = 0;
+  for (auto &address : addresses) {
+    _insert_locked(address);
+  }
+  return EXIT_SUCCESS;
+}
+
+bool ACA_Host_Ip_Set::_get_message_address(const struct nlmsghdr *message,
+                                           host_ip_address &address)
+{
+  if (message->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifaddrmsg))) {
+    return false;
+  }
+
+  auto address_message = (const struct ifaddrmsg *)NLMSG_DATA(message);
+  int attribute_length = IFA_PAYLOAD(message);
+  const struct rtattr *local_attribute = nullptr;
+  const struct rtattr *address_attribute = nullptr;
+
+  for (auto attribute = IFA_RTA(address_message); RTA_OK(attribute, attribute_length);
+       attribute = RTA_NEXT(attribute, attribute_length)) {
+    if (attribute->rta_type == IFA_LOCAL) {
+      local_attribute = attribute;
+    } else if (attribute->rta_type == IFA_ADDRESS) {
+      address_attribute = attribute;
+    }
+  }
+
+  // IFA_ADDRESS is the peer on a point to point link, IFA_LOCAL is ours when present
+  const struct rtattr *attribute = local_attribute ? local_attribute : address_attribute;
+  if (attribute == nullptr) {
+    return false;
+  }
+
+  if (address_message->ifa_family == AF_INET && RTA_PAYLOAD(attribute) >= 4) {
+    uint32_t ipv4_address;
+    memcpy(&ipv4_address, RTA_DATA(attribute), sizeof(ipv4_address));
+    address = from_ipv4(ipv4_address);
+    return true;
+  }
+  if (address_message->ifa_family == AF_INET6 && RTA_PAYLOAD(attribute) >= 16) {
+    address = from_ipv6((const uint8_t *)RTA_DATA(attribute));
+    return true;
+  }
+  return false;
+}
+
+int ACA_Host_Ip_Set::apply_netlink_messages(const void *buffer, size_t length)
+{
+  int applied_count = 0;
+  bool need_reload = false;
+  int remaining_length = (int)length;
+
+  for (auto message = (const struct nlmsghdr *)buffer; NLMSG_OK(message, remaining_length);
+       message = NLMSG_NEXT(message, remaining_length)) {
+    if (message->nlmsg_type == NLMSG_DONE) {
+      break;
+    }
+    if (message->nlmsg_type != RTM_NEWADDR && message->nlmsg_type != RTM_DELADDR) {
+      continue;
+    }
+
+    host_ip_address address;
+    if (!_get_message_address(message, address)) {
+      continue;
+    }
+    applied_count++;
+
+    if (message->nlmsg_type == RTM_NEWADDR) {
+      if (insert(address)) {
+        ACA_LOG_INFO("Host address added: <%s>\n", to_string(address).c_str());
+      }
+    } else {
+      ACA_LOG_INFO("Host address removed: <%s>\n", to_string(address).c_str());
+      erase(address);
+      // the address could still be configured on another interface
+      need_reload = true;
+    }
+  }
+
+  if (need_reload) {
+    load_local_addresses();
+  }
+  return applied_count;
+}
+
+int ACA_Host_Ip_Set::start_monitor()
+{
+  struct sockaddr_nl local_address;
+  int rc;
+
+  if (_monitor_thread.joinable()) {
+    return EXIT_SUCCESS;
+  }
+
+  _netlink_socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (_netlink_socket < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to open the netlink socket: %s\n", strerror(-rc));
+    return rc;
+  }
+
+  memset(&local_address, 0, sizeof(local_address));
+  local_address.nl_family = AF_NETLINK;
+  local_address.nl_groups = RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+  if (bind(_netlink_socket, (struct sockaddr *)&local_address, sizeof(local_address)) < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to subscribe to host address changes: %s\n", strerror(-rc));
+    stop_monitor();
+    return rc;
+  }
+
+  _stop_event = eventfd(0, EFD_CLOEXEC);
+  if (_stop_event < 0) {
+    rc = -errno;
+    ACA_LOG_ERROR("Failed to create the monitor stop event: %s\n", strerror(-rc));
+    stop_monitor();
+    return rc;
+  }
+
+  // subscribed before loading, so a change made in between is not missed
+  rc = load_local_addresses();
+  if (rc != EXIT_SUCCESS) {
+    stop_monitor();
+    return rc;
+  }
+
+  _monitor_thread = thread(&ACA_Host_Ip_Set::_monitor_loop, this);
+  return EXIT_SUCCESS;
+}
+
+void ACA_Host_Ip_Set::stop_monitor()
+{
+  if (_monitor_thread.joinable()) {
+    uint64_t stop = 1;
+    if (write(_stop_event, &stop, sizeof(stop)) != sizeof(stop)) {
+      ACA_LOG_ERROR("Failed to stop the host address monitor: %s\n", strerror(errno));
+    }
+    _monitor_thread.join();
+  }
+  if (_netlink_socket >= 0) {
+    close(_netlink_socket);
+    _netlink_socket = -1;
+  }
+  if (_stop_event >= 0) {
+    close(_stop_event);
+    _stop_event = -1;
+  }
+}
+
+void ACA_Host_Ip_Set::_monitor_loop()
+{
+  alignas(struct nlmsghdr) char buffer[HOST_IP_MONITOR_BUFFER_SIZE];
+  struct pollfd poll_fds[2] = { { _netlink_socket, POLLIN, 0 }, { _stop_event, POLLIN, 0 } };
+
+  ACA_LOG_INFO("%s", "Host address monitor started\n");
+
+  while (true) {
+    if (poll(poll_fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ACA_LOG_ERROR("Host address monitor poll failed: %s\n", strerror(errno));
+      break;
+    }
+    if (poll_fds[1].revents != 0) {
+      break;
+    }
+    if (poll_fds[0].revents == 0) {
+      continue;
+    }
+
+    ssize_t length = recv(_netlink_socket, buffer, sizeof(buffer), 0);
+    if (length < 0) {
+      if (errno == EINTR || errno == EAGAIN) {
+        continue;
+      }
+      if (errno == ENOBUFS) {
+        // the kernel dropped notifications, start over from the current addresses
+        ACA_LOG_WARN("%s", "Host address notifications were lost, reloading\n");
+        load_local_addresses();
+        continue;
+      }
+      ACA_LOG_ERROR("Host address monitor recv failed: %s\n", strerror(errno));
+      break;
+    }
+    apply_netlink_messages(buffer, (size_t)length);
+  }
+
+  ACA_LOG_INFO("%s", "Host address monitor stopped\n");
+}
+} // namespace aca_ovs_l2_programmer
@@ -18,6 +18,8 @@
 #include "aca_net_config.h"
 #include "aca_vlan_manager.h"
 #include "aca_ovs_l2_programmer.h"
+#include "aca_revision_tracker.h"
+#include "aca_update_coalescer.h"
 #include <chrono>
 #include <thread>
 #include <errno.h>
@@ -25,12 +27,9 @@
 #include <boost/algorithm/string/split.hpp> // Include for boost::split
 #include <arpa/inet.h>
 #include <sys/socket.h>
-#include <netdb.h>
-#include <ifaddrs.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <linux/if_link.h>
 
 using namespace std;
 using namespace aca_vlan_manager;
@@ -95,70 +94,22 @@ ACA_OVS_L2_Programmer &ACA_OVS_L2_Programmer::get_instance()
 
 bool ACA_OVS_L2_Programmer::is_ip_on_the_same_host(const std::string host_ip)
 {
-  return std::find(this->host_ips_vector.begin(), this->host_ips_vector.end(),
-                   host_ip) != this->host_ips_vector.end();
+  return _host_ips.contains(host_ip);
 }
 
-void ACA_OVS_L2_Programmer::get_local_host_ips()
+bool ACA_OVS_L2_Programmer::is_ip_on_the_same_host(const aca_net_types::ipv4_addr host_ip)
 {
-  struct ifaddrs *ifaddr, *ifa;
-  int family, s, n;
-  char host[NI_MAXHOST];
+  return _host_ips.contains(ACA_Host_Ip_Set::from_ipv4(host_ip.value));
+}
 
-  if (getifaddrs(&ifaddr) == -1) {
-    perror("getifaddrs");
+void ACA_OVS_L2_Programmer::get_local_host_ips()
+{
+  // without the netlink notifications, fall back to the addresses seen at startup
+  if (_host_ips.start_monitor() != EXIT_SUCCESS &&
+      _host_ips.load_local_addresses() != EXIT_SUCCESS) {
     exit(EXIT_FAILURE);
   }
-
-  /* Walk through linked list, maintaining head pointer so we
-       can free list later */
-
-  for (ifa = ifaddr, n = 0; ifa != NULL; ifa = ifa->ifa_next, n++) {
-    if (ifa->ifa_addr == NULL)
-      continue;
-
-    family = ifa->ifa_addr->sa_family;
-
-    /* Display interface name and family (including symbolic
-           form of the latter for the common families) */
-
-    ACA_LOG_INFO("%-8s %s (%d)\n", ifa->ifa_name,
-                 (family == AF_PACKET) ? "AF_PACKET" :
-                 (family == AF_INET)   ? "AF_INET" :
-                 (family == AF_INET6)  ? "AF_INET6" :
-                                         "???",
-                 family);
-
-    /* For an AF_INET* interface address, display the address */
-
-    if (family == AF_INET || family == AF_INET6) {
-      s = getnameinfo(ifa->ifa_addr,
-                      (family == AF_INET) ? sizeof(struct sockaddr_in) :
-                                            sizeof(struct sockaddr_in6),
-                      host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST);
-      if (s != 0) {
-        ACA_LOG_WARN("getnameinfo() failed: %s\n", gai_strerror(s));
-        exit(EXIT_FAILURE);
-      }
-
-      ACA_LOG_INFO("\t\taddress: <%s>\n", host);
-      std::string host_ip_string = std::string(host);
-      host_ips_vector.push_back(host_ip_string);
-    }
-  }
-
-  freeifaddrs(ifaddr);
-
-  vector<string>::iterator it = host_ips_vector.begin();
-  while (it != host_ips_vector.end()) {
-    ACA_LOG_DEBUG("Current Host IP: [%s]\n", it->c_str());
-    if (it->empty()) {
-      ACA_LOG_DEBUG("Removing empty IP: [%s]\n", it->c_str());
-      it = host_ips_vector.erase(it);
-    } else {
-      it++;
-    }
-  }
+  ACA_LOG_INFO("Found %zu addresses on this host\n", _host_ips.size());
 }
 
 int ACA_OVS_L2_Programmer::setup_ovs_bridges_if_need()
@@ -242,6 +193,12 @@ int ACA_OVS_L2_Programmer::setup_ovs_bridges_if_need()
 
     execute_openflow_command("add-flow br-tun \"table=0,priority=25,in_port=\"vxlan-generic\" actions=resubmit(,4)\"",
                              not_care_culminative_time, overall_rc);
+
+    // nothing programmed before survived the new bridges
+    aca_revision_tracker::ACA_Revision_Tracker::get_instance().clear();
+    aca_update_coalescer::ACA_Update_Coalescer::get_instance().clear();
+    _bridges_created = true;
+
     setup_ovs_bridges_mutex.unlock();
     // -----critical section ends-----
 
@@ -274,6 +231,11 @@ int ACA_OVS_L2_Programmer::setup_ovs_bridges_if_need()
   return overall_rc;
 }
 
+bool ACA_OVS_L2_Programmer::is_bridges_created()
+{
+  return _bridges_created.load();
+}
+
 int ACA_OVS_L2_Programmer::create_port(const string vpc_id, const string port_name,
                                        const string virtual_ip, const string virtual_mac,
                                        uint tunnel_id, ulong &culminative_time)
@@ -21,6 +21,9 @@
 #include "aca_ovs_l3_programmer.h"
 #include "goalstateprovisioner.grpc.pb.h"
 #include "aca_arp_responder.h"
+#include "aca_id_table.h"
+#include "aca_revision_tracker.h"
+#include "aca_update_coalescer.h"
 #include <unordered_map>
 #include <mutex>
 #include <chrono>
@@ -31,9 +34,47 @@ using namespace std;
 using namespace aca_vlan_manager;
 using namespace aca_ovs_l2_programmer;
 using namespace aca_arp_responder;
+using aca_goal_state_index::ACA_Goal_State_Index;
+using aca_goal_state_index::neighbor_fixed_ip_entry;
+using aca_id_table::ACA_Id_Table;
 
 namespace aca_ovs_l3_programmer
 {
+// references taken while a router update or a restore is built, the routers
+// table takes its own for the entries it keeps when they are stored
+class id_reference_holder {
+  public:
+  ~id_reference_holder()
+  {
+    for (id_handle handle : _handles) {
+      ACA_Id_Table::get_instance().release(handle);
+    }
+  }
+
+  // NO_HANDLE if the id table is full
+  id_handle intern(const string &id)
+  {
+    id_handle handle = ACA_Id_Table::get_instance().intern(id);
+    if (handle != ACA_Id_Table::NO_HANDLE) {
+      _handles.push_back(handle);
+    }
+    return handle;
+  }
+
+  // as intern(), the callers catch the exception
+  id_handle intern_or_throw(const string &id)
+  {
+    id_handle handle = intern(id);
+    if (handle == ACA_Id_Table::NO_HANDLE) {
+      throw std::runtime_error("id table is full");
+    }
+    return handle;
+  }
+
+  private:
+  vector<id_handle> _handles;
+};
+
 ACA_OVS_L3_Programmer &ACA_OVS_L3_Programmer::get_instance()
 {
   // Instance is destroyed when program exits.
@@ -48,18 +89,187 @@ void ACA_OVS_L3_Programmer::clear_all_data()
 
   // -----critical section starts-----
   _routers_table_mutex.lock();
+  for (auto &router : _routers_table) {
+    _move_table_references(router.second, nullptr);
+    ACA_Id_Table::get_instance().release(router.first);
+  }
   // All the elements in the unordered_map container are dropped:
   // their destructors are called, and they are removed from the container,
   // leaving _routers_table with a size of 0.
   _routers_table.clear();
+  _subnet_router_index.clear();
   _routers_table_mutex.unlock();
   // -----critical section ends-----
 
+  // routers and neighbors recorded as applied have to be programmed again
+  aca_revision_tracker::ACA_Revision_Tracker::get_instance().clear();
+  aca_update_coalescer::ACA_Update_Coalescer::get_instance().clear();
+
   ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::clear_all_data <--- Exiting\n");
 }
 
-int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_RouterConfiguration,
+void ACA_OVS_L3_Programmer::_index_router_subnets(id_handle router_handle)
+{
+  auto router_it = _routers_table.find(router_handle);
+  if (router_it == _routers_table.end()) {
+    return;
+  }
+  for (auto &kv : router_it->second) {
+    _subnet_router_index[kv.first] = router_handle;
+  }
+}
+
+void ACA_OVS_L3_Programmer::_unindex_router_subnets(id_handle router_handle)
+{
+  auto router_it = _routers_table.find(router_handle);
+  if (router_it == _routers_table.end()) {
+    return;
+  }
+  for (auto &kv : router_it->second) {
+    auto index_it = _subnet_router_index.find(kv.first);
+    // the subnet could have moved to another router since
+    if (index_it != _subnet_router_index.end() && index_it->second == router_handle) {
+      _subnet_router_index.erase(index_it);
+    }
+  }
+}
+
+void ACA_OVS_L3_Programmer::_move_table_references(
+        const unordered_map<id_handle, subnet_routing_table_entry> &old_subnets,
+        const unordered_map<id_handle, subnet_routing_table_entry> *new_subnets)
+{
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+
+  // take the references of the entries new_subnets adds before dropping the old ones,
+  // so an id kept under another entry never goes away in between
+  if (new_subnets != nullptr) {
+    for (auto &[subnet_handle, new_subnet] : *new_subnets) {
+      auto old_subnet_it = old_subnets.find(subnet_handle);
+      const subnet_routing_table_entry *old_subnet =
+              (old_subnet_it == old_subnets.end()) ? nullptr : &old_subnet_it->second;
+
+      if (old_subnet == nullptr) {
+        id_table.retain(subnet_handle);
+      }
+      if (old_subnet == nullptr || old_subnet->vpc_id != new_subnet.vpc_id) {
+        id_table.retain(new_subnet.vpc_id);
+      }
+      for (auto &neighbor : new_subnet.neighbor_ports) {
+        if (old_subnet == nullptr || old_subnet->neighbor_ports.count(neighbor.first) == 0) {
+          id_table.retain(neighbor.first);
+        }
+      }
+      for (auto &routing_rule : new_subnet.routing_rules) {
+        if (old_subnet == nullptr || old_subnet->routing_rules.count(routing_rule.first) == 0) {
+          id_table.retain(routing_rule.first);
+        }
+      }
+    }
+  }
+
+  for (auto &[subnet_handle, old_subnet] : old_subnets) {
+    const subnet_routing_table_entry *new_subnet = nullptr;
+    if (new_subnets != nullptr) {
+      auto new_subnet_it = new_subnets->find(subnet_handle);
+      if (new_subnet_it != new_subnets->end()) {
+        new_subnet = &new_subnet_it->second;
+      }
+    }
+
+    if (new_subnet == nullptr) {
+      id_table.release(subnet_handle);
+    }
+    if (new_subnet == nullptr || new_subnet->vpc_id != old_subnet.vpc_id) {
+      id_table.release(old_subnet.vpc_id);
+    }
+    for (auto &neighbor : old_subnet.neighbor_ports) {
+      if (new_subnet == nullptr || new_subnet->neighbor_ports.count(neighbor.first) == 0) {
+        id_table.release(neighbor.first);
+      }
+    }
+    for (auto &routing_rule : old_subnet.routing_rules) {
+      if (new_subnet == nullptr || new_subnet->routing_rules.count(routing_rule.first) == 0) {
+        id_table.release(routing_rule.first);
+      }
+    }
+  }
+}
+
+void ACA_OVS_L3_Programmer::_drop_deleted_neighbors(
+        id_handle router_handle, unordered_map<id_handle, subnet_routing_table_entry> &new_subnets)
+{
+  auto router_it = _routers_table.find(router_handle);
+
+  for (auto &[subnet_handle, new_subnet] : new_subnets) {
+    const subnet_routing_table_entry *old_subnet = nullptr;
+    if (router_it != _routers_table.end()) {
+      auto old_subnet_it = router_it->second.find(subnet_handle);
+      if (old_subnet_it != router_it->second.end()) {
+        old_subnet = &old_subnet_it->second;
+      }
+    }
+
+    for (auto neighbor_it = new_subnet.neighbor_ports.begin();
+         neighbor_it != new_subnet.neighbor_ports.end();) {
+      if (old_subnet == nullptr || old_subnet->neighbor_ports.count(neighbor_it->first) == 0) {
+        neighbor_it = new_subnet.neighbor_ports.erase(neighbor_it);
+      } else {
+        ++neighbor_it;
+      }
+    }
+  }
+}
+
+void ACA_OVS_L3_Programmer::_store_router_subnets(
+        id_handle router_handle, unordered_map<id_handle, subnet_routing_table_entry> &new_subnets)
+{
+  auto router_it = _routers_table.find(router_handle);
+
+  if (router_it == _routers_table.end()) {
+    ACA_Id_Table::get_instance().retain(router_handle);
+    router_it = _routers_table.emplace(router_handle, new_subnets).first;
+    _move_table_references({}, &new_subnets);
+  } else {
+    _unindex_router_subnets(router_handle);
+    _move_table_references(router_it->second, &new_subnets);
+    router_it->second = new_subnets;
+  }
+  _index_router_subnets(router_handle);
+}
+
+bool ACA_OVS_L3_Programmer::_erase_router(id_handle router_handle)
+{
+  auto router_it = _routers_table.find(router_handle);
+  if (router_it == _routers_table.end()) {
+    return false;
+  }
+
+  _unindex_router_subnets(router_handle);
+  _move_table_references(router_it->second, nullptr);
+  _routers_table.erase(router_it);
+  ACA_Id_Table::get_instance().release(router_handle);
+  return true;
+}
+
+unordered_map<id_handle, subnet_routing_table_entry> *
+ACA_OVS_L3_Programmer::_find_router_subnets(id_handle subnet_handle, id_handle &router_handle)
+{
+  auto index_it = _subnet_router_index.find(subnet_handle);
+  if (index_it == _subnet_router_index.end()) {
+    return nullptr;
+  }
+  auto router_it = _routers_table.find(index_it->second);
+  if (router_it == _routers_table.end() ||
+      router_it->second.find(subnet_handle) == router_it->second.end()) {
+    return nullptr;
+  }
+  router_handle = router_it->first;
+  return &router_it->second;
+}
+
+int ACA_OVS_L3_Programmer::create_or_update_router(const RouterConfiguration &current_RouterConfiguration,
                                                    GoalState &parsed_struct,
+                                                   const ACA_Goal_State_Index &goal_state_index,
                                                    ulong &dataplane_programming_time)
 {
   ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::create_or_update_router ---> Entering\n");
@@ -89,6 +299,12 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
     ACA_LOG_ERROR("%s", "router_id is empty");
     return -EINVAL;
   }
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  id_reference_holder update_references;
+  id_handle router_handle = update_references.intern(router_id);
+  if (router_handle == ACA_Id_Table::NO_HANDLE) {
+    return -ENOSPC;
+  }
 
   if (!aca_validate_mac_address(
               current_RouterConfiguration.host_dvr_mac_address().c_str())) {
@@ -110,16 +326,16 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
   // do nothing for (_host_dvr_mac == current_RouterConfiguration.host_dvr_mac_address())
 
   // -----critical section starts-----
-  _routers_table_mutex.lock();
-  if (_routers_table.find(router_id) == _routers_table.end()) {
+  _routers_table_mutex.lock_shared();
+  if (_routers_table.find(router_handle) == _routers_table.end()) {
     is_router_exist = false;
   } else {
     is_router_exist = true;
   }
-  _routers_table_mutex.unlock();
+  _routers_table_mutex.unlock_shared();
   // -----critical section ends-----
 
-  unordered_map<string, subnet_routing_table_entry> new_subnet_routing_tables;
+  unordered_map<id_handle, subnet_routing_table_entry> new_subnet_routing_tables;
 
   try {
     if (is_router_exist) {
@@ -133,7 +349,14 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
       } else {
         // current_RouterConfiguration.update_type() == UpdateType::DELTA
         // carefully update the existing entry with new information
-        new_subnet_routing_tables = _routers_table[router_id];
+        // -----critical section starts-----
+        _routers_table_mutex.lock_shared();
+        auto router_it = _routers_table.find(router_handle);
+        if (router_it != _routers_table.end()) {
+          new_subnet_routing_tables = router_it->second;
+        }
+        _routers_table_mutex.unlock_shared();
+        // -----critical section ends-----
       }
     }
 
@@ -143,330 +366,303 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
     // it is okay for have subnet_routing_tables_size = 0
     for (int i = 0; i < current_RouterConfiguration.subnet_routing_tables_size(); i++) {
-      auto current_subnet_routing_table =
+      auto &current_subnet_routing_table =
               current_RouterConfiguration.subnet_routing_tables(i);
 
       string current_router_subnet_id = current_subnet_routing_table.subnet_id();
+      id_handle current_router_subnet_handle =
+              update_references.intern_or_throw(current_router_subnet_id);
 
       ACA_LOG_DEBUG("Processing subnet ID: %s for router ID: %s.\n",
                     current_router_subnet_id.c_str(),
                     current_RouterConfiguration.id().c_str());
 
       // check if current_router_subnet_id already exist in new_subnet_routing_tables
-      if (new_subnet_routing_tables.find(current_router_subnet_id) !=
+      if (new_subnet_routing_tables.find(current_router_subnet_handle) !=
           new_subnet_routing_tables.end()) {
         is_subnet_routing_table_exist = true;
       }
 
       // Look up the subnet configuration to query for additional info
-      for (int j = 0; j < parsed_struct.subnet_states_size(); j++) {
-        SubnetConfiguration current_SubnetConfiguration =
-                parsed_struct.subnet_states(j).configuration();
+      const SubnetState *found_SubnetState =
+              goal_state_index.find_subnet(current_router_subnet_id);
 
-        ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
-                      current_SubnetConfiguration.id().c_str());
+      if (found_SubnetState != nullptr &&
+          found_SubnetState->operation_type() == OperationType::INFO) {
+        const SubnetConfiguration &current_SubnetConfiguration =
+                found_SubnetState->configuration();
+
+        found_vpc_id = current_SubnetConfiguration.vpc_id();
 
-        if ((parsed_struct.subnet_states(j).operation_type() == OperationType::INFO) &&
-            (current_SubnetConfiguration.id() == current_router_subnet_id)) {
-          found_vpc_id = current_SubnetConfiguration.vpc_id();
+        found_cidr = current_SubnetConfiguration.cidr();
 
-          found_cidr = current_SubnetConfiguration.cidr();
+        slash_pos = found_cidr.find('/');
+        if (slash_pos == string::npos) {
+          throw std::invalid_argument("'/' not found in cidr");
+        }
+        found_network_type = current_SubnetConfiguration.network_type();
+        found_tunnel_id = current_SubnetConfiguration.tunnel_id();
+        if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
+          throw std::invalid_argument("found_tunnel_id is invalid");
+        }
 
-          slash_pos = found_cidr.find('/');
-          if (slash_pos == string::npos) {
-            throw std::invalid_argument("'/' not found in cidr");
-          }
-          found_network_type = current_SubnetConfiguration.network_type();
-          found_tunnel_id = current_SubnetConfiguration.tunnel_id();
-          if (!aca_validate_tunnel_id(found_tunnel_id, found_network_type)) {
-            throw std::invalid_argument("found_tunnel_id is invalid");
-          }
+        // subnet info's gateway ip and mac needs to be there and valid
+        found_gateway_ip = current_SubnetConfiguration.gateway().ip_address();
 
-          // subnet info's gateway ip and mac needs to be there and valid
-          found_gateway_ip = current_SubnetConfiguration.gateway().ip_address();
+        // inet_pton returns 1 for success 0 for failure
+        if (inet_pton(AF_INET, found_gateway_ip.c_str(), &(sa.sin_addr)) != 1) {
+          throw std::invalid_argument("found gateway ip address is not in the expect format");
+        }
 
-          // inet_pton returns 1 for success 0 for failure
-          if (inet_pton(AF_INET, found_gateway_ip.c_str(), &(sa.sin_addr)) != 1) {
-            throw std::invalid_argument("found gateway ip address is not in the expect format");
-          }
+        found_gateway_mac = current_SubnetConfiguration.gateway().mac_address();
 
-          found_gateway_mac = current_SubnetConfiguration.gateway().mac_address();
+        if (!aca_validate_mac_address(found_gateway_mac.c_str())) {
+          throw std::invalid_argument("found_gateway_mac is invalid");
+        }
 
-          if (!aca_validate_mac_address(found_gateway_mac.c_str())) {
-            throw std::invalid_argument("found_gateway_mac is invalid");
-          }
+        subnet_routing_table_entry new_subnet_routing_table_entry;
+
+        if (is_subnet_routing_table_exist) {
+          new_subnet_routing_table_entry =
+                  new_subnet_routing_tables[current_router_subnet_handle];
+        }
+
+        // update the subnet routing table entry
+        new_subnet_routing_table_entry.vpc_id = update_references.intern_or_throw(found_vpc_id);
+        new_subnet_routing_table_entry.network_type = found_network_type;
+        new_subnet_routing_table_entry.cidr = found_cidr;
+        new_subnet_routing_table_entry.tunnel_id = found_tunnel_id;
+        new_subnet_routing_table_entry.gateway_ip = found_gateway_ip;
+        new_subnet_routing_table_entry.gateway_mac = found_gateway_mac;
+        // don't need to handle the gateway_ip and gateway_mac change, because that will
+        // require the subnet to remove the gateway port and add in a new one
 
-          subnet_routing_table_entry new_subnet_routing_table_entry;
+        source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
 
-          if (is_subnet_routing_table_exist) {
-            new_subnet_routing_table_entry =
-                    new_subnet_routing_tables[current_router_subnet_id];
+        current_gateway_mac = found_gateway_mac;
+        current_gateway_mac.erase(
+                remove(current_gateway_mac.begin(), current_gateway_mac.end(), ':'),
+                current_gateway_mac.end());
+
+        addr = inet_network(found_gateway_ip.c_str());
+        snprintf(hex_ip_buffer, HEX_IP_BUFFER_SIZE, "0x%08x", addr);
+
+        // Program ARP responder:
+        arp_config stArpCfg;
+
+        stArpCfg.mac_address = found_gateway_mac;
+        stArpCfg.ipv4_address = found_gateway_ip;
+        stArpCfg.vlan_id = source_vlan_id;
+
+        ACA_ARP_Responder::get_instance().create_or_update_arp_entry(&stArpCfg);
+
+        ACA_LOG_DEBUG("Add arp entry for gateway: ip = %s,vlan id = %u and mac = %s",
+                      found_gateway_ip.c_str(), source_vlan_id,
+                      found_gateway_mac.c_str());
+
+        // Program ICMP responder:
+        cmd_string =
+                "add-flow br-tun \"table=52,priority=50,icmp,dl_vlan=" +
+                to_string(source_vlan_id) + ",nw_dst=" + found_gateway_ip +
+                " actions=move:NXM_OF_ETH_SRC[]->NXM_OF_ETH_DST[],mod_dl_src:" + found_gateway_mac +
+                ",move:NXM_OF_IP_SRC[]->NXM_OF_IP_DST[],mod_nw_src:" + found_gateway_ip +
+                ",load:0xff->NXM_NX_IP_TTL[],load:0->NXM_OF_ICMP_TYPE[],in_port\"";
+
+        ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+                cmd_string, dataplane_programming_time, overall_rc);
+        // Should be able to ping the gateway now
+
+        // add essential rule to restore from neighbor host DVR mac to destination GW mac:
+        // Note: all port from the same subnet on current host will share this rule
+        cmd_string = "add-flow br-int \"table=0,priority=25,dl_vlan=" +
+                     to_string(source_vlan_id) + ",dl_src=" + HOST_DVR_MAC_MATCH +
+                     " actions=mod_dl_src:" + found_gateway_mac + " output:NORMAL\"";
+
+        ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+                cmd_string, dataplane_programming_time, overall_rc);
+
+        for (int k = 0; k < current_subnet_routing_table.routing_rules_size(); k++) {
+          auto &current_routing_rule = current_subnet_routing_table.routing_rules(k);
+          // a rule to delete is in the table already if it is known at all
+          id_handle current_routing_rule_handle =
+                  (current_routing_rule.operation_type() == OperationType::DELETE) ?
+                          id_table.find(current_routing_rule.id()) :
+                          update_references.intern_or_throw(current_routing_rule.id());
+
+          // check if current_routing_rule already exist in new_subnet_routing_tables
+          if (new_subnet_routing_table_entry.routing_rules.find(
+                      current_routing_rule_handle) !=
+              new_subnet_routing_table_entry.routing_rules.end()) {
+            is_routing_rule_exist = true;
           }
 
-          // update the subnet routing table entry
-          new_subnet_routing_table_entry.vpc_id = found_vpc_id;
-          new_subnet_routing_table_entry.network_type = found_network_type;
-          new_subnet_routing_table_entry.cidr = found_cidr;
-          new_subnet_routing_table_entry.tunnel_id = found_tunnel_id;
-          new_subnet_routing_table_entry.gateway_ip = found_gateway_ip;
-          new_subnet_routing_table_entry.gateway_mac = found_gateway_mac;
-          // don't need to handle the gateway_ip and gateway_mac change, because that will
-          // require the subnet to remove the gateway port and add in a new one
-
-          source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
-
-          current_gateway_mac = found_gateway_mac;
-          current_gateway_mac.erase(
-                  remove(current_gateway_mac.begin(), current_gateway_mac.end(), ':'),
-                  current_gateway_mac.end());
-
-          addr = inet_network(found_gateway_ip.c_str());
-          snprintf(hex_ip_buffer, HEX_IP_BUFFER_SIZE, "0x%08x", addr);
-
-          // Program ARP responder:
-          arp_config stArpCfg;
-
-          stArpCfg.mac_address = found_gateway_mac;
-          stArpCfg.ipv4_address = found_gateway_ip;
-          stArpCfg.vlan_id = source_vlan_id;
-
-          ACA_ARP_Responder::get_instance().create_or_update_arp_entry(&stArpCfg);
-
-          ACA_LOG_DEBUG("Add arp entry for gateway: ip = %s,vlan id = %u and mac = %s",
-                        found_gateway_ip.c_str(), source_vlan_id,
-                        found_gateway_mac.c_str());
-
-          // Program ICMP responder:
-          cmd_string =
-                  "add-flow br-tun \"table=52,priority=50,icmp,dl_vlan=" +
-                  to_string(source_vlan_id) + ",nw_dst=" + found_gateway_ip +
-                  " actions=move:NXM_OF_ETH_SRC[]->NXM_OF_ETH_DST[],mod_dl_src:" + found_gateway_mac +
-                  ",move:NXM_OF_IP_SRC[]->NXM_OF_IP_DST[],mod_nw_src:" + found_gateway_ip +
-                  ",load:0xff->NXM_NX_IP_TTL[],load:0->NXM_OF_ICMP_TYPE[],in_port\"";
-
-          ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-                  cmd_string, dataplane_programming_time, overall_rc);
-          // Should be able to ping the gateway now
-
-          // add essential rule to restore from neighbor host DVR mac to destination GW mac:
-          // Note: all port from the same subnet on current host will share this rule
-          cmd_string = "add-flow br-int \"table=0,priority=25,dl_vlan=" +
-                       to_string(source_vlan_id) + ",dl_src=" + HOST_DVR_MAC_MATCH +
-                       " actions=mod_dl_src:" + found_gateway_mac + " output:NORMAL\"";
-
-          ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-                  cmd_string, dataplane_programming_time, overall_rc);
-
-          for (int k = 0; k < current_subnet_routing_table.routing_rules_size(); k++) {
-            auto current_routing_rule = current_subnet_routing_table.routing_rules(k);
-
-            // check if current_routing_rule already exist in new_subnet_routing_tables
-            if (new_subnet_routing_table_entry.routing_rules.find(
-                        current_routing_rule.id()) !=
-                new_subnet_routing_table_entry.routing_rules.end()) {
-              is_routing_rule_exist = true;
+          // populate the routing_rule_entry and add that to
+          // new_subnet_routing_table_entry.routing_rules only if the
+          // operation type for that routing_rule is CREATE/UPDATE/INFO
+          if ((current_routing_rule.operation_type() == OperationType::CREATE) ||
+              (current_routing_rule.operation_type() == OperationType::UPDATE) ||
+              (current_routing_rule.operation_type() == OperationType::INFO)) {
+            routing_rule_entry new_routing_rule_entry;
+
+            if (is_routing_rule_exist) {
+              new_routing_rule_entry =
+                      new_subnet_routing_table_entry
+                              .routing_rules[current_routing_rule_handle];
             }
 
-            // populate the routing_rule_entry and add that to
-            // new_subnet_routing_table_entry.routing_rules only if the
-            // operation type for that routing_rule is CREATE/UPDATE/INFO
-            if ((current_routing_rule.operation_type() == OperationType::CREATE) ||
-                (current_routing_rule.operation_type() == OperationType::UPDATE) ||
-                (current_routing_rule.operation_type() == OperationType::INFO)) {
-              routing_rule_entry new_routing_rule_entry;
-
-              if (is_routing_rule_exist) {
-                new_routing_rule_entry =
-                        new_subnet_routing_table_entry
-                                .routing_rules[current_routing_rule.id()];
-              }
+            new_routing_rule_entry.next_hop_ip = current_routing_rule.next_hop_ip();
+            new_routing_rule_entry.priority = current_routing_rule.priority();
+            new_routing_rule_entry.destination_type =
+                    current_routing_rule.routing_rule_extra_info().destination_type();
+            new_routing_rule_entry.next_hop_mac =
+                    current_routing_rule.routing_rule_extra_info().next_hop_mac();
 
-              new_routing_rule_entry.next_hop_ip = current_routing_rule.next_hop_ip();
-              new_routing_rule_entry.priority = current_routing_rule.priority();
-              new_routing_rule_entry.destination_type =
-                      current_routing_rule.routing_rule_extra_info().destination_type();
-              new_routing_rule_entry.next_hop_mac =
-                      current_routing_rule.routing_rule_extra_info().next_hop_mac();
-
-              auto remote_host_ip = "";
-              ulong culminative_dataplane_programming_time = 0;
-              for (int x = 0; x < parsed_struct.neighbor_states_size(); x++) {
-                NeighborConfiguration current_NeighborConfiguration1 =
-                        parsed_struct.neighbor_states(x).configuration();
-                ACA_LOG_INFO("current_NeighborConfiguration.host_ip_address(): %s \n",
-                             current_NeighborConfiguration1.host_ip_address().c_str());
-                for (int y = 0; y < current_NeighborConfiguration1.fixed_ips_size(); y++) {
-                  ACA_LOG_INFO("current_NeighborConfiguration.fixed_ips(%d): neighbor_type: %d, subnet_id %s, ip_address %s \n",
-                               y, current_NeighborConfiguration1.fixed_ips(y).neighbor_type(),
-                               current_NeighborConfiguration1.fixed_ips(y)
-                                       .subnet_id()
-                                       .c_str(),
-                               current_NeighborConfiguration1.fixed_ips(y)
-                                       .ip_address()
-                                       .c_str());
-                  ACA_LOG_INFO("current_routing_rule.next_hop_ip() %s\n",
-                               current_routing_rule.next_hop_ip().c_str());
-                  auto current_fixed_ip = current_NeighborConfiguration1.fixed_ips(y);
-                  string virtual_ip_address = current_fixed_ip.ip_address();
-                  string virtual_mac_address =
-                          current_NeighborConfiguration1.mac_address();
-                  string gw_mac;
-                  uint dest_tunnel_id = 0;
-
-                  if (strcmp(current_routing_rule.next_hop_ip().c_str(),
-                             current_fixed_ip.ip_address().c_str()) == 0) {
-                    for (int z = 0; z < parsed_struct.subnet_states_size(); z++) {
-                      SubnetConfiguration config =
-                              parsed_struct.subnet_states(z).configuration();
-                      ACA_LOG_INFO("config.id(): %s\n", config.id().c_str());
-                      ACA_LOG_INFO("current_fixed_ip.subnet_id(): %s\n",
-                                   current_fixed_ip.subnet_id());
-                      if (config.id() ==
-                          current_NeighborConfiguration1.fixed_ips(y).subnet_id()) {
-                        gw_mac = config.gateway().mac_address();
-                        dest_tunnel_id = config.tunnel_id();
-                        ACA_LOG_INFO("gw_mac: %s\n", gw_mac.c_str());
-                        ACA_LOG_INFO("dest_tunnel_id: %d\n", dest_tunnel_id);
-                      }
-                    }
-                    remote_host_ip =
-                            current_NeighborConfiguration1.host_ip_address().c_str();
-                    int source_vlan_id =
-                            ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
-
-                    int destination_vlan_id =
-                            ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(dest_tunnel_id);
-
-                    bool is_port_on_same_host =
-                            ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(remote_host_ip);
-
-                    ACA_LOG_INFO("current_fixed_ip.subnet_id(): %s\n",
-                                 current_fixed_ip.subnet_id().c_str());
-                    ACA_LOG_INFO("current_subnet_routing_table.subnet_id(): %s\n",
-                                 current_subnet_routing_table.subnet_id().c_str());
-
-                    if (is_port_on_same_host) {
-                      if (current_fixed_ip.subnet_id() !=
-                          current_subnet_routing_table.subnet_id()) {
-                        cmd_string =
-                                "add-flow br-tun \"table=0,priority=50,ip,dl_vlan=" +
-                                to_string(source_vlan_id) +
-                                ",nw_dst=" + current_routing_rule.destination() +
-                                ",dl_dst=" + found_gateway_mac +
-                                " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
-                                ",mod_dl_src:" + gw_mac +
-                                ",mod_dl_dst:" + virtual_mac_address + ",output:IN_PORT\"";
-                      }
-                    } else {
-                      cmd_string =
-                              "add-flow br-tun \"table=0,priority=50,ip,dl_vlan=" +
-                              to_string(source_vlan_id) +
-                              ",nw_dst=" + current_routing_rule.destination() +
-                              ",dl_dst=" + found_gateway_mac +
-                              " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
-                              ",mod_dl_src:" + _host_dvr_mac +
-                              ",mod_dl_dst:" + virtual_mac_address + ",resubmit(,2)\"";
-                    }
-
-                    ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-                            cmd_string, culminative_dataplane_programming_time, overall_rc);
-                  }
-                }
-                if (strcmp(remote_host_ip, "") != 0) {
-                  break;
-                }
+            ulong culminative_dataplane_programming_time = 0;
+            neighbor_fixed_ip_entry next_hop_neighbor;
+
+            if (goal_state_index.find_neighbor_fixed_ip(current_routing_rule.next_hop_ip(),
+                                                         next_hop_neighbor)) {
+              const NeighborConfiguration &current_NeighborConfiguration1 =
+                      *next_hop_neighbor.neighbor_configuration;
+              auto &current_fixed_ip = *next_hop_neighbor.fixed_ip;
+              string virtual_mac_address = current_NeighborConfiguration1.mac_address();
+              string gw_mac;
+              uint dest_tunnel_id = 0;
+
+              const SubnetState *dest_SubnetState =
+                      goal_state_index.find_subnet(current_fixed_ip.subnet_id());
+              if (dest_SubnetState != nullptr) {
+                gw_mac = dest_SubnetState->configuration().gateway().mac_address();
+                dest_tunnel_id = dest_SubnetState->configuration().tunnel_id();
+                ACA_LOG_INFO("gw_mac: %s\n", gw_mac.c_str());
+                ACA_LOG_INFO("dest_tunnel_id: %d\n", dest_tunnel_id);
               }
 
-              if (!is_routing_rule_exist) {
-                new_subnet_routing_table_entry.routing_rules.emplace(
-                        current_routing_rule.id(), new_routing_rule_entry);
+              const string &remote_host_ip = current_NeighborConfiguration1.host_ip_address();
+              int source_vlan_id =
+                      ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
 
-                ACA_LOG_INFO("Added routing table entry for routering rule id %s\n",
-                             current_routing_rule.id().c_str());
+              int destination_vlan_id =
+                      ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(dest_tunnel_id);
+
+              bool is_port_on_same_host =
+                      ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(remote_host_ip);
+
+              ACA_LOG_INFO("current_fixed_ip.subnet_id(): %s\n",
+                           current_fixed_ip.subnet_id().c_str());
+              ACA_LOG_INFO("current_subnet_routing_table.subnet_id(): %s\n",
+                           current_subnet_routing_table.subnet_id().c_str());
+
+              if (is_port_on_same_host) {
+                if (current_fixed_ip.subnet_id() != current_subnet_routing_table.subnet_id()) {
+                  cmd_string =
+                          "add-flow br-tun \"table=0,priority=50,ip,dl_vlan=" +
+                          to_string(source_vlan_id) +
+                          ",nw_dst=" + current_routing_rule.destination() +
+                          ",dl_dst=" + found_gateway_mac +
+                          " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
+                          ",mod_dl_src:" + gw_mac +
+                          ",mod_dl_dst:" + virtual_mac_address + ",output:IN_PORT\"";
+                }
               } else {
-                ACA_LOG_INFO("Using existing routing table entry for routering rule id %s\n",
-                             current_routing_rule.id().c_str());
+                cmd_string =
+                        "add-flow br-tun \"table=0,priority=50,ip,dl_vlan=" +
+                        to_string(source_vlan_id) +
+                        ",nw_dst=" + current_routing_rule.destination() +
+                        ",dl_dst=" + found_gateway_mac +
+                        " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
+                        ",mod_dl_src:" + _host_dvr_mac +
+                        ",mod_dl_dst:" + virtual_mac_address + ",resubmit(,2)\"";
               }
 
-            } else if (current_routing_rule.operation_type() == OperationType::DELETE) {
-              int source_vlan_id =
-                      ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
-              string cmd_string =
-                      "del-flows br-tun \"table=0,priority=50,ip,dl_vlan=" +
-                      to_string(source_vlan_id) + ",dl_dst=" + found_gateway_mac +
-                      ",nw_dst=" + current_routing_rule.destination() + "\" --strict";
-
               ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
                       cmd_string, culminative_dataplane_programming_time, overall_rc);
-              if (new_subnet_routing_table_entry.routing_rules.erase(
-                          current_routing_rule.id())) {
-                ACA_LOG_INFO("Successfuly cleaned up entry for router rule id %s\n",
-                             current_routing_rule.id().c_str());
-              } else {
-                ACA_LOG_ERROR("Failed to clean up entry for router rule id %s\n",
-                              current_routing_rule.id().c_str());
-                overall_rc = EXIT_FAILURE;
-              }
+            }
+
+            if (!is_routing_rule_exist) {
+              new_subnet_routing_table_entry.routing_rules.emplace(
+                      current_routing_rule_handle, new_routing_rule_entry);
+
+              ACA_LOG_INFO("Added routing table entry for routering rule id %s\n",
+                           current_routing_rule.id().c_str());
+            } else {
+              ACA_LOG_INFO("Using existing routing table entry for routering rule id %s\n",
+                           current_routing_rule.id().c_str());
+            }
+
+          } else if (current_routing_rule.operation_type() == OperationType::DELETE) {
+            int source_vlan_id =
+                    ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(found_tunnel_id);
+            string cmd_string =
+                    "del-flows br-tun \"table=0,priority=50,ip,dl_vlan=" +
+                    to_string(source_vlan_id) + ",dl_dst=" + found_gateway_mac +
+                    ",nw_dst=" + current_routing_rule.destination() + "\" --strict";
+
+            ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+                    cmd_string, culminative_dataplane_programming_time, overall_rc);
+            if (new_subnet_routing_table_entry.routing_rules.erase(
+                        current_routing_rule_handle)) {
+              ACA_LOG_INFO("Successfuly cleaned up entry for router rule id %s\n",
+                           current_routing_rule.id().c_str());
             } else {
-              ACA_LOG_ERROR("Invalid operation_type: %d for router_rule with ID: %s.\n",
-                            current_routing_rule.operation_type(),
+              ACA_LOG_ERROR("Failed to clean up entry for router rule id %s\n",
                             current_routing_rule.id().c_str());
               overall_rc = EXIT_FAILURE;
             }
-          }
-
-          if (!is_subnet_routing_table_exist) {
-            new_subnet_routing_tables.emplace(current_router_subnet_id,
-                                              new_subnet_routing_table_entry);
-
-            ACA_LOG_INFO("Added router subnet table entry for subnet id %s\n",
-                         current_router_subnet_id.c_str());
           } else {
-            ACA_LOG_INFO("Using existing router subnet table entry for subnet id %s\n",
-                         current_router_subnet_id.c_str());
-            new_subnet_routing_tables[current_router_subnet_id] = new_subnet_routing_table_entry;
-          }
-          ACA_LOG_DEBUG("After inserting subnet routing table entry for subnet: %s, printing out the contents:\n",
-                        current_router_subnet_id.c_str());
-          for (auto kv : new_subnet_routing_tables) {
-            ACA_LOG_DEBUG("subnet_id: %s\n", kv.first.c_str());
+            ACA_LOG_ERROR("Invalid operation_type: %d for router_rule with ID: %s.\n",
+                          current_routing_rule.operation_type(),
+                          current_routing_rule.id().c_str());
+            overall_rc = EXIT_FAILURE;
           }
-          subnet_info_found = true;
-          overall_rc = EXIT_SUCCESS;
-          break;
         }
 
-        if (!subnet_info_found) {
-          ACA_LOG_ERROR("Not able to find the info for router with subnet ID: %s.\n",
-                        current_router_subnet_id.c_str());
-          overall_rc = -EXIT_FAILURE;
+        if (!is_subnet_routing_table_exist) {
+          new_subnet_routing_tables.emplace(current_router_subnet_handle,
+                                            new_subnet_routing_table_entry);
+
+          ACA_LOG_INFO("Added router subnet table entry for subnet id %s\n",
+                       current_router_subnet_id.c_str());
+        } else {
+          ACA_LOG_INFO("Using existing router subnet table entry for subnet id %s\n",
+                       current_router_subnet_id.c_str());
+          new_subnet_routing_tables[current_router_subnet_handle] = new_subnet_routing_table_entry;
         }
-      } // for (int j = 0; j < parsed_struct.subnet_states_size(); j++)
+        ACA_LOG_DEBUG("After inserting subnet routing table entry for subnet: %s, printing out the contents:\n",
+                      current_router_subnet_id.c_str());
+        for (auto kv : new_subnet_routing_tables) {
+          ACA_LOG_DEBUG("subnet_id: %s\n", id_table.get_id(kv.first).c_str());
+        }
+        subnet_info_found = true;
+        overall_rc = EXIT_SUCCESS;
+      }
+
+      if (!subnet_info_found) {
+        ACA_LOG_ERROR("Not able to find the info for router with subnet ID: %s.\n",
+                      current_router_subnet_id.c_str());
+        overall_rc = -EXIT_FAILURE;
+      }
     } // for (int i = 0; i < current_RouterConfiguration.subnet_routing_tables_size(); i++)
 
     if (!is_router_exist || (current_RouterConfiguration.update_type() == UpdateType::FULL)) {
       // -----critical section starts-----
       _routers_table_mutex.lock();
-      _routers_table.emplace(router_id, new_subnet_routing_tables);
+      _store_router_subnets(router_handle, new_subnet_routing_tables);
       _routers_table_mutex.unlock();
       // -----critical section ends-----
       ACA_LOG_INFO("Added router entry for router id %s\n", router_id.c_str());
     } else {
       ACA_LOG_DEBUG("Using existing router entry for router id %s\n", router_id.c_str());
-      ACA_LOG_DEBUG("Let's print out what we have in router %s 's subnet routing table.\n",
-                    router_id);
-      for (auto kv : _routers_table[router_id]) {
-        ACA_LOG_DEBUG("subnet_id: %s\n", kv.first.c_str());
-      }
       // -----critical section starts-----
       _routers_table_mutex.lock();
-      _routers_table[router_id] = new_subnet_routing_tables;
+      _drop_deleted_neighbors(router_handle, new_subnet_routing_tables);
+      _store_router_subnets(router_handle, new_subnet_routing_tables);
       _routers_table_mutex.unlock();
       // -----critical section ends-----
       ACA_LOG_DEBUG("After updating, print out what we have in router %s 's subnet routing table.\n",
-                    router_id);
-      for (auto kv : _routers_table[router_id]) {
-        ACA_LOG_DEBUG("subnet_id: %s\n", kv.first.c_str());
+                    router_id.c_str());
+      for (auto &kv : new_subnet_routing_tables) {
+        ACA_LOG_DEBUG("subnet_id: %s\n", id_table.get_id(kv.first).c_str());
       }
     }
 
@@ -489,7 +685,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
   return overall_rc;
 } // namespace aca_ovs_l3_programmer
 
-int ACA_OVS_L3_Programmer::delete_router(RouterConfiguration &current_RouterConfiguration,
+int ACA_OVS_L3_Programmer::delete_router(const RouterConfiguration &current_RouterConfiguration,
                                          ulong &dataplane_programming_time)
 {
   ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::delete_router ---> Entering\n");
@@ -504,28 +700,32 @@ int ACA_OVS_L3_Programmer::delete_router(RouterConfiguration &current_RouterConf
     ACA_LOG_ERROR("%s", "router_id is empty");
     return -EINVAL;
   }
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  id_handle router_handle = id_table.find(router_id);
+
+  unordered_map<id_handle, subnet_routing_table_entry> router_subnet_routing_tables;
 
   // -----critical section starts-----
-  _routers_table_mutex.lock();
-  if (_routers_table.find(router_id) == _routers_table.end()) {
+  _routers_table_mutex.lock_shared();
+  auto router_it = _routers_table.find(router_handle);
+  if (router_it == _routers_table.end()) {
     ACA_LOG_ERROR("Entry not found for router_id %s\n", router_id.c_str());
     overall_rc = ENOENT;
   } else {
+    router_subnet_routing_tables = router_it->second;
     overall_rc = EXIT_SUCCESS;
   }
-  _routers_table_mutex.unlock();
+  _routers_table_mutex.unlock_shared();
   // -----critical section ends-----
 
   if (overall_rc == ENOENT) {
     return overall_rc;
   }
 
-  auto router_subnet_routing_tables = _routers_table[router_id];
-
   // for each connected subnet's gateway:
   for (auto subnet_it = router_subnet_routing_tables.begin();
        subnet_it != router_subnet_routing_tables.end(); subnet_it++) {
-    string subnet_entry_to_delete = subnet_it->first.c_str();
+    string subnet_entry_to_delete = id_table.get_id(subnet_it->first);
     ACA_LOG_DEBUG("Subnet_id entry to delete:%s\n", subnet_entry_to_delete.c_str());
 
     source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(
@@ -567,7 +767,7 @@ int ACA_OVS_L3_Programmer::delete_router(RouterConfiguration &current_RouterConf
 
   // -----critical section starts-----
   _routers_table_mutex.lock();
-  if (_routers_table.erase(router_id)) {
+  if (_erase_router(router_handle)) {
     ACA_LOG_INFO("Successfuly cleaned up entry for router_id %s\n", router_id.c_str());
     overall_rc = EXIT_SUCCESS;
   } else {
@@ -583,7 +783,7 @@ int ACA_OVS_L3_Programmer::delete_router(RouterConfiguration &current_RouterConf
   return overall_rc;
 }
 
-int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_RouterConfiguration,
+int ACA_OVS_L3_Programmer::create_or_update_router(const RouterConfiguration &current_RouterConfiguration,
                                                    GoalStateV2 &parsed_struct,
                                                    ulong &dataplane_programming_time)
 {
@@ -612,6 +812,12 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
     ACA_LOG_ERROR("%s", "router_id is empty");
     return -EINVAL;
   }
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  id_reference_holder update_references;
+  id_handle router_handle = update_references.intern(router_id);
+  if (router_handle == ACA_Id_Table::NO_HANDLE) {
+    return -ENOSPC;
+  }
 
   if (!aca_validate_mac_address(
               current_RouterConfiguration.host_dvr_mac_address().c_str())) {
@@ -633,16 +839,16 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
   // do nothing for (_host_dvr_mac == current_RouterConfiguration.host_dvr_mac_address())
 
   // -----critical section starts-----
-  _routers_table_mutex.lock();
-  if (_routers_table.find(router_id) == _routers_table.end()) {
+  _routers_table_mutex.lock_shared();
+  if (_routers_table.find(router_handle) == _routers_table.end()) {
     is_router_exist = false;
   } else {
     is_router_exist = true;
   }
-  _routers_table_mutex.unlock();
+  _routers_table_mutex.unlock_shared();
   // -----critical section ends-----
 
-  unordered_map<string, subnet_routing_table_entry> new_subnet_routing_tables;
+  unordered_map<id_handle, subnet_routing_table_entry> new_subnet_routing_tables;
 
   try {
     if (is_router_exist) {
@@ -656,7 +862,14 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
       } else {
         // current_RouterConfiguration.update_type() == UpdateType::DELTA
         // carefully update the existing entry with new information
-        new_subnet_routing_tables = _routers_table[router_id];
+        // -----critical section starts-----
+        _routers_table_mutex.lock_shared();
+        auto router_it = _routers_table.find(router_handle);
+        if (router_it != _routers_table.end()) {
+          new_subnet_routing_tables = router_it->second;
+        }
+        _routers_table_mutex.unlock_shared();
+        // -----critical section ends-----
       }
     }
 
@@ -666,17 +879,19 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
     // it is okay for have subnet_routing_tables_size = 0
     for (int i = 0; i < current_RouterConfiguration.subnet_routing_tables_size(); i++) {
-      auto current_subnet_routing_table =
+      auto &current_subnet_routing_table =
               current_RouterConfiguration.subnet_routing_tables(i);
 
       string current_router_subnet_id = current_subnet_routing_table.subnet_id();
+      id_handle current_router_subnet_handle =
+              update_references.intern_or_throw(current_router_subnet_id);
 
       ACA_LOG_DEBUG("Processing subnet ID: %s for router ID: %s.\n",
                     current_router_subnet_id.c_str(),
                     current_RouterConfiguration.id().c_str());
 
       // check if current_router_subnet_id already exist in new_subnet_routing_tables
-      if (new_subnet_routing_tables.find(current_router_subnet_id) !=
+      if (new_subnet_routing_tables.find(current_router_subnet_handle) !=
           new_subnet_routing_tables.end()) {
         is_subnet_routing_table_exist = true;
       }
@@ -685,8 +900,8 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
       auto subnetStateFound = parsed_struct.subnet_states().find(current_router_subnet_id);
 
       if (subnetStateFound != parsed_struct.subnet_states().end()) {
-        SubnetState current_SubnetState = subnetStateFound->second;
-        SubnetConfiguration current_SubnetConfiguration =
+        const SubnetState &current_SubnetState = subnetStateFound->second;
+        const SubnetConfiguration &current_SubnetConfiguration =
                 current_SubnetState.configuration();
 
         ACA_LOG_DEBUG("current_SubnetConfiguration subnet ID: %s.\n",
@@ -724,11 +939,11 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
         if (is_subnet_routing_table_exist) {
           new_subnet_routing_table_entry =
-                  new_subnet_routing_tables[current_router_subnet_id];
+                  new_subnet_routing_tables[current_router_subnet_handle];
         }
 
         // update the subnet routing table entry
-        new_subnet_routing_table_entry.vpc_id = found_vpc_id;
+        new_subnet_routing_table_entry.vpc_id = update_references.intern_or_throw(found_vpc_id);
         new_subnet_routing_table_entry.network_type = found_network_type;
         new_subnet_routing_table_entry.cidr = found_cidr;
         new_subnet_routing_table_entry.tunnel_id = found_tunnel_id;
@@ -783,11 +998,16 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
                 cmd_string, dataplane_programming_time, overall_rc);
 
         for (int k = 0; k < current_subnet_routing_table.routing_rules_size(); k++) {
-          auto current_routing_rule = current_subnet_routing_table.routing_rules(k);
+          auto &current_routing_rule = current_subnet_routing_table.routing_rules(k);
+          // a rule to delete is in the table already if it is known at all
+          id_handle current_routing_rule_handle =
+                  (current_routing_rule.operation_type() == OperationType::DELETE) ?
+                          id_table.find(current_routing_rule.id()) :
+                          update_references.intern_or_throw(current_routing_rule.id());
 
           // check if current_routing_rule already exist in new_subnet_routing_tables
           if (new_subnet_routing_table_entry.routing_rules.find(
-                      current_routing_rule.id()) !=
+                      current_routing_rule_handle) !=
               new_subnet_routing_table_entry.routing_rules.end()) {
             is_routing_rule_exist = true;
           }
@@ -803,7 +1023,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
             if (is_routing_rule_exist) {
               new_routing_rule_entry =
                       new_subnet_routing_table_entry
-                              .routing_rules[current_routing_rule.id()];
+                              .routing_rules[current_routing_rule_handle];
             }
 
             new_routing_rule_entry.next_hop_ip = current_routing_rule.next_hop_ip();
@@ -815,7 +1035,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
             if (!is_routing_rule_exist) {
               new_subnet_routing_table_entry.routing_rules.emplace(
-                      current_routing_rule.id(), new_routing_rule_entry);
+                      current_routing_rule_handle, new_routing_rule_entry);
 
               ACA_LOG_INFO("Added routing table entry for routering rule id %s\n",
                            current_routing_rule.id().c_str());
@@ -826,7 +1046,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
           } else if (current_routing_rule.operation_type() == OperationType::DELETE) {
             if (new_subnet_routing_table_entry.routing_rules.erase(
-                        current_routing_rule.id())) {
+                        current_routing_rule_handle)) {
               ACA_LOG_INFO("Successfuly cleaned up entry for router rule id %s\n",
                            current_routing_rule.id().c_str());
             } else {
@@ -843,7 +1063,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
         }
 
         if (!is_subnet_routing_table_exist) {
-          new_subnet_routing_tables.emplace(current_router_subnet_id,
+          new_subnet_routing_tables.emplace(current_router_subnet_handle,
                                             new_subnet_routing_table_entry);
 
           ACA_LOG_INFO("Added router subnet table entry for subnet id %s\n",
@@ -851,7 +1071,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
         } else {
           ACA_LOG_INFO("Using existing router subnet table entry for subnet id %s\n",
                        current_router_subnet_id.c_str());
-          new_subnet_routing_tables[current_router_subnet_id] = new_subnet_routing_table_entry;
+          new_subnet_routing_tables[current_router_subnet_handle] = new_subnet_routing_table_entry;
         }
       } else {
         ACA_LOG_ERROR("Not able to find the info for router with subnet ID: %s.\n",
@@ -864,7 +1084,7 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
     if (!is_router_exist || (current_RouterConfiguration.update_type() == UpdateType::FULL)) {
       // -----critical section starts-----
       _routers_table_mutex.lock();
-      _routers_table.emplace(router_id, new_subnet_routing_tables);
+      _store_router_subnets(router_handle, new_subnet_routing_tables);
       _routers_table_mutex.unlock();
       // -----critical section ends-----
       ACA_LOG_INFO("Added router entry for router id %s\n", router_id.c_str());
@@ -872,7 +1092,8 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
       ACA_LOG_INFO("Using existing router entry for router id %s\n", router_id.c_str());
       // -----critical section starts-----
       _routers_table_mutex.lock();
-      _routers_table[router_id] = new_subnet_routing_tables;
+      _drop_deleted_neighbors(router_handle, new_subnet_routing_tables);
+      _store_router_subnets(router_handle, new_subnet_routing_tables);
       _routers_table_mutex.unlock();
       // -----critical section ends-----
     }
@@ -898,8 +1119,8 @@ int ACA_OVS_L3_Programmer::create_or_update_router(RouterConfiguration &current_
 
 int ACA_OVS_L3_Programmer::create_or_update_l3_neighbor(
         const string neighbor_id, const string vpc_id, const string subnet_id,
-        const string virtual_ip, const string virtual_mac,
-        const string remote_host_ip, uint tunnel_id, ulong &culminative_time)
+        const ipv4_addr virtual_ip, const mac_addr virtual_mac,
+        const ipv4_addr remote_host_ip, uint tunnel_id, ulong &culminative_time)
 {
   ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::create_or_update_l3_neighbor ---> Entering\n");
 
@@ -921,16 +1142,12 @@ int ACA_OVS_L3_Programmer::create_or_update_l3_neighbor(
     throw std::invalid_argument("subnet_id is empty");
   }
 
-  if (virtual_ip.empty()) {
-    throw std::invalid_argument("virtual_ip is empty");
+  if (virtual_ip.is_unset()) {
+    throw std::invalid_argument("virtual_ip is unset");
   }
 
-  if (virtual_mac.empty()) {
-    throw std::invalid_argument("virtual_mac is empty");
-  }
-
-  if (remote_host_ip.empty()) {
-    throw std::invalid_argument("remote_host_ip is empty");
+  if (remote_host_ip.is_unset()) {
+    throw std::invalid_argument("remote_host_ip is unset");
   }
 
   if (tunnel_id == 0) {
@@ -940,77 +1157,86 @@ int ACA_OVS_L3_Programmer::create_or_update_l3_neighbor(
   bool is_port_on_same_host =
           ACA_OVS_L2_Programmer::get_instance().is_ip_on_the_same_host(remote_host_ip);
 
-  // going through our list of routers
-  for (auto router_it = _routers_table.begin();
-       router_it != _routers_table.end(); router_it++) {
-    ACA_LOG_DEBUG("router ID:%s\n ", router_it->first.c_str());
-    // try to see if the destination subnet GW is connected to the current router
-    auto found_subnet = router_it->second.find(subnet_id);
-    for (auto kv : router_it->second) {
-      ACA_LOG_DEBUG("[create_or_update_l3_neighbor] router ID: [%s], subnet routering table's subnet ID: [%s], subnet_id we're looking for: [%s]\n",
-                    router_it->first.c_str(), kv.first.c_str(), subnet_id.c_str());
-    }
-    if (found_subnet == router_it->second.end()) {
-      // subnet not found in this router, go look at the next router
-      continue;
-    } else {
-      // destination subnet found!
-      found_subnet_in_router = true;
-      string destination_gw_mac = found_subnet->second.gateway_mac;
-
-      // for each other subnet connected to this router, create the routing rule
-      for (auto subnet_it = router_it->second.begin();
-           subnet_it != router_it->second.end(); subnet_it++) {
-        if (subnet_it->first == subnet_id) {
-          // for the destination subnet, add the neighbor port to track it
-          neighbor_port_table_entry new_neighbor_port_table_entry;
-          new_neighbor_port_table_entry.virtual_ip = virtual_ip;
-          new_neighbor_port_table_entry.virtual_mac = virtual_mac;
-          new_neighbor_port_table_entry.host_ip = remote_host_ip;
-          subnet_it->second.neighbor_ports.emplace(neighbor_id, new_neighbor_port_table_entry);
-
-          // skip the destination neighbor subnet for the static routing rule below
-          // because routing rule are for source packet transformation
-          continue;
-        }
-        ACA_LOG_DEBUG("Found L3 neighbor subnet_id:%s\n ", subnet_it->first.c_str());
-
-        source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(
-                subnet_it->second.tunnel_id);
-
-        destination_vlan_id =
-                ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(tunnel_id);
-
-        // for the first implementation, we will go ahead and program the on demand routing rule here
-        // in the future, the programming of the on demand rule will be triggered by the first packet
-        // sent to openflow controller, that's ACA
-
-        // the openflow rule depends on whether the hosting ip is on this compute host or not
-        if (is_port_on_same_host) {
-          cmd_string = "add-flow br-tun \"table=0,priority=25,ip,dl_vlan=" +
-                       to_string(source_vlan_id) + ",nw_dst=" + virtual_ip +
-                       ",dl_dst=" + subnet_it->second.gateway_mac +
-                       " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
-                       ",mod_dl_src:" + destination_gw_mac +
-                       ",mod_dl_dst:" + virtual_mac + ",output:IN_PORT\"";
-        } else {
-          cmd_string = "add-flow br-tun \"table=0,priority=25,ip,dl_vlan=" +
-                       to_string(source_vlan_id) + ",nw_dst=" + virtual_ip +
-                       ",dl_dst=" + subnet_it->second.gateway_mac +
-                       " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
-                       ",mod_dl_src:" + _host_dvr_mac +
-                       ",mod_dl_dst:" + virtual_mac + ",resubmit(,2)\"";
-        }
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  // a subnet never interned cannot be on any of our routers
+  id_handle subnet_handle = id_table.find(subnet_id);
+  id_handle router_handle = ACA_Id_Table::NO_HANDLE;
+  string destination_gw_mac;
+  // <tunnel ID, gateway mac> of the other subnets connected to the router
+  vector<pair<uint, string> > source_subnets;
 
-        ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-                cmd_string, culminative_time, overall_rc);
+  // -----critical section starts-----
+  _routers_table_mutex.lock();
+  auto router_subnets = _find_router_subnets(subnet_handle, router_handle);
+  if (router_subnets != nullptr) {
+    // destination subnet found!
+    found_subnet_in_router = true;
+    for (auto &[current_subnet_handle, current_subnet] : *router_subnets) {
+      if (current_subnet_handle != subnet_handle) {
+        source_subnets.emplace_back(current_subnet.tunnel_id, current_subnet.gateway_mac);
+        continue;
+      }
+      // for the destination subnet, add the neighbor port to track it,
+      // only interned here so neighbors outside of any router take no handle
+      destination_gw_mac = current_subnet.gateway_mac;
+      id_handle neighbor_handle = id_table.intern(neighbor_id);
+      if (neighbor_handle == ACA_Id_Table::NO_HANDLE) {
+        overall_rc = -ENOSPC;
+        continue;
+      }
+      neighbor_port_table_entry new_neighbor_port_table_entry;
+      new_neighbor_port_table_entry.virtual_ip = virtual_ip;
+      new_neighbor_port_table_entry.virtual_mac = virtual_mac;
+      new_neighbor_port_table_entry.host_ip = remote_host_ip;
+      // the entry holds one reference
+      if (!current_subnet.neighbor_ports.emplace(neighbor_handle, new_neighbor_port_table_entry)
+                   .second) {
+        id_table.release(neighbor_handle);
       }
-      // we found our interested router from _routers_table which has the destination subnet GW connected to it.
-      // Since each subnet GW can only be connected to one router, therefore, there is no point to look at other
-      // routers on the higher level for (auto router_it = _routers_table.begin();...) loop
-      break;
     }
   }
+  _routers_table_mutex.unlock();
+  // -----critical section ends-----
+
+  if (found_subnet_in_router) {
+    ACA_LOG_DEBUG("subnet_id %s is connected to router_id %s\n", subnet_id.c_str(),
+                  id_table.get_id(router_handle).c_str());
+    destination_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(tunnel_id);
+  }
+
+  string virtual_ip_string = virtual_ip.to_string();
+  string virtual_mac_string = virtual_mac.to_string();
+
+  // for each other subnet connected to this router, create the routing rule,
+  // the destination neighbor subnet is skipped because routing rule are for
+  // source packet transformation
+  for (auto &[source_tunnel_id, source_gateway_mac] : source_subnets) {
+    source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(source_tunnel_id);
+
+    // for the first implementation, we will go ahead and program the on demand routing rule here
+    // in the future, the programming of the on demand rule will be triggered by the first packet
+    // sent to openflow controller, that's ACA
+
+    // the openflow rule depends on whether the hosting ip is on this compute host or not
+    if (is_port_on_same_host) {
+      cmd_string = "add-flow br-tun \"table=0,priority=25,ip,dl_vlan=" +
+                   to_string(source_vlan_id) + ",nw_dst=" + virtual_ip_string +
+                   ",dl_dst=" + source_gateway_mac +
+                   " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
+                   ",mod_dl_src:" + destination_gw_mac +
+                   ",mod_dl_dst:" + virtual_mac_string + ",output:IN_PORT\"";
+    } else {
+      cmd_string = "add-flow br-tun \"table=0,priority=25,ip,dl_vlan=" +
+                   to_string(source_vlan_id) + ",nw_dst=" + virtual_ip_string +
+                   ",dl_dst=" + source_gateway_mac +
+                   " actions=mod_vlan_vid:" + to_string(destination_vlan_id) +
+                   ",mod_dl_src:" + _host_dvr_mac +
+                   ",mod_dl_dst:" + virtual_mac_string + ",resubmit(,2)\"";
+    }
+
+    ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+            cmd_string, culminative_time, overall_rc);
+  }
 
   if (!found_subnet_in_router) {
     ACA_LOG_ERROR("subnet_id %s not found in our local routers\n", subnet_id.c_str());
@@ -1024,7 +1250,7 @@ int ACA_OVS_L3_Programmer::create_or_update_l3_neighbor(
 }
 
 int ACA_OVS_L3_Programmer::delete_l3_neighbor(const string neighbor_id, const string subnet_id,
-                                              const string virtual_ip, ulong &culminative_time)
+                                              const ipv4_addr virtual_ip, ulong &culminative_time)
 {
   ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::delete_l3_neighbor ---> Entering\n");
 
@@ -1040,66 +1266,66 @@ int ACA_OVS_L3_Programmer::delete_l3_neighbor(const string neighbor_id, const st
     throw std::invalid_argument("subnet_id is empty");
   }
 
-  if (virtual_ip.empty()) {
-    throw std::invalid_argument("virtual_ip is empty");
+  if (virtual_ip.is_unset()) {
+    throw std::invalid_argument("virtual_ip is unset");
   }
 
-  // going through our list of routers
-  for (auto router_it = _routers_table.begin();
-       router_it != _routers_table.end(); router_it++) {
-    ACA_LOG_DEBUG("router ID:%s\n ", router_it->first.c_str());
-
-    // try to see if the destination subnet GW is connected to the current router
-    auto found_subnet = router_it->second.find(subnet_id);
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  id_handle subnet_handle = id_table.find(subnet_id);
+  id_handle neighbor_handle = id_table.find(neighbor_id);
+  id_handle router_handle = ACA_Id_Table::NO_HANDLE;
+  // tunnel IDs of the other subnets connected to the router
+  vector<uint> source_tunnel_ids;
 
-    if (found_subnet == router_it->second.end()) {
-      // subnet not found in this router, go look at the next router
-      continue;
-    } else {
-      // destination subnet found!
-      found_subnet_in_router = true;
-
-      // for each other subnet connected to this router, delete the routing rule
-      for (auto subnet_it = router_it->second.begin();
-           subnet_it != router_it->second.end(); subnet_it++) {
-        if (subnet_it->first == subnet_id) {
-          // for the destination subnet, remove the tracking neighbor port
-          if (subnet_it->second.neighbor_ports.erase(neighbor_id)) {
-            ACA_LOG_INFO("Successfuly cleaned up entry for neighbor_id %s\n",
-                         neighbor_id.c_str());
-            overall_rc = EXIT_SUCCESS;
-          } else {
-            ACA_LOG_ERROR("Failed to clean up entry for neighbor_id %s\n",
-                          neighbor_id.c_str());
-            overall_rc = EXIT_FAILURE;
-          }
+  // -----critical section starts-----
+  _routers_table_mutex.lock();
+  auto router_subnets = _find_router_subnets(subnet_handle, router_handle);
+  if (router_subnets != nullptr) {
+    // destination subnet found!
+    found_subnet_in_router = true;
+    for (auto &[current_subnet_handle, current_subnet] : *router_subnets) {
+      if (current_subnet_handle != subnet_handle) {
+        source_tunnel_ids.push_back(current_subnet.tunnel_id);
+        continue;
+      }
+      // for the destination subnet, remove the tracking neighbor port
+      if (current_subnet.neighbor_ports.erase(neighbor_handle)) {
+        id_table.release(neighbor_handle);
+        ACA_LOG_INFO("Successfuly cleaned up entry for neighbor_id %s\n",
+                     neighbor_id.c_str());
+        overall_rc = EXIT_SUCCESS;
+      } else {
+        ACA_LOG_ERROR("Failed to clean up entry for neighbor_id %s\n", neighbor_id.c_str());
+        overall_rc = EXIT_FAILURE;
+      }
+    }
+  }
+  _routers_table_mutex.unlock();
+  // -----critical section ends-----
 
-          // skip the destination neighbor subnet for the static routing rule below
-          // because routing rule are for source packet transformation
-          continue;
-        }
-        ACA_LOG_DEBUG("subnet_id:%s\n ", subnet_it->first.c_str());
+  if (found_subnet_in_router) {
+    ACA_LOG_DEBUG("subnet_id %s is connected to router_id %s\n", subnet_id.c_str(),
+                  id_table.get_id(router_handle).c_str());
+  }
 
-        source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(
-                subnet_it->second.tunnel_id);
+  // for each other subnet connected to this router, delete the routing rule,
+  // the destination neighbor subnet is skipped because routing rule are for
+  // source packet transformation
+  for (auto source_tunnel_id : source_tunnel_ids) {
+    source_vlan_id = ACA_Vlan_Manager::get_instance().get_or_create_vlan_id(source_tunnel_id);
 
-        // for the first implementation with static routing rules (non on-demand)
-        // go ahead to remove it
-        string cmd_string = "del-flows br-tun \"table=0,priority=50,ip,dl_vlan=" +
-                            to_string(source_vlan_id) + ",nw_dst=" + virtual_ip + "\" --strict";
+    // for the first implementation with static routing rules (non on-demand)
+    // go ahead to remove it
+    string cmd_string = "del-flows br-tun \"table=0,priority=50,ip,dl_vlan=" +
+                        to_string(source_vlan_id) + ",nw_dst=" + virtual_ip.to_string() +
+                        "\" --strict";
 
-        ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-                cmd_string, culminative_time, overall_rc);
+    ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+            cmd_string, culminative_time, overall_rc);
 
-        // once we have the on demand routing rule implemented, we will need remove any
-        // on demand routing rule assoicated this deleted neighbor to stop the traffic
-        // immediately, we cannot rely on the rule's idle timout
-      }
-      // we found our interested router from _routers_table which has the destination subnet GW connected to it.
-      // Since each subnet GW can only be connected to one router, therefore, there is no point to look at other
-      // routers on the higher level for (auto router_it = _routers_table.begin();...) loop
-      break;
-    }
+    // once we have the on demand routing rule implemented, we will need remove any
+    // on demand routing rule assoicated this deleted neighbor to stop the traffic
+    // immediately, we cannot rely on the rule's idle timout
   }
 
   if (!found_subnet_in_router) {
@@ -1113,4 +1339,152 @@ int ACA_OVS_L3_Programmer::delete_l3_neighbor(const string neighbor_id, const st
   return overall_rc;
 }
 
+void ACA_OVS_L3_Programmer::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::snapshot ---> Entering\n");
+
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+
+  // -----critical section starts-----
+  _routers_table_mutex.lock_shared();
+  snapshot_writer.put_string(_host_dvr_mac);
+  snapshot_writer.put_u32(_routers_table.size());
+  for (auto &[router_handle, subnet_routing_tables] : _routers_table) {
+    snapshot_writer.put_string(id_table.get_id(router_handle));
+    snapshot_writer.put_u32(subnet_routing_tables.size());
+    for (auto &[subnet_handle, subnet_routing_table] : subnet_routing_tables) {
+      snapshot_writer.put_string(id_table.get_id(subnet_handle));
+      snapshot_writer.put_string(id_table.get_id(subnet_routing_table.vpc_id));
+      snapshot_writer.put_u32(subnet_routing_table.network_type);
+      snapshot_writer.put_string(subnet_routing_table.cidr);
+      snapshot_writer.put_u32(subnet_routing_table.tunnel_id);
+      snapshot_writer.put_string(subnet_routing_table.gateway_ip);
+      snapshot_writer.put_string(subnet_routing_table.gateway_mac);
+
+      snapshot_writer.put_u32(subnet_routing_table.neighbor_ports.size());
+      for (auto &[neighbor_handle, neighbor_port] : subnet_routing_table.neighbor_ports) {
+        snapshot_writer.put_string(id_table.get_id(neighbor_handle));
+        snapshot_writer.put_string(neighbor_port.virtual_ip.to_string());
+        snapshot_writer.put_string(neighbor_port.virtual_mac.to_string());
+        snapshot_writer.put_string(neighbor_port.host_ip.to_string());
+      }
+
+      snapshot_writer.put_u32(subnet_routing_table.routing_rules.size());
+      for (auto &[routing_rule_handle, routing_rule] : subnet_routing_table.routing_rules) {
+        snapshot_writer.put_string(id_table.get_id(routing_rule_handle));
+        snapshot_writer.put_string(routing_rule.destination);
+        snapshot_writer.put_u32(routing_rule.destination_type);
+        snapshot_writer.put_string(routing_rule.next_hop_ip);
+        snapshot_writer.put_string(routing_rule.next_hop_mac);
+        snapshot_writer.put_u32(routing_rule.priority);
+      }
+    }
+  }
+  _routers_table_mutex.unlock_shared();
+  // -----critical section ends-----
+
+  ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::snapshot <--- Exiting\n");
+}
+
+int ACA_OVS_L3_Programmer::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  ACA_LOG_DEBUG("%s", "ACA_OVS_L3_Programmer::restore ---> Entering\n");
+
+  uint32_t router_count = 0;
+  uint32_t enum_value = 0;
+  string vpc_id;
+  string virtual_ip;
+  string virtual_mac;
+  string host_ip;
+  string host_dvr_mac;
+  bool is_restored = true;
+  id_reference_holder restore_references;
+  unordered_map<id_handle, unordered_map<id_handle, subnet_routing_table_entry> > restored_routers;
+
+  snapshot_reader.get_string(host_dvr_mac);
+  snapshot_reader.get_u32(router_count);
+  try {
+    for (uint32_t i = 0; i < router_count && snapshot_reader.is_good(); i++) {
+      string router_id;
+      uint32_t subnet_count = 0;
+
+      snapshot_reader.get_string(router_id);
+      snapshot_reader.get_u32(subnet_count);
+      auto &subnet_routing_tables =
+              restored_routers[restore_references.intern_or_throw(router_id)];
+
+      for (uint32_t j = 0; j < subnet_count && snapshot_reader.is_good(); j++) {
+        string subnet_id;
+        uint32_t neighbor_count = 0;
+        uint32_t routing_rule_count = 0;
+
+        snapshot_reader.get_string(subnet_id);
+        subnet_routing_table_entry &subnet_routing_table =
+                subnet_routing_tables[restore_references.intern_or_throw(subnet_id)];
+        snapshot_reader.get_string(vpc_id);
+        subnet_routing_table.vpc_id = restore_references.intern_or_throw(vpc_id);
+        snapshot_reader.get_u32(enum_value);
+        subnet_routing_table.network_type = static_cast<NetworkType>(enum_value);
+        snapshot_reader.get_string(subnet_routing_table.cidr);
+        snapshot_reader.get_u32(subnet_routing_table.tunnel_id);
+        snapshot_reader.get_string(subnet_routing_table.gateway_ip);
+        snapshot_reader.get_string(subnet_routing_table.gateway_mac);
+
+        snapshot_reader.get_u32(neighbor_count);
+        for (uint32_t k = 0; k < neighbor_count && snapshot_reader.is_good(); k++) {
+          string neighbor_id;
+          snapshot_reader.get_string(neighbor_id);
+          neighbor_port_table_entry &neighbor_port =
+                  subnet_routing_table
+                          .neighbor_ports[restore_references.intern_or_throw(neighbor_id)];
+          snapshot_reader.get_string(virtual_ip);
+          snapshot_reader.get_string(virtual_mac);
+          snapshot_reader.get_string(host_ip);
+          // written after validation, so a bad address means a corrupted snapshot
+          if (snapshot_reader.is_good() &&
+              (!ipv4_addr::parse(virtual_ip, neighbor_port.virtual_ip) ||
+               !mac_addr::parse(virtual_mac, neighbor_port.virtual_mac) ||
+               !ipv4_addr::parse(host_ip, neighbor_port.host_ip))) {
+            throw std::runtime_error("invalid address for neighbor " + neighbor_id);
+          }
+        }
+
+        snapshot_reader.get_u32(routing_rule_count);
+        for (uint32_t k = 0; k < routing_rule_count && snapshot_reader.is_good(); k++) {
+          string routing_rule_id;
+          snapshot_reader.get_string(routing_rule_id);
+          routing_rule_entry &routing_rule =
+                  subnet_routing_table
+                          .routing_rules[restore_references.intern_or_throw(routing_rule_id)];
+          snapshot_reader.get_string(routing_rule.destination);
+          snapshot_reader.get_u32(enum_value);
+          routing_rule.destination_type = static_cast<DestinationType>(enum_value);
+          snapshot_reader.get_string(routing_rule.next_hop_ip);
+          snapshot_reader.get_string(routing_rule.next_hop_mac);
+          snapshot_reader.get_u32(routing_rule.priority);
+        }
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    ACA_LOG_ERROR("Failed to restore the routers table: %s\n", e.what());
+    is_restored = false;
+  }
+
+  // only a complete routers table is stored, it takes its own references
+  if (is_restored && snapshot_reader.is_good()) {
+    // -----critical section starts-----
+    _routers_table_mutex.lock();
+    _host_dvr_mac = host_dvr_mac;
+    for (auto &router : restored_routers) {
+      _store_router_subnets(router.first, router.second);
+    }
+    _routers_table_mutex.unlock();
+    // -----critical section ends-----
+  }
+
+  int overall_rc = (is_restored && snapshot_reader.is_good()) ? EXIT_SUCCESS : -EINVAL;
+
+  ACA_LOG_DEBUG("ACA_OVS_L3_Programmer::restore <--- Exiting, overall_rc = %d\n", overall_rc);
+  return overall_rc;
+}
 } // namespace aca_ovs_l3_programmer
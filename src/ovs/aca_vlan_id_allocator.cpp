@@ -0,0 +1,131 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_vlan_id_allocator.h"
+#include "aca_log.h"
+#include <cstdio>
+
+namespace aca_vlan_manager
+{
+// vlan ids 0 and 4095 are never handed out
+static const uint64_t FIRST_WORD_RESERVED_BITS = 1ULL;
+static const uint64_t LAST_WORD_RESERVED_BITS = 1ULL << 63;
+
+static inline bool aca_is_valid_vlan_id(uint vlan_id)
+{
+  return vlan_id > 0 && vlan_id < VLAN_ID_COUNT - 1;
+}
+
+ACA_Vlan_Id_Allocator::ACA_Vlan_Id_Allocator()
+{
+  clear();
+}
+
+uint ACA_Vlan_Id_Allocator::allocate()
+{
+  uint start_vlan_id = _next_vlan_id.load(std::memory_order_relaxed) % VLAN_ID_COUNT;
+  uint start_word = start_vlan_id / BITS_PER_WORD;
+
+  // the start word is looked at twice, from start_vlan_id first and in full after
+  // wrapping around
+  for (uint probe = 0; probe <= WORD_COUNT; probe++) {
+    uint word_index = (start_word + probe) % WORD_COUNT;
+    uint64_t candidate_bits = ~0ULL;
+    if (probe == 0) {
+      candidate_bits <<= (start_vlan_id % BITS_PER_WORD);
+    }
+
+    uint64_t word = _allocated_bits[word_index].load(std::memory_order_relaxed);
+    uint64_t free_bits = ~word & candidate_bits;
+
+    while (free_bits != 0) {
+      uint bit = __builtin_ctzll(free_bits);
+      uint64_t bit_mask = 1ULL << bit;
+
+      // on failure word is reloaded, try the next free bit of the updated word
+      if (_allocated_bits[word_index].compare_exchange_weak(
+                  word, word | bit_mask, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        uint vlan_id = word_index * BITS_PER_WORD + bit;
+        _next_vlan_id.store(vlan_id + 1, std::memory_order_relaxed);
+        return vlan_id;
+      }
+      free_bits = ~word & candidate_bits;
+    }
+  }
+
+  ACA_LOG_ERROR("%s", "All internal vlan ids are in use\n");
+  return 0;
+}
+
+bool ACA_Vlan_Id_Allocator::reserve(uint vlan_id)
+{
+  if (!aca_is_valid_vlan_id(vlan_id)) {
+    return false;
+  }
+
+  uint64_t bit_mask = 1ULL << (vlan_id % BITS_PER_WORD);
+  uint64_t previous_word = _allocated_bits[vlan_id / BITS_PER_WORD].fetch_or(
+          bit_mask, std::memory_order_acq_rel);
+
+  return (previous_word & bit_mask) == 0;
+}
+
+void ACA_Vlan_Id_Allocator::release(uint vlan_id)
+{
+  if (!aca_is_valid_vlan_id(vlan_id)) {
+    ACA_LOG_ERROR("Cannot release invalid vlan id %u\n", vlan_id);
+    return;
+  }
+
+  uint64_t bit_mask = 1ULL << (vlan_id % BITS_PER_WORD);
+  uint64_t previous_word = _allocated_bits[vlan_id / BITS_PER_WORD].fetch_and(
+          ~bit_mask, std::memory_order_acq_rel);
+
+  if ((previous_word & bit_mask) == 0) {
+    ACA_LOG_ERROR("vlan id %u was released but not allocated\n", vlan_id);
+  }
+}
+
+void ACA_Vlan_Id_Allocator::clear()
+{
+  for (uint i = 0; i < WORD_COUNT; i++) {
+    _allocated_bits[i].store(0, std::memory_order_relaxed);
+  }
+  _allocated_bits[0].fetch_or(FIRST_WORD_RESERVED_BITS, std::memory_order_relaxed);
+  _allocated_bits[WORD_COUNT - 1].fetch_or(LAST_WORD_RESERVED_BITS, std::memory_order_relaxed);
+  _next_vlan_id.store(1, std::memory_order_release);
+}
+
+uint ACA_Vlan_Id_Allocator::get_allocated_count()
+{
+  uint allocated_count = 0;
+
+  for (uint i = 0; i < WORD_COUNT; i++) {
+    allocated_count += __builtin_popcountll(_allocated_bits[i].load(std::memory_order_relaxed));
+  }
+
+  // minus the two reserved ids
+  return allocated_count - 2;
+}
+
+uint ACA_Vlan_Id_Allocator::get_next_vlan_id()
+{
+  return _next_vlan_id.load(std::memory_order_relaxed);
+}
+
+void ACA_Vlan_Id_Allocator::set_next_vlan_id(uint vlan_id)
+{
+  _next_vlan_id.store(vlan_id, std::memory_order_relaxed);
+}
+} // namespace aca_vlan_manager
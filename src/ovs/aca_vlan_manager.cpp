@@ -18,6 +18,9 @@
 #include "aca_ovs_control.h"
 #include "aca_ovs_l2_programmer.h"
 #include "aca_arp_responder.h"
+#include "aca_vpc_serial_executor.h"
+#include "aca_revision_tracker.h"
+#include "aca_update_coalescer.h"
 #include <errno.h>
 #include <algorithm>
 #include <shared_mutex>
@@ -26,6 +29,7 @@
 using namespace aca_ovs_control;
 using namespace aca_ovs_l2_programmer;
 using namespace aca_arp_responder;
+using aca_vpc_serial_executor::ACA_Vpc_Serial_Executor;
 
 extern std::atomic_ulong g_total_vpcs_table_mutex_time;
 
@@ -47,43 +51,69 @@ void ACA_Vlan_Manager::clear_all_data()
   // their destructors are called, and they are removed from the container,
   // leaving an empty _vpcs_table.
   _vpcs_table.clear();
+  _vlan_id_allocator.clear();
+
+  for (auto &tunnel_id : _tunnel_ids_by_vlan_id) {
+    tunnel_id.store(0, std::memory_order_release);
+  }
+
+  // the ports recorded as applied are gone with the table, program them again
+  aca_revision_tracker::ACA_Revision_Tracker::get_instance().clear();
+  aca_update_coalescer::ACA_Update_Coalescer::get_instance().clear();
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::clear_all_data <--- Exiting\n");
 }
 
-// this function assumes there is no existing entry for vpc_id
-void ACA_Vlan_Manager::create_entry(uint tunnel_id)
+// this function assumes there is no existing entry for vpc_id,
+// it is called on the serial executor shard owning tunnel_id
+std::shared_ptr<vpc_table_entry> ACA_Vlan_Manager::create_entry(uint tunnel_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::create_entry ---> Entering\n");
 
-  vpc_table_entry *new_vpc_table_entry = new vpc_table_entry;
-  // fetch the value first to used for new_vpc_table_entry->vlan_id
-  // then add 1 after, doing both atomically
-  // std::memory_order_relaxed option won't help much for x86 but other
-  // CPU architecture can take advantage of it
-  new_vpc_table_entry->vlan_id =
-          current_available_vlan_id.fetch_add(1, std::memory_order_relaxed);
+  auto new_vpc_table_entry = std::make_shared<vpc_table_entry>();
+  // 0 when all the vlan ids are in use, it is rejected when programming flows
+  new_vpc_table_entry->vlan_id = _vlan_id_allocator.allocate();
 
   _vpcs_table.insert(tunnel_id, new_vpc_table_entry);
+  set_tunnel_id_by_vlan_id(new_vpc_table_entry->vlan_id, tunnel_id);
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::create_entry <--- Exiting\n");
+
+  return new_vpc_table_entry;
+}
+
+void ACA_Vlan_Manager::set_tunnel_id_by_vlan_id(uint vlan_id, uint tunnel_id)
+{
+  if (vlan_id >= VLAN_ID_COUNT) {
+    ACA_LOG_ERROR("vlan_id %u is out of range, tunnel_id %u is not indexed\n", vlan_id,
+                  tunnel_id);
+    return;
+  }
+  _tunnel_ids_by_vlan_id[vlan_id].store(tunnel_id, std::memory_order_release);
 }
 
 uint ACA_Vlan_Manager::get_or_create_vlan_id(uint tunnel_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_or_create_vlan_id ---> Entering\n");
 
-  vpc_table_entry *new_vpc_table_entry = nullptr;
-  // -----critical section starts-----
-  _vpcs_table_mutex.lock();
-  if (!_vpcs_table.find(tunnel_id, new_vpc_table_entry)) {
-    create_entry(tunnel_id);
+  std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
 
-    _vpcs_table.find(tunnel_id, new_vpc_table_entry);
+  // the vlan id of an existing VPC never changes, no need to go through its shard
+  if (_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
+    ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_or_create_vlan_id <--- Exiting\n");
+    return current_vpc_table_entry->vlan_id;
   }
-  _vpcs_table_mutex.unlock();
-  // -----critical section ends-----
-  uint acquired_vlan_id = new_vpc_table_entry->vlan_id;
+
+  // find and create are serialized on the VPC's shard, no other thread
+  // can create the same entry in between
+  uint acquired_vlan_id = ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> new_vpc_table_entry;
+
+    if (!_vpcs_table.find(tunnel_id, new_vpc_table_entry)) {
+      new_vpc_table_entry = create_entry(tunnel_id);
+    }
+    return static_cast<int>(new_vpc_table_entry->vlan_id);
+  });
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_or_create_vlan_id <--- Exiting\n");
 
@@ -95,36 +125,31 @@ int ACA_Vlan_Manager::create_ovs_port(string /*vpc_id*/, string ovs_port,
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::create_ovs_port ---> Entering\n");
 
-  vpc_table_entry *current_vpc_table_entry;
-  int overall_rc = EXIT_FAILURE;
-  // -----critical section starts-----
-  _vpcs_table_mutex.lock();
-  bool vpc_table_entry_found = _vpcs_table.find(tunnel_id, current_vpc_table_entry);
+  int overall_rc = EXIT_SUCCESS;
+  bool is_first_port = false;
+  uint internal_vlan_id = 0;
 
-  if (!vpc_table_entry_found) {
-    create_entry(tunnel_id);
+  // the empty check and the insert run on the VPC's shard, so two ports
+  // of the same VPC cannot both see an empty port list
+  ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
 
-    // vpc_table_entry_found used here just in case if
-    // vpc_table_entry is deleted by another thread between
-    // create_entry(tunnel_id) above and the _vpcs_table.find below
-    vpc_table_entry_found = _vpcs_table.find(tunnel_id, current_vpc_table_entry);
-  }
-  _vpcs_table_mutex.unlock();
-  // -----critical section ends-----
+    if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
+      current_vpc_table_entry = create_entry(tunnel_id);
+    }
+
+    is_first_port = current_vpc_table_entry->ovs_ports.empty();
+    internal_vlan_id = current_vpc_table_entry->vlan_id;
+    current_vpc_table_entry->ovs_ports.insert(ovs_port);
+
+    return EXIT_SUCCESS;
+  });
 
   // first port in the VPC will add the below rule:
   // table 4 = incoming vxlan, allow incoming vxlan traffic matching tunnel_id
   // to stamp with internal vlan and deliver to br-int
-  if (current_vpc_table_entry->ovs_ports.empty()) {
-    int internal_vlan_id = current_vpc_table_entry->vlan_id;
-
-    string cmd_string =
-            "add-flow br-tun \"table=4, priority=1,tun_id=" + to_string(tunnel_id) +
-            " actions=mod_vlan_vid:" + to_string(internal_vlan_id) + ",output:\"patch-int\"\"";
-
-    ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
-            cmd_string, culminative_time, overall_rc);
-    current_vpc_table_entry->ovs_ports.insert(ovs_port, nullptr);
+  if (is_first_port) {
+    add_incoming_vxlan_rule(tunnel_id, internal_vlan_id, culminative_time, overall_rc);
   }
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::create_ovs_port <--- Exiting\n");
@@ -138,27 +163,79 @@ int ACA_Vlan_Manager::delete_ovs_port(string /*vpc_id*/, string ovs_port,
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::delete_ovs_port ---> Entering\n");
 
-  vpc_table_entry *current_vpc_table_entry;
-  int overall_rc = EXIT_SUCCESS;
+  bool is_vpc_removed = false;
+  uint released_vlan_id = 0;
+
+  int overall_rc = ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
+
+    if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
+      ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
+      return ENOENT;
+    }
 
-  if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
-    ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
-    overall_rc = ENOENT;
-  } else {
     current_vpc_table_entry->ovs_ports.erase(ovs_port);
 
     // clean up the vpc_table entry if there is no port assoicated
     if (current_vpc_table_entry->ovs_ports.empty()) {
+      released_vlan_id = current_vpc_table_entry->vlan_id;
+      set_tunnel_id_by_vlan_id(released_vlan_id, 0);
       _vpcs_table.erase(tunnel_id);
+      is_vpc_removed = true;
+    }
+    return EXIT_SUCCESS;
+  });
+
+  if (is_vpc_removed) {
+    // also delete the rule assoicated with the VPC:
+    // table 4 = incoming vxlan, allow incoming vxlan traffic matching tunnel_id
+    // to stamp with internal vlan and deliver to br-int
+    string cmd_string = "del-flows br-tun \"table=4, priority=1,tun_id=" +
+                        to_string(tunnel_id) + "\" --strict";
+
+    ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+            cmd_string, culminative_time, overall_rc);
+
+    // the L2 neighbor and L3 routing flows and the ARP entries of the VPC still
+    // match its vlan id, the id is only handed out again once they are gone
+    if (released_vlan_id != 0) {
+      size_t arp_entry_count =
+              ACA_ARP_Responder::get_instance().delete_vlan_arp_entries(released_vlan_id);
+      ACA_LOG_DEBUG("Deleted %zu arp entries of vlan id %u\n", arp_entry_count,
+                    released_vlan_id);
 
-      // also delete the rule assoicated with the VPC:
-      // table 4 = incoming vxlan, allow incoming vxlan traffic matching tunnel_id
-      // to stamp with internal vlan and deliver to br-int
-      string cmd_string = "del-flows br-tun \"table=4, priority=1,tun_id=" +
-                          to_string(tunnel_id) + "\" --strict";
+      cmd_string = "del-flows br-tun \"dl_vlan=" + to_string(released_vlan_id) + "\"";
+      ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+              cmd_string, culminative_time, overall_rc);
 
+      cmd_string = "del-flows br-int \"dl_vlan=" + to_string(released_vlan_id) + "\"";
       ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
               cmd_string, culminative_time, overall_rc);
+
+      // the neighbors and routers programmed into the vlan are sent again at the same
+      // revision when a port of the VPC comes back, they must not be skipped then
+      size_t forgotten_count =
+              aca_revision_tracker::ACA_Revision_Tracker::get_instance().forget_tunnel(tunnel_id);
+      ACA_LOG_DEBUG("Forgot %zu applied revisions of tunnel id %u\n", forgotten_count, tunnel_id);
+
+      _vlan_id_allocator.release(released_vlan_id);
+    }
+
+    // a new port of the same VPC may have been created while the rule was being
+    // deleted, and its rule deleted with it. Put it back in that case, a port
+    // created after this check adds its rule after the delete above
+    uint recreated_vlan_id = 0;
+    ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+      std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
+
+      if (_vpcs_table.find(tunnel_id, current_vpc_table_entry) &&
+          !current_vpc_table_entry->ovs_ports.empty()) {
+        recreated_vlan_id = current_vpc_table_entry->vlan_id;
+      }
+      return EXIT_SUCCESS;
+    });
+    if (recreated_vlan_id != 0) {
+      add_incoming_vxlan_rule(tunnel_id, recreated_vlan_id, culminative_time, overall_rc);
     }
   }
 
@@ -167,6 +244,17 @@ int ACA_Vlan_Manager::delete_ovs_port(string /*vpc_id*/, string ovs_port,
   return overall_rc;
 }
 
+void ACA_Vlan_Manager::add_incoming_vxlan_rule(uint tunnel_id, uint internal_vlan_id,
+                                               ulong &culminative_time, int &overall_rc)
+{
+  string cmd_string = "add-flow br-tun \"table=4, priority=1,tun_id=" + to_string(tunnel_id) +
+                      " actions=mod_vlan_vid:" + to_string(internal_vlan_id) +
+                      ",output:\"patch-int\"\"";
+
+  ACA_OVS_L2_Programmer::get_instance().execute_openflow_command(
+          cmd_string, culminative_time, overall_rc);
+}
+
 int ACA_Vlan_Manager::create_l2_neighbor(string virtual_ip, string virtual_mac,
                                          string remote_host_ip, uint tunnel_id,
                                          ulong & /*culminative_time*/)
@@ -260,14 +348,18 @@ string ACA_Vlan_Manager::get_zeta_gateway_id(uint tunnel_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_zeta_gateway_id ---> Entering\n");
 
-  vpc_table_entry *current_vpc_table_entry;
   string zeta_gateway_id;
 
-  if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
-    ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
-  } else {
+  ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
+
+    if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
+      ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
+      return ENOENT;
+    }
     zeta_gateway_id = current_vpc_table_entry->zeta_gateway_id;
-  }
+    return EXIT_SUCCESS;
+  });
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_zeta_gateway_id <--- Entering\n");
   return zeta_gateway_id;
@@ -277,14 +369,15 @@ void ACA_Vlan_Manager::set_zeta_gateway(uint tunnel_id, const string auxGateway_
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::set_zeta_gateway ---> Entering\n");
 
-  vpc_table_entry *new_vpc_table_entry = nullptr;
+  ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> new_vpc_table_entry;
 
-  if (!_vpcs_table.find(tunnel_id, new_vpc_table_entry)) {
-    create_entry(tunnel_id);
-
-    _vpcs_table.find(tunnel_id, new_vpc_table_entry);
-  }
-  new_vpc_table_entry->zeta_gateway_id = auxGateway_id;
+    if (!_vpcs_table.find(tunnel_id, new_vpc_table_entry)) {
+      new_vpc_table_entry = create_entry(tunnel_id);
+    }
+    new_vpc_table_entry->zeta_gateway_id = auxGateway_id;
+    return EXIT_SUCCESS;
+  });
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::set_zeta_gateway <--- Exiting\n");
 }
@@ -294,14 +387,16 @@ int ACA_Vlan_Manager::remove_zeta_gateway(uint tunnel_id)
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::remove_zeta_gateway ---> Entering\n");
   int overall_rc = EXIT_SUCCESS;
 
-  string zeta_gateway_id;
-  vpc_table_entry *current_vpc_table_entry;
+  ACA_Vpc_Serial_Executor::get_instance().execute(tunnel_id, [&] {
+    std::shared_ptr<vpc_table_entry> current_vpc_table_entry;
 
-  if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
-    ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
-  } else {
-    current_vpc_table_entry->zeta_gateway_id = "";
-  }
+    if (!_vpcs_table.find(tunnel_id, current_vpc_table_entry)) {
+      ACA_LOG_ERROR("tunnel_id %u not found in vpc_table\n", tunnel_id);
+    } else {
+      current_vpc_table_entry->zeta_gateway_id = "";
+    }
+    return EXIT_SUCCESS;
+  });
 
   ACA_LOG_DEBUG("ACA_Vlan_Manager::remove_zeta_gateway <--- Exiting, overall_rc = %d\n",
                 overall_rc);
@@ -313,35 +408,12 @@ bool ACA_Vlan_Manager::is_exist_zeta_gateway(string zeta_gateway_id)
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_aux_gateway_id ---> Entering\n");
   bool zeta_gateway_id_found = false;
 
-  for (size_t i = 0; i < _vpcs_table.hashSize; i++) {
-    auto hash_node = (_vpcs_table.hashTable[i]).head;
-    if (hash_node == nullptr) {
-      // no entry for this hashtable bucket, go look at the next bucket
-      continue;
-    } else {
-      // found entry in this hashtable bucket, need to look into the list of hash_nodes
-      //-----Start share lock to enable mutiple concurrent reads-----
-      std::shared_lock<std::shared_timed_mutex> hash_bucket_lock(
-              (_vpcs_table.hashTable[i]).mutex_);
-
-      while (hash_node != nullptr) {
-        if (hash_node->getValue()->zeta_gateway_id == zeta_gateway_id) {
-          zeta_gateway_id_found = true;
-          break;
-        }
-
-        if (zeta_gateway_id_found) {
-          break; // break out of for loop on _vpcs_table
-        } else {
-          // zeta_gateway_id not found yet, look at the next hash_node
-          hash_node = hash_node->next;
-        }
-      }
-
-      hash_bucket_lock.unlock();
-      //-----End share lock to enable mutiple concurrent reads-----
+  _vpcs_table.for_each([&](const uint &,
+                           const std::shared_ptr<vpc_table_entry> &current_vpc_table_entry) {
+    if (current_vpc_table_entry->zeta_gateway_id == zeta_gateway_id) {
+      zeta_gateway_id_found = true;
     }
-  }
+  });
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_aux_gateway_id <--- Exiting\n");
 
@@ -351,38 +423,10 @@ bool ACA_Vlan_Manager::is_exist_zeta_gateway(string zeta_gateway_id)
 uint ACA_Vlan_Manager::get_tunnelId_by_vlanId(uint vlan_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_tunnelId_by_vlanId ---> Entering\n");
-  bool vlan_id_found = false;
   uint tunnel_id = 0;
 
-  for (size_t i = 0; i < _vpcs_table.hashSize; i++) {
-    auto hash_node = (_vpcs_table.hashTable[i]).head;
-    if (hash_node == nullptr) {
-      // no entry for this hashtable bucket, go look at the next bucket
-      continue;
-    } else {
-      // found entry in this hashtable bucket, need to look into the list of hash_nodes
-      //-----Start share lock to enable mutiple concurrent reads-----
-      std::shared_lock<std::shared_timed_mutex> hash_bucket_lock(
-              (_vpcs_table.hashTable[i]).mutex_);
-
-      while (hash_node != nullptr) {
-        if (hash_node->getValue()->vlan_id == vlan_id) {
-          vlan_id_found = true;
-          tunnel_id = hash_node->getKey();
-          break;
-        }
-
-        if (vlan_id_found) {
-          break; // break out of for loop on _vpcs_table
-        } else {
-          // zeta_gateway_id not found yet, look at the next hash_node
-          hash_node = hash_node->next;
-        }
-      }
-
-      hash_bucket_lock.unlock();
-      //-----End share lock to enable mutiple concurrent reads-----
-    }
+  if (vlan_id < VLAN_ID_COUNT) {
+    tunnel_id = _tunnel_ids_by_vlan_id[vlan_id].load(std::memory_order_acquire);
   }
 
   ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::get_tunnelId_by_vlanId <--- Exiting\n");
@@ -390,4 +434,81 @@ uint ACA_Vlan_Manager::get_tunnelId_by_vlanId(uint vlan_id)
   return tunnel_id;
 }
 
+void ACA_Vlan_Manager::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::snapshot ---> Entering\n");
+
+  uint32_t entry_count = 0;
+  aca_snapshot::ACA_Snapshot_Writer entries_writer;
+
+  _vpcs_table.for_each([&](const uint &tunnel_id,
+                           const std::shared_ptr<vpc_table_entry> &current_vpc_table_entry) {
+    entries_writer.put_u32(tunnel_id);
+    entries_writer.put_u32(current_vpc_table_entry->vlan_id);
+    entries_writer.put_string(current_vpc_table_entry->zeta_gateway_id);
+    entries_writer.put_u32(current_vpc_table_entry->ovs_ports.size());
+    current_vpc_table_entry->ovs_ports.for_each(
+            [&](const string &ovs_port) { entries_writer.put_string(ovs_port); });
+    entry_count++;
+  });
+
+  snapshot_writer.put_u32(_vlan_id_allocator.get_next_vlan_id());
+  snapshot_writer.put_u32(entry_count);
+  snapshot_writer.put_bytes(entries_writer.get_data());
+
+  ACA_LOG_DEBUG("ACA_Vlan_Manager::snapshot <--- Exiting, %u VPCs\n", entry_count);
+}
+
+int ACA_Vlan_Manager::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  ACA_LOG_DEBUG("%s", "ACA_Vlan_Manager::restore ---> Entering\n");
+
+  uint32_t next_vlan_id = 0;
+  uint32_t entry_count = 0;
+
+  int overall_rc = EXIT_SUCCESS;
+
+  snapshot_reader.get_u32(next_vlan_id);
+  snapshot_reader.get_u32(entry_count);
+
+  for (uint32_t i = 0; i < entry_count && snapshot_reader.is_good(); i++) {
+    uint32_t tunnel_id = 0;
+    uint32_t port_count = 0;
+    auto new_vpc_table_entry = std::make_shared<vpc_table_entry>();
+
+    snapshot_reader.get_u32(tunnel_id);
+    snapshot_reader.get_u32(new_vpc_table_entry->vlan_id);
+    snapshot_reader.get_string(new_vpc_table_entry->zeta_gateway_id);
+    snapshot_reader.get_u32(port_count);
+    for (uint32_t j = 0; j < port_count && snapshot_reader.is_good(); j++) {
+      string ovs_port;
+      if (snapshot_reader.get_string(ovs_port)) {
+        new_vpc_table_entry->ovs_ports.insert(ovs_port);
+      }
+    }
+
+    if (!snapshot_reader.is_good()) {
+      break;
+    }
+    // the VPC keeps the vlan id it had before the restart, flows still use it
+    // two VPCs sharing a vlan id would leak traffic between them, reject the snapshot
+    if (!_vlan_id_allocator.reserve(new_vpc_table_entry->vlan_id)) {
+      ACA_LOG_ERROR("vlan id %u of tunnel_id %u is invalid or already in use\n",
+                    new_vpc_table_entry->vlan_id, tunnel_id);
+      overall_rc = -EINVAL;
+      break;
+    }
+    _vpcs_table.insert(tunnel_id, new_vpc_table_entry);
+    set_tunnel_id_by_vlan_id(new_vpc_table_entry->vlan_id, tunnel_id);
+  }
+
+  _vlan_id_allocator.set_next_vlan_id(next_vlan_id);
+
+  if (!snapshot_reader.is_good()) {
+    overall_rc = -EINVAL;
+  }
+
+  ACA_LOG_DEBUG("ACA_Vlan_Manager::restore <--- Exiting, overall_rc = %d\n", overall_rc);
+  return overall_rc;
+}
 } // namespace aca_vlan_manager
@@ -16,8 +16,6 @@
 #include "aca_log.h"
 #include "goalstateprovisioner.grpc.pb.h"
 #include <errno.h>
-#include <sstream>
-#include <iomanip>
 #include "aca_ovs_l2_programmer.h"
 #include "aca_util.h"
 #include "aca_ovs_control.h"
@@ -114,20 +112,12 @@ uint8_t ACA_Zeta_Oam_Server::_get_message_type(oam_message *oammsg)
 
 string ACA_Zeta_Oam_Server::_get_mac_addr(uint8_t *mac)
 {
-  string mac_string;
-  stringstream ss;
+  aca_net_types::mac_addr mac_address;
 
   // Convert mac address to string
   // from uint8[6] to string
-  for (int i = 0; i < 6; i++) {
-    ss << std::hex << std::setw(2) << std::setfill('0')
-       << static_cast<unsigned int>(mac[i]);
-    ss << ":";
-  }
-  ss >> mac_string;
-  mac_string.pop_back();
-
-  return mac_string;
+  memcpy(mac_address.bytes, mac, MAC_ADDRESS_LENGTH);
+  return mac_address.to_string();
 }
 
 uint ACA_Zeta_Oam_Server::_get_tunnel_id(uint8_t *vni)
@@ -148,8 +138,9 @@ oam_match ACA_Zeta_Oam_Server::_get_oam_match_field(oam_message *oammsg)
 
   flow_inject_msg msg_data = oammsg->data.msg_inject_flow;
 
-  match.sip = inet_ntoa(msg_data.inner_src_ip);
-  match.dip = inet_ntoa(msg_data.inner_dst_ip);
+  // inet_ntoa returns a shared static buffer, format on the stack instead
+  match.sip = aca_net_types::ipv4_addr{ msg_data.inner_src_ip.s_addr }.to_string();
+  match.dip = aca_net_types::ipv4_addr{ msg_data.inner_dst_ip.s_addr }.to_string();
   match.sport = to_string(ntohs(msg_data.src_port));
   match.dport = to_string(ntohs(msg_data.dst_port));
   match.proto = to_string(msg_data.proto);
@@ -166,8 +157,8 @@ oam_action ACA_Zeta_Oam_Server::_get_oam_action_field(oam_message *oammsg)
 
   flow_inject_msg msg_data = oammsg->data.msg_inject_flow;
 
-  action.inst_nw_dst = inet_ntoa(msg_data.inst_dst_ip);
-  action.node_nw_dst = inet_ntoa(msg_data.node_dst_ip);
+  action.inst_nw_dst = aca_net_types::ipv4_addr{ msg_data.inst_dst_ip.s_addr }.to_string();
+  action.node_nw_dst = aca_net_types::ipv4_addr{ msg_data.node_dst_ip.s_addr }.to_string();
   action.inst_dl_dst = _get_mac_addr(msg_data.inst_dst_mac);
   action.node_dl_dst = _get_mac_addr(msg_data.node_dst_mac);
   action.idle_timeout = to_string(msg_data.idle_timeout);
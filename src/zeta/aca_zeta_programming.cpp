@@ -184,7 +184,7 @@ void start_upd_listener(uint oam_port_number)
   }
 }
 
-int ACA_Zeta_Programming::create_zeta_config(const alcor::schema::GatewayConfiguration current_AuxGateway,
+int ACA_Zeta_Programming::create_zeta_config(const alcor::schema::GatewayConfiguration &current_AuxGateway,
                                              uint tunnel_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Zeta_Programming::create_zeta_config ---> Entering\n");
@@ -255,7 +255,7 @@ int ACA_Zeta_Programming::create_zeta_config(const alcor::schema::GatewayConfigu
   return overall_rc;
 }
 
-int ACA_Zeta_Programming::delete_zeta_config(const alcor::schema::GatewayConfiguration current_AuxGateway,
+int ACA_Zeta_Programming::delete_zeta_config(const alcor::schema::GatewayConfiguration &current_AuxGateway,
                                              uint tunnel_id)
 {
   ACA_LOG_DEBUG("%s", "ACA_Zeta_Programming::delete_zeta_config ---> Entering\n");
@@ -308,32 +308,16 @@ int ACA_Zeta_Programming::_create_zeta_group_entry(zeta_config *zeta_cfg)
   string cmd = "-O OpenFlow13 add-group br-tun group_id=" + to_string(zeta_cfg->group_id) +
                ",type=select";
 
-  for (size_t i = 0; i < zeta_cfg->zeta_buckets.hashSize; i++) {
-    auto hash_node = zeta_cfg->zeta_buckets.hashTable[i].head;
-    if (hash_node == nullptr) {
-      continue;
-    } else {
-      //-----Start share lock to enable mutiple concurrent reads-----
-      std::shared_lock<std::shared_timed_mutex> hash_bucket_lock(
-              (zeta_cfg->zeta_buckets.hashTable[i]).mutex_);
-
-      while (hash_node != nullptr) {
-        // add the static arp entries
-        string static_arp_string = "arp -s " + hash_node->getKey().ip_addr +
-                                   " " + hash_node->getKey().mac_addr;
-
-        aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
-
-        // fill zeta_gws
-        cmd += ",bucket=\"set_field:" + hash_node->getKey().ip_addr +
-               "->tun_dst,mod_dl_dst:" + hash_node->getKey().mac_addr +
-               ",output:vxlan-generic\"";
-        hash_node = hash_node->next;
-      }
-      hash_bucket_lock.unlock();
-      //-----End share lock to enable mutiple concurrent reads-----
-    }
-  }
+  zeta_cfg->zeta_buckets.for_each([&](const FWD_Info &zeta_gw, int *) {
+    // add the static arp entries
+    string static_arp_string = "arp -s " + zeta_gw.ip_addr + " " + zeta_gw.mac_addr;
+
+    aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
+
+    // fill zeta_gws
+    cmd += ",bucket=\"set_field:" + zeta_gw.ip_addr + "->tun_dst,mod_dl_dst:" +
+           zeta_gw.mac_addr + ",output:vxlan-generic\"";
+  });
 
   //-----Start unique lock-----
   std::unique_lock<std::timed_mutex> group_entry_lock(_group_operation_mutex);
@@ -363,31 +347,15 @@ int ACA_Zeta_Programming::_update_zeta_group_entry(zeta_config *zeta_cfg)
   string cmd = "-O OpenFlow13 mod-group br-tun group_id=" + to_string(zeta_cfg->group_id) +
                ",type=select";
 
-  for (size_t i = 0; i < zeta_cfg->zeta_buckets.hashSize; i++) {
-    auto hash_node = zeta_cfg->zeta_buckets.hashTable[i].head;
-    if (hash_node == nullptr) {
-      continue;
-    } else {
-      //-----Start share lock to enable mutiple concurrent reads-----
-      std::shared_lock<std::shared_timed_mutex> hash_bucket_lock(
-              (zeta_cfg->zeta_buckets.hashTable[i]).mutex_);
-
-      while (hash_node != nullptr) {
-        // add the static arp entries
-        string static_arp_string = "arp -s " + hash_node->getKey().ip_addr +
-                                   " " + hash_node->getKey().mac_addr;
+  zeta_cfg->zeta_buckets.for_each([&](const FWD_Info &zeta_gw, int *) {
+    // add the static arp entries
+    string static_arp_string = "arp -s " + zeta_gw.ip_addr + " " + zeta_gw.mac_addr;
 
-        aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
+    aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
 
-        cmd += ",bucket=\"set_field:" + hash_node->getKey().ip_addr +
-               "->tun_dst,mod_dl_dst:" + hash_node->getKey().mac_addr +
-               ",output:vxlan-generic\"";
-        hash_node = hash_node->next;
-      }
-      hash_bucket_lock.unlock();
-      //-----End share lock to enable mutiple concurrent reads-----
-    }
-  }
+    cmd += ",bucket=\"set_field:" + zeta_gw.ip_addr + "->tun_dst,mod_dl_dst:" +
+           zeta_gw.mac_addr + ",output:vxlan-generic\"";
+  });
 
   //-----Start unique lock-----
   std::unique_lock<std::timed_mutex> group_entry_lock(_group_operation_mutex);
@@ -426,25 +394,11 @@ int ACA_Zeta_Programming::_delete_zeta_group_entry(zeta_config *zeta_cfg)
     ACA_LOG_ERROR("delete_zeta_group_entry failed!!! overrall_rc: %d\n", overall_rc);
   }
 
-  for (size_t i = 0; i < zeta_cfg->zeta_buckets.hashSize; i++) {
-    auto hash_node = zeta_cfg->zeta_buckets.hashTable[i].head;
-    if (hash_node == nullptr) {
-      continue;
-    } else {
-      //-----Start share lock to enable mutiple concurrent reads-----
-      std::shared_lock<std::shared_timed_mutex> hash_bucket_lock(
-              (zeta_cfg->zeta_buckets.hashTable[i]).mutex_);
-
-      while (hash_node != nullptr) {
-        // delete the static arp entries
-        string static_arp_string = "arp -d " + hash_node->getKey().ip_addr;
-        aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
-        hash_node = hash_node->next;
-      }
-      hash_bucket_lock.unlock();
-      //-----End share lock to enable mutiple concurrent reads-----
-    }
-  }
+  zeta_cfg->zeta_buckets.for_each([&](const FWD_Info &zeta_gw, int *) {
+    // delete the static arp entries
+    string static_arp_string = "arp -d " + zeta_gw.ip_addr;
+    aca_net_config::Aca_Net_Config::get_instance().execute_system_command(static_arp_string);
+  });
 
   ACA_LOG_DEBUG("ACA_Zeta_Programming::_delete_zeta_group_entry <--- Exiting, overall_rc = %d\n",
                 overall_rc);
@@ -509,4 +463,86 @@ uint ACA_Zeta_Programming::get_group_id(string zeta_gateway_id)
   ACA_LOG_DEBUG("ACA_Zeta_Programming::get_group_id <--- Exiting, overall_rc = %u\n", group_id);
 }
 
-} // namespace aca_zeta_programming
\ No newline at end of file
+void ACA_Zeta_Programming::snapshot(aca_snapshot::ACA_Snapshot_Writer &snapshot_writer)
+{
+  ACA_LOG_DEBUG("%s", "ACA_Zeta_Programming::snapshot ---> Entering\n");
+
+  uint32_t entry_count = 0;
+  aca_snapshot::ACA_Snapshot_Writer entries_writer;
+
+  _zeta_config_table_mutex.lock();
+  _zeta_config_table.for_each([&](const string &zeta_gateway_id, zeta_config *current_zeta_cfg) {
+    uint32_t bucket_count = 0;
+    aca_snapshot::ACA_Snapshot_Writer buckets_writer;
+
+    current_zeta_cfg->zeta_buckets.for_each([&](const FWD_Info &zeta_gw, int *) {
+      buckets_writer.put_string(zeta_gw.ip_addr);
+      buckets_writer.put_string(zeta_gw.mac_addr);
+      bucket_count++;
+    });
+
+    entries_writer.put_string(zeta_gateway_id);
+    entries_writer.put_u32(current_zeta_cfg->group_id);
+    entries_writer.put_u32(current_zeta_cfg->oam_port);
+    entries_writer.put_u32(bucket_count);
+    entries_writer.put_bytes(buckets_writer.get_data());
+    entry_count++;
+  });
+  _zeta_config_table_mutex.unlock();
+
+  snapshot_writer.put_u32(current_available_group_id.load());
+  snapshot_writer.put_u32(entry_count);
+  snapshot_writer.put_bytes(entries_writer.get_data());
+
+  ACA_LOG_DEBUG("ACA_Zeta_Programming::snapshot <--- Exiting, %u zeta gateways\n", entry_count);
+}
+
+int ACA_Zeta_Programming::restore(aca_snapshot::ACA_Snapshot_Reader &snapshot_reader)
+{
+  ACA_LOG_DEBUG("%s", "ACA_Zeta_Programming::restore ---> Entering\n");
+
+  uint32_t next_group_id = 0;
+  uint32_t entry_count = 0;
+
+  snapshot_reader.get_u32(next_group_id);
+  snapshot_reader.get_u32(entry_count);
+
+  _zeta_config_table_mutex.lock();
+  for (uint32_t i = 0; i < entry_count && snapshot_reader.is_good(); i++) {
+    string zeta_gateway_id;
+    uint32_t bucket_count = 0;
+    zeta_config *new_zeta_cfg = new zeta_config;
+
+    snapshot_reader.get_string(zeta_gateway_id);
+    snapshot_reader.get_u32(new_zeta_cfg->group_id);
+    snapshot_reader.get_u32(new_zeta_cfg->oam_port);
+    snapshot_reader.get_u32(bucket_count);
+    for (uint32_t j = 0; j < bucket_count && snapshot_reader.is_good(); j++) {
+      string ip_addr;
+      string mac_addr;
+      if (snapshot_reader.get_string(ip_addr) && snapshot_reader.get_string(mac_addr)) {
+        new_zeta_cfg->zeta_buckets.insert(FWD_Info(ip_addr, mac_addr), nullptr);
+      }
+    }
+
+    if (!snapshot_reader.is_good()) {
+      delete new_zeta_cfg;
+      break;
+    }
+    _zeta_config_table.insert(zeta_gateway_id, new_zeta_cfg);
+  }
+  _zeta_config_table_mutex.unlock();
+
+  // group ids handed out before the restart must not be handed out again
+  uint current_group_id = current_available_group_id.load();
+  while (current_group_id < next_group_id &&
+         !current_available_group_id.compare_exchange_weak(current_group_id, next_group_id)) {
+  }
+
+  int overall_rc = snapshot_reader.is_good() ? EXIT_SUCCESS : -EINVAL;
+
+  ACA_LOG_DEBUG("ACA_Zeta_Programming::restore <--- Exiting, overall_rc = %d\n", overall_rc);
+  return overall_rc;
+}
+
+} // namespace aca_zeta_programming
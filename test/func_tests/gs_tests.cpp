@@ -51,6 +51,7 @@ string g_ofctl_target = EMPTY_STRING;
 string g_ofctl_options = EMPTY_STRING;
 string g_ncm_address = EMPTY_STRING;
 string g_ncm_port = EMPTY_STRING;
+string g_ncm_hedge_address = EMPTY_STRING;
 string g_grpc_server_port = EMPTY_STRING;
 // by default, this should run as GRCP client, unless specified by the corresponding flag.
 bool g_run_as_server = false;
@@ -0,0 +1,107 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_admission_controller.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+
+using namespace std;
+using aca_admission_controller::ACA_Admission_Controller;
+using aca_admission_controller::ACA_Admission_Guard;
+
+TEST(admission_controller_test_cases, resource_budget)
+{
+  ACA_Admission_Controller &admission_controller = ACA_Admission_Controller::get_instance();
+  bool parked_admitted = false;
+
+  admission_controller.set_limits(10, 0);
+
+  EXPECT_TRUE(admission_controller.try_admit(6, 100));
+  // over the budget while the first one is in flight
+  EXPECT_FALSE(admission_controller.try_admit(6, 100));
+
+  // parked until credits are released
+  admission_controller.admit_async(6, 100, [&] { parked_admitted = true; });
+  EXPECT_FALSE(parked_admitted);
+  EXPECT_EQ(admission_controller.get_queue_depth(), 1UL);
+
+  admission_controller.release(6, 100);
+  EXPECT_TRUE(parked_admitted);
+  EXPECT_EQ(admission_controller.get_queue_depth(), 0UL);
+  EXPECT_EQ(admission_controller.get_in_flight_resources(), 6UL);
+
+  admission_controller.release(6, 100);
+  EXPECT_EQ(admission_controller.get_in_flight_resources(), 0UL);
+  EXPECT_EQ(admission_controller.get_in_flight_bytes(), 0UL);
+
+  admission_controller.set_limits(ADMISSION_MAX_IN_FLIGHT_RESOURCES, ADMISSION_MAX_IN_FLIGHT_BYTES);
+}
+
+TEST(admission_controller_test_cases, oversized_goal_state_admitted_when_idle)
+{
+  ACA_Admission_Controller &admission_controller = ACA_Admission_Controller::get_instance();
+
+  admission_controller.set_limits(10, 1000);
+
+  // bigger than the whole budget, but nothing else is in flight
+  EXPECT_TRUE(admission_controller.try_admit(50, 5000));
+  EXPECT_FALSE(admission_controller.try_admit(1, 1));
+  admission_controller.release(50, 5000);
+  EXPECT_TRUE(admission_controller.try_admit(1, 1));
+  admission_controller.release(1, 1);
+
+  admission_controller.set_limits(ADMISSION_MAX_IN_FLIGHT_RESOURCES, ADMISSION_MAX_IN_FLIGHT_BYTES);
+}
+
+TEST(admission_controller_test_cases, guard_releases_on_exception)
+{
+  ACA_Admission_Controller &admission_controller = ACA_Admission_Controller::get_instance();
+  unsigned long deferred_count = admission_controller.get_deferred_count();
+  bool parked_admitted = false;
+
+  admission_controller.set_limits(10, 0);
+
+  try {
+    EXPECT_TRUE(admission_controller.try_admit(8, 100));
+    ACA_Admission_Guard admission_guard(8, 100);
+    admission_controller.admit_async(8, 100, [&] { parked_admitted = true; });
+    EXPECT_EQ(admission_controller.get_deferred_count(), deferred_count + 1);
+    EXPECT_GE(admission_controller.get_max_queue_depth(), 1UL);
+    throw std::runtime_error("programming failed");
+  } catch (const std::runtime_error &) {
+  }
+
+  // the first credits came back while unwinding and the parked one got in
+  EXPECT_TRUE(parked_admitted);
+  EXPECT_EQ(admission_controller.get_in_flight_resources(), 8UL);
+
+  {
+    ACA_Admission_Guard admission_guard(8, 100);
+    admission_guard.release();
+    // released once only
+  }
+  EXPECT_EQ(admission_controller.get_in_flight_resources(), 0UL);
+
+  {
+    // owns nothing, does not give back credits it never took
+    ACA_Admission_Guard admission_guard(8, 100, false);
+  }
+  EXPECT_TRUE(admission_controller.try_admit(1, 1));
+  EXPECT_EQ(admission_controller.get_in_flight_resources(), 1UL);
+  admission_controller.release(1, 1);
+
+  admission_controller.set_limits(ADMISSION_MAX_IN_FLIGHT_RESOURCES, ADMISSION_MAX_IN_FLIGHT_BYTES);
+}
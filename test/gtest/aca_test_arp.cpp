@@ -110,6 +110,26 @@ TEST(arp_config_test_cases, add_arp_entry_invalid)
   EXPECT_EQ(retcode, EXIT_FAILURE);
 }
 
+TEST(arp_config_test_cases, add_arp_entry_malformed)
+{
+  arp_config stArpCfgIn;
+
+  stArpCfgIn.ipv4_address = "10.0.2.256";
+  stArpCfgIn.mac_address = "AA:BB:CC:DD:EE:FF";
+  stArpCfgIn.vlan_id = 1201;
+  EXPECT_EQ(ACA_ARP_Responder::get_instance().add_arp_entry(&stArpCfgIn), EXIT_FAILURE);
+
+  stArpCfgIn.ipv4_address = "10.0.2.1";
+  stArpCfgIn.mac_address = "AA:BB:CC:DD:EE";
+  EXPECT_EQ(ACA_ARP_Responder::get_instance().add_arp_entry(&stArpCfgIn), EXIT_FAILURE);
+  EXPECT_EQ(ACA_ARP_Responder::get_instance().delete_arp_entry(&stArpCfgIn), EXIT_FAILURE);
+
+  // nothing for ARP to answer without an IPv4 address
+  stArpCfgIn.ipv4_address = "";
+  stArpCfgIn.mac_address = "AA:BB:CC:DD:EE:FF";
+  EXPECT_EQ(ACA_ARP_Responder::get_instance().add_arp_entry(&stArpCfgIn), EXIT_SUCCESS);
+}
+
 TEST(arp_config_test_cases, delete_arp_entry_valid)
 {
   int retcode = 0;
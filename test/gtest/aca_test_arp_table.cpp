@@ -0,0 +1,132 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_arp_table.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_arp_responder::ACA_Arp_Table;
+
+static const uint8_t aca_test_arp_table_mac_1[ARP_MAC_ADDRESS_LENGTH] = { 0xaa, 0xbb, 0xcc,
+                                                                          0xdd, 0xee, 0xff };
+static const uint8_t aca_test_arp_table_mac_2[ARP_MAC_ADDRESS_LENGTH] = { 0x02, 0x00, 0x00,
+                                                                          0x00, 0x00, 0x01 };
+
+TEST(arp_table_test_cases, insert_find_update_erase)
+{
+  ACA_Arp_Table arp_table;
+  uint64_t key = ACA_Arp_Table::make_key(1201, 0x0101000a);
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+
+  EXPECT_EQ(ACA_Arp_Table::get_vlan_id(key), 1201);
+  EXPECT_EQ(ACA_Arp_Table::get_ipv4_address(key), 0x0101000aU);
+
+  EXPECT_FALSE(arp_table.find(key, mac_address));
+  EXPECT_TRUE(arp_table.insert(key, aca_test_arp_table_mac_1));
+  EXPECT_FALSE(arp_table.insert(key, aca_test_arp_table_mac_2));
+  EXPECT_TRUE(arp_table.find(key, mac_address));
+  EXPECT_EQ(memcmp(mac_address, aca_test_arp_table_mac_1, ARP_MAC_ADDRESS_LENGTH), 0);
+
+  // same address on another vlan is another entry
+  EXPECT_FALSE(arp_table.contains(ACA_Arp_Table::make_key(1202, 0x0101000a)));
+
+  arp_table.insert_or_update(key, aca_test_arp_table_mac_2);
+  EXPECT_TRUE(arp_table.find(key, mac_address));
+  EXPECT_EQ(memcmp(mac_address, aca_test_arp_table_mac_2, ARP_MAC_ADDRESS_LENGTH), 0);
+  EXPECT_EQ(arp_table.size(), 1UL);
+
+  EXPECT_TRUE(arp_table.erase(key));
+  EXPECT_FALSE(arp_table.erase(key));
+  EXPECT_FALSE(arp_table.contains(key));
+  EXPECT_EQ(arp_table.size(), 0UL);
+
+  // an erased key can come back
+  EXPECT_TRUE(arp_table.insert(key, aca_test_arp_table_mac_1));
+  EXPECT_TRUE(arp_table.contains(key));
+}
+
+TEST(arp_table_test_cases, grows_and_drops_erased_entries)
+{
+  ACA_Arp_Table arp_table;
+  const uint32_t entry_count = 50000;
+  uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    ASSERT_TRUE(arp_table.insert(ACA_Arp_Table::make_key(i % 4096, i), aca_test_arp_table_mac_1));
+  }
+  EXPECT_EQ(arp_table.size(), entry_count);
+
+  // erase and insert churn leaves tombstones behind, resizes clean them up
+  for (int round = 0; round < 4; round++) {
+    for (uint32_t i = 0; i < entry_count; i++) {
+      ASSERT_TRUE(arp_table.erase(ACA_Arp_Table::make_key(i % 4096, i)));
+      ASSERT_TRUE(arp_table.insert(ACA_Arp_Table::make_key(i % 4096, i),
+                                   aca_test_arp_table_mac_2));
+    }
+  }
+
+  EXPECT_EQ(arp_table.size(), entry_count);
+  for (uint32_t i = 0; i < entry_count; i++) {
+    ASSERT_TRUE(arp_table.find(ACA_Arp_Table::make_key(i % 4096, i), mac_address));
+    ASSERT_EQ(memcmp(mac_address, aca_test_arp_table_mac_2, ARP_MAC_ADDRESS_LENGTH), 0);
+  }
+
+  uint32_t visited_count = 0;
+  arp_table.for_each([&](uint64_t, const uint8_t *) { visited_count++; });
+  EXPECT_EQ(visited_count, entry_count);
+
+  arp_table.clear();
+  EXPECT_EQ(arp_table.size(), 0UL);
+  EXPECT_FALSE(arp_table.contains(ACA_Arp_Table::make_key(1, 1)));
+}
+
+TEST(arp_table_test_cases, readers_run_while_the_table_grows)
+{
+  ACA_Arp_Table arp_table;
+  const uint32_t stable_count = 1000;
+  const uint32_t growing_count = 100000;
+  atomic<bool> writer_done(false);
+  vector<thread> readers;
+
+  for (uint32_t i = 0; i < stable_count; i++) {
+    arp_table.insert(ACA_Arp_Table::make_key(1, i), aca_test_arp_table_mac_1);
+  }
+
+  // entries inserted before the readers start must stay visible through every resize
+  for (int r = 0; r < 4; r++) {
+    readers.emplace_back([&]() {
+      uint8_t mac_address[ARP_MAC_ADDRESS_LENGTH];
+      while (!writer_done.load()) {
+        for (uint32_t i = 0; i < stable_count; i++) {
+          ASSERT_TRUE(arp_table.find(ACA_Arp_Table::make_key(1, i), mac_address));
+          ASSERT_EQ(mac_address[0], 0xaa);
+        }
+      }
+    });
+  }
+
+  for (uint32_t i = 0; i < growing_count; i++) {
+    arp_table.insert(ACA_Arp_Table::make_key(2, i), aca_test_arp_table_mac_2);
+  }
+  writer_done = true;
+
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(arp_table.size(), stable_count + growing_count);
+}
@@ -0,0 +1,82 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_dag_scheduler.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using aca_dag_scheduler::ACA_Dag_Scheduler;
+
+TEST(dag_scheduler_test_cases, dependencies_are_respected)
+{
+  ACA_Dag_Scheduler dag_scheduler;
+  atomic_int ports_done(0);
+  atomic_bool neighbor_saw_all_ports(false);
+  atomic_bool dhcp_saw_neighbor(false);
+
+  auto ports_join = dag_scheduler.add_join_node();
+  for (int i = 0; i < 3; i++) {
+    auto port = dag_scheduler.add_node([&] {
+      this_thread::sleep_for(chrono::milliseconds(5));
+      ports_done++;
+      return EXIT_SUCCESS;
+    });
+    // ports were added after their join node, so it has to be the other way
+    EXPECT_EQ(dag_scheduler.add_dependency(port, ports_join), -EINVAL);
+  }
+
+  ports_join = dag_scheduler.add_join_node();
+  for (ACA_Dag_Scheduler::node_id port = 1; port <= 3; port++) {
+    EXPECT_EQ(dag_scheduler.add_dependency(port, ports_join), EXIT_SUCCESS);
+  }
+
+  auto neighbor = dag_scheduler.add_node([&] {
+    neighbor_saw_all_ports = (ports_done == 3);
+    return EXIT_SUCCESS;
+  });
+  auto dhcp = dag_scheduler.add_node([&] {
+    dhcp_saw_neighbor = neighbor_saw_all_ports.load();
+    return EXIT_SUCCESS;
+  });
+  EXPECT_EQ(dag_scheduler.add_dependency(ports_join, neighbor), EXIT_SUCCESS);
+  EXPECT_EQ(dag_scheduler.add_dependency(neighbor, dhcp), EXIT_SUCCESS);
+
+  EXPECT_EQ(dag_scheduler.node_count(), 7UL);
+  EXPECT_EQ(dag_scheduler.run(), EXIT_SUCCESS);
+  EXPECT_TRUE(neighbor_saw_all_ports);
+  EXPECT_TRUE(dhcp_saw_neighbor);
+}
+
+TEST(dag_scheduler_test_cases, failure_is_reported_and_dependents_still_run)
+{
+  ACA_Dag_Scheduler dag_scheduler;
+  atomic_int dependents_run(0);
+
+  auto pending = dag_scheduler.add_node([] { return EINPROGRESS; });
+  auto failed = dag_scheduler.add_node([]() -> int { throw runtime_error("bad state"); });
+  auto dependent = dag_scheduler.add_node([&] {
+    dependents_run++;
+    return EXIT_SUCCESS;
+  });
+  dag_scheduler.add_dependency(pending, dependent);
+  dag_scheduler.add_dependency(failed, dependent);
+
+  // an error wins over pending
+  EXPECT_EQ(dag_scheduler.run(), EXIT_FAILURE);
+  EXPECT_EQ(dependents_run.load(), 1);
+}
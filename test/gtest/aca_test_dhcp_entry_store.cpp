@@ -0,0 +1,113 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_dhcp_entry_store.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_dhcp_server::ACA_Dhcp_Entry_Store;
+using aca_dhcp_server::dhcp_entry_data;
+
+static dhcp_entry_data aca_test_dhcp_entry(uint32_t ipv4_address)
+{
+  dhcp_entry_data stData = {};
+  stData.ipv4_address = ipv4_address;
+  stData.subnet_mask = 0x00ffffff;
+  stData.dns_address_count = 1;
+  stData.dns_addresses[0] = 0x08080808;
+  return stData;
+}
+
+TEST(dhcp_entry_store_test_cases, parse_mac_address)
+{
+  uint64_t mac_address = 0;
+
+  EXPECT_TRUE(ACA_Dhcp_Entry_Store::parse_mac_address("AA:BB:CC:DD:EE:FF", mac_address));
+  EXPECT_EQ(mac_address, 0xaabbccddeeffULL);
+  EXPECT_TRUE(ACA_Dhcp_Entry_Store::parse_mac_address("aa-bb-cc-dd-ee-01", mac_address));
+  EXPECT_EQ(mac_address, 0xaabbccddee01ULL);
+  EXPECT_EQ(ACA_Dhcp_Entry_Store::mac_address_to_string(mac_address), "aa:bb:cc:dd:ee:01");
+
+  EXPECT_FALSE(ACA_Dhcp_Entry_Store::parse_mac_address("aa:bb:cc:dd:ee", mac_address));
+  EXPECT_FALSE(ACA_Dhcp_Entry_Store::parse_mac_address("aa:bb:cc:dd:ee:ff:00", mac_address));
+  EXPECT_FALSE(ACA_Dhcp_Entry_Store::parse_mac_address("aa.bb.cc.dd.ee.ff", mac_address));
+}
+
+TEST(dhcp_entry_store_test_cases, insert_find_update_erase)
+{
+  ACA_Dhcp_Entry_Store dhcp_store;
+  dhcp_entry_data stData;
+
+  EXPECT_FALSE(dhcp_store.find(0xaabbccddeeffULL, stData));
+  EXPECT_TRUE(dhcp_store.insert(0xaabbccddeeffULL, aca_test_dhcp_entry(0x0100000a)));
+  EXPECT_FALSE(dhcp_store.insert(0xaabbccddeeffULL, aca_test_dhcp_entry(0x0200000a)));
+  EXPECT_EQ(dhcp_store.size(), 1UL);
+
+  EXPECT_TRUE(dhcp_store.find(0xaabbccddeeffULL, stData));
+  EXPECT_EQ(stData.ipv4_address, 0x0100000aU);
+  EXPECT_EQ(stData.dns_addresses[0], 0x08080808U);
+
+  EXPECT_TRUE(dhcp_store.update(0xaabbccddeeffULL, aca_test_dhcp_entry(0x0300000a)));
+  EXPECT_FALSE(dhcp_store.update(0x1ULL, aca_test_dhcp_entry(0x0300000a)));
+  EXPECT_TRUE(dhcp_store.find(0xaabbccddeeffULL, stData));
+  EXPECT_EQ(stData.ipv4_address, 0x0300000aU);
+
+  EXPECT_TRUE(dhcp_store.erase(0xaabbccddeeffULL));
+  EXPECT_FALSE(dhcp_store.erase(0xaabbccddeeffULL));
+  EXPECT_EQ(dhcp_store.size(), 0UL);
+}
+
+TEST(dhcp_entry_store_test_cases, concurrent_lookups_during_updates)
+{
+  ACA_Dhcp_Entry_Store dhcp_store;
+  const uint64_t mac_count = 4096;
+  vector<thread> readers;
+
+  for (uint64_t mac = 0; mac < mac_count; mac++) {
+    dhcp_store.insert(0x020000000000ULL | mac, aca_test_dhcp_entry((uint32_t)mac));
+  }
+
+  for (int r = 0; r < 4; r++) {
+    readers.emplace_back([&]() {
+      dhcp_entry_data stData;
+      for (int round = 0; round < 20; round++) {
+        for (uint64_t mac = 0; mac < mac_count; mac++) {
+          ASSERT_TRUE(dhcp_store.find(0x020000000000ULL | mac, stData));
+          ASSERT_EQ(stData.ipv4_address & 0xffff, (uint32_t)mac);
+        }
+      }
+    });
+  }
+
+  // rewrite every entry while the readers look them up, keeping the low bits
+  for (uint32_t round = 1; round <= 20; round++) {
+    for (uint64_t mac = 0; mac < mac_count; mac++) {
+      dhcp_store.update(0x020000000000ULL | mac,
+                        aca_test_dhcp_entry(round << 16 | (uint32_t)mac));
+    }
+  }
+
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  size_t visited_count = 0;
+  dhcp_store.for_each([&](uint64_t, const dhcp_entry_data &) { visited_count++; });
+  EXPECT_EQ(visited_count, mac_count);
+
+  dhcp_store.clear();
+  EXPECT_EQ(dhcp_store.size(), 0UL);
+}
@@ -0,0 +1,71 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_goal_state_index.h"
+#include "goalstate.pb.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace alcor::schema;
+using aca_goal_state_index::ACA_Goal_State_Index;
+using aca_goal_state_index::neighbor_fixed_ip_entry;
+
+TEST(goal_state_index_test_cases, lookups)
+{
+  GoalState GoalState_builder;
+
+  SubnetState *new_subnet_states = GoalState_builder.add_subnet_states();
+  new_subnet_states->set_operation_type(OperationType::CREATE);
+  new_subnet_states->mutable_configuration()->set_id("subnet-1");
+  new_subnet_states->mutable_configuration()->set_tunnel_id(10);
+  // the INFO state wins over the CREATE one above
+  new_subnet_states = GoalState_builder.add_subnet_states();
+  new_subnet_states->set_operation_type(OperationType::INFO);
+  new_subnet_states->mutable_configuration()->set_id("subnet-1");
+  new_subnet_states->mutable_configuration()->set_tunnel_id(20);
+
+  GatewayState *new_gateway_states = GoalState_builder.add_gateway_states();
+  new_gateway_states->mutable_configuration()->set_id("gateway-1");
+  new_gateway_states->mutable_configuration()->set_gateway_type(ZETA);
+
+  VpcState *new_vpc_states = GoalState_builder.add_vpc_states();
+  new_vpc_states->set_operation_type(OperationType::INFO);
+  new_vpc_states->mutable_configuration()->set_id("vpc-1");
+  new_vpc_states->mutable_configuration()->add_gateway_ids("gateway-0");
+  new_vpc_states->mutable_configuration()->add_gateway_ids("gateway-1");
+
+  NeighborState *new_neighbor_states = GoalState_builder.add_neighbor_states();
+  new_neighbor_states->mutable_configuration()->set_id("neighbor-1");
+  NeighborConfiguration_FixedIp *FixedIp_builder =
+          new_neighbor_states->mutable_configuration()->add_fixed_ips();
+  FixedIp_builder->set_subnet_id("subnet-1");
+  FixedIp_builder->set_ip_address("10.0.0.3");
+
+  ACA_Goal_State_Index goal_state_index(GoalState_builder);
+
+  ASSERT_NE(goal_state_index.find_subnet("subnet-1"), nullptr);
+  EXPECT_EQ(goal_state_index.find_subnet("subnet-1")->configuration().tunnel_id(), 20U);
+  EXPECT_EQ(goal_state_index.find_subnet("subnet-2"), nullptr);
+
+  ASSERT_NE(goal_state_index.find_zeta_gateway("vpc-1"), nullptr);
+  EXPECT_EQ(goal_state_index.find_zeta_gateway("vpc-1")->id(), "gateway-1");
+  EXPECT_EQ(goal_state_index.find_zeta_gateway("vpc-2"), nullptr);
+
+  neighbor_fixed_ip_entry next_hop_neighbor;
+  ASSERT_TRUE(goal_state_index.find_neighbor_fixed_ip("10.0.0.3", next_hop_neighbor));
+  EXPECT_EQ(next_hop_neighbor.neighbor_configuration->id(), "neighbor-1");
+  EXPECT_EQ(next_hop_neighbor.fixed_ip->subnet_id(), "subnet-1");
+  EXPECT_FALSE(goal_state_index.find_neighbor_fixed_ip("10.0.0.4", next_hop_neighbor));
+}
@@ -0,0 +1,211 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_grpc_client.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <memory>
+
+using namespace std;
+
+// nothing listens on this port, requests sent to it fail with UNAVAILABLE
+#define UNREACHABLE_NCM_ADDRESS "127.0.0.1:1"
+
+static void set_unreachable_hedge_endpoint(GoalStateProvisionerClientImpl &client)
+{
+  client.hedge_chan_ =
+          grpc::CreateChannel(UNREACHABLE_NCM_ADDRESS, grpc::InsecureChannelCredentials());
+  client.hedge_stub_ = GoalStateProvisioner::NewStub(client.hedge_chan_);
+}
+
+static std::shared_ptr<HedgedHostRequest> make_hedged_request(grpc::CompletionQueue *cq)
+{
+  auto request = std::make_shared<HedgedHostRequest>();
+  request->request.add_state_requests()->set_request_id("hedge_test");
+  request->cq = cq;
+  request->deadline = std::chrono::system_clock::now() + std::chrono::seconds(2);
+  return request;
+}
+
+static AsyncClientHedgeAlarm *set_hedge_alarm(std::shared_ptr<HedgedHostRequest> request,
+                                              std::chrono::milliseconds delay)
+{
+  AsyncClientHedgeAlarm *hedge_alarm = new AsyncClientHedgeAlarm;
+  hedge_alarm->type_ = ASYNC_CLIENT_HEDGE_ALARM;
+  hedge_alarm->request_ = request;
+  hedge_alarm->alarm.Set(request->cq, std::chrono::system_clock::now() + delay,
+                         (void *)static_cast<AsyncClientTag *>(hedge_alarm));
+  return hedge_alarm;
+}
+
+static void drain_completion_queue(GoalStateProvisionerClientImpl &client,
+                                   grpc::CompletionQueue &cq)
+{
+  void *got_tag;
+  bool ok = false;
+
+  cq.Shutdown();
+  while (cq.Next(&got_tag, &ok)) {
+    delete client.HandleAsyncEvent(got_tag, ok);
+  }
+}
+
+TEST(grpc_client_test_cases, hedge_delay_default_until_enough_samples)
+{
+  GoalStateProvisionerClientImpl client;
+
+  // no sample recorded yet
+  EXPECT_EQ(client.GetHedgeDelay(), ON_DEMAND_HEDGE_DEFAULT_DELAY_IN_MICROSECONDS);
+
+  for (int i = 0; i < ON_DEMAND_HEDGE_MIN_LATENCY_SAMPLES - 1; i++) {
+    client.RecordReplyLatency(1000000);
+  }
+  EXPECT_EQ(client.GetHedgeDelay(), ON_DEMAND_HEDGE_DEFAULT_DELAY_IN_MICROSECONDS);
+
+  client.RecordReplyLatency(1000000);
+  EXPECT_EQ(client.GetHedgeDelay(), 1000000);
+}
+
+TEST(grpc_client_test_cases, hedge_delay_is_p95_with_floor)
+{
+  GoalStateProvisionerClientImpl client;
+
+  // 100 samples of 1..100 ms, the p95 is the 96th smallest one
+  for (long i = 100; i >= 1; i--) {
+    client.RecordReplyLatency(i * 1000);
+  }
+  EXPECT_EQ(client.GetHedgeDelay(), 96000);
+
+  GoalStateProvisionerClientImpl fast_client;
+
+  // very fast replies do not bring the delay below the minimum
+  for (int i = 0; i < ON_DEMAND_HEDGE_MIN_LATENCY_SAMPLES; i++) {
+    fast_client.RecordReplyLatency(10);
+  }
+  EXPECT_EQ(fast_client.GetHedgeDelay(), ON_DEMAND_HEDGE_MIN_DELAY_IN_MICROSECONDS);
+}
+
+TEST(grpc_client_test_cases, hedge_delay_ring_buffer_wraparound)
+{
+  GoalStateProvisionerClientImpl client;
+
+  for (int i = 0; i < ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE; i++) {
+    client.RecordReplyLatency(900000);
+  }
+  EXPECT_EQ(client.GetHedgeDelay(), 900000);
+
+  // the newer samples overwrite the oldest ones once the buffer is full
+  for (int i = 0; i < ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE - 1; i++) {
+    client.RecordReplyLatency(100000);
+  }
+  EXPECT_EQ(client.GetHedgeDelay(), 100000);
+
+  client.RecordReplyLatency(100000);
+  EXPECT_EQ(client.GetHedgeDelay(), 100000);
+
+  // and the buffer keeps wrapping
+  for (int i = 0; i < ON_DEMAND_HEDGE_LATENCY_SAMPLE_SIZE; i++) {
+    client.RecordReplyLatency(700000);
+  }
+  EXPECT_EQ(client.GetHedgeDelay(), 700000);
+}
+
+TEST(grpc_client_test_cases, hedge_fires_when_no_reply)
+{
+  GoalStateProvisionerClientImpl client;
+  grpc::CompletionQueue cq;
+  void *got_tag;
+  bool ok = false;
+
+  set_unreachable_hedge_endpoint(client);
+  auto request = make_hedged_request(&cq);
+  set_hedge_alarm(request, std::chrono::milliseconds(10));
+
+  ASSERT_TRUE(cq.Next(&got_tag, &ok));
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(client.HandleAsyncEvent(got_tag, ok), nullptr);
+  EXPECT_TRUE(request->hedged.load());
+
+  // the hedged call fails against the unreachable endpoint, its failure
+  // is consumed by the client and does not answer the request
+  ASSERT_TRUE(cq.Next(&got_tag, &ok));
+  EXPECT_EQ(client.HandleAsyncEvent(got_tag, ok), nullptr);
+  EXPECT_FALSE(request->answered.load());
+
+  drain_completion_queue(client, cq);
+}
+
+TEST(grpc_client_test_cases, hedge_not_sent_when_cancelled_or_answered)
+{
+  GoalStateProvisionerClientImpl client;
+  grpc::CompletionQueue cq;
+  void *got_tag;
+  bool ok = true;
+
+  set_unreachable_hedge_endpoint(client);
+
+  // a cancelled alarm comes out of the queue with ok == false
+  auto cancelled_request = make_hedged_request(&cq);
+  AsyncClientHedgeAlarm *hedge_alarm =
+          set_hedge_alarm(cancelled_request, std::chrono::seconds(10));
+  hedge_alarm->alarm.Cancel();
+
+  ASSERT_TRUE(cq.Next(&got_tag, &ok));
+  EXPECT_FALSE(ok);
+  EXPECT_EQ(client.HandleAsyncEvent(got_tag, ok), nullptr);
+  EXPECT_FALSE(cancelled_request->hedged.load());
+
+  // the alarm fires after the request was already answered
+  auto answered_request = make_hedged_request(&cq);
+  answered_request->answered = true;
+  set_hedge_alarm(answered_request, std::chrono::milliseconds(10));
+
+  ASSERT_TRUE(cq.Next(&got_tag, &ok));
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(client.HandleAsyncEvent(got_tag, ok), nullptr);
+  EXPECT_FALSE(answered_request->hedged.load());
+
+  drain_completion_queue(client, cq);
+}
+
+TEST(grpc_client_test_cases, first_reply_wins)
+{
+  GoalStateProvisionerClientImpl client;
+  auto request = make_hedged_request(nullptr);
+
+  AsyncClientCall *original_call = new AsyncClientCall;
+  original_call->type_ = ASYNC_CLIENT_CALL;
+  original_call->request_ = request;
+  original_call->is_hedge = false;
+  original_call->sent_time = std::chrono::steady_clock::now();
+
+  AsyncClientCall *hedged_call = new AsyncClientCall;
+  hedged_call->type_ = ASYNC_CLIENT_CALL;
+  hedged_call->request_ = request;
+  hedged_call->is_hedge = true;
+  hedged_call->sent_time = std::chrono::steady_clock::now();
+
+  // the hedged reply arrives first and is handed to the caller
+  AsyncClientCall *answer =
+          client.HandleAsyncEvent((void *)static_cast<AsyncClientTag *>(hedged_call), true);
+  EXPECT_EQ(answer, hedged_call);
+  EXPECT_TRUE(request->answered.load());
+  delete answer;
+
+  // the slower original reply is dropped by the client
+  EXPECT_EQ(client.HandleAsyncEvent((void *)static_cast<AsyncClientTag *>(original_call), true),
+            nullptr);
+}
@@ -0,0 +1,148 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "hashmap/HashMap.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(hashmap_test_cases, insert_find_erase)
+{
+  CTSL::HashMap<string, int *> hash_map;
+  int *value = nullptr;
+
+  EXPECT_TRUE(hash_map.empty());
+  hash_map.insert("key_1", new int(1));
+  hash_map.insert("key_2", new int(2));
+  EXPECT_EQ(hash_map.size(), 2UL);
+  EXPECT_TRUE(hash_map.find("key_1", value));
+  EXPECT_EQ(*value, 1);
+
+  // an existing key keeps its node and gets the new value
+  int *old_value = value;
+  hash_map.insert("key_1", new int(11));
+  delete old_value;
+  EXPECT_EQ(hash_map.size(), 2UL);
+  EXPECT_TRUE(hash_map.find("key_1", value));
+  EXPECT_EQ(*value, 11);
+
+  hash_map.erase("key_1");
+  hash_map.erase("key_3");
+  EXPECT_FALSE(hash_map.find("key_1", value));
+  EXPECT_EQ(hash_map.size(), 1UL);
+
+  hash_map.clear();
+  EXPECT_TRUE(hash_map.empty());
+  EXPECT_FALSE(hash_map.find("key_2", value));
+}
+
+TEST(hashmap_test_cases, shared_ptr_values)
+{
+  CTSL::HashMap<int, std::shared_ptr<string> > hash_map;
+  std::shared_ptr<string> value;
+
+  hash_map.insert(1, std::make_shared<string>("value_1"));
+  ASSERT_TRUE(hash_map.find(1, value));
+
+  // a value found before the erase stays valid, the map only drops its reference
+  hash_map.erase(1);
+  EXPECT_FALSE(hash_map.find(1, value));
+  EXPECT_EQ(*value, "value_1");
+  EXPECT_EQ(value.use_count(), 1);
+
+  hash_map.insert(2, std::make_shared<string>("value_2"));
+  hash_map.clear();
+  EXPECT_TRUE(hash_map.empty());
+}
+
+TEST(hashmap_test_cases, grows_past_initial_buckets)
+{
+  CTSL::HashMap<uint, int *> hash_map(4);
+  const uint entry_count = 100000;
+  int *value = nullptr;
+
+  for (uint i = 0; i < entry_count; i++) {
+    hash_map.insert(i, new int(i));
+  }
+  EXPECT_EQ(hash_map.size(), entry_count);
+
+  for (uint i = 0; i < entry_count; i++) {
+    ASSERT_TRUE(hash_map.find(i, value));
+    ASSERT_EQ(*value, (int)i);
+  }
+
+  for (uint i = 0; i < entry_count; i += 2) {
+    hash_map.erase(i);
+  }
+  EXPECT_EQ(hash_map.size(), entry_count / 2);
+  EXPECT_FALSE(hash_map.find(0, value));
+  EXPECT_TRUE(hash_map.find(1, value));
+}
+
+TEST(hashmap_test_cases, for_each_visits_every_entry)
+{
+  CTSL::HashMap<uint, int *> hash_map;
+  uint visited_count = 0;
+  uint key_sum = 0;
+
+  for (uint i = 1; i <= 1000; i++) {
+    hash_map.insert(i, nullptr);
+  }
+
+  hash_map.for_each([&](const uint &key, int *) {
+    visited_count++;
+    key_sum += key;
+  });
+
+  EXPECT_EQ(visited_count, 1000U);
+  EXPECT_EQ(key_sum, 500500U);
+}
+
+TEST(hashmap_test_cases, concurrent_insert_find_and_for_each)
+{
+  CTSL::HashMap<uint, int *> hash_map;
+  const uint thread_count = 4;
+  const uint entries_per_thread = 20000;
+  vector<thread> writers;
+
+  for (uint t = 0; t < thread_count; t++) {
+    writers.emplace_back([&hash_map, t, entries_per_thread]() {
+      int *value = nullptr;
+      for (uint i = 0; i < entries_per_thread; i++) {
+        uint key = t * entries_per_thread + i;
+        hash_map.insert(key, new int(key));
+        EXPECT_TRUE(hash_map.find(key, value));
+      }
+    });
+  }
+
+  thread reader([&hash_map]() {
+    for (int round = 0; round < 10; round++) {
+      size_t visited_count = 0;
+      hash_map.for_each([&](const uint &, int *) { visited_count++; });
+      EXPECT_LE(visited_count, hash_map.size());
+    }
+  });
+
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  reader.join();
+
+  EXPECT_EQ(hash_map.size(), thread_count * entries_per_thread);
+}
@@ -0,0 +1,128 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_host_ip_set.h"
+#include "gtest/gtest.h"
+#include <cstring>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+using namespace std;
+using aca_ovs_l2_programmer::ACA_Host_Ip_Set;
+using aca_ovs_l2_programmer::host_ip_address;
+
+// build one RTM_NEWADDR / RTM_DELADDR message carrying ip_address as IFA_LOCAL
+static size_t aca_test_host_ip_set_build_message(char *buffer, uint16_t message_type,
+                                                 const string &ip_address)
+{
+  uint8_t address[16];
+  unsigned char family = AF_INET;
+  size_t address_length = 4;
+
+  if (inet_pton(AF_INET, ip_address.c_str(), address) != 1) {
+    inet_pton(AF_INET6, ip_address.c_str(), address);
+    family = AF_INET6;
+    address_length = 16;
+  }
+
+  auto message = (struct nlmsghdr *)buffer;
+  message->nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+  message->nlmsg_type = message_type;
+
+  auto address_message = (struct ifaddrmsg *)NLMSG_DATA(message);
+  memset(address_message, 0, sizeof(*address_message));
+  address_message->ifa_family = family;
+
+  auto attribute = (struct rtattr *)(buffer + NLMSG_ALIGN(message->nlmsg_len));
+  attribute->rta_type = IFA_LOCAL;
+  attribute->rta_len = RTA_LENGTH(address_length);
+  memcpy(RTA_DATA(attribute), address, address_length);
+  message->nlmsg_len = NLMSG_ALIGN(message->nlmsg_len) + RTA_ALIGN(attribute->rta_len);
+
+  return message->nlmsg_len;
+}
+
+TEST(host_ip_set_test_cases, parse_insert_contains_erase)
+{
+  ACA_Host_Ip_Set host_ips;
+  host_ip_address ipv4_address;
+  host_ip_address mapped_address;
+  host_ip_address ipv6_address;
+
+  EXPECT_TRUE(ACA_Host_Ip_Set::parse_ip_address("10.213.43.187", ipv4_address));
+  EXPECT_TRUE(ACA_Host_Ip_Set::parse_ip_address("::ffff:10.213.43.187", mapped_address));
+  EXPECT_TRUE(ACA_Host_Ip_Set::parse_ip_address("fe80::1", ipv6_address));
+  EXPECT_FALSE(ACA_Host_Ip_Set::parse_ip_address("10.213.43", ipv6_address));
+  EXPECT_TRUE(ipv4_address == mapped_address);
+  EXPECT_EQ(ACA_Host_Ip_Set::to_string(ipv4_address), "10.213.43.187");
+  EXPECT_EQ(ACA_Host_Ip_Set::to_string(ipv6_address), "fe80::1");
+
+  EXPECT_FALSE(host_ips.contains("10.213.43.187"));
+  EXPECT_TRUE(host_ips.insert(ipv4_address));
+  EXPECT_FALSE(host_ips.insert(mapped_address));
+  EXPECT_TRUE(host_ips.insert(ipv6_address));
+  EXPECT_EQ(host_ips.size(), 2UL);
+  EXPECT_TRUE(host_ips.contains("10.213.43.187"));
+  EXPECT_TRUE(host_ips.contains("fe80::1"));
+  EXPECT_FALSE(host_ips.contains("10.213.43.188"));
+  EXPECT_FALSE(host_ips.contains("not an ip"));
+
+  EXPECT_TRUE(host_ips.erase(ipv4_address));
+  EXPECT_FALSE(host_ips.erase(ipv4_address));
+  EXPECT_FALSE(host_ips.contains("10.213.43.187"));
+  EXPECT_TRUE(host_ips.contains("fe80::1"));
+
+  host_ips.clear();
+  EXPECT_EQ(host_ips.size(), 0UL);
+  EXPECT_FALSE(host_ips.contains("fe80::1"));
+}
+
+TEST(host_ip_set_test_cases, grow_and_erase_keep_probe_sequences)
+{
+  ACA_Host_Ip_Set host_ips;
+  const uint32_t address_count = HOST_IP_SET_INITIAL_SLOTS * 8;
+
+  for (uint32_t i = 0; i < address_count; i++) {
+    EXPECT_TRUE(host_ips.insert(ACA_Host_Ip_Set::from_ipv4(htonl(0x0a000000 + i))));
+  }
+  EXPECT_EQ(host_ips.size(), address_count);
+
+  // erase every other address, the remaining ones must still be found
+  for (uint32_t i = 0; i < address_count; i += 2) {
+    EXPECT_TRUE(host_ips.erase(ACA_Host_Ip_Set::from_ipv4(htonl(0x0a000000 + i))));
+  }
+  for (uint32_t i = 0; i < address_count; i++) {
+    EXPECT_EQ(host_ips.contains(ACA_Host_Ip_Set::from_ipv4(htonl(0x0a000000 + i))), i % 2 == 1);
+  }
+  EXPECT_EQ(host_ips.size(), address_count / 2);
+}
+
+TEST(host_ip_set_test_cases, apply_netlink_address_messages)
+{
+  ACA_Host_Ip_Set host_ips;
+  alignas(struct nlmsghdr) char buffer[512];
+  size_t length;
+
+  length = aca_test_host_ip_set_build_message(buffer, RTM_NEWADDR, "192.0.2.10");
+  length += aca_test_host_ip_set_build_message(buffer + length, RTM_NEWADDR, "2001:db8::10");
+  EXPECT_EQ(host_ips.apply_netlink_messages(buffer, length), 2);
+  EXPECT_TRUE(host_ips.contains("192.0.2.10"));
+  EXPECT_TRUE(host_ips.contains("2001:db8::10"));
+
+  // a removed address is gone once the set is reloaded from the host's interfaces
+  length = aca_test_host_ip_set_build_message(buffer, RTM_DELADDR, "192.0.2.10");
+  EXPECT_EQ(host_ips.apply_netlink_messages(buffer, length), 1);
+  EXPECT_FALSE(host_ips.contains("192.0.2.10"));
+}
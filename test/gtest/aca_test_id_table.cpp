@@ -0,0 +1,103 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_id_table.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_id_table::ACA_Id_Table;
+using aca_id_table::id_handle;
+
+TEST(id_table_test_cases, intern_find_get_id)
+{
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  string port_id = "8e1f7f88-b718-11ea-b3de-0242ac130004";
+  string subnet_id = "27330ae4-b718-11ea-b3df-0242ac130004";
+
+  EXPECT_EQ(id_table.find(port_id), ACA_Id_Table::NO_HANDLE);
+
+  id_handle port_handle = id_table.intern(port_id);
+  id_handle subnet_handle = id_table.intern(subnet_id);
+  EXPECT_NE(port_handle, ACA_Id_Table::NO_HANDLE);
+  EXPECT_NE(port_handle, subnet_handle);
+  EXPECT_EQ(id_table.intern(port_id), port_handle);
+  EXPECT_EQ(id_table.find(port_id), port_handle);
+
+  EXPECT_EQ(id_table.get_id(port_handle), port_id);
+  EXPECT_EQ(id_table.get_id(subnet_handle), subnet_id);
+  EXPECT_EQ(id_table.get_id(ACA_Id_Table::NO_HANDLE), "");
+}
+
+TEST(id_table_test_cases, concurrent_intern)
+{
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  const int id_count = ID_TABLE_CHUNK_SIZE * 2;
+  vector<vector<id_handle> > handles(4, vector<id_handle>(id_count));
+  vector<thread> workers;
+
+  for (size_t t = 0; t < handles.size(); t++) {
+    workers.emplace_back([&id_table, &handles, t, id_count] {
+      for (int i = 0; i < id_count; i++) {
+        handles[t][i] = id_table.intern("id_table_test_neighbor_" + to_string(i));
+        id_table.get_id(handles[t][i]);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // every thread got the same handle for the same id, and it maps back to the id
+  for (int i = 0; i < id_count; i++) {
+    for (size_t t = 1; t < handles.size(); t++) {
+      EXPECT_EQ(handles[t][i], handles[0][i]);
+    }
+    EXPECT_EQ(id_table.get_id(handles[0][i]), "id_table_test_neighbor_" + to_string(i));
+  }
+  EXPECT_GE(id_table.size(), (size_t)id_count);
+}
+
+TEST(id_table_test_cases, release_and_reuse)
+{
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+  string neighbor_id = "id_table_test_released_neighbor";
+  size_t initial_size = id_table.size();
+
+  id_handle neighbor_handle = id_table.intern(neighbor_id);
+  EXPECT_EQ(id_table.intern(neighbor_id), neighbor_handle);
+  EXPECT_EQ(id_table.size(), initial_size + 1);
+
+  // a retained reference is dropped like an interned one
+  id_table.retain(neighbor_handle);
+  id_table.release(neighbor_handle);
+
+  // still referenced once
+  id_table.release(neighbor_handle);
+  EXPECT_EQ(id_table.find(neighbor_id), neighbor_handle);
+  EXPECT_EQ(id_table.get_id(neighbor_handle), neighbor_id);
+
+  // the last reference frees the handle for the next new id
+  id_table.release(neighbor_handle);
+  EXPECT_EQ(id_table.find(neighbor_id), ACA_Id_Table::NO_HANDLE);
+  EXPECT_EQ(id_table.get_id(neighbor_handle), "");
+  EXPECT_EQ(id_table.size(), initial_size);
+
+  string other_neighbor_id = "id_table_test_other_neighbor";
+  EXPECT_EQ(id_table.intern(other_neighbor_id), neighbor_handle);
+  EXPECT_EQ(id_table.get_id(neighbor_handle), other_neighbor_id);
+  id_table.release(neighbor_handle);
+}
@@ -0,0 +1,165 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_journal.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_journal::ACA_Journal;
+
+static const string journal_test_file = "/tmp/aca_test_journal";
+
+static vector<string> journal_test_replay(ACA_Journal &journal)
+{
+  vector<string> records;
+
+  journal.replay([&](const char *payload, size_t payload_length) {
+    records.emplace_back(payload, payload_length);
+  });
+
+  return records;
+}
+
+TEST(journal_test_cases, append_and_replay_after_reopen)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  remove(journal_test_file.c_str());
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  EXPECT_EQ(journal.open(journal_test_file, 4096), -EINVAL);
+  EXPECT_EQ(journal.append("port_1", 6), EXIT_SUCCESS);
+  EXPECT_EQ(journal.append("neighbor_22", 11), EXIT_SUCCESS);
+  journal.close();
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  vector<string> records = journal_test_replay(journal);
+  ASSERT_EQ(records.size(), 2UL);
+  EXPECT_EQ(records[0], "port_1");
+  EXPECT_EQ(records[1], "neighbor_22");
+
+  // appends made while replaying are dropped
+  journal.replay([&](const char *, size_t) { journal.append("again", 5); });
+  EXPECT_EQ(journal_test_replay(journal).size(), 2UL);
+
+  // full journal grows instead of dropping the record
+  string big_record(4096, 'x');
+  EXPECT_EQ(journal.append(big_record.data(), big_record.size()), EXIT_SUCCESS);
+  EXPECT_GE(journal.capacity(), 8192UL);
+  vector<string> grown_records = journal_test_replay(journal);
+  ASSERT_EQ(grown_records.size(), 3UL);
+  EXPECT_EQ(grown_records[2], big_record);
+
+  EXPECT_EQ(journal.reset(), EXIT_SUCCESS);
+  EXPECT_EQ(journal.size(), 0UL);
+  EXPECT_TRUE(journal_test_replay(journal).empty());
+
+  journal.close();
+  remove(journal_test_file.c_str());
+}
+
+TEST(journal_test_cases, discard_records_covered_by_snapshot)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  remove(journal_test_file.c_str());
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  EXPECT_EQ(journal.append("port_1", 6), EXIT_SUCCESS);
+  size_t snapshot_position = journal.size();
+  EXPECT_EQ(journal.append("port_2", 6), EXIT_SUCCESS);
+
+  EXPECT_EQ(journal.discard_before(journal.size() + 1), -EINVAL);
+  EXPECT_EQ(journal.discard_before(snapshot_position), EXIT_SUCCESS);
+  // the kept records were written to a new file renamed over the journal
+  FILE *compact_file = fopen((journal_test_file + ".compact").c_str(), "r");
+  EXPECT_EQ(compact_file, nullptr);
+  if (compact_file != nullptr) {
+    fclose(compact_file);
+  }
+  EXPECT_EQ(journal.append("port_3", 6), EXIT_SUCCESS);
+  journal.close();
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  vector<string> records = journal_test_replay(journal);
+  ASSERT_EQ(records.size(), 2UL);
+  EXPECT_EQ(records[0], "port_2");
+  EXPECT_EQ(records[1], "port_3");
+
+  journal.close();
+  remove(journal_test_file.c_str());
+}
+
+TEST(journal_test_cases, torn_record_is_dropped)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  remove(journal_test_file.c_str());
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  EXPECT_EQ(journal.append("router_1", 8), EXIT_SUCCESS);
+  EXPECT_EQ(journal.append("router_2", 8), EXIT_SUCCESS);
+  size_t first_record_size = journal.size() / 2;
+  journal.close();
+
+  // corrupt the payload of the second record
+  FILE *journal_file = fopen(journal_test_file.c_str(), "r+");
+  ASSERT_NE(journal_file, nullptr);
+  fseek(journal_file, first_record_size + 12, SEEK_SET);
+  fputc('X', journal_file);
+  fclose(journal_file);
+
+  ASSERT_EQ(journal.open(journal_test_file, 4096), EXIT_SUCCESS);
+  vector<string> records = journal_test_replay(journal);
+  ASSERT_EQ(records.size(), 1UL);
+  EXPECT_EQ(records[0], "router_1");
+
+  // the next record replaces the torn one
+  EXPECT_EQ(journal.append("router_3", 8), EXIT_SUCCESS);
+  records = journal_test_replay(journal);
+  ASSERT_EQ(records.size(), 2UL);
+  EXPECT_EQ(records[1], "router_3");
+
+  journal.close();
+  remove(journal_test_file.c_str());
+}
+
+TEST(journal_test_cases, concurrent_appends_are_group_committed)
+{
+  ACA_Journal &journal = ACA_Journal::get_instance();
+  remove(journal_test_file.c_str());
+  vector<thread> appenders;
+
+  ASSERT_EQ(journal.open(journal_test_file, 1 << 20), EXIT_SUCCESS);
+
+  for (int i = 0; i < 8; i++) {
+    appenders.emplace_back([&journal, i] {
+      for (int j = 0; j < 50; j++) {
+        string record = "goal_state_" + to_string(i) + "_" + to_string(j);
+        EXPECT_EQ(journal.append(record.data(), record.size()), EXIT_SUCCESS);
+      }
+    });
+  }
+  for (auto &appender : appenders) {
+    appender.join();
+  }
+
+  EXPECT_EQ(journal.flush(), EXIT_SUCCESS);
+  EXPECT_EQ(journal_test_replay(journal).size(), 400UL);
+
+  journal.close();
+  remove(journal_test_file.c_str());
+}
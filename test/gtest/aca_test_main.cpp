@@ -36,6 +36,7 @@ string g_ofctl_target = EMPTY_STRING;
 string g_ofctl_options = EMPTY_STRING;
 string g_ncm_address = EMPTY_STRING;
 string g_ncm_port = EMPTY_STRING;
+string g_ncm_hedge_address = EMPTY_STRING;
 string g_grpc_server_port = EMPTY_STRING;
 std::thread *g_grpc_server_thread = NULL;
 GoalStateProvisionerAsyncServer *g_grpc_server = NULL;
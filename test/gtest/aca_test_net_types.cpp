@@ -0,0 +1,73 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_net_types.h"
+#include "gtest/gtest.h"
+#include <unordered_set>
+
+using namespace std;
+using aca_net_types::ipv4_addr;
+using aca_net_types::mac_addr;
+
+TEST(net_types_test_cases, ipv4_addr_parse_and_print)
+{
+  ipv4_addr address;
+
+  EXPECT_TRUE(ipv4_addr::parse("10.0.0.2", address));
+  EXPECT_EQ(address.value, htonl(0x0a000002));
+  EXPECT_EQ(address.to_string(), "10.0.0.2");
+  EXPECT_FALSE(address.is_unset());
+
+  EXPECT_FALSE(ipv4_addr::parse("", address));
+  EXPECT_FALSE(ipv4_addr::parse("10.0.0", address));
+  EXPECT_FALSE(ipv4_addr::parse("10.0.0.256", address));
+  EXPECT_FALSE(ipv4_addr::parse("fe80::1", address));
+}
+
+TEST(net_types_test_cases, mac_addr_parse_and_print)
+{
+  mac_addr address;
+  mac_addr dash_address;
+
+  EXPECT_TRUE(mac_addr::parse("fa:16:3E:d7:f2:06", address));
+  EXPECT_EQ(address.to_string(), "fa:16:3e:d7:f2:06");
+  EXPECT_EQ(address.to_u64(), 0xfa163ed7f206ULL);
+  EXPECT_TRUE(mac_addr::parse("fa-16-3e-d7-f2-6", dash_address));
+  EXPECT_TRUE(address == dash_address);
+
+  EXPECT_FALSE(mac_addr::parse("", address));
+  EXPECT_FALSE(mac_addr::parse("fa:16:3e:d7:f2", address));
+  EXPECT_FALSE(mac_addr::parse("fa:16:3e:d7:f2:06:01", address));
+  EXPECT_FALSE(mac_addr::parse("fa:16-3e:d7:f2:06", address));
+  EXPECT_FALSE(mac_addr::parse("fa:16:3e:d7:f2:0g", address));
+  EXPECT_FALSE(mac_addr::parse("fa:163:e:d7:f2:06", address));
+}
+
+TEST(net_types_test_cases, usable_as_hash_keys)
+{
+  unordered_set<ipv4_addr> ipv4_addresses;
+  unordered_set<mac_addr> mac_addresses;
+  ipv4_addr ipv4_address;
+  mac_addr mac_address;
+
+  ASSERT_TRUE(ipv4_addr::parse("192.168.1.1", ipv4_address));
+  ASSERT_TRUE(mac_addr::parse("02:00:00:00:00:01", mac_address));
+  ipv4_addresses.insert(ipv4_address);
+  mac_addresses.insert(mac_address);
+
+  ASSERT_TRUE(ipv4_addr::parse("192.168.1.1", ipv4_address));
+  ASSERT_TRUE(mac_addr::parse("02-00-00-00-00-01", mac_address));
+  EXPECT_EQ(ipv4_addresses.count(ipv4_address), 1UL);
+  EXPECT_EQ(mac_addresses.count(mac_address), 1UL);
+}
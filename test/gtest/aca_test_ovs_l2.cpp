@@ -16,6 +16,7 @@
 #include "aca_util.h"
 #include "aca_config.h"
 #include "aca_vlan_manager.h"
+#include "aca_arp_responder.h"
 #include "aca_ovs_l2_programmer.h"
 #include "aca_comm_mgr.h"
 #include "gtest/gtest.h"
@@ -33,6 +34,8 @@ using namespace aca_comm_manager;
 using namespace aca_net_config;
 using namespace aca_ovs_l2_programmer;
 using aca_ovs_control::ACA_OVS_Control;
+using aca_arp_responder::ACA_ARP_Responder;
+using aca_arp_responder::arp_config;
 
 // extern the string and helper functions from aca_test_ovs_util.cpp
 extern string project_id;
@@ -814,6 +817,91 @@ TEST(ovs_l2_test_cases, 1_port_CREATE_plus_10_l2_neighbor_CREATE)
   g_debug_mode = previous_debug_mode;
 }
 
+TEST(ovs_l2_test_cases, vlan_id_to_tunnel_id_lookup)
+{
+  ulong not_care_culminative_time = 0;
+  uint tunnel_id = 4321;
+  ACA_Vlan_Manager &vlan_manager = ACA_Vlan_Manager::get_instance();
+
+  vlan_manager.clear_all_data();
+
+  uint vlan_id = vlan_manager.get_or_create_vlan_id(tunnel_id);
+  EXPECT_EQ(vlan_manager.get_tunnelId_by_vlanId(vlan_id), tunnel_id);
+  EXPECT_EQ(vlan_manager.get_tunnelId_by_vlanId(VLAN_ID_COUNT), 0U);
+
+  // the reverse index entry goes away with the last port of the VPC
+  vlan_manager.create_ovs_port(vpc_id_1, port_name_1, tunnel_id, not_care_culminative_time);
+  EXPECT_EQ(vlan_manager.get_tunnelId_by_vlanId(vlan_id), tunnel_id);
+  vlan_manager.delete_ovs_port(vpc_id_1, port_name_1, tunnel_id, not_care_culminative_time);
+  EXPECT_EQ(vlan_manager.get_tunnelId_by_vlanId(vlan_id), 0U);
+
+  vlan_manager.clear_all_data();
+}
+
+TEST(ovs_l2_test_cases, reused_vlan_id_has_no_old_arp_entries)
+{
+  ulong not_care_culminative_time = 0;
+  uint tunnel_id = 4321;
+  ACA_Vlan_Manager &vlan_manager = ACA_Vlan_Manager::get_instance();
+  ACA_ARP_Responder &arp_responder = ACA_ARP_Responder::get_instance();
+  in_addr ipv4_address;
+
+  vlan_manager.clear_all_data();
+  arp_responder.clear_all_data();
+  inet_pton(AF_INET, vip_address_1.c_str(), &ipv4_address);
+
+  vlan_manager.create_ovs_port(vpc_id_1, port_name_1, tunnel_id, not_care_culminative_time);
+  uint vlan_id = vlan_manager.get_or_create_vlan_id(tunnel_id);
+
+  arp_config stArpCfg;
+  stArpCfg.mac_address = vmac_address_1;
+  stArpCfg.ipv4_address = vip_address_1;
+  stArpCfg.vlan_id = vlan_id;
+  EXPECT_EQ(arp_responder.add_arp_entry(&stArpCfg), EXIT_SUCCESS);
+  EXPECT_TRUE(arp_responder.does_arp_entry_exist(vlan_id, ipv4_address.s_addr));
+
+  // the last port of the VPC goes away with its vlan id
+  vlan_manager.delete_ovs_port(vpc_id_1, port_name_1, tunnel_id, not_care_culminative_time);
+
+  // other VPCs come up until one is given the same vlan id
+  uint reused_vlan_id = 0;
+  for (uint i = 1; i < VLAN_ID_COUNT && reused_vlan_id != vlan_id; i++) {
+    reused_vlan_id = vlan_manager.get_or_create_vlan_id(tunnel_id + i);
+  }
+  EXPECT_EQ(reused_vlan_id, vlan_id);
+  EXPECT_FALSE(arp_responder.does_arp_entry_exist(vlan_id, ipv4_address.s_addr));
+
+  vlan_manager.clear_all_data();
+  arp_responder.clear_all_data();
+}
+
+TEST(ovs_l2_test_cases, restore_rejects_duplicate_vlan_id)
+{
+  uint tunnel_id = 4321;
+  uint vlan_id = 5;
+  ACA_Vlan_Manager &vlan_manager = ACA_Vlan_Manager::get_instance();
+  aca_snapshot::ACA_Snapshot_Writer snapshot_writer;
+
+  vlan_manager.clear_all_data();
+
+  // same layout as ACA_Vlan_Manager::snapshot, two VPCs with the same vlan id
+  snapshot_writer.put_u32(vlan_id + 1);
+  snapshot_writer.put_u32(2);
+  for (uint i = 0; i < 2; i++) {
+    snapshot_writer.put_u32(tunnel_id + i);
+    snapshot_writer.put_u32(vlan_id);
+    snapshot_writer.put_string("");
+    snapshot_writer.put_u32(0);
+  }
+
+  const string &data = snapshot_writer.get_data();
+  aca_snapshot::ACA_Snapshot_Reader snapshot_reader(data.data(), data.size());
+  EXPECT_EQ(vlan_manager.restore(snapshot_reader), -EINVAL);
+  EXPECT_NE(vlan_manager.get_tunnelId_by_vlanId(vlan_id), tunnel_id + 1);
+
+  vlan_manager.clear_all_data();
+}
+
 TEST(ovs_l2_test_cases, DISABLED_2_ports_CREATE_test_traffic_PARENT)
 {
   string two_port_vmac_address_1 = "fa:16:3e:d7:f2:6a";
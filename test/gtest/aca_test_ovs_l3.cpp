@@ -20,6 +20,9 @@
 #include "gtest/gtest.h"
 #include "goalstate.pb.h"
 #include "aca_ovs_control.h"
+#include "aca_ovs_l3_programmer.h"
+#include "aca_id_table.h"
+#include "aca_goal_state_index.h"
 #include <unistd.h> /* for getopt */
 #include <iostream>
 #include <string>
@@ -31,6 +34,9 @@ using namespace aca_comm_manager;
 using namespace aca_net_config;
 using namespace aca_ovs_l2_programmer;
 using aca_ovs_control::ACA_OVS_Control;
+using aca_ovs_l3_programmer::ACA_OVS_L3_Programmer;
+using aca_id_table::ACA_Id_Table;
+using aca_goal_state_index::ACA_Goal_State_Index;
 
 // extern the string and helper functions from aca_test_ovs_util.cpp
 extern string project_id;
@@ -201,6 +207,53 @@ TEST(ovs_l3_test_cases, ADD_DELETE_ROUTER_test_no_traffic)
   EXPECT_EQ(overall_rc, EXIT_SUCCESS);
 }
 
+TEST(ovs_l3_test_cases, ROUTER_CREATE_UPDATE_DELETE_releases_ids)
+{
+  ulong not_care_culminative_time = 0;
+  ACA_OVS_L3_Programmer &l3_programmer = ACA_OVS_L3_Programmer::get_instance();
+  ACA_Id_Table &id_table = ACA_Id_Table::get_instance();
+
+  GoalState GoalState_builder;
+  aca_test_create_default_router_goal_state(&GoalState_builder);
+  ACA_Goal_State_Index goal_state_index(GoalState_builder);
+  RouterConfiguration *RouterConfiguration_builder =
+          GoalState_builder.mutable_router_states(0)->mutable_configuration();
+  auto *RouterConfiguration_SubnetRoutingRule_builder =
+          RouterConfiguration_builder->mutable_subnet_routing_tables(0)->mutable_routing_rules(0);
+
+  l3_programmer.clear_all_data();
+  size_t initial_id_count = id_table.size();
+
+  for (int i = 0; i < 3; i++) {
+    // create, drop a routing rule with a DELTA update, put it back with a FULL one
+    RouterConfiguration_builder->set_update_type(UpdateType::DELTA);
+    RouterConfiguration_SubnetRoutingRule_builder->set_operation_type(OperationType::CREATE);
+    EXPECT_EQ(l3_programmer.create_or_update_router(*RouterConfiguration_builder,
+                                                    GoalState_builder, goal_state_index,
+                                                    not_care_culminative_time),
+              EXIT_SUCCESS);
+    EXPECT_GT(id_table.size(), initial_id_count);
+
+    RouterConfiguration_SubnetRoutingRule_builder->set_operation_type(OperationType::DELETE);
+    EXPECT_EQ(l3_programmer.create_or_update_router(*RouterConfiguration_builder,
+                                                    GoalState_builder, goal_state_index,
+                                                    not_care_culminative_time),
+              EXIT_SUCCESS);
+
+    RouterConfiguration_builder->set_update_type(UpdateType::FULL);
+    RouterConfiguration_SubnetRoutingRule_builder->set_operation_type(OperationType::CREATE);
+    EXPECT_EQ(l3_programmer.create_or_update_router(*RouterConfiguration_builder,
+                                                    GoalState_builder, goal_state_index,
+                                                    not_care_culminative_time),
+              EXIT_SUCCESS);
+
+    // every id the router table referenced is released with the router
+    EXPECT_EQ(l3_programmer.delete_router(*RouterConfiguration_builder, not_care_culminative_time),
+              EXIT_SUCCESS);
+    EXPECT_EQ(id_table.size(), initial_id_count);
+  }
+}
+
 TEST(ovs_l3_test_cases, 1_l3_neighbor_CREATE_DELETE)
 {
   aca_test_1_neighbor_CREATE_DELETE(NeighborType::L3);
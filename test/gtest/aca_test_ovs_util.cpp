@@ -20,6 +20,8 @@
 #include "aca_ovs_l2_programmer.h"
 #include "aca_ovs_l3_programmer.h"
 #include "aca_comm_mgr.h"
+#include "aca_revision_tracker.h"
+#include "aca_update_coalescer.h"
 #include "gtest/gtest.h"
 #include "goalstate.pb.h"
 #include <unistd.h> /* for getopt */
@@ -34,6 +36,8 @@ using namespace aca_ovs_control;
 using namespace aca_vlan_manager;
 using namespace aca_ovs_l2_programmer;
 using namespace aca_ovs_l3_programmer;
+using aca_revision_tracker::ACA_Revision_Tracker;
+using aca_update_coalescer::ACA_Update_Coalescer;
 
 string project_id = "99d9d709-8478-4b46-9f3f-000000000000";
 string vpc_id_1 = "1b08a5bc-b718-11ea-b3de-111111111111";
@@ -97,6 +101,10 @@ void aca_test_reset_environment()
 
   ACA_OVS_L3_Programmer::get_instance().clear_all_data();
 
+  // the next test pushes the same revisions again, they must not be skipped
+  ACA_Revision_Tracker::get_instance().clear();
+  ACA_Update_Coalescer::get_instance().clear();
+
   // delete br-int and br-tun bridges
   ACA_OVS_L2_Programmer::get_instance().execute_ovsdb_command(
           "del-br br-int", not_care_culminative_time, overall_rc);
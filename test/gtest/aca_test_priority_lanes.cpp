@@ -0,0 +1,110 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_config.h"
+#include "aca_priority_lanes.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_priority_lanes::ACA_Priority_Lanes;
+
+static void wait_until(std::atomic_bool &flag)
+{
+  // bounded wait so a broken scheduler fails the test instead of hanging it
+  for (int i = 0; i < 5000 && !flag.load(); i++) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+}
+
+TEST(priority_lanes_test_cases, high_priority_not_blocked_by_bulk)
+{
+  ACA_Priority_Lanes priority_lanes;
+  std::atomic_bool release_bulk(false);
+  std::atomic_bool bulk_started(false);
+  std::atomic_bool high_priority_done(false);
+
+  // one worker reserved for the high priority lane, one shared
+  priority_lanes.start(2, 1);
+
+  priority_lanes.push(ACA_Priority_Lanes::BULK_LANE, [&] {
+    bulk_started = true;
+    wait_until(release_bulk);
+  });
+  wait_until(bulk_started);
+  ASSERT_TRUE(bulk_started.load());
+
+  priority_lanes.push(ACA_Priority_Lanes::HIGH_PRIORITY_LANE,
+                      [&] { high_priority_done = true; });
+  wait_until(high_priority_done);
+
+  // the high priority task finished while the bulk task is still running
+  EXPECT_TRUE(high_priority_done.load());
+  EXPECT_FALSE(release_bulk.load());
+
+  release_bulk = true;
+  priority_lanes.stop();
+}
+
+TEST(priority_lanes_test_cases, bulk_not_starved)
+{
+  ACA_Priority_Lanes priority_lanes;
+  std::atomic_bool release_worker(false);
+  std::atomic_bool worker_busy(false);
+  std::mutex order_mutex;
+  vector<int> execution_order;
+  int high_priority_tasks = GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY * 3;
+
+  // a single shared worker, so both lanes compete for it
+  priority_lanes.start(1, 0);
+
+  priority_lanes.push(ACA_Priority_Lanes::HIGH_PRIORITY_LANE, [&] {
+    worker_busy = true;
+    wait_until(release_worker);
+  });
+  wait_until(worker_busy);
+
+  // queue the bulk task first, then a burst of high priority tasks
+  priority_lanes.push(ACA_Priority_Lanes::BULK_LANE, [&] {
+    std::lock_guard<std::mutex> order_lock(order_mutex);
+    execution_order.push_back(-1);
+  });
+  for (int i = 0; i < high_priority_tasks; i++) {
+    priority_lanes.push(ACA_Priority_Lanes::HIGH_PRIORITY_LANE, [&, i] {
+      std::lock_guard<std::mutex> order_lock(order_mutex);
+      execution_order.push_back(i);
+    });
+  }
+  EXPECT_EQ(priority_lanes.queue_depth(ACA_Priority_Lanes::BULK_LANE), (size_t)1);
+
+  release_worker = true;
+  priority_lanes.stop();
+
+  ASSERT_EQ(execution_order.size(), (size_t)high_priority_tasks + 1);
+  int bulk_position = -1;
+  for (size_t i = 0; i < execution_order.size(); i++) {
+    if (execution_order[i] == -1) {
+      bulk_position = i;
+    }
+  }
+  // high priority goes first, but the bulk task gets its turn
+  // after at most GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY of them
+  EXPECT_GT(bulk_position, 0);
+  EXPECT_LE(bulk_position, GRPC_PRIORITY_LANES_MAX_CONSECUTIVE_HIGH_PRIORITY);
+}
@@ -0,0 +1,108 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_reply_publisher.h"
+#include "gtest/gtest.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using aca_reply_publisher::ACA_Reply_Publisher;
+
+TEST(reply_publisher_test_cases, replies_are_batched_until_linger_expires)
+{
+  mutex batches_mutex;
+  vector<vector<string>> batches;
+
+  ACA_Reply_Publisher reply_publisher(
+          [&](const vector<string> &batch) {
+            lock_guard<mutex> lock(batches_mutex);
+            batches.push_back(batch);
+            return EXIT_SUCCESS;
+          },
+          1024, 4096, chrono::milliseconds(50));
+
+  EXPECT_EQ(reply_publisher.publish("reply_1"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("reply_2"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("reply_3"), EXIT_SUCCESS);
+
+  this_thread::sleep_for(chrono::milliseconds(200));
+
+  {
+    lock_guard<mutex> lock(batches_mutex);
+    ASSERT_EQ(batches.size(), 1UL);
+    // one message per reply, never concatenated
+    EXPECT_EQ(batches[0], vector<string>({ "reply_1", "reply_2", "reply_3" }));
+  }
+  EXPECT_EQ(reply_publisher.get_published_batch_count(), 1UL);
+}
+
+TEST(reply_publisher_test_cases, full_batch_is_sent_without_lingering)
+{
+  mutex batches_mutex;
+  vector<vector<string>> batches;
+
+  ACA_Reply_Publisher reply_publisher(
+          [&](const vector<string> &batch) {
+            lock_guard<mutex> lock(batches_mutex);
+            batches.push_back(batch);
+            return EXIT_SUCCESS;
+          },
+          10, 4096, chrono::seconds(60));
+
+  EXPECT_EQ(reply_publisher.publish("12345"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("67890"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("abc"), EXIT_SUCCESS);
+
+  // the first batch is full, the rest goes out on close
+  this_thread::sleep_for(chrono::milliseconds(200));
+  {
+    lock_guard<mutex> lock(batches_mutex);
+    ASSERT_EQ(batches.size(), 1UL);
+    EXPECT_EQ(batches[0], vector<string>({ "12345", "67890" }));
+  }
+
+  reply_publisher.close();
+  EXPECT_EQ(reply_publisher.publish("late"), -ESHUTDOWN);
+  ASSERT_EQ(batches.size(), 2UL);
+  EXPECT_EQ(batches[1], vector<string>({ "abc" }));
+}
+
+TEST(reply_publisher_test_cases, replies_are_dropped_when_the_bus_is_slow)
+{
+  mutex send_mutex;
+  send_mutex.lock();
+
+  ACA_Reply_Publisher reply_publisher(
+          [&](const vector<string> &) {
+            // stuck until the test lets it go
+            lock_guard<mutex> lock(send_mutex);
+            return EXIT_SUCCESS;
+          },
+          8, 16, chrono::microseconds(0));
+
+  EXPECT_EQ(reply_publisher.publish("reply_01"), EXIT_SUCCESS);
+  this_thread::sleep_for(chrono::milliseconds(50));
+
+  EXPECT_EQ(reply_publisher.publish("reply_02"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("reply_03"), EXIT_SUCCESS);
+  EXPECT_EQ(reply_publisher.publish("reply_04"), -ENOBUFS);
+  EXPECT_EQ(reply_publisher.get_dropped_count(), 1UL);
+
+  send_mutex.unlock();
+  reply_publisher.close();
+  EXPECT_EQ(reply_publisher.get_published_batch_count(), 3UL);
+}
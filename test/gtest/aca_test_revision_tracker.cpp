@@ -0,0 +1,169 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_revision_tracker.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_revision_tracker::ACA_Revision_Tracker;
+
+// resource types are opaque ints to the tracker
+static const int REVISION_TEST_PORT = 1;
+static const int REVISION_TEST_NEIGHBOR = 2;
+
+TEST(revision_tracker_test_cases, skip_revision_not_newer)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  uint64_t generation = revision_tracker.get_generation();
+  string port_id = "revision_test_port";
+
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 3));
+
+  revision_tracker.record_applied(REVISION_TEST_PORT, port_id, 3, generation);
+  EXPECT_TRUE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 2));
+  EXPECT_TRUE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 3));
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 4));
+  EXPECT_EQ(revision_tracker.cache_hit_count(), 2UL);
+
+  // same id under another resource type is a different resource
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_NEIGHBOR, port_id, 3));
+
+  // an older revision finishing late does not roll the record back
+  revision_tracker.record_applied(REVISION_TEST_PORT, port_id, 5, generation);
+  revision_tracker.record_applied(REVISION_TEST_PORT, port_id, 4, generation);
+  EXPECT_EQ(revision_tracker.get_applied_revision(REVISION_TEST_PORT, port_id), 5U);
+
+  revision_tracker.forget(REVISION_TEST_PORT, port_id);
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 5));
+  EXPECT_EQ(revision_tracker.size(), 0UL);
+}
+
+TEST(revision_tracker_test_cases, unset_revision_always_applied)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  uint64_t generation = revision_tracker.get_generation();
+  string neighbor_id = "revision_test_neighbor";
+
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, neighbor_id, 0, generation);
+  EXPECT_EQ(revision_tracker.size(), 0UL);
+
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, neighbor_id, 1, generation);
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_NEIGHBOR, neighbor_id, 0));
+}
+
+TEST(revision_tracker_test_cases, concurrent_records)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  uint64_t generation = revision_tracker.get_generation();
+  vector<thread> workers;
+
+  for (uint32_t revision = 1; revision <= 8; revision++) {
+    workers.emplace_back([&revision_tracker, generation, revision] {
+      for (int i = 0; i < 500; i++) {
+        string port_id = "revision_test_port_" + to_string(i);
+        revision_tracker.record_applied(REVISION_TEST_PORT, port_id, revision, generation);
+        revision_tracker.is_applied(REVISION_TEST_PORT, port_id, revision);
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_EQ(revision_tracker.size(), 500UL);
+  for (int i = 0; i < 500; i++) {
+    string port_id = "revision_test_port_" + to_string(i);
+    EXPECT_EQ(revision_tracker.get_applied_revision(REVISION_TEST_PORT, port_id), 8U);
+  }
+  revision_tracker.clear();
+}
+
+TEST(revision_tracker_test_cases, snapshot_round_trip)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  uint64_t generation = revision_tracker.get_generation();
+  aca_snapshot::ACA_Snapshot_Writer snapshot_writer;
+
+  revision_tracker.record_applied(REVISION_TEST_PORT, "revision_test_port", 7, generation);
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, "revision_test_port", 9, generation);
+  revision_tracker.snapshot(snapshot_writer);
+  revision_tracker.clear();
+  EXPECT_EQ(revision_tracker.get_applied_revision(REVISION_TEST_PORT, "revision_test_port"), 0U);
+
+  const string &data = snapshot_writer.get_data();
+  aca_snapshot::ACA_Snapshot_Reader snapshot_reader(data.data(), data.size());
+  EXPECT_EQ(revision_tracker.restore(snapshot_reader), EXIT_SUCCESS);
+  EXPECT_EQ(revision_tracker.get_applied_revision(REVISION_TEST_PORT, "revision_test_port"), 7U);
+  EXPECT_EQ(revision_tracker.get_applied_revision(REVISION_TEST_NEIGHBOR, "revision_test_port"),
+            9U);
+  revision_tracker.clear();
+}
+
+TEST(revision_tracker_test_cases, record_dropped_after_clear)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  string port_id = "revision_test_port";
+
+  // the dataplane is reset while the port is being programmed
+  uint64_t generation = revision_tracker.get_generation();
+  revision_tracker.clear();
+  revision_tracker.record_applied(REVISION_TEST_PORT, port_id, 3, generation);
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 3));
+
+  generation = revision_tracker.get_generation();
+  revision_tracker.record_applied(REVISION_TEST_PORT, port_id, 3, generation);
+  EXPECT_TRUE(revision_tracker.is_applied(REVISION_TEST_PORT, port_id, 3));
+  revision_tracker.clear();
+}
+
+TEST(revision_tracker_test_cases, forget_tunnel_drops_its_resources)
+{
+  ACA_Revision_Tracker &revision_tracker = ACA_Revision_Tracker::get_instance();
+  revision_tracker.clear();
+  uint64_t generation = revision_tracker.get_generation();
+  aca_snapshot::ACA_Snapshot_Writer snapshot_writer;
+
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_1", 3,
+                                  generation, { 21 });
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_2", 3,
+                                  generation, { 22, 21 });
+  revision_tracker.record_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_3", 3,
+                                  generation, { 22 });
+  revision_tracker.record_applied(REVISION_TEST_PORT, "revision_test_port", 3, generation);
+
+  // the tunnel ids survive a restart
+  revision_tracker.snapshot(snapshot_writer);
+  revision_tracker.clear();
+  const string &data = snapshot_writer.get_data();
+  aca_snapshot::ACA_Snapshot_Reader snapshot_reader(data.data(), data.size());
+  EXPECT_EQ(revision_tracker.restore(snapshot_reader), EXIT_SUCCESS);
+
+  // the vlan of tunnel 21 is torn down, the same revisions have to be programmed again
+  EXPECT_EQ(revision_tracker.forget_tunnel(21), 2UL);
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_1", 3));
+  EXPECT_FALSE(revision_tracker.is_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_2", 3));
+  EXPECT_TRUE(revision_tracker.is_applied(REVISION_TEST_NEIGHBOR, "revision_test_neighbor_3", 3));
+  EXPECT_TRUE(revision_tracker.is_applied(REVISION_TEST_PORT, "revision_test_port", 3));
+  EXPECT_EQ(revision_tracker.forget_tunnel(21), 0UL);
+  revision_tracker.clear();
+}
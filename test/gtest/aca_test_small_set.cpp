@@ -0,0 +1,75 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_small_set.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <string>
+
+using namespace std;
+
+static set<string> aca_test_small_set_values(const ACA_Small_Set<string, 2> &small_set)
+{
+  set<string> values;
+  small_set.for_each([&](const string &value) { values.insert(value); });
+  return values;
+}
+
+TEST(small_set_test_cases, insert_erase_within_inline_capacity)
+{
+  ACA_Small_Set<string, 2> small_set;
+
+  EXPECT_TRUE(small_set.empty());
+  EXPECT_TRUE(small_set.insert("port_1"));
+  EXPECT_FALSE(small_set.insert("port_1"));
+  EXPECT_TRUE(small_set.insert("port_2"));
+  EXPECT_EQ(small_set.size(), 2UL);
+  EXPECT_TRUE(small_set.contains("port_2"));
+
+  EXPECT_TRUE(small_set.erase("port_1"));
+  EXPECT_FALSE(small_set.erase("port_1"));
+  EXPECT_EQ(aca_test_small_set_values(small_set), set<string>({ "port_2" }));
+
+  EXPECT_TRUE(small_set.erase("port_2"));
+  EXPECT_TRUE(small_set.empty());
+}
+
+TEST(small_set_test_cases, grows_past_inline_capacity)
+{
+  ACA_Small_Set<string, 2> small_set;
+  set<string> expected_values;
+
+  for (int i = 0; i < 10; i++) {
+    string value = "port_" + to_string(i);
+    EXPECT_TRUE(small_set.insert(value));
+    expected_values.insert(value);
+  }
+  EXPECT_EQ(small_set.size(), 10UL);
+  EXPECT_EQ(aca_test_small_set_values(small_set), expected_values);
+
+  // erase from the inline slots and from the overflow
+  for (int i : { 0, 7, 1, 9 }) {
+    string value = "port_" + to_string(i);
+    EXPECT_TRUE(small_set.erase(value));
+    expected_values.erase(value);
+    EXPECT_FALSE(small_set.contains(value));
+  }
+  EXPECT_EQ(small_set.size(), 6UL);
+  EXPECT_EQ(aca_test_small_set_values(small_set), expected_values);
+
+  small_set.clear();
+  EXPECT_TRUE(small_set.empty());
+  EXPECT_TRUE(small_set.insert("port_1"));
+  EXPECT_EQ(aca_test_small_set_values(small_set), set<string>({ "port_1" }));
+}
@@ -0,0 +1,162 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_snapshot.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+using namespace aca_snapshot;
+
+static const string snapshot_test_file = "/tmp/aca_test_snapshot";
+
+TEST(snapshot_test_cases, writer_and_reader_round_trip)
+{
+  ACA_Snapshot_Writer snapshot_writer;
+  ACA_Snapshot_Writer entries_writer;
+
+  entries_writer.put_string("port_1");
+  entries_writer.put_string("");
+
+  snapshot_writer.put_u8(7);
+  snapshot_writer.put_u16(4094);
+  snapshot_writer.put_u32(123456789);
+  snapshot_writer.put_u64(0x0123456789abcdefULL);
+  snapshot_writer.put_u32(2);
+  snapshot_writer.put_bytes(entries_writer.get_data());
+
+  const string &data = snapshot_writer.get_data();
+  ACA_Snapshot_Reader snapshot_reader(data.data(), data.size());
+  uint8_t u8_value = 0;
+  uint16_t u16_value = 0;
+  uint32_t u32_value = 0;
+  uint64_t u64_value = 0;
+  string string_value;
+
+  EXPECT_TRUE(snapshot_reader.get_u8(u8_value));
+  EXPECT_EQ(u8_value, 7);
+  EXPECT_TRUE(snapshot_reader.get_u16(u16_value));
+  EXPECT_EQ(u16_value, 4094);
+  EXPECT_TRUE(snapshot_reader.get_u32(u32_value));
+  EXPECT_EQ(u32_value, 123456789U);
+  EXPECT_TRUE(snapshot_reader.get_u64(u64_value));
+  EXPECT_EQ(u64_value, 0x0123456789abcdefULL);
+  EXPECT_TRUE(snapshot_reader.get_u32(u32_value));
+  EXPECT_EQ(u32_value, 2U);
+  EXPECT_TRUE(snapshot_reader.get_string(string_value));
+  EXPECT_EQ(string_value, "port_1");
+  EXPECT_TRUE(snapshot_reader.get_string(string_value));
+  EXPECT_EQ(string_value, "");
+  EXPECT_TRUE(snapshot_reader.is_at_end());
+  EXPECT_TRUE(snapshot_reader.is_good());
+
+  // reading past the end fails and the reader stays failed
+  EXPECT_FALSE(snapshot_reader.get_u8(u8_value));
+  EXPECT_FALSE(snapshot_reader.is_good());
+}
+
+TEST(snapshot_test_cases, truncated_string_is_detected)
+{
+  ACA_Snapshot_Writer snapshot_writer;
+  snapshot_writer.put_string("neighbor_22");
+
+  const string &data = snapshot_writer.get_data();
+  ACA_Snapshot_Reader snapshot_reader(data.data(), data.size() - 1);
+  string string_value;
+
+  EXPECT_FALSE(snapshot_reader.get_string(string_value));
+  EXPECT_FALSE(snapshot_reader.is_good());
+}
+
+TEST(snapshot_test_cases, write_and_load_file)
+{
+  ACA_Snapshot_Writer snapshot_writer;
+  remove(snapshot_test_file.c_str());
+
+  ACA_Snapshot_File missing_file;
+  EXPECT_EQ(missing_file.load(snapshot_test_file), -ENOENT);
+
+  snapshot_writer.put_u32(42);
+  snapshot_writer.put_string("router_1");
+  ASSERT_EQ(ACA_Snapshot_File::write(snapshot_test_file, snapshot_writer.get_data()),
+            EXIT_SUCCESS);
+
+  ACA_Snapshot_File snapshot_file;
+  ASSERT_EQ(snapshot_file.load(snapshot_test_file), EXIT_SUCCESS);
+  EXPECT_EQ(snapshot_file.load(snapshot_test_file), -EINVAL);
+
+  ACA_Snapshot_Reader snapshot_reader = snapshot_file.get_reader();
+  uint32_t u32_value = 0;
+  string string_value;
+  EXPECT_TRUE(snapshot_reader.get_u32(u32_value));
+  EXPECT_EQ(u32_value, 42U);
+  EXPECT_TRUE(snapshot_reader.get_string(string_value));
+  EXPECT_EQ(string_value, "router_1");
+  EXPECT_TRUE(snapshot_reader.is_at_end());
+
+  remove(snapshot_test_file.c_str());
+}
+
+TEST(snapshot_test_cases, previous_snapshot_is_kept)
+{
+  ACA_Snapshot_Writer first_writer;
+  ACA_Snapshot_Writer second_writer;
+  string previous_file = ACA_Snapshot_File::get_previous_path(snapshot_test_file);
+  remove(snapshot_test_file.c_str());
+  remove(previous_file.c_str());
+
+  first_writer.put_u32(1);
+  ASSERT_EQ(ACA_Snapshot_File::write(snapshot_test_file, first_writer.get_data()), EXIT_SUCCESS);
+  second_writer.put_u32(2);
+  ASSERT_EQ(ACA_Snapshot_File::write(snapshot_test_file, second_writer.get_data()),
+            EXIT_SUCCESS);
+
+  ACA_Snapshot_File snapshot_file;
+  ACA_Snapshot_File previous_snapshot_file;
+  uint32_t u32_value = 0;
+  ASSERT_EQ(snapshot_file.load(snapshot_test_file), EXIT_SUCCESS);
+  EXPECT_TRUE(snapshot_file.get_reader().get_u32(u32_value));
+  EXPECT_EQ(u32_value, 2U);
+  ASSERT_EQ(previous_snapshot_file.load(previous_file), EXIT_SUCCESS);
+  EXPECT_TRUE(previous_snapshot_file.get_reader().get_u32(u32_value));
+  EXPECT_EQ(u32_value, 1U);
+
+  remove(snapshot_test_file.c_str());
+  remove(previous_file.c_str());
+}
+
+TEST(snapshot_test_cases, damaged_file_is_rejected)
+{
+  ACA_Snapshot_Writer snapshot_writer;
+  snapshot_writer.put_string("subnet_1");
+  ASSERT_EQ(ACA_Snapshot_File::write(snapshot_test_file, snapshot_writer.get_data()),
+            EXIT_SUCCESS);
+
+  // flip the last byte of the data
+  fstream snapshot_stream(snapshot_test_file, ios::in | ios::out | ios::binary);
+  snapshot_stream.seekg(-1, ios::end);
+  char last_byte = snapshot_stream.get();
+  snapshot_stream.seekp(-1, ios::end);
+  snapshot_stream.put(last_byte ^ 0x5a);
+  snapshot_stream.close();
+
+  ACA_Snapshot_File snapshot_file;
+  EXPECT_EQ(snapshot_file.load(snapshot_test_file), -EINVAL);
+  EXPECT_EQ(snapshot_file.size(), 0UL);
+
+  remove(snapshot_test_file.c_str());
+}
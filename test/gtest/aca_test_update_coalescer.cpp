@@ -0,0 +1,188 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_update_coalescer.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace std;
+using aca_update_coalescer::ACA_Update_Coalescer;
+
+// resource types are opaque ints to the coalescer
+static const int COALESCER_TEST_PORT = 1;
+
+TEST(update_coalescer_test_cases, newer_update_supersedes_older)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_1";
+
+  // a port re-created twice, three creates queued before the first one starts
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 1, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 2, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 3, ACA_Update_Coalescer::CREATE_OPERATION);
+
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 1,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 1);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 2,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 2);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 3,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 3);
+
+  EXPECT_EQ(coalescer.size(), 0UL);
+}
+
+TEST(update_coalescer_test_cases, stale_update_after_newer_one_is_done)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_2";
+
+  // the newer create overtakes the older one in the queue and finishes first
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 4, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 5, ACA_Update_Coalescer::CREATE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 5,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 4),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 5);
+
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 4,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 5),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 4);
+
+  // nothing pending, applied as usual
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 4,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 5),
+            ACA_Update_Coalescer::APPLY);
+}
+
+TEST(update_coalescer_test_cases, create_and_delete_cancel_out)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_3";
+  string programmed_port_id = "coalescer_test_port_4";
+  unsigned long coalesced_before = coalescer.coalesced_count();
+
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 1, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 2, ACA_Update_Coalescer::DELETE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 1,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 1);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 2,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 0),
+            ACA_Update_Coalescer::SKIP_CANCELLED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 2);
+  EXPECT_EQ(coalescer.coalesced_count(), coalesced_before + 2);
+
+  // a port already programmed by an earlier create must still be deleted
+  coalescer.add_pending(COALESCER_TEST_PORT, programmed_port_id, 1,
+                        ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, programmed_port_id, 2,
+                        ACA_Update_Coalescer::DELETE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, programmed_port_id, 1,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 1),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, programmed_port_id, 2,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 1),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, programmed_port_id, 1);
+  coalescer.remove_pending(COALESCER_TEST_PORT, programmed_port_id, 2);
+
+  EXPECT_EQ(coalescer.size(), 0UL);
+}
+
+TEST(update_coalescer_test_cases, clear_applies_queued_updates)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_5";
+
+  // the dataplane is reset with two creates of the port still queued
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 6, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 7, ACA_Update_Coalescer::CREATE_OPERATION);
+  coalescer.clear();
+  EXPECT_EQ(coalescer.size(), 0UL);
+
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 6,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 6);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 7);
+
+  EXPECT_EQ(coalescer.size(), 0UL);
+}
+
+TEST(update_coalescer_test_cases, delete_before_newer_create_is_applied)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_6";
+
+  // the port is deleted and created again, the delete removes the old revision's flows
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 2, ACA_Update_Coalescer::DELETE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 3, ACA_Update_Coalescer::CREATE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 2,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 1),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 2);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 3,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 0),
+            ACA_Update_Coalescer::APPLY);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 3);
+
+  // a newer delete supersedes an older one
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 4, ACA_Update_Coalescer::DELETE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 5, ACA_Update_Coalescer::DELETE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 4,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 3),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 4);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 5);
+
+  EXPECT_EQ(coalescer.size(), 0UL);
+}
+
+TEST(update_coalescer_test_cases, create_finishing_before_older_delete_skips_it)
+{
+  ACA_Update_Coalescer &coalescer = ACA_Update_Coalescer::get_instance();
+  string port_id = "coalescer_test_port_7";
+  unsigned long coalesced_before = coalescer.coalesced_count();
+
+  // the small create runs on a priority lane before the older bulk delete
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 2, ACA_Update_Coalescer::DELETE_OPERATION);
+  coalescer.add_pending(COALESCER_TEST_PORT, port_id, 3, ACA_Update_Coalescer::CREATE_OPERATION);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 3,
+                             ACA_Update_Coalescer::CREATE_OPERATION, 1),
+            ACA_Update_Coalescer::APPLY);
+
+  // the create is still being programmed
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 2,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 1),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+
+  // the create is done and its revision recorded
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 3);
+  EXPECT_EQ(coalescer.decide(COALESCER_TEST_PORT, port_id, 2,
+                             ACA_Update_Coalescer::DELETE_OPERATION, 3),
+            ACA_Update_Coalescer::SKIP_SUPERSEDED);
+  coalescer.remove_pending(COALESCER_TEST_PORT, port_id, 2);
+  EXPECT_EQ(coalescer.coalesced_count(), coalesced_before + 2);
+
+  EXPECT_EQ(coalescer.size(), 0UL);
+}
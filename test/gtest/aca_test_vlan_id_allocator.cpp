@@ -0,0 +1,111 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_vlan_id_allocator.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_vlan_manager::ACA_Vlan_Id_Allocator;
+
+TEST(vlan_id_allocator_test_cases, all_valid_ids_then_exhausted)
+{
+  ACA_Vlan_Id_Allocator vlan_id_allocator;
+  set<uint> vlan_ids;
+
+  for (uint i = 1; i < VLAN_ID_COUNT - 1; i++) {
+    uint vlan_id = vlan_id_allocator.allocate();
+    EXPECT_EQ(vlan_id, i);
+    vlan_ids.insert(vlan_id);
+  }
+  EXPECT_EQ(vlan_ids.size(), VLAN_ID_COUNT - 2UL);
+  EXPECT_EQ(vlan_id_allocator.get_allocated_count(), VLAN_ID_COUNT - 2U);
+
+  // 0 and 4095 are never handed out
+  EXPECT_EQ(vlan_id_allocator.allocate(), 0U);
+
+  vlan_id_allocator.release(100);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 100U);
+}
+
+TEST(vlan_id_allocator_test_cases, released_ids_are_reused_after_the_others)
+{
+  ACA_Vlan_Id_Allocator vlan_id_allocator;
+
+  EXPECT_EQ(vlan_id_allocator.allocate(), 1U);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 2U);
+  vlan_id_allocator.release(1);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 3U);
+  EXPECT_EQ(vlan_id_allocator.get_allocated_count(), 2U);
+
+  // wraps around once the end is reached
+  vlan_id_allocator.set_next_vlan_id(VLAN_ID_COUNT - 2);
+  EXPECT_EQ(vlan_id_allocator.allocate(), VLAN_ID_COUNT - 2U);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 1U);
+}
+
+TEST(vlan_id_allocator_test_cases, reserve_restored_ids)
+{
+  ACA_Vlan_Id_Allocator vlan_id_allocator;
+
+  EXPECT_TRUE(vlan_id_allocator.reserve(7));
+  EXPECT_FALSE(vlan_id_allocator.reserve(7));
+  EXPECT_FALSE(vlan_id_allocator.reserve(0));
+  EXPECT_FALSE(vlan_id_allocator.reserve(VLAN_ID_COUNT - 1));
+  EXPECT_FALSE(vlan_id_allocator.reserve(VLAN_ID_COUNT));
+
+  vlan_id_allocator.set_next_vlan_id(7);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 8U);
+
+  vlan_id_allocator.clear();
+  EXPECT_EQ(vlan_id_allocator.get_allocated_count(), 0U);
+  EXPECT_EQ(vlan_id_allocator.allocate(), 1U);
+}
+
+TEST(vlan_id_allocator_test_cases, concurrent_allocations_are_unique)
+{
+  ACA_Vlan_Id_Allocator vlan_id_allocator;
+  const int thread_count = 8;
+  const int allocations_per_thread = 500;
+  vector<vector<uint> > allocated_ids(thread_count);
+  vector<thread> threads;
+
+  for (int i = 0; i < thread_count; i++) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < allocations_per_thread; j++) {
+        uint vlan_id = vlan_id_allocator.allocate();
+        allocated_ids[i].push_back(vlan_id);
+        // churn, give every other id back
+        if (j % 2 == 0) {
+          vlan_id_allocator.release(vlan_id);
+        }
+      }
+    });
+  }
+  for (auto &current_thread : threads) {
+    current_thread.join();
+  }
+
+  set<uint> kept_ids;
+  for (auto &thread_ids : allocated_ids) {
+    for (size_t j = 1; j < thread_ids.size(); j += 2) {
+      EXPECT_NE(thread_ids[j], 0U);
+      EXPECT_TRUE(kept_ids.insert(thread_ids[j]).second);
+    }
+  }
+  EXPECT_EQ(vlan_id_allocator.get_allocated_count(), kept_ids.size());
+}
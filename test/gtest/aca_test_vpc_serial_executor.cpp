@@ -0,0 +1,69 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_vpc_serial_executor.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+using aca_vpc_serial_executor::ACA_Vpc_Serial_Executor;
+
+TEST(vpc_serial_executor_test_cases, same_vpc_is_serialized)
+{
+  ACA_Vpc_Serial_Executor &vpc_executor = ACA_Vpc_Serial_Executor::get_instance();
+  const uint tunnel_id = 20;
+  // not atomic on purpose, the shard is the only writer
+  int vpc_operation_count = 0;
+  vector<thread> callers;
+
+  for (int i = 0; i < 8; i++) {
+    callers.emplace_back([&] {
+      for (int j = 0; j < 100; j++) {
+        vpc_executor.execute(tunnel_id, [&] {
+          vpc_operation_count++;
+          return EXIT_SUCCESS;
+        });
+      }
+    });
+  }
+  for (auto &caller : callers) {
+    caller.join();
+  }
+
+  int final_count = vpc_executor.execute(tunnel_id, [&] { return vpc_operation_count; });
+  EXPECT_EQ(final_count, 800);
+}
+
+TEST(vpc_serial_executor_test_cases, nested_execute_and_exception)
+{
+  ACA_Vpc_Serial_Executor &vpc_executor = ACA_Vpc_Serial_Executor::get_instance();
+  const uint tunnel_id = 21;
+
+  EXPECT_FALSE(vpc_executor.is_on_shard(tunnel_id));
+
+  // a nested call on the same shard runs inline instead of waiting on itself
+  int rc = vpc_executor.execute(tunnel_id, [&] {
+    EXPECT_TRUE(vpc_executor.is_on_shard(tunnel_id));
+    return vpc_executor.execute(tunnel_id + vpc_executor.shard_count(), [] { return 7; });
+  });
+  EXPECT_EQ(rc, 7);
+
+  EXPECT_THROW(vpc_executor.execute(tunnel_id,
+                                    []() -> int { throw runtime_error("bad vpc"); }),
+               runtime_error);
+  // the shard keeps running after an operation threw
+  EXPECT_EQ(vpc_executor.execute(tunnel_id, [] { return EXIT_SUCCESS; }), EXIT_SUCCESS);
+}
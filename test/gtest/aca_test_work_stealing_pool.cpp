@@ -0,0 +1,85 @@
+// MIT License
+// Copyright(c) 2020 Futurewei Cloud
+//
+//     Permission is hereby granted,
+//     free of charge, to any person obtaining a copy of this software and associated documentation files(the "Software"), to deal in the Software without restriction,
+//     including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies of the Software, and to permit persons
+//     to whom the Software is furnished to do so, subject to the following conditions:
+//
+//     The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+//
+//     THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//     FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//     WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "aca_log.h"
+#include "aca_work_stealing_pool.h"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using aca_work_stealing_pool::ACA_Work_Stealing_Pool;
+
+TEST(work_stealing_pool_test_cases, parallel_for_runs_every_item_once)
+{
+  ACA_Work_Stealing_Pool &pool = ACA_Work_Stealing_Pool::get_instance();
+  const size_t item_count = 1000;
+  vector<atomic_int> item_runs(item_count);
+
+  EXPECT_GT(pool.size(), 0);
+
+  pool.parallel_for(item_count, 0, [&](size_t i) { item_runs[i]++; });
+
+  for (size_t i = 0; i < item_count; i++) {
+    EXPECT_EQ(item_runs[i].load(), 1);
+  }
+
+  // odd chunk size leaves a short last chunk
+  pool.parallel_for(item_count, 7, [&](size_t i) { item_runs[i]++; });
+
+  for (size_t i = 0; i < item_count; i++) {
+    EXPECT_EQ(item_runs[i].load(), 2);
+  }
+}
+
+TEST(work_stealing_pool_test_cases, nested_parallel_for_and_exception)
+{
+  ACA_Work_Stealing_Pool &pool = ACA_Work_Stealing_Pool::get_instance();
+  atomic_int inner_runs(0);
+
+  // more outer items than workers, each of them fanning out again
+  pool.parallel_for(pool.size() * 4, 1, [&](size_t) {
+    pool.parallel_for(10, 1, [&](size_t) { inner_runs++; });
+  });
+  EXPECT_EQ(inner_runs.load(), pool.size() * 40);
+
+  atomic_int item_runs(0);
+  EXPECT_THROW(pool.parallel_for(100, 1,
+                                 [&](size_t i) {
+                                   item_runs++;
+                                   if (i == 50) {
+                                     throw runtime_error("workitem failed");
+                                   }
+                                 }),
+               runtime_error);
+  // the other items still ran
+  EXPECT_EQ(item_runs.load(), 100);
+}
+
+TEST(work_stealing_pool_test_cases, single_chunk_runs_on_caller)
+{
+  ACA_Work_Stealing_Pool &pool = ACA_Work_Stealing_Pool::get_instance();
+  thread::id caller_id = this_thread::get_id();
+  vector<thread::id> item_threads(8);
+
+  pool.parallel_for(1, 0, [&](size_t i) { item_threads[i] = this_thread::get_id(); });
+  EXPECT_EQ(item_threads[0], caller_id);
+
+  pool.parallel_for(item_threads.size(), item_threads.size(),
+                    [&](size_t i) { item_threads[i] = this_thread::get_id(); });
+  for (auto &item_thread : item_threads) {
+    EXPECT_EQ(item_thread, caller_id);
+  }
+}